@@ -5,7 +5,7 @@
 
 namespace TMTT {
  
-class ChiSquared4ParamsApprox : public L1ChiSquared{
+class ChiSquared4ParamsApprox : public L1ChiSquared<4>{
  
 public:
     ChiSquared4ParamsApprox(const Settings* settings, const uint nPar);
@@ -13,15 +13,14 @@ public:
     ~ChiSquared4ParamsApprox(){}
  
 protected:
-    std::vector<double> seed(const L1track3D& l1track3D);
-    std::vector<double> residuals(std::vector<double> x);
-    Matrix<double> D(std::vector<double> x);
-    Matrix<double> Vinv();
-    std::map<std::string, double> convertParams(std::vector<double> x);
- 
-private:
-    std::vector<double> mapToVec(std::map<std::string, double> x);
-    std::map<std::string, double> vecToMap(std::vector<double> x);
+    // Indices of the helix params in ParamVec.
+    enum {RINV = 0, PHI0 = 1, T = 2, Z0 = 3};
+
+    ParamVec seed(const L1track3D& l1track3D);
+    void residuals(const ParamVec& x, std::vector<double>& delta);
+    void D(const ParamVec& x, std::vector<ParamVec>& D);
+    void Vinv(std::vector<double>& vInv);
+    L1ChiSquaredParams convertParams(const ParamVec& x);
 };
 
 }
@@ -0,0 +1,23 @@
+#ifndef __DEBUGLEVEL_H__
+#define __DEBUGLEVEL_H__
+
+//==================================================================================================
+/**
+* Compile time limit on the debug printout, e.g. of the Kalman fit (KalmanDebugLevel).
+*
+* Debug printout is guarded by TMTT_DEBUG_ON(level, runLevel), which is true if level is compiled
+* in (level <= TMTT_MAX_DEBUG_LEVEL) and enabled at run time (runLevel >= level). For a level above
+* TMTT_MAX_DEBUG_LEVEL the condition is a compile time constant, so the printout is removed by the
+* compiler and the run time level is not even read. The default keeps the level 1 (per track)
+* printout, and removes the per stub & per state printout of the hot loops.
+* To get it, compile with e.g. USER_CXXFLAGS="-DTMTT_MAX_DEBUG_LEVEL=4".
+*/
+//==================================================================================================
+
+#ifndef TMTT_MAX_DEBUG_LEVEL
+#define TMTT_MAX_DEBUG_LEVEL 1
+#endif
+
+#define TMTT_DEBUG_ON(level, runLevel) ((level) <= TMTT_MAX_DEBUG_LEVEL && (runLevel) >= (level))
+
+#endif
@@ -34,7 +34,11 @@ public:
   virtual void init(const Settings* settings, unsigned int iPhiSec, unsigned int iEtaReg, 
 		    float etaMinSector, float etaMaxSector, float) = 0;
 
-  void init(const Settings* settings, unsigned int iPhiSec, unsigned int iEtaReg) {settings_ = settings; iPhiSec_ = iPhiSec; iEtaReg_ = iEtaReg; optoLinkID_ = this->calcOptoLinkID();}
+  void init(const Settings* settings, unsigned int iPhiSec, unsigned int iEtaReg) {settings_ = settings; iPhiSec_ = iPhiSec; iEtaReg_ = iEtaReg; optoLinkID_ = this->calcOptoLinkID(); touchedCells_.clear(); trackCands2D_.clear();}
+
+  // Remove all stubs & tracks from the HT array, ready for the next event, keeping its configuration.
+  // Only the cells that received stubs are cleared, so this is much faster than calling init() again.
+  virtual void reset();
 
   // Add stub to HT array.
   // N.B. The argument lists for this are different for r-phi & r-z HT, so unfortunately it can't be declared in base class.
@@ -108,6 +112,13 @@ public:
 
 protected:
 
+  // Add stub to cell (i,j) of HT array, noting the cells that receive stubs.
+  void storeInCell(unsigned int i, unsigned int j, const Stub* stub, const vector<bool>& inSubSecs) {
+    HTcell& cell = htArray_(i,j);
+    if (cell.numUnfilteredStubs() == 0) touchedCells_.push_back( pair<unsigned int, unsigned int>(i, j) );
+    cell.store( stub, inSubSecs ); // Calls HTcell::store()
+  }
+
   // Given a range in one of the coordinates specified by coordRange, calculate the corresponding range of bins. The other arguments specify the axis. And also if some cells nominally associated to stub are to be killed.
   virtual pair<unsigned int, unsigned int> convertCoordRangeToBinRange( pair<float, float> coordRange, unsigned int nBinsAxis, float coordAxisMin, float coordAxisBinSize, unsigned int killSomeHTcells, bool debug = false) const;
 
@@ -143,6 +154,9 @@ protected:
   // This has two dimensions, representing the two track helix parameters being varied.
   matrix<HTcell> htArray_; 
 
+  // Cells of the HT array that have received stubs since the last reset. (All others are empty).
+  vector< pair<unsigned int, unsigned int> > touchedCells_;
+
   // Contains algorithm used for duplicate track removal.
   KillDupTrks<L1track2D> killDupTrks_;
 
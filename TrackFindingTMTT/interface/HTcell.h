@@ -35,6 +35,9 @@ public:
 	    float etaMinSector, float etaMaxSector, float qOverPt, unsigned int ibin_qOverPt, 
 	    bool mergedCell);
 
+  // Remove all stubs from this cell, ready for the next event.
+  void reset();
+
   // Add stub to this cell in HT array.
   void store (const Stub* stub) { vStubs_.push_back(stub); }
 
@@ -35,6 +35,9 @@ public:
   // If eta subsectors are being used within each sector, specify which ones the stub is compatible with.
   void store( const Stub* stub, const vector<bool>& inEtaSubSecs);
 
+  // Remove all stubs & tracks, ready for the next event, keeping the configuration set by init().
+  virtual void reset() {nReceivedStubs_ = 0; HTbase::reset();}
+
   // Termination. Causes HT array to search for tracks etc.
   // ... function end() is in base class ...
 
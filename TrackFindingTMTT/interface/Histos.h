@@ -11,6 +11,8 @@ using  boost::numeric::ublas::matrix;
 
 #include <vector>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <string>
 
 using namespace std;
@@ -29,6 +31,8 @@ namespace TMTT {
 
 class InputData;
 class TP;
+class Stub;
+class L1track3D;
 class Sector;
 class HTrphi;
 class Get3Dtracks;
@@ -46,13 +50,13 @@ public:
   // Book & fill all histograms.
   void book();
   void fill(const InputData& inputData, const matrix<Sector>& mSectors, const matrix<HTrphi>& mHtPhis, 
-    	    const matrix<Get3Dtracks> mGet3Dtrks, const std::map<std::string,std::vector<L1fittedTrack>>& fittedTracks);
+    	    const matrix<Get3Dtracks>& mGet3Dtrks, const std::map<std::string,std::vector<L1fittedTrack>>& fittedTracks);
 
   // Print tracking performance summary & make tracking efficiency histograms.
   void endJobAnalysis();
 
   // Determine "B" parameter, used in GP firmware to allow for tilted modules.
-  void trackerGeometryAnalysis( const TrackerGeometryInfo trackerGeometryInfo );
+  void trackerGeometryAnalysis( const TrackerGeometryInfo& trackerGeometryInfo );
 
   // Did user request output histograms via the TFileService in their cfg?
   bool available() const {return fs_.isAvailable();}
@@ -60,8 +64,14 @@ public:
   // Should histograms be produced?
   bool enabled() const {return ( settings_->enableHistos() && available() );}
 
+  // Should the given group of histograms (e.g. "TrackCands") be produced? (See cfg param DisabledHistosGroups).
+  bool enabled(const string& group) const {return ( this->enabled() && disabledGroups_.count(group) == 0 );}
+
 private:
 
+  // Track candidates matched to each tracking particle.
+  typedef unordered_map<const TP*, vector<const L1track3D*> > TPtrackMap;
+
   // Book histograms for specific topics.
   void bookInputData();
   void bookEtaPhiSectors();
@@ -77,8 +87,8 @@ private:
   void fillRphiHT(const matrix<HTrphi>& mHtRphis);
   void fillRZfilters(const matrix<Get3Dtracks>& mGet3Dtrks);
   void fillStudyBusyEvents(const InputData& inputData, const matrix<Sector>& mSectors, const matrix<HTrphi>& mHtRphis, 
-    		           const matrix<Get3Dtracks> mGet3Dtrks);
-  void fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks> mGet3Dtrks, bool withRZfilter);
+    		           const matrix<Get3Dtracks>& mGet3Dtrks);
+  void fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks>& mGet3Dtrks, bool withRZfilter);
   void fillTrackFitting(const InputData& inputData, const std::map<std::string,std::vector<L1fittedTrack>>& fittedTracks);
 
   // Produce plots of tracking efficiency after HZ or after r-z track filter (run at end of job)
@@ -98,8 +108,19 @@ private:
   // Understand why not all tracking particles were reconstructed.
   // Returns list of tracking particles that were not reconstructed and an integer indicating why.
   // Only considers TP used for algorithmic efficiency measurement.
-  map<const TP*, string> diagnoseTracking(const vector<TP>& allTPs, const matrix<Get3Dtracks> mGet3Dtrks,
-					  bool withRZfilter) const;
+  map<const TP*, string> diagnoseTracking(const vector<TP>& allTPs, const matrix<Get3Dtracks>& mGet3Dtrks,
+					  const TPtrackMap& tpTracks, bool withRZfilter) const;
+
+  // Find the track candidates matched to each tracking particle, looping once over the tracks of all sectors.
+  TPtrackMap assocTrackCands3D(const matrix<Get3Dtracks>& mGet3Dtrks, bool withRZfilter) const;
+
+  // Find the tracking particles matched to the given tracks, which are flagged if killed in a busy sector,
+  // together with a flag indicating if any of their tracks survived.
+  map<const TP*, bool> tpSurvivedBusySec(const map<const L1track3D*, bool>& trkKilled) const;
+
+  // Copy the given stubs into digiStubs, digitized for input to the HT of the given phi sector, and return pointers to the copies.
+  // (If digitization is disabled, the input stubs are returned instead).
+  vector<const Stub*> digitizeStubsForHT(const vector<const Stub*>& stubs, unsigned int iPhiSec, vector<Stub>& digiStubs) const;
 
  private:
 
@@ -116,6 +137,7 @@ private:
   vector<string> useRZfilter_;
   bool ranRZfilter_;
   bool resPlotOpt_;
+  set<string> disabledGroups_; // Groups of histograms not to be produced.
 
   edm::Service<TFileService> fs_;
 
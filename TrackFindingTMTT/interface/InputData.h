@@ -13,6 +13,7 @@ using namespace std;
 namespace TMTT {
 
 class Settings;
+class ModuleInfoCache;
 
 //=== Unpacks stub & tracking particle (truth) data into user-friendlier format in Stub & TP classes.
 //=== Also makes B-field available to Settings class.
@@ -26,7 +27,8 @@ public:
   const edm::EDGetTokenT<DetSetVec> stubInputTag,
   const edm::EDGetTokenT<TTStubAssMap> stubTruthInputTag,
   const edm::EDGetTokenT<TTClusterAssMap> clusterTruthInputTag,
-  const edm::EDGetTokenT< reco::GenJetCollection > genJetInputTag
+  const edm::EDGetTokenT< reco::GenJetCollection > genJetInputTag,
+  const ModuleInfoCache* moduleInfoCache = nullptr
    );
 
   // Get tracking particles
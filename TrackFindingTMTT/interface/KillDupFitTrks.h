@@ -65,6 +65,11 @@ private:
   // Debug printout of which tracks are duplicates.
   void printDuplicateTracks(const vector<L1fittedTrack>& tracks) const;
 
+  // Key identifying an HT cell (m,c) in the hash set of used cells.
+  static unsigned long long cellKey(const pair<unsigned int, unsigned int>& htCell) {
+    return (static_cast<unsigned long long>(htCell.first) << 32) | htCell.second;
+  }
+
 private:
 
   const Settings *settings_; // Configuration parameters.
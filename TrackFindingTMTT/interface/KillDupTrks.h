@@ -7,6 +7,8 @@
 #include <functional>
 #include <utility>
 #include <iostream>
+#include <unordered_map>
+#include <bitset>
 
 #include "L1Trigger/TrackFindingTMTT/interface/Settings.h"
 #include "L1Trigger/TrackFindingTMTT/interface/Stub.h"
@@ -80,16 +82,21 @@ private:
    */
 vector<T> filterAlg25(const vector<T>& vecTracks) const;
 
+  /**
+  *  Compares two overlapping candidates in filterAlg25, flagging which (if any) is to be killed.
+  */
+  void compareAlg25(unsigned int i, unsigned int j, const vector<T>& vecTracks, vector<bool>& indices) const;
+
   /**
   *  Prints out a consistently formatted formatted report of killed duplicate track
   */
   void printKill(unsigned alg, unsigned dup, unsigned cand, T dupTrack, T candTrack) const;
 
   /**
-  * Counts candidate layers with stubs in common
+  * Finds for each candidate the other candidates with stubs in common in at least dupTrkMinCommonHitsLayers_ layers
+  * (sorted by index). Candidates are found via a hash map of the stubs, rather than comparing all pairs of candidates.
   */
-  unsigned int layerMatches(std::vector< std::pair<unsigned int, unsigned int> >* iStubs,
-			    std::vector< std::pair<unsigned int, unsigned int> >* jStubs) const;
+  void findOverlaps(const vector<T>& vecTracks, vector< vector<unsigned int> >& overlaps) const;
 private:
 
   const Settings *settings_; // Configuration parameters.
@@ -4,47 +4,63 @@
 
 #ifndef __L1_CHI_SQUARED__
 #define __L1_CHI_SQUARED__
- 
-#include "L1Trigger/TrackFindingTMTT/interface/Matrix.h"
+
+#include "L1Trigger/TrackFindingTMTT/interface/SymMatrix.h"
 #include "L1Trigger/TrackFindingTMTT/interface/Stub.h"
 #include "L1Trigger/TrackFindingTMTT/interface/TrackFitGeneric.h"
 #include "L1Trigger/TrackFindingTMTT/interface/Settings.h"
 #include "L1Trigger/TrackFindingTMTT/interface/L1track3D.h"
 #include <vector>
-#include <map>
-#include <utility>
- 
+#include <array>
+
  namespace TMTT {
 
- 
-class L1ChiSquared : public TrackFitGeneric{
+// Helix parameters returned by a chi-squared fit.
+struct L1ChiSquaredParams {
+  double qOverPt;
+  double phi0;
+  double z0;
+  double t;
+};
+
+//=== NPAR is the number of fitted helix parameters (4 or 5), fixed at compile time, so the
+//=== normal equations of each iteration are solved with a SymMatrix<NPAR> on the stack.
+
+template <unsigned int NPAR> class L1ChiSquared : public TrackFitGeneric{
 public:
+    typedef std::array<double, NPAR> ParamVec;
+
     L1ChiSquared(const Settings* settings, const uint nPar);
- 
+
     virtual ~L1ChiSquared(){}
- 
+
     L1fittedTrack fit(const L1track3D& l1track3D);
- 
+
 protected:
     /* Methods */
-    virtual std::vector<double> seed(const L1track3D& l1track3D)=0;
-    virtual std::vector<double> residuals(std::vector<double> x)=0;
-    virtual Matrix<double> D(std::vector<double> x)=0; // derivatives
-    virtual Matrix<double> Vinv()=0; // Covariances
-    virtual std::map<std::string, double> convertParams(std::vector<double> x)=0;
- 
+    virtual ParamVec seed(const L1track3D& l1track3D)=0;
+    // Residuals of the stubs_, two per stub.
+    virtual void residuals(const ParamVec& x, std::vector<double>& resids)=0;
+    // Derivatives of the residuals w.r.t. the helix params, one row per residual.
+    virtual void D(const ParamVec& x, std::vector<ParamVec>& derivs)=0;
+    // Diagonal of the inverse covariance matrix, one element per residual.
+    virtual void Vinv(std::vector<double>& vInv)=0;
+    virtual L1ChiSquaredParams convertParams(const ParamVec& x)=0;
+
     /* Variables */
     std::vector<const Stub*> stubs_;
-    std::map<std::string, double> trackParams_;
     uint nPar_;
     float largestresid_;
     int ilargestresid_;
     double chiSq_;
- 
+
 private:
 
-    void calculateChiSq( std::vector<double> resids );
-    void calculateDeltaChiSq( std::vector<double> deltaX, std::vector<double> covX );
+    // Do one iteration of the fit, updating the helix params x. Returns false if the normal equations can't be solved.
+    bool fitIteration( ParamVec& x, ParamVec& deltaX, ParamVec& covX );
+
+    void calculateChiSq( const std::vector<double>& resids );
+    void calculateDeltaChiSq( const ParamVec& deltaX, const ParamVec& covX );
 
     int numFittingIterations_;
     int killTrackFitWorstHit_;
@@ -52,11 +68,15 @@ private:
     double killingResidualCut_;
 
     unsigned int minStubLayers_;
-    unsigned int minStubLayersRed_; 
+    unsigned int minStubLayersRed_;
+
+    // Work space, kept to avoid reallocating it for each track.
+    std::vector<double>   resids_;
+    std::vector<ParamVec> derivs_;
+    std::vector<double>   vInv_;
 };
 
 }
 
 #endif
- 
 
@@ -0,0 +1,94 @@
+#ifndef __MODULEINFO_H__
+#define __MODULEINFO_H__
+
+#include "DataFormats/DetId/interface/DetId.h"
+
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+class TrackerGeometry;
+class TrackerTopology;
+class PixelGeomDetUnit;
+class PixelTopology;
+
+namespace TMTT {
+
+//=== Info about a tracker module, common to all stubs in it. 
+
+class ModuleInfo {
+
+public:
+
+  // Get the module info from the tracker geometry, given the DetId of the lower sensor in the module.
+  ModuleInfo(const TrackerGeometry* trackerGeometry, const TrackerTopology* trackerTopology, const DetId& detId);
+
+  ~ModuleInfo() {}
+
+public:
+
+  DetId                   detId_; // DetId of lower sensor in module.
+  const PixelGeomDetUnit* geomDet_; // Geometry of lower sensor.
+  const PixelTopology*    topology_;
+  bool                    barrel_;
+  bool                    endcap_; // From sensor subdetector (GeomDetEnumerators::isEndcap).
+  bool                    psModule_;
+  bool                    tiltedBarrel_;
+  float                   moduleMinR_; // Min & max (r,phi,z) coordinates of the centres of the two sensors.
+  float                   moduleMaxR_;
+  float                   moduleMinPhi_;
+  float                   moduleMaxPhi_;
+  float                   moduleMinZ_;
+  float                   moduleMaxZ_;
+  float                   moduleTilt_; // Tilt angle (range -PI/2 to +PI/2).
+  unsigned int            layerId_;
+  unsigned int            endcapRing_; // As given by TrackerTopology (Stub adds any geometry specific offset).
+  unsigned int            endcapWheel_;
+  float                   stripPitch_;
+  float                   stripLength_;
+  unsigned int            nStrips_;
+  float                   sensorWidth_;
+  bool                    outerModuleAtSmallerR_;
+  float                   sigmaPerp_;
+  float                   sigmaPar_;
+};
+
+//==================================================================================================
+/**
+* Cache of the ModuleInfo of all modules of the outer tracker, so that stubs can get the info
+* about their module without querying the tracker geometry & topology.
+* It is filled at the start of each run, and looked up via the DetId of the stacked module,
+* which the TTStub gives access to. The module info is stored in a flat array, with a
+* hash map from the DetId to the position in the array.
+*/
+//==================================================================================================
+
+class ModuleInfoCache {
+
+public:
+
+  ModuleInfoCache() {}
+
+  ~ModuleInfoCache() {}
+
+  // Fill the cache (at the start of each run).
+  void init(const TrackerGeometry* trackerGeometry, const TrackerTopology* trackerTopology);
+
+  // Info about the module with given stacked module DetId (or nullptr if not in cache).
+  const ModuleInfo* moduleInfo(const DetId& stackDetId) const {
+    unordered_map<unsigned int, unsigned int>::const_iterator it = index_.find(stackDetId.rawId());
+    return (it != index_.end())  ?  &(modules_[it->second])  :  nullptr;
+  }
+
+  unsigned int numModules() const {return modules_.size();}
+
+private:
+
+  vector<ModuleInfo>                        modules_;
+  unordered_map<unsigned int, unsigned int> index_; // Position in modules_ of each stacked module DetId.
+};
+
+}
+
+#endif
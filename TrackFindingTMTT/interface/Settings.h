@@ -30,6 +30,8 @@ public:
   bool                 enableMCtruth()           const   {return enableMCtruth_;}
   // Enable output histograms & job tracking performance summary (disable to save CPU).
   bool                 enableHistos()            const   {return enableHistos_;}
+  // Groups of histograms not to book or fill (e.g. "TrackCands"), to save CPU.
+  const vector<string>& disabledHistosGroups()    const   {return disabledHistosGroups_;}
 
   //=== Cuts on MC truth tracks for tracking efficiency measurements.
 
@@ -385,6 +387,13 @@ public:
   // N.B. This parameter does not appear inside TMTrackProducer_Defaults_cfi.py . It is created inside tmtt_tf_analysis_cfg.py .
   bool                 writeOutEdmFile()         const   {return writeOutEdmFile_;}
 
+  // Print time spent in each processing stage of TMTrackProducer at end of job (for benchmarking).
+  bool                 printStageTiming()        const   {return printStageTiming_;}
+
+  // File to which the digest of the fitted tracks of each event is written (none if empty).
+  // The digest of the whole job is always printed at end of job.
+  const string&        digestFileName()          const   {return digestFileName_;}
+
   //=== Hard-wired constants
 
   double               pitchPS()                 const   {cout<<"ERROR: Use Stub::stripPitch instead of Settings::pitchPS!";exit(1);return 0.;} // pitch of PS modules - OBSOLETE
@@ -439,6 +448,7 @@ private:
   // General settings
   bool                 enableMCtruth_;
   bool                 enableHistos_;
+  vector<string>       disabledHistosGroups_;
 
   // Cuts on truth tracking particles.
   double               genMinPt_;
@@ -662,6 +672,10 @@ private:
   // Boolean indicating an an EDM output file will be written.
   bool                 writeOutEdmFile_;
 
+  // Print time per processing stage at end of job.
+  bool                 printStageTiming_;
+  string               digestFileName_;
+
   // B-field in Tesla
   float                bField_;
 
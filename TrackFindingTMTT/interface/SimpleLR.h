@@ -26,14 +26,34 @@ public:
 
 	virtual void initRun();
 
-        L1fittedTrack fit(const L1track3D& l1track3D);
+	// Fit a single track candidate (using the same code as fitTracks()).
+	L1fittedTrack fit(const L1track3D& l1track3D);
+
+	// Fit several track candidates at once, with their stubs packed into arrays. 
+	// Gives the same result as calling fit() for each of them.
+	virtual vector<L1fittedTrack> fitTracks(const vector<L1track3D>& l1tracks3D);
 
 protected:
 
+	// Pack the stubs of the nTrks given track candidates into the arrays used by firstHelices() & fitPacked().
+	void packStubs(const L1track3D* l1tracks3D, unsigned int nTrks);
+
+	// First helix params. of each packed track candidate & residuals of its stubs w.r.t. them.
+	void firstHelices();
+
+	// Helix parameters from the regression sums (before outlier rejection).
+	void firstHelix(unsigned int numStubs, double SumRPhi, double SumR, double SumPhi, double SumR2,
+			double& qOverPt, double& phiT, double& phi0) const;
+
+	// Fit track candidate iTrk of those packed by packStubs(), after firstHelices() has been run.
+	L1fittedTrack fitPacked(const L1track3D& l1track3D, unsigned int iTrk);
+
+	// Debug printout of the coordinates of packed stub i.
+	void printPackedStub(unsigned int i) const;
+
 	const Settings* settings_;
 
 	float phiSectorWidth_;
-	float phiSectorCentre;
 
 	float phiMult_;
 	float rTMult_;
@@ -64,7 +84,29 @@ protected:
 	unsigned int 	     shiftingBitsz0_;
 	unsigned int         shiftingBitsLambda_;
 
-	
+	// Stubs of the track candidates being fitted, with those of each track contiguous.
+	// (Kept as data members to avoid reallocating them for each sector).
+	vector<unsigned int> trkFirstStub_; // Index of first stub of each track (plus one past the last track).
+	vector<const Stub*>  bStub_;
+	vector<unsigned int> bTrk_;         // Index of the track the stub is on.
+	vector<float>        bR_;           // rT if digitized, r otherwise.
+	vector<float>        bPhi_;         // phiS if digitized, phi otherwise (continuous across phi = pi in sector 0).
+	vector<float>        bZ_;
+	vector<float>        bStubPhi_;     // Stub phi (used by residuals if not digitized).
+	vector<int>          bIPhiS_;       // Digitized phiS & rT (used by residuals if digitized).
+	vector<int>          bIRt_;
+	vector<char>         bPS_;
+	vector<char>         bBarrel_;
+	vector<float>        bRPhi_;        // Products of stub coordinates needed by the regression sums.
+	vector<float>        bR2_;
+	vector<float>        bRZ_;
+	vector<double>       bRes_;         // Stub residual w.r.t. first helix params.
+	vector<char>         bKeep_;        // Stub kept by outlier rejection.
+
+	// First helix parameters of each track being fitted.
+	vector<double>       trkQoverPt_;
+	vector<double>       trkPhiT_;
+	vector<double>       trkPhi0_;
 };
 
 }
@@ -35,6 +35,9 @@ class TrackerTopology;
 namespace TMTT {
 
 class TP;
+class TPtranslator;
+class ModuleInfo;
+class ModuleInfoCache;
 
 // typedef edm::Ref< edm::DetSetVector< Phase2TrackerDigi >, Phase2TrackerDigi > Ref_Phase2TrackerDigi_;
 typedef edmNew::DetSetVector< TTStub<Ref_Phase2TrackerDigi_> > DetSetVec;
@@ -54,19 +57,23 @@ public:
   Stub(double phi, double r, double z, double bend, int layerid, bool psModule, bool barrel, unsigned int iphi, double alpha, const Settings* settings, const TrackerTopology* trackerTopology, unsigned int ID);
 
   // Store useful info about stub (for use with TMTT code).
-  Stub(const TTStubRef& ttStubRef, unsigned int index_in_vStubs, const Settings* settings, const TrackerGeometry*  trackerGeometry, const TrackerTopology*  trackerTopology);
+  // The info about the module is taken from moduleInfoCache if given, and otherwise from the tracker geometry.
+  Stub(const TTStubRef& ttStubRef, unsigned int index_in_vStubs, const Settings* settings, const TrackerGeometry*  trackerGeometry, const TrackerTopology*  trackerTopology, const ModuleInfoCache* moduleInfoCache = nullptr);
 
   ~Stub(){}
 
   bool operator==(const Stub& stubOther) {return (this->index() == stubOther.index());}
 
   // Fill truth info with association from stub to tracking particles.
-  // The 1st argument is a map relating TrackingParticles to TP.
-  void fillTruth(const map<edm::Ptr< TrackingParticle >, const TP* >& translateTP, const edm::Handle<TTStubAssMap>& mcTruthTTStubHandle, const edm::Handle<TTClusterAssMap>& mcTruthTTClusterHandle);
+  // The 1st argument relates TrackingParticles to TP.
+  void fillTruth(const TPtranslator& translateTP, const edm::Handle<TTStubAssMap>& mcTruthTTStubHandle, const edm::Handle<TTClusterAssMap>& mcTruthTTClusterHandle);
 
   // Calculate bin range along q/Pt axis of r-phi Hough transform array consistent with bend of this stub.
   void calcQoverPtrange();
 
+  // N.B. The digitize functions below change the stub coordinates. TMTrackProducer therefore only calls them for
+  // copies of the stubs made for each sector, leaving the stubs in InputData undigitized.
+
   // Digitize stub for input to Geographic Processor, with digitized phi coord. measured relative to closest phi sector.
   // (This approximation is valid if their are an integer number of digitisation bins inside each phi octant).
   // However, you should also call digitizeForHTinput() before accessing digitized stub data, even if you only care about that going into GP! Otherwise, you will not identify stubs assigned to more than one octant.
@@ -256,7 +263,7 @@ private:
   void setFrontend(bool rejectStub);          
 
   // Set info about the module that this stub is in.
-  void setModuleInfo(const TrackerGeometry* trackerGeometry, const TrackerTopology* trackerTopology, const DetId& detId);
+  void setModuleInfo(const ModuleInfo& moduleInfo);
 
   // Determine tracker geometry version by counting modules.
   void setTrackerGeometryVersion(const TrackerGeometry* trackerGeometry, const TrackerTopology* trackerTopology);
@@ -0,0 +1,78 @@
+#ifndef __STUBSECTORASSIGNER_H__
+#define __STUBSECTORASSIGNER_H__
+
+#include "boost/numeric/ublas/matrix.hpp"
+#include <vector>
+#include <utility>
+
+using namespace std;
+using boost::numeric::ublas::matrix;
+
+//==================================================================================================
+/**
+* Finds for each stub the few (eta,phi) sectors that it can be inside, so that each sector only
+* needs to test those stubs with Sector::inside(), instead of testing all stubs in the event.
+*
+* The candidate phi sectors are found from the stub phi (or the track phi estimated from the stub
+* bend) and the phi tolerance used by Sector::insidePhi(). The candidate eta regions are found
+* by comparing the range in z at r = ChosenRofZ of tracks from the beam-spot compatible with the
+* stub to the precomputed eta region boundaries, as in Sector::insideEta(). Both are widened by a
+* safety margin, since the stub coordinates used by Sector::inside() are digitized per phi sector.
+* The candidates are thus a superset of the sectors that the stub is inside.
+*/
+//==================================================================================================
+
+namespace TMTT {
+
+class Settings;
+class Stub;
+
+class StubSectorAssigner {
+
+public:
+
+  // Initialize constants from configuration parameters.
+  StubSectorAssigner(const Settings* settings);
+
+  ~StubSectorAssigner() {}
+
+  // Find the candidate sectors of all the stubs.
+  void assign(const vector<const Stub*>& vStubs);
+
+  // Candidate stubs of given sector, in the same order as in the input stub collection.
+  const vector<const Stub*>& candidateStubs(unsigned int iPhiSec, unsigned int iEtaReg) const {return candidates_(iPhiSec, iEtaReg);}
+
+  // Range of candidate phi sectors of a stub (first sector & number of sectors, to be taken modulo the number of phi sectors).
+  pair<int, unsigned int> phiSecRange(const Stub* stub) const;
+
+  // Range of candidate eta regions of a stub (first region & number of regions).
+  pair<unsigned int, unsigned int> etaRegRange(const Stub* stub) const;
+
+private:
+
+  unsigned int numPhiSectors_;
+  unsigned int numEtaRegions_;
+
+  // Phi sector definition.
+  float sectorHalfWidth_;
+  float chosenRofPhi_;
+  float minPt_;
+  bool  useStubPhi_;
+  bool  useStubPhiTrk_;
+  float assumedPhiTrkRes_;
+  bool  handleStripsPhiSec_;
+
+  // Eta region definition.
+  float chosenRofZ_;
+  float beamWindowZ_;
+  bool  handleStripsEtaSec_;
+  vector<float> zOuterMin_; // Range in z at r = ChosenRofZ of each eta region.
+  vector<float> zOuterMax_;
+
+  // Candidate stubs of each (phi,eta) sector.
+  matrix< vector<const Stub*> > candidates_;
+};
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __SYMMATRIX_H__
+#define __SYMMATRIX_H__
+
+#include <array>
+#include <cmath>
+
+//=== Symmetric NxN matrix of fixed (compile-time) size, with a Cholesky solver.
+//=== Used for the normal equations of the linearised chi-squared track fits, where N
+//=== is the number of helix parameters, so is stored on the stack & fully unrollable.
+
+namespace TMTT {
+
+template <unsigned int N> class SymMatrix {
+
+public:
+
+  typedef std::array<double, N> Vector;
+
+  SymMatrix() {this->reset();}
+
+  void reset() {m_.fill(0.);}
+
+  // Access element (i,j). Only the lower triangle (i >= j) is stored.
+  double& operator()(unsigned int i, unsigned int j)       {return (i >= j) ? m_[i*N + j] : m_[j*N + i];}
+  double  operator()(unsigned int i, unsigned int j) const {return (i >= j) ? m_[i*N + j] : m_[j*N + i];}
+
+  // Add w*v*v^T to the matrix.
+  void addOuter(const Vector& v, double w = 1.) {
+    for (unsigned int i = 0; i < N; i++) {
+      const double wvi = w*v[i];
+      for (unsigned int j = 0; j <= i; j++) m_[i*N + j] += wvi*v[j];
+    }
+  }
+
+  // Solve A*x = b, where A is this matrix, by Cholesky decomposition A = L*L^T.
+  // Returns false (leaving x unchanged) if the matrix is not positive definite.
+  bool solve(const Vector& b, Vector& x) const {
+    std::array<double, N*N> l;
+    for (unsigned int i = 0; i < N; i++) {
+      for (unsigned int j = 0; j <= i; j++) {
+        double sum = m_[i*N + j];
+        for (unsigned int k = 0; k < j; k++) sum -= l[i*N + k]*l[j*N + k];
+        if (i == j) {
+          if (not (sum > 0.)) return false;
+          l[i*N + i] = std::sqrt(sum);
+        } else {
+          l[i*N + j] = sum/l[j*N + j];
+        }
+      }
+    }
+    // Forward substitution L*y = b, then back substitution L^T*x = y.
+    Vector y;
+    for (unsigned int i = 0; i < N; i++) {
+      double sum = b[i];
+      for (unsigned int k = 0; k < i; k++) sum -= l[i*N + k]*y[k];
+      y[i] = sum/l[i*N + i];
+    }
+    for (unsigned int i = N; i-- > 0;) {
+      double sum = y[i];
+      for (unsigned int k = i + 1; k < N; k++) sum -= l[k*N + i]*x[k];
+      x[i] = sum/l[i*N + i];
+    }
+    return true;
+  }
+
+private:
+
+  std::array<double, N*N> m_;
+};
+
+}
+
+#endif
@@ -30,8 +30,9 @@ public:
 
   bool operator==(const TP& tpOther) {return (this->index() == tpOther.index());}
 
-  // Fill truth info with association from tracking particle to stubs.
-  void fillTruth(const vector<Stub>& vStubs);
+  // Fill truth info with association from tracking particle to stubs,
+  // given the stubs produced by this tracking particle (as found by InputData).
+  void fillTruth(vector<const Stub*> assocStubs);
 
   // == Functions for returning info about tracking particles ===
 
@@ -132,6 +133,33 @@ private:
   float                              nearestJetPt_;
 };
 
+//=== Finds the TP corresponding to an edm::Ptr<TrackingParticle>, using a table indexed by the
+//=== position of the TrackingParticle in its collection, rather than a map lookup per stub & cluster.
+
+class TPtranslator {
+
+public:
+
+  // Size the table for a TrackingParticle collection with the given product ID & size.
+  void init(const edm::ProductID& productID, unsigned int collectionSize) {
+    productID_ = productID;
+    tpOfKey_.assign(collectionSize, nullptr);
+  }
+
+  // Note a TP, which must have been made from the collection given to init().
+  void add(const TP& tp) {tpOfKey_.at(tp.key()) = &tp;}
+
+  // Returns the TP made from the given TrackingParticle, or nullptr if it wasn't stored in InputData::vTPs_.
+  const TP* find(const TrackingParticlePtr& tpPtr) const {
+    return (tpPtr.id() == productID_ && tpPtr.key() < tpOfKey_.size())  ?  tpOfKey_[tpPtr.key()]  :  nullptr;
+  }
+
+private:
+
+  edm::ProductID     productID_;
+  vector<const TP*>  tpOfKey_;
+};
+
 }
 
 #endif
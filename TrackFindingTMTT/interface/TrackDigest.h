@@ -0,0 +1,65 @@
+#ifndef __TRACKDIGEST_H__
+#define __TRACKDIGEST_H__
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+//==================================================================================================
+/**
+* Digest (64 bit FNV-1a hash) of the fitted tracks, used to check that two runs (e.g. before and
+* after an optimization) produce identical tracks, without writing ntuples.
+*
+* A track contributes its (eta,phi) sector, its helix parameters & chi2 (bit exact) and the indices
+* of its stubs, in output order. Event digests can be combined into a run digest by adding them
+* to another TrackDigest.
+*/
+//==================================================================================================
+
+namespace TMTT {
+
+class L1fittedTrack;
+
+class TrackDigest {
+
+public:
+
+  TrackDigest() {this->reset();}
+
+  ~TrackDigest() {}
+
+  void reset() {hash_ = 14695981039346656037ULL; n_ = 0;}
+
+  // Add a fitted track.
+  void add(const L1fittedTrack& fitTrk);
+
+  // Add all fitted tracks of a collection.
+  void add(const vector<L1fittedTrack>& fitTrks);
+
+  // Add the digest of e.g. an event to a run digest.
+  void add(const TrackDigest& digest) {this->addWord(digest.value()); n_++;}
+
+  uint64_t     value() const {return hash_;}
+
+  // Number of tracks (or digests) added.
+  unsigned int n()     const {return n_;}
+
+  // Digest as 16 digit hexadecimal string.
+  string       str()   const;
+
+private:
+
+  void addWord(uint64_t word);
+  void addFloat(float x);
+
+private:
+
+  uint64_t     hash_;
+  unsigned int n_;
+};
+
+}
+
+#endif
@@ -38,6 +38,10 @@ public:
   // Fit a track candidate obtained from the Hough Transform.
   virtual L1fittedTrack fit( const L1track3D& l1track3D );
 
+  // Fit several track candidates (e.g. all those in a sector), returning one fitted track for each.
+  // By default, this calls fit() for each of them, but fitters may provide a faster implementation.
+  virtual vector<L1fittedTrack> fitTracks( const vector<L1track3D>& l1tracks3D );
+
   // Optional debug printout at end of job.
   virtual void endJob() {}
 
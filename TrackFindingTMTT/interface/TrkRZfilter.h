@@ -69,6 +69,9 @@ private:
   // in r-z using tracklet algo.
   vector<const Stub*> seedFilter (const vector<const Stub*>& stubs, float trkQoverPt, bool print );
 
+  // Sort the stubs of a track candidate by layer, and copy their coordinates into the arrays used by the Seed Filter.
+  void fillSeedFilterArrays (const vector<const Stub*>& stubs);
+
   //--- Estimate r-z helix parameters from centre of eta-sector if no better estimate provided by r-z filter.
   void estRZhelix();
 
@@ -105,6 +108,25 @@ private:
   float seedResolution_;
   bool  keepAllSeed_;
 
+  // Layers allowed for the first & second seeding stubs of the Seed Filter (bit i set for layer ID i).
+  unsigned int firstSeedLayerMask_;
+  unsigned int secondSeedLayerMask_;
+
+  // Stubs of the track candidate being filtered by the Seed Filter, sorted by layer, with their coordinates.
+  // (Kept as data members to avoid reallocating them for each track candidate).
+  vector<const Stub*>   sfStubs_;
+  vector<float>         sfR_;
+  vector<float>         sfZ_;
+  vector<float>         sfRErr_;
+  vector<float>         sfZErr_;
+  vector<unsigned int>  sfLayerId_;
+  vector<char>          sfOnSeedLine_;  // Is stub compatible with the seed currently being considered?
+  // Range [first, last) of the stubs in each layer.
+  vector< pair<unsigned int, unsigned int> > sfLayerRange_;
+  // Stubs that can be used as the first or second seeding stub.
+  vector<unsigned int>  sfFirstSeeds_;
+  vector<unsigned int>  sfSecondSeeds_;
+
   // Number of seed combinations considered by the Seed Filter, for each input track.
   vector<unsigned int>  numSeedCombsPerTrk_;
   vector<unsigned int>  numGoodSeedCombsPerTrk_;
@@ -14,6 +14,7 @@
 #include "L1Trigger/TrackFindingTMTT/interface/MuxHToutputs.h"
 #include "L1Trigger/TrackFindingTMTT/interface/MiniHTstage.h"
 #include "L1Trigger/TrackFindingTMTT/interface/StubWindowSuggest.h"
+#include "L1Trigger/TrackFindingTMTT/interface/StubSectorAssigner.h"
 
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/Event.h"
@@ -36,7 +37,9 @@ namespace TMTT {
 
 TMTrackProducer::TMTrackProducer(const edm::ParameterSet& iConfig):
   stubInputTag( consumes<DetSetVec>( iConfig.getParameter<edm::InputTag>("stubInputTag") ) ),
-  trackerGeometryInfo_()
+  trackerGeometryInfo_(),
+  stageTime_(kNumStages, 0.),
+  nEventsTimed_(0)
 {
   // Get configuration parameters
   settings_ = new Settings(iConfig);
@@ -80,6 +83,9 @@ TMTrackProducer::TMTrackProducer(const edm::ParameterSet& iConfig):
     string edmName = string("TML1Tracks") + fitterName;
     produces< TTTrackCollection >(edmName).setBranchAlias(edmName);
   }
+
+  // Optionally write digests of the fitted tracks of each event.
+  if (settings_->digestFileName() != "") digestOut_.open(settings_->digestFileName().c_str());
 }
 
 
@@ -110,10 +116,42 @@ void TMTrackProducer::beginRun(const edm::Run& iRun, const edm::EventSetup& iSet
   const TrackerTopology*  trackerTopology = trackerTopologyHandle.product();
 
   trackerGeometryInfo_.getTiltedModuleInfo( settings_, trackerTopology, trackerGeometry );
+
+  // Cache the info about each module needed to create the stubs.
+  moduleInfoCache_.init( trackerGeometry, trackerTopology );
+
+  // Create matrix of Sector objects, which decide which stubs are in which (eta,phi) sector,
+  // and matrix of r-phi Hough-Transform arrays, with one-to-one correspondence to sectors.
+  // These only depend on the configuration & B-field, so are reused by every event in the run.
+  mSectors_.resize(settings_->numPhiSectors(), settings_->numEtaRegions(), false);
+  mHtRphis_.resize(settings_->numPhiSectors(), settings_->numEtaRegions(), false);
+  mDigiStubs_.resize(settings_->numPhiSectors(), settings_->numEtaRegions(), false);
+
+  for (unsigned int iPhiSec = 0; iPhiSec < settings_->numPhiSectors(); iPhiSec++) {
+    for (unsigned int iEtaReg = 0; iEtaReg < settings_->numEtaRegions(); iEtaReg++) {
+      Sector& sector = mSectors_(iPhiSec, iEtaReg);
+      sector.init(settings_, iPhiSec, iEtaReg); 
+      mHtRphis_(iPhiSec, iEtaReg).init(settings_, iPhiSec, iEtaReg, sector.etaMin(), sector.etaMax(), sector.phiCentre());
+    }
+  }
+}
+
+void TMTrackProducer::endStage(unsigned int iStage)
+{
+  if (settings_->printStageTiming()) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> dt = now - stageStart_;
+    stageTime_[iStage] += dt.count();
+    stageStart_ = now;
+  }
 }
 
 void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
+  if (settings_->printStageTiming()) {
+    stageStart_ = std::chrono::steady_clock::now();
+    nEventsTimed_++;
+  }
 
   // edm::Handle<TrackingParticleCollection> tpHandle;
   // edm::EDGetToken token( consumes<edm::View<TrackingParticleCollection>>( edm::InputTag( "mix", "MergedTrackTruth" ) ) );
@@ -121,15 +159,16 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 
 
   // Note useful info about MC truth particles and about reconstructed stubs .
-  InputData inputData(iEvent, iSetup, settings_, tpInputTag, stubInputTag, stubTruthInputTag, clusterTruthInputTag, genJetInputTag_);
+  InputData inputData(iEvent, iSetup, settings_, tpInputTag, stubInputTag, stubTruthInputTag, clusterTruthInputTag, genJetInputTag_, &moduleInfoCache_);
 
   const vector<TP>&          vTPs   = inputData.getTPs();
   const vector<const Stub*>& vStubs = inputData.getStubs(); 
 
-  // Creates matrix of Sector objects, which decide which stubs are in which (eta,phi) sector
-  matrix<Sector>  mSectors(settings_->numPhiSectors(), settings_->numEtaRegions());
-  // Create matrix of r-phi Hough-Transform arrays, with one-to-one correspondence to sectors.
-  matrix<HTrphi>  mHtRphis(settings_->numPhiSectors(), settings_->numEtaRegions());
+  endStage(kInputData);
+
+  // Sectors & r-phi Hough-Transform arrays, which were configured at the start of the run.
+  const matrix<Sector>& mSectors = mSectors_;
+  matrix<HTrphi>&       mHtRphis = mHtRphis_;
   // Create matrix of Get3Dtracks objects, to run optional r-z track filter, with one-to-one correspondence to sectors.
   matrix<Get3Dtracks>  mGet3Dtrks(settings_->numPhiSectors(), settings_->numEtaRegions());
 
@@ -156,25 +195,41 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 
   //=== Do tracking in the r-phi Hough transform within each sector.
 
+  // Find the few (eta,phi) sectors each stub can be inside, so each sector only need check those stubs.
+  StubSectorAssigner sectorAssigner(settings_);
+  sectorAssigner.assign(vStubs);
+
   // Fill Hough-Transform arrays with stubs.
   for (unsigned int iPhiSec = 0; iPhiSec < settings_->numPhiSectors(); iPhiSec++) {
     for (unsigned int iEtaReg = 0; iEtaReg < settings_->numEtaRegions(); iEtaReg++) {
 
-      Sector& sector = mSectors(iPhiSec, iEtaReg);
+      const Sector& sector = mSectors(iPhiSec, iEtaReg);
       HTrphi& htRphi = mHtRphis(iPhiSec, iEtaReg);
 
-      // Initialize constants for this sector.
-      sector.init(settings_, iPhiSec, iEtaReg); 
-      htRphi.init(settings_, iPhiSec, iEtaReg, sector.etaMin(), sector.etaMax(), sector.phiCentre());
+      // Remove stubs & tracks of the previous event from the HT array.
+      htRphi.reset();
+
+      // Remove digitized stubs of the previous event from this sector.
+      vector<Stub>& digiStubs = mDigiStubs_(iPhiSec, iEtaReg);
+      digiStubs.clear();
 
       // Check sector is enabled (always true, except if user disabled some for special studies).
       if (settings_->isHTRPhiEtaRegWhitelisted(iEtaReg)) {
 
-	for (const Stub* stub: vStubs) {
-	  // Digitize stub as would be at input to GP. This doesn't need the octant number, since we assumed an integer number of
-	  // phi digitisation  bins inside an octant. N.B. This changes the coordinates & bend stored in the stub.
-	  // The cast allows us to ignore the "const".
-	  if (settings_->enableDigitize()) (const_cast<Stub*>(stub))->digitizeForGPinput(iPhiSec);
+	const vector<const Stub*>& candStubs = sectorAssigner.candidateStubs(iPhiSec, iEtaReg);
+	// Reserve space for all candidate stubs, so the pointers to the digitized copies stored in the HT stay valid.
+	if (settings_->enableDigitize()) digiStubs.reserve(candStubs.size());
+
+	for (const Stub* candStub: candStubs) {
+	  const Stub* stub = candStub;
+
+	  if (settings_->enableDigitize()) {
+	    // Digitize copy of stub as would be at input to GP. This doesn't need the octant number, since we assumed an integer number of
+	    // phi digitisation  bins inside an octant. N.B. This changes the coordinates & bend stored in the copy.
+	    digiStubs.push_back(*candStub);
+	    digiStubs.back().digitizeForGPinput(iPhiSec);
+	    stub = &digiStubs.back();
+	  }
 
 	  // Check if stub is inside this sector
 	  bool inside = sector.inside( stub );
@@ -184,10 +239,14 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 	    const vector<bool> inEtaSubSecs =  sector.insideEtaSubSecs( stub );
 
 	    // Digitize stub if as would be at input to HT, which slightly degrades its coord. & bend resolution, affecting the HT performance.
-	    if (settings_->enableDigitize()) (const_cast<Stub*>(stub))->digitizeForHTinput(iPhiSec);
+	    if (settings_->enableDigitize()) digiStubs.back().digitizeForHTinput(iPhiSec);
 
 	    // Store stub in Hough transform array for this sector, indicating its compatibility with eta subsectors with sector.
 	    htRphi.store( stub, inEtaSubSecs );
+
+	  } else if (settings_->enableDigitize()) {
+	    // Stub not needed by this sector.
+	    digiStubs.pop_back();
 	  }
 	}
       }
@@ -211,6 +270,8 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
     miniHTstage.exec( mHtRphis );
   }
 
+  endStage(kHT);
+
   //=== Make 3D tracks, optionally running r-z track filters (such as Seed Filter) & duplicate track removal. 
 
   for (unsigned int iPhiSec = 0; iPhiSec < settings_->numPhiSectors(); iPhiSec++) {
@@ -249,6 +310,8 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
     }
   }
 
+  endStage(kTracks3D);
+
   // Initialize the duplicate track removal algorithm that can optionally be run after the track fit.
   KillDupFitTrks killDupFitTrks;
   killDupFitTrks.init(settings_, settings_->dupTrkAlgFit());
@@ -275,27 +338,22 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
         // Get 3D track candidates found by Hough transform (plus optional r-z filters/duplicate removal) in this sector.
 	const vector<L1track3D>& vecTrk3D = get3Dtrk.trackCands3D(useRZfilt);
 
-        // Fit all tracks in this sector
-	vector<L1fittedTrack> fittedTracksInSec;
-        for (const L1track3D& trk : vecTrk3D) {
-
-	  // IRT
-	  //bool OK = (trk.getMatchedTP() != nullptr && trk.getMatchedTP()->pt() > 50 && fabs(trk.getMatchedTP()->eta()) > 1.4 && fabs(trk.getMatchedTP()->eta()) < 1.8);
-          //if (trk.getNumStubs() != trk.getNumLayers()) OK = false;
-          //if (not OK) continue;
-
-          // Ensure stubs assigned to this track is digitized with respect to the phi sector the track is in.
-	  if (settings_->enableDigitize()) {
+        // Digitize stubs assigned to the tracks in way this specific track fitter uses them.
+	// (They are this sector's copies of the stubs, so are already digitized with respect to its phi sector).
+	if (settings_->enableDigitize()) {
+          for (const L1track3D& trk : vecTrk3D) {
   	    const vector<const Stub*>& stubsOnTrk = trk.getStubs();
             for (const Stub* s : stubsOnTrk) {
-             (const_cast<Stub*>(s))->digitizeForHTinput(iPhiSec);
-	     // Also digitize stub in way this specific track fitter uses it.
              (const_cast<Stub*>(s))->digitizeForSForTFinput(fitterName);          
 	    }
 	  }
+	}
 
-	  L1fittedTrack fitTrack = fitterWorkerMap_[fitterName]->fit(trk);
+        // Fit all tracks in this sector
+	vector<L1fittedTrack> fitTracksInSec = fitterWorkerMap_[fitterName]->fitTracks(vecTrk3D);
 
+	vector<L1fittedTrack> fittedTracksInSec;
+        for (L1fittedTrack& fitTrack : fitTracksInSec) {
 	  if (fitTrack.accepted()) { // If fitter accepted track, then store it.
   	    // Optionally digitize fitted track, degrading slightly resolution.
  	     if (settings_->enableDigitize()) fitTrack.digitizeTrack(fitterName);
@@ -319,6 +377,16 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
     }
   }
 
+  endStage(kFit);
+
+  // Digests of the fitted tracks, to allow quick comparison of the output of different builds.
+  for (const string& fitterName : trackFitters_) {
+    TrackDigest eventDigest;
+    eventDigest.add(fittedTracks[fitterName]);
+    runDigests_[fitterName].add(eventDigest);
+    if (digestOut_.is_open()) digestOut_<<"event "<<fitterName<<" "<<eventDigest.n()<<" "<<eventDigest.str()<<endl;
+  }
+
   // Debug printout
   unsigned int static nEvents = 0;
   nEvents++;
@@ -341,13 +409,19 @@ void TMTrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 
 
   // Allow histogramming to plot undigitized variables.
-  for (const Stub* stub: vStubs) {
-    if (settings_->enableDigitize()) (const_cast<Stub*>(stub))->setDigitizeWarningsOn(false);
+  if (settings_->enableDigitize()) {
+    for (unsigned int iPhiSec = 0; iPhiSec < settings_->numPhiSectors(); iPhiSec++) {
+      for (unsigned int iEtaReg = 0; iEtaReg < settings_->numEtaRegions(); iEtaReg++) {
+	for (Stub& digiStub : mDigiStubs_(iPhiSec, iEtaReg)) digiStub.setDigitizeWarningsOn(false);
+      }
+    }
   }
 
   // Fill histograms to monitor input data & tracking performance.
   hists_->fill(inputData, mSectors, mHtRphis, mGet3Dtrks, fittedTracks);
 
+  endStage(kHistos);
+
   //=== Store output EDM track and hardware stub collections.
 #ifdef OutputHT_TTracks
   iEvent.put( std::move( htTTTracksForOutput ),  "TML1TracksHT");
@@ -381,6 +455,27 @@ void TMTrackProducer::endJob()
 
   cout<<endl<<"Number of (eta,phi) sectors used = (" << settings_->numEtaRegions() << "," << settings_->numPhiSectors()<<")"<<endl; 
 
+  // Print digests of the fitted tracks of the job.
+  cout<<endl;
+  for (const string& fitterName : trackFitters_) {
+    const TrackDigest& runDigest = runDigests_[fitterName];
+    cout<<"Track digest "<<fitterName<<" : "<<runDigest.str()<<" ("<<runDigest.n()<<" events)"<<endl;
+    if (digestOut_.is_open()) digestOut_<<"run "<<fitterName<<" "<<runDigest.n()<<" "<<runDigest.str()<<endl;
+  }
+  if (digestOut_.is_open()) digestOut_.close();
+
+  // Print time spent in each processing stage.
+  if (settings_->printStageTiming() && nEventsTimed_ > 0) {
+    const string stageNames[kNumStages] = {"InputData", "HT", "Tracks3D", "Fit", "Histos"};
+    double totTime = 0.;
+    for (unsigned int i = 0; i < kNumStages; i++) totTime += stageTime_[i];
+    cout<<endl<<"=== TMTT stage timing for "<<nEventsTimed_<<" events ==="<<endl;
+    for (unsigned int i = 0; i < kNumStages; i++) {
+      cout<<"Stage "<<stageNames[i]<<" : total = "<<stageTime_[i]<<" s, per event = "<<1000.*stageTime_[i]/nEventsTimed_<<" ms"<<endl;
+    }
+    cout<<"Events/s : "<<(totTime > 0. ? nEventsTimed_/totTime : 0.)<<endl;
+  }
+
 }
 
 DEFINE_FWK_MODULE(TMTrackProducer);
@@ -12,12 +12,21 @@
 #include "L1Trigger/TrackFindingTMTT/interface/Stub.h"
 #include "L1Trigger/TrackFindingTMTT/interface/L1track3D.h"
 #include "L1Trigger/TrackFindingTMTT/interface/TrackerGeometryInfo.h"
+#include "L1Trigger/TrackFindingTMTT/interface/ModuleInfo.h"
+#include "L1Trigger/TrackFindingTMTT/interface/Sector.h"
+#include "L1Trigger/TrackFindingTMTT/interface/HTrphi.h"
+#include "L1Trigger/TrackFindingTMTT/interface/TrackDigest.h"
+
+#include "boost/numeric/ublas/matrix.hpp"
 
 #include <vector>
 #include <map>
 #include <string>
+#include <chrono>
+#include <fstream>
 
 using namespace std;
+using  boost::numeric::ublas::matrix;
 
 namespace TMTT {
 
@@ -39,6 +48,9 @@ private:
   virtual void produce(edm::Event&, const edm::EventSetup&);
   virtual void endJob() ;
 
+  // Adds time since last call to the given processing stage (if stage timing enabled).
+  void endStage(unsigned int iStage);
+
 private:
   edm::EDGetTokenT<DetSetVec> stubInputTag;
   edm::EDGetTokenT<TrackingParticleCollection> tpInputTag;
@@ -56,6 +68,28 @@ private:
   map<string, TrackFitGeneric*> fitterWorkerMap_;
 
   TrackerGeometryInfo              trackerGeometryInfo_;
+
+  // Info about each tracker module, filled at the start of each run and used to create the stubs.
+  ModuleInfoCache                  moduleInfoCache_;
+
+  // Sectors & their r-phi Hough-Transform arrays, configured at the start of each run and 
+  // emptied at the start of each event, so the HT arrays need not be reallocated for each event.
+  matrix<Sector>                   mSectors_;
+  matrix<HTrphi>                   mHtRphis_;
+  // Copies of the stubs inside each sector, digitized with respect to it. These are used by the HT and all later
+  // stages, so the stubs in InputData are never digitized and each sector can be processed independently of the others.
+  matrix< vector<Stub> >           mDigiStubs_;
+
+  // Time spent in each processing stage, printed at end of job if Settings::printStageTiming().
+  enum {kInputData, kHT, kTracks3D, kFit, kHistos, kNumStages};
+  vector<double>                   stageTime_;
+  unsigned int                     nEventsTimed_;
+  std::chrono::steady_clock::time_point stageStart_;
+
+  // Digest of the fitted tracks of the job for each fitter, printed at end of job.
+  map<string, TrackDigest>         runDigests_;
+  // Optional file with the digests of each event.
+  std::ofstream                    digestOut_;
 };
 
 }
@@ -19,6 +19,9 @@ TMTrackProducer_params = cms.PSet(
   EnableMCtruth = cms.bool(True),
   # Enable output histograms & job tracking performance summary (disable to save CPU)
   EnableHistos = cms.bool(True),
+  # Groups of histograms not to book or fill, to save CPU if EnableHistos = True. Allowed groups are
+  # "InputData", "EtaPhiSectors", "RphiHT", "RZfilters", "StudyBusyEvents", "TrackCands" & "TrackFitting".
+  DisabledHistosGroups = cms.vstring(),
 
   #=== Cuts on MC truth particles (i.e., tracking particles) used for tracking efficiency measurements.
 
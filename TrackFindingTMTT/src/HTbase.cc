@@ -16,10 +16,9 @@ namespace TMTT {
 void HTbase::end() {
 
   // Calculate useful info about each cell in array.
-  for (unsigned int i = 0; i < htArray_.size1(); i++) {
-    for (unsigned int j = 0; j < htArray_.size2(); j++) {
-      htArray_(i,j).end(); // Calls HTcell::end()
-    }
+  // (Only needed for cells with stubs, as the empty ones are already in the state end() would leave them in).
+  for (const pair<unsigned int, unsigned int>& cell : touchedCells_) {
+    htArray_(cell.first, cell.second).end(); // Calls HTcell::end()
   }
 
   // Produce a list of all track candidates found in this array, each containing all the stubs on each one
@@ -36,6 +35,16 @@ void HTbase::end() {
   }
 }
 
+//=== Remove all stubs & tracks from the HT array, ready for the next event.
+
+void HTbase::reset() {
+  for (const pair<unsigned int, unsigned int>& cell : touchedCells_) {
+    htArray_(cell.first, cell.second).reset(); // Calls HTcell::reset()
+  }
+  touchedCells_.clear();
+  trackCands2D_.clear();
+}
+
 //=== Number of filtered stubs in each cell summed over all cells in HT array.
 //=== If a stub appears in multiple cells, it will be counted multiple times.
 unsigned int HTbase::numStubsInc() const {
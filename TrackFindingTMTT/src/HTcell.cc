@@ -41,6 +41,19 @@ void HTcell::init(const Settings* settings, unsigned int iPhiSec, unsigned int i
 
   // Check if subsectors are being used within each sector. These are only ever used for r-phi HT.
   numSubSecs_ = settings->numSubSecsEta();
+
+  this->reset();
+}
+
+//=== Remove all stubs from this cell, ready for the next event.
+//=== (Leaves the cell in the same state as calling end() on an empty cell would).
+
+void HTcell::reset() {
+  vStubs_.clear();
+  vFilteredStubs_.clear();
+  subSectors_.clear();
+  numFilteredLayersInCell_ = 0;
+  numFilteredLayersInCellBestSubSec_ = 0;
 }
 
 //=== Termination. Search for track in this HT cell etc.
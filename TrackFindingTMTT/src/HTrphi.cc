@@ -232,7 +232,7 @@ void HTrphi::store(const Stub* stub, const vector<bool>& inEtaSubSecs) {
             }
           }
 
-          if (canStoreStub) HTbase::htArray_(iStore, jStore).store( stub, inEtaSubSecs ); // Calls HTcell::store()
+          if (canStoreStub) this->storeInCell(iStore, jStore, stub, inEtaSubSecs);
         }
 
         // Check that limitations of firmware would not prevent stub being stored correctly in this HT column.
@@ -252,7 +252,7 @@ void HTrphi::store(const Stub* stub, const vector<bool>& inEtaSubSecs) {
       phiTrk += binSizePhiTrkAxis_ / 2.;
     unsigned int binCenter = std::floor( phiTrk / binSizePhiTrkAxis_ );
     if ( binCenter < nBinsPhiTrkAxis_ )
-      HTbase::htArray_(i, binCenter).store( stub, inEtaSubSecs );
+      this->storeInCell(i, binCenter, stub, inEtaSubSecs);
 
   } else if ( shape_ == 2 ) {
 
@@ -284,11 +284,11 @@ void HTrphi::store(const Stub* stub, const vector<bool>& inEtaSubSecs) {
     binMin.first = ( iMin % 3 == 0 );
     binMax.first = ( iMax % 3 == 0 );
     if ( binCenter.first && binCenter.second < nBinsPhiTrkAxis_ )
-      HTbase::htArray_(i, binCenter.second).store( stub, inEtaSubSecs );
+      this->storeInCell(i, binCenter.second, stub, inEtaSubSecs);
     else if ( binMin.first && binMin.second < nBinsPhiTrkAxis_ )
-      HTbase::htArray_(i, binMin.second).store( stub, inEtaSubSecs );
+      this->storeInCell(i, binMin.second, stub, inEtaSubSecs);
     else if ( binMax.first && binMax.second < nBinsPhiTrkAxis_ )
-      HTbase::htArray_(i, binMax.second).store( stub, inEtaSubSecs );
+      this->storeInCell(i, binMax.second, stub, inEtaSubSecs);
 
   } else if ( shape_ == 3 ) {
 
@@ -309,9 +309,9 @@ void HTrphi::store(const Stub* stub, const vector<bool>& inEtaSubSecs) {
     binMin.first = ( iMin % 2 == i % 2 );
     binMax.first = ( iMax % 2 == i % 2 );
     if ( binMin.first && binMin.second < nBinsPhiTrkAxis_ )
-      HTbase::htArray_(i, binMin.second).store( stub, inEtaSubSecs );
+      this->storeInCell(i, binMin.second, stub, inEtaSubSecs);
     else if ( binMax.first && binMax.second < nBinsPhiTrkAxis_ )
-      HTbase::htArray_(i, binMax.second).store( stub, inEtaSubSecs );
+      this->storeInCell(i, binMax.second, stub, inEtaSubSecs);
   }
       }
     }
@@ -44,6 +44,13 @@ Histos::Histos(const Settings* settings) : settings_(settings), plotFirst_(true)
   useRZfilter_      = settings->useRZfilter();
   ranRZfilter_      = (useRZfilter_.size() > 0); // Was any r-z track filter run?
   resPlotOpt_       = settings->resPlotOpt(); // Only use signal events for helix resolution plots?
+
+  // Groups of histograms the user doesn't want (to save CPU).
+  const vector<string> groups = {"InputData", "EtaPhiSectors", "RphiHT", "RZfilters", "StudyBusyEvents", "TrackCands", "TrackFitting"};
+  for (const string& group : settings->disabledHistosGroups()) {
+    if (std::count(groups.begin(), groups.end(), group) == 0) throw cms::Exception("Histos ERROR: Unknown histogram group in cfg param DisabledHistosGroups: ")<<group<<endl;
+    disabledGroups_.insert(group);
+  }
 }
 
 //=== Book all histograms
@@ -55,47 +62,51 @@ void Histos::book() {
   TH1::SetDefaultSumw2(true);
 
   // Book histograms about input data.
-  this->bookInputData();
+  if (this->enabled("InputData")) this->bookInputData();
   // Book histograms checking if (eta,phi) sector definition choices are good.
-  this->bookEtaPhiSectors();
+  if (this->enabled("EtaPhiSectors")) this->bookEtaPhiSectors();
   // Book histograms checking filling of r-phi HT array.
-  this->bookRphiHT();
+  if (this->enabled("RphiHT")) this->bookRphiHT();
   // Book histograms about r-z track filters.
-  this->bookRZfilters();
+  if (this->enabled("RZfilters")) this->bookRZfilters();
   // Book histograms for studying freak, extra large events at HT.
-  this->bookStudyBusyEvents();
-  // Book histograms studying 3D track candidates found after HT.
-  this->bookTrackCands(false);
-  // Book histograms studying 3D track candidates found after r-z track filter.
-  if (ranRZfilter_) this->bookTrackCands(true);
+  if (this->enabled("StudyBusyEvents")) this->bookStudyBusyEvents();
+  if (this->enabled("TrackCands")) {
+    // Book histograms studying 3D track candidates found after HT.
+    this->bookTrackCands(false);
+    // Book histograms studying 3D track candidates found after r-z track filter.
+    if (ranRZfilter_) this->bookTrackCands(true);
+  }
   // Book histograms studying track fitting performance
-  this->bookTrackFitting();
+  if (this->enabled("TrackFitting")) this->bookTrackFitting();
 }
 
 //=== Fill all histograms
 
 void Histos::fill(const InputData& inputData, const matrix<Sector>& mSectors, const matrix<HTrphi>& mHtRphis, 
-    	          const matrix<Get3Dtracks> mGet3Dtrks, const std::map<std::string,std::vector<L1fittedTrack>>& fittedTracks) 
+    	          const matrix<Get3Dtracks>& mGet3Dtrks, const std::map<std::string,std::vector<L1fittedTrack>>& fittedTracks) 
 {
   // Don't bother filling histograms if user didn't request them via TFileService in their cfg.
   if ( ! this->enabled() ) return;
 
   // Fill histograms about input data.
-  this->fillInputData(inputData);
+  if (this->enabled("InputData")) this->fillInputData(inputData);
   // Fill histograms checking if (eta,phi) sector definition choices are good.
-  this->fillEtaPhiSectors(inputData, mSectors);
+  if (this->enabled("EtaPhiSectors")) this->fillEtaPhiSectors(inputData, mSectors);
   // Fill histograms checking filling of r-phi HT array.
-  this->fillRphiHT(mHtRphis);
+  if (this->enabled("RphiHT")) this->fillRphiHT(mHtRphis);
   // Fill histograms about r-z track filters.
-  this->fillRZfilters(mGet3Dtrks);
+  if (this->enabled("RZfilters")) this->fillRZfilters(mGet3Dtrks);
   // Fill histograms for studying freak, extra large events at HT.
-  this->fillStudyBusyEvents(inputData, mSectors, mHtRphis, mGet3Dtrks);
-  // Fill histograms studying 3D track candidates found after HT.
-  this->fillTrackCands(inputData, mGet3Dtrks, false);
-  // Fill histograms studying 3D track candidates found after r-z track filter.
-  if (ranRZfilter_) this->fillTrackCands(inputData, mGet3Dtrks, true);
+  if (this->enabled("StudyBusyEvents")) this->fillStudyBusyEvents(inputData, mSectors, mHtRphis, mGet3Dtrks);
+  if (this->enabled("TrackCands")) {
+    // Fill histograms studying 3D track candidates found after HT.
+    this->fillTrackCands(inputData, mGet3Dtrks, false);
+    // Fill histograms studying 3D track candidates found after r-z track filter.
+    if (ranRZfilter_) this->fillTrackCands(inputData, mGet3Dtrks, true);
+  }
   // Fill histograms studying track fitting performance
-  this->fillTrackFitting(inputData, fittedTracks);
+  if (this->enabled("TrackFitting")) this->fillTrackFitting(inputData, fittedTracks);
 }
 
 //=== Book histograms using input stubs and tracking particles.
@@ -290,7 +301,7 @@ void Histos::fillInputData(const InputData& inputData) {
   // Study efficiency for good stubs of tightened front end-electronics cuts.
   for (const TP& tp : vTPs) {
     if (tp.useForAlgEff()) {// Only bother for stubs that are on TP that we have a chance of reconstructing.
-      const vector<const Stub*> stubs = tp.assocStubs();
+      const vector<const Stub*>& stubs = tp.assocStubs();
       for (const Stub* s : stubs) {
         hisStubIneffiVsInvPt_->Fill(1./tp.pt()    , (! s->frontendPass()) );
         hisStubIneffiVsEta_->Fill  (fabs(tp.eta()), (! s->frontendPass()) );
@@ -460,9 +471,24 @@ void Histos::fillInputData(const InputData& inputData) {
     }
   }
 
+  // The r & z ranges below are needed by the firmware, so take them from copies of the stubs digitized for GP input,
+  // as the stubs in InputData are never digitized. (The r & z digitization is the same in all phi sectors).
+  vector<Stub> digiStubs;
+  vector<const Stub*> rangeStubs;
+  if (settings_->enableDigitize()) {
+    digiStubs.reserve(vStubs.size());
+    for (const Stub* stub : vStubs) {
+      digiStubs.push_back(*stub);
+      digiStubs.back().digitizeForGPinput(0);
+      rangeStubs.push_back(&digiStubs.back());
+    }
+  } else {
+    rangeStubs = vStubs;
+  }
+
   // Determine r (z) range of each barrel layer (endcap wheel).
 
-  for (const Stub* stub : vStubs) {
+  for (const Stub* stub : rangeStubs) {
     unsigned int layer = stub->layerId();
     if (stub->barrel()) {
       // Get range in r of each barrel layer.
@@ -490,7 +516,7 @@ void Histos::fillInputData(const InputData& inputData) {
 
   // Determine Range in (r,|z|) of each module type.
 
-  for (const Stub* stub : vStubs) {
+  for (const Stub* stub : rangeStubs) {
     float r = stub->r();
     float z = fabs(stub->z());
     unsigned int modType = stub->digitalStub().moduleType();
@@ -1115,7 +1141,7 @@ void Histos::bookTrackCands(bool withRZfilter) {
 
 //=== Fill histograms studying track candidates found before track fit is run.
 
-void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks> mGet3Dtrks, bool withRZfilter) {
+void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks>& mGet3Dtrks, bool withRZfilter) {
 
   string tName = withRZfilter  ?  "RZ"  :  "HT";
 
@@ -1123,12 +1149,15 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
 
   const vector<TP>&  vTPs = inputData.getTPs();
 
+  // Find the track candidates associated to each TP once, instead of rescanning all sectors per TP.
+  const TPtrackMap tpTracks = this->assocTrackCands3D(mGet3Dtrks, withRZfilter);
+
   // Debug histogram for LR track fitter.
   for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
       const Get3Dtracks& get3Dtrk = mGet3Dtrks(iPhiSec, iEtaReg);
       const std::vector< L1track3D >& tracks = get3Dtrk.trackCands3D(withRZfilter);
-      for ( auto t : tracks ) {
-        const std::vector< const Stub* > stubs = t.getStubs();
+      for ( const auto& t : tracks ) {
+        const std::vector< const Stub* >& stubs = t.getStubs();
         std::map< unsigned int, unsigned int > layerMap;
         for ( auto s : stubs )
           layerMap[ s->layerIdReduced() ]++;
@@ -1166,7 +1195,8 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
 
   unsigned int nStubsOnTracks = 0;
   vector<unsigned int> nStubsOnTracksInOctant(numPhiOctants, 0);
-  map< unsigned int, set<const Stub*> > uniqueStubsOnTracksInOctant;
+  // Stubs are identified by their index, as each sector holds its own (digitized) copies of the stubs.
+  map< unsigned int, set<unsigned int> > uniqueStubsOnTracksInOctant;
   for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
     unsigned int nStubsOnTracksInEtaReg = 0;
     for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
@@ -1182,12 +1212,13 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
       hisStubsOnTracksPerSect_[tName]->Fill(nStubsOnTrksInSec); // Number of stubs assigned to tracks in this sector.
       nStubsOnTracksInOctant[iOctant] += nStubsOnTrksInSec; // Number of stubs assigned to tracks in this octant.
       nStubsOnTracksInEtaReg += nStubsOnTrksInSec;
-      set<const Stub*> uniqueStubsOnTracksInSector;
+      set<unsigned int> uniqueStubsOnTracksInSector;
       // Loop over all stubs on all tracks in this sector, and add to std::set(), so each individual stub recorded at most once.
       for (const L1track3D& trk : get3Dtrk.trackCands3D(withRZfilter) ) {
-	const vector<const Stub*>& stubs = trk.getStubs();
-	uniqueStubsOnTracksInSector.insert(stubs.begin(), stubs.end());
-	uniqueStubsOnTracksInOctant[iOctant].insert(stubs.begin(), stubs.end());
+	for (const Stub* stub : trk.getStubs()) {
+	  uniqueStubsOnTracksInSector.insert(stub->index());
+	  uniqueStubsOnTracksInOctant[iOctant].insert(stub->index());
+	}
       }
       // Plot number of stubs assigned to tracks per sector, never counting each individual stub more than once.
       hisUniqueStubsOnTrksPerSect_[tName]->Fill(uniqueStubsOnTracksInSector.size());
@@ -1287,7 +1318,7 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
 	  if (tp->useForAlgEff()) {
             hisFracMatchStubsOnTracks_[tName]->Fill( trk.getPurity() );
 
-            const vector<const Stub*> stubs = trk.getStubs();
+            const vector<const Stub*>& stubs = trk.getStubs();
             for (const Stub* s : stubs) {
 	      // Was this stub produced by correct truth particle?
 	      const set<const TP*> stubTPs = s->assocTPs();
@@ -1339,35 +1370,29 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
   unsigned int nSecsMatchingTPs = 0; // Total no. of eta x phi sectors that all TPs were reconstructed in
   unsigned int nTrksMatchingTPs = 0; // Total no. of tracks that all TPs were reconstructed as
 
-  for (const TP& tp: vTPs) {
+  for (const auto& iter : tpTracks) {
+    const TP& tp = *(iter.first);
 
-    bool tpRecoed = false;
-    for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
-      bool tpRecoedInEtaSec = false;
-      for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
-        const Get3Dtracks& get3Dtrk = mGet3Dtrks(iPhiSec, iEtaReg);
-
-	// Get reconstructed tracks in this sector corresponding to this TP.
-	const vector<const L1track3D*> trks = get3Dtrk.assocTrackCands3D( tp, withRZfilter );
-	// Count them
-	unsigned int nTrk = trks.size(); 
-        if (nTrk > 0) {
-	  tpRecoed = true;            // This TP was reconstructed at least once in tracker.
-	  tpRecoedInEtaSec = true;    // This TP was reconstructed at least once in this eta sector.
-          nSecsMatchingTPs += 1;      // Increment sum by no. of sectors this TP was reconstructed in
-  	  nTrksMatchingTPs += nTrk;   // Increment sum by no. of tracks this TP was reconstructed as
-          profDupTracksVsEta_[tName]->Fill(fabs(tp.eta()), nTrk - 1); // Study duplication of tracks within an individual HT array.
-          profDupTracksVsInvPt_[tName]->Fill(fabs(tp.qOverPt()), nTrk - 1); // Study duplication of tracks within an individual HT array.
-        }
-      }
-      if (tpRecoedInEtaSec) nEtaSecsMatchingTPs++; // Increment each time TP found in an eta sector.
+    // Count the reconstructed tracks corresponding to this TP in each (eta,phi) sector.
+    map<pair<unsigned int, unsigned int>, unsigned int> nTrkInSec;
+    set<unsigned int> etaRegs;
+    for (const L1track3D* trk : iter.second) {
+      nTrkInSec[pair<unsigned int, unsigned int>(trk->iEtaReg(), trk->iPhiSec())]++;
+      etaRegs.insert(trk->iEtaReg());
     }
 
-    if (tpRecoed) {
-      // Increment sum each time a TP is reconstructed at least once inside Tracker
-      if (tp.useForEff()) nRecoedTPsForEff++;
-      nRecoedTPs++; 
+    for (const auto& secIter : nTrkInSec) {
+      unsigned int nTrk = secIter.second; 
+      nSecsMatchingTPs += 1;      // Increment sum by no. of sectors this TP was reconstructed in
+      nTrksMatchingTPs += nTrk;   // Increment sum by no. of tracks this TP was reconstructed as
+      profDupTracksVsEta_[tName]->Fill(fabs(tp.eta()), nTrk - 1); // Study duplication of tracks within an individual HT array.
+      profDupTracksVsInvPt_[tName]->Fill(fabs(tp.qOverPt()), nTrk - 1); // Study duplication of tracks within an individual HT array.
     }
+    nEtaSecsMatchingTPs += etaRegs.size(); // Increment each time TP found in an eta sector.
+
+    // Increment sum each time a TP is reconstructed at least once inside Tracker
+    if (tp.useForEff()) nRecoedTPsForEff++;
+    nRecoedTPs++; 
   }
 
   //--- Plot mean number of tracks/event, counting number due to different kinds of duplicates
@@ -1406,24 +1431,20 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
     if ((resPlotOpt_ && tp.useForAlgEff()) || (not resPlotOpt_)) { // Check TP is good for efficiency measurement (& also comes from signal event if requested)
 
       // For each tracking particle, find the corresponding reconstructed track(s).
-      for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
-	for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
-          const Get3Dtracks& get3Dtrk = mGet3Dtrks(iPhiSec, iEtaReg);
-
-  	  const vector<const L1track3D*> trkVec = get3Dtrk.assocTrackCands3D( tp, withRZfilter );
-	  for (const L1track3D* trk : trkVec) {
-	    hisQoverPtRes_[tName]->Fill(trk->qOverPt() - tp.qOverPt());
-	    hisPhi0Res_[tName]->Fill(reco::deltaPhi(trk->phi0(), tp.phi0()));
-	    hisEtaRes_[tName]->Fill(trk->eta() - tp.eta());
-	    hisZ0Res_[tName]->Fill(trk->z0() - tp.z0());
-
-	    hisRecoVsTrueQinvPt_[tName]->Fill( tp.qOverPt(), trk->qOverPt() );
-	    hisRecoVsTruePhi0_[tName]->Fill( tp.phi0(), trk->phi0( ));
-	    hisRecoVsTrueD0_[tName]->Fill( tp.d0(), trk->d0() );
-	    hisRecoVsTrueZ0_[tName]->Fill( tp.z0(), trk->z0() );
-	    hisRecoVsTrueEta_[tName]->Fill( tp.eta(), trk->eta() );
-          }
-	}
+      const auto iter = tpTracks.find(&tp);
+      if (iter != tpTracks.end()) {
+	for (const L1track3D* trk : iter->second) {
+	  hisQoverPtRes_[tName]->Fill(trk->qOverPt() - tp.qOverPt());
+	  hisPhi0Res_[tName]->Fill(reco::deltaPhi(trk->phi0(), tp.phi0()));
+	  hisEtaRes_[tName]->Fill(trk->eta() - tp.eta());
+	  hisZ0Res_[tName]->Fill(trk->z0() - tp.z0());
+
+	  hisRecoVsTrueQinvPt_[tName]->Fill( tp.qOverPt(), trk->qOverPt() );
+	  hisRecoVsTruePhi0_[tName]->Fill( tp.phi0(), trk->phi0( ));
+	  hisRecoVsTrueD0_[tName]->Fill( tp.d0(), trk->d0() );
+	  hisRecoVsTrueZ0_[tName]->Fill( tp.z0(), trk->z0() );
+	  hisRecoVsTrueEta_[tName]->Fill( tp.eta(), trk->eta() );
+        }
       }
     }
   }
@@ -1483,17 +1504,12 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
       // Check if this TP was reconstructed anywhere in the tracker..
       bool tpRecoed = false;
       bool tpRecoedPerfect = false;
-      for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
-	for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
-          const Get3Dtracks& get3Dtrk = mGet3Dtrks(iPhiSec, iEtaReg);
-  	  const vector<const L1track3D*> assTrkVec = get3Dtrk.assocTrackCands3D( tp, withRZfilter );
-	  if (assTrkVec.size() > 0) {
-	    tpRecoed = true;
-	    // Also note if TP was reconstructed perfectly (no incorrect hits on reco track).
-	    for (const L1track3D* assTrk : assTrkVec) {
-	      if (assTrk->getPurity() == 1.) tpRecoedPerfect = true; 
-	    }
-	  }
+      const auto iter = tpTracks.find(&tp);
+      if (iter != tpTracks.end()) {
+	tpRecoed = true;
+	// Also note if TP was reconstructed perfectly (no incorrect hits on reco track).
+	for (const L1track3D* assTrk : iter->second) {
+	  if (assTrk->getPurity() == 1.) tpRecoedPerfect = true; 
 	}
       }
 
@@ -1549,12 +1565,29 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
   }
 
   // Diagnose reason why not all viable tracking particles were reconstructed.
-  const map<const TP*, string> diagnosis = this->diagnoseTracking(inputData.getTPs(), mGet3Dtrks, withRZfilter);
+  const map<const TP*, string> diagnosis = this->diagnoseTracking(inputData.getTPs(), mGet3Dtrks, tpTracks, withRZfilter);
   for (const auto& iter: diagnosis) {
     hisRecoFailureReason_[tName]->Fill(iter.second.c_str(), 1.); // Stores flag indicating failure reason.
   }
 }
 
+//=== Find the track candidates associated to each tracking particle, in a single pass over all sectors.
+//=== TPs with no associated track candidate are absent from the map.
+
+Histos::TPtrackMap Histos::assocTrackCands3D(const matrix<Get3Dtracks>& mGet3Dtrks, bool withRZfilter) const {
+  TPtrackMap tpTracks;
+  for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
+    for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
+      const Get3Dtracks& get3Dtrk = mGet3Dtrks(iPhiSec, iEtaReg);
+      for (const L1track3D& trk : get3Dtrk.trackCands3D(withRZfilter)) {
+	const TP* tp = trk.getMatchedTP();
+	if (tp != nullptr) tpTracks[tp].push_back(&trk);
+      }
+    }
+  }
+  return tpTracks;
+}
+
 //=== Understand why not all tracking particles were reconstructed.
 //=== Returns list of tracking particles that were not reconstructed and an string indicating why.
 //=== Only considers TP used for algorithmic efficiency measurement.
@@ -1562,8 +1595,8 @@ void Histos::fillTrackCands(const InputData& inputData, const matrix<Get3Dtracks
 // (If string = "mystery", reason for loss unknown. This may be a result of reconstruction of one 
 // track candidate preventing reconstruction of another. e.g. Due to duplicate track removal).
 
-map<const TP*, string> Histos::diagnoseTracking(const vector<TP>& allTPs, const matrix<Get3Dtracks> mGet3Dtrks, 
-						bool withRZfilter) const 
+map<const TP*, string> Histos::diagnoseTracking(const vector<TP>& allTPs, const matrix<Get3Dtracks>& mGet3Dtrks, 
+						const TPtrackMap& tpTracks, bool withRZfilter) const 
 {
   map<const TP*, string> diagnosis;
 
@@ -1574,13 +1607,7 @@ map<const TP*, string> Histos::diagnoseTracking(const vector<TP>& allTPs, const
     if ( tp.useForAlgEff()) { //--- Only consider TP that are reconstructable.
 
       //--- Check if this TP was reconstructed anywhere in the tracker..
-      bool tpRecoed = false;
-      for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
-	for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
-          const Get3Dtracks& get3Dtrk = mGet3Dtrks(iPhiSec, iEtaReg);
-	  if (get3Dtrk.assocTrackCands3D( tp, withRZfilter ).size() > 0) tpRecoed = true;
-	}
-      }
+      bool tpRecoed = (tpTracks.count(&tp) > 0);
 
       if ( tpRecoed) {
        
@@ -1670,7 +1697,9 @@ map<const TP*, string> Histos::diagnoseTracking(const vector<TP>& allTPs, const
 	      htRphiUnfiltered.init(settings_, secBest.iPhiSec(), secBest.iEtaReg(), 
 				    secBest.etaMin(), secBest.etaMax(), secBest.phiCentre());
 	      htRphiUnfiltered.disableBendFilter(); // Switch off bend filter
-	      for (const Stub* s: insideSecStubs[iSec]) {
+	      // The stubs in InputData are not digitized, so use copies of them digitized for this sector.
+	      vector<Stub> digiStubs;
+	      for (const Stub* s: this->digitizeStubsForHT(insideSecStubs[iSec], secBest.iPhiSec(), digiStubs)) {
 		// Check which eta subsectors within the sector the stub is compatible with (if subsectors being used).
 		const vector<bool> inEtaSubSecs =  secBest.insideEtaSubSecs( s );
 		htRphiUnfiltered.store(s, inEtaSubSecs);
@@ -1696,7 +1725,8 @@ map<const TP*, string> Histos::diagnoseTracking(const vector<TP>& allTPs, const
   	        HTrphi htRphiTmp;
 	        htRphiTmp.init(settings_, secBest.iPhiSec(), secBest.iEtaReg(), 
 			       secBest.etaMin(), secBest.etaMax(), secBest.phiCentre());
-		for (const Stub* s: insideSecStubs[iSec]) {
+		vector<Stub> digiStubs;
+		for (const Stub* s: this->digitizeStubsForHT(insideSecStubs[iSec], secBest.iPhiSec(), digiStubs)) {
 		  // Check which eta subsectors within the sector the stub is compatible with (if subsectors being used).
 		  const vector<bool> inEtaSubSecs =  secBest.insideEtaSubSecs( s );
 		  htRphiTmp.store(s, inEtaSubSecs);
@@ -1785,6 +1815,24 @@ map<const TP*, string> Histos::diagnoseTracking(const vector<TP>& allTPs, const
   return diagnosis;
 }
 
+//=== Copy the given stubs into digiStubs, digitized for input to the HT of the given phi sector, and return pointers to the copies.
+//=== (If digitization is disabled, the input stubs are returned instead).
+
+vector<const Stub*> Histos::digitizeStubsForHT(const vector<const Stub*>& stubs, unsigned int iPhiSec, vector<Stub>& digiStubs) const {
+  if (not settings_->enableDigitize()) return stubs;
+
+  // Reserve space for all stubs, so the returned pointers stay valid.
+  digiStubs.clear();
+  digiStubs.reserve(stubs.size());
+  vector<const Stub*> digiStubPtrs;
+  for (const Stub* s : stubs) {
+    digiStubs.push_back(*s);
+    digiStubs.back().digitizeForHTinput(iPhiSec);
+    digiStubPtrs.push_back( &digiStubs.back() );
+  }
+  return digiStubPtrs;
+}
+
 //=== Book histograms studying freak, large events with too many stubs.
 
 void Histos::bookStudyBusyEvents() {
@@ -1831,7 +1879,7 @@ void Histos::bookStudyBusyEvents() {
 //=== Fill histograms studying freak, large events with too many stubs at HT.
 
 void Histos::fillStudyBusyEvents(const InputData& inputData, const matrix<Sector>& mSectors, const matrix<HTrphi>& mHtRphis, 
-                		 const matrix<Get3Dtracks> mGet3Dtrks) {
+                		 const matrix<Get3Dtracks>& mGet3Dtrks) {
 
   const bool withRZfilter = false; // Care about events at HT.
 
@@ -1956,23 +2004,12 @@ void Histos::fillStudyBusyEvents(const InputData& inputData, const matrix<Sector
       //--- Count tracking particles lost by killing tracks in individual busy sectors.
       if (tooBusyOut) {
 	unsigned int nTPkilled = 0;
-	for (const TP& tp: vTPs) {
-	  if (tp.useForAlgEff()) { // Check TP is good for algorithmic efficiency measurement.
-
-	    bool tpRecoed = false;
-	    bool tpRecoedSurvived = false;
-	    for (const auto& trkm : trksInSector) {
-	      const L1track3D* trk = trkm.first;
-	      bool kill            = trkm.second;
-	      if (trk->getMatchedTP() == &tp) {
-		tpRecoed = true;                        // Truth particle was reconstructed
-		if (! kill) tpRecoedSurvived = true;    // Ditto & reconstructed track wasn't killed by busy sector.
-	      }
-	    }
-
-	    bool tpKilled = tpRecoed && ( ! tpRecoedSurvived );
-	    if (tpKilled) nTPkilled++;
-	  }
+	// Truth particles reconstructed in this sector, with flag indicating if any of their tracks survived.
+	const map<const TP*, bool> tpRecoedSurvived = this->tpSurvivedBusySec(trksInSector);
+	for (const auto& tpm : tpRecoedSurvived) {
+	  // Check TP is good for algorithmic efficiency measurement.
+	  bool tpKilled = ( ! tpm.second );
+	  if (tpm.first->useForAlgEff() && tpKilled) nTPkilled++;
 	}
 	hisNumTPkilledBusySec_->Fill(nTPkilled);
       }
@@ -1984,26 +2021,35 @@ void Histos::fillStudyBusyEvents(const InputData& inputData, const matrix<Sector
 
   //--- Check loss in tracking efficiency caused by killing tracks in busy sectors.
 
+  const map<const TP*, bool> tpRecoedSurvived = this->tpSurvivedBusySec(trksInEntireTracker);
+
   for (const TP& tp: vTPs) {
     if (tp.useForAlgEff()) { // Check TP is good for algorithmic efficiency measurement.
 
-      bool tpRecoed = false;
-      bool tpRecoedSurvived = false;
-      for (const auto& trkm : trksInEntireTracker) {
-	const L1track3D* trk = trkm.first;
-	bool kill            = trkm.second;
-	if (trk->getMatchedTP() == &tp) {
-	  tpRecoed = true;                        // Truth particle was reconstructed
-	  if (! kill) tpRecoedSurvived = true;    // Ditto & reconstructed track wasn't killed by busy sector.
-	}
-      }
-      bool tpKilled = tpRecoed && ( ! tpRecoedSurvived );
+      const auto iter = tpRecoedSurvived.find(&tp);
+      bool tpRecoed = (iter != tpRecoedSurvived.end()); // Truth particle was reconstructed
+      bool tpKilled = tpRecoed && ( ! iter->second );   // Ditto & all its reconstructed tracks were killed by busy sectors.
       profFracTPKilledVsEta_->Fill(fabs(tp.eta()), tpKilled);
       profFracTPKilledVsInvPt_->Fill(fabs(tp.qOverPt()), tpKilled);
     }
   }
 }
 
+//=== Given tracks with a flag indicating if they were killed as in a busy sector, find the truth particles
+//=== they are matched to, with a flag indicating if at least one of their tracks survived.
+
+map<const TP*, bool> Histos::tpSurvivedBusySec(const map<const L1track3D*, bool>& trkKilled) const {
+  map<const TP*, bool> tpSurvived;
+  for (const auto& trkm : trkKilled) {
+    const TP* tp = trkm.first->getMatchedTP();
+    if (tp != nullptr) {
+      bool& survived = tpSurvived[tp];
+      if (! trkm.second) survived = true;
+    }
+  }
+  return tpSurvived;
+}
+
 //=== Book histograms for studying track fitting.
 
 void Histos::bookTrackFitting() {
@@ -2278,16 +2324,15 @@ void Histos::fillTrackFitting( const InputData& inputData, const map<string,vect
     for (const TP& tp: vTPs) {
       tpRecoedMap[&tp]     = false;
       tpPerfRecoedMap[&tp] = false;
-      unsigned int nMatch = 0;
-      for (const L1fittedTrack& fitTrk : fittedTracks) {
-	const TP*   assocTP =  fitTrk.getMatchedTP(); // Get the TP the fitted track matches to, if any.
-	if (assocTP == &tp) {
-	  tpRecoedMap[&tp] = true; 
-	  if (fitTrk.getPurity() == 1.) tpPerfRecoedMap[&tp] = true;
-	  nMatch++;
-	}
+      tpRecoedDup[&tp]     = 0;
+    }
+    for (const L1fittedTrack& fitTrk : fittedTracks) {
+      const TP*   assocTP =  fitTrk.getMatchedTP(); // Get the TP the fitted track matches to, if any.
+      if (assocTP != nullptr) {
+	tpRecoedMap[assocTP] = true; 
+	if (fitTrk.getPurity() == 1.) tpPerfRecoedMap[assocTP] = true;
+	tpRecoedDup[assocTP]++;
       }
-      tpRecoedDup[&tp] = nMatch;
     }
 
     // Count truth particles that are successfully fitted.
@@ -2371,7 +2416,7 @@ void Histos::fillTrackFitting( const InputData& inputData, const map<string,vect
 	// Study incorrect hits on matched tracks.
 	hisNumStubsVsPurityMatched_[fitName]->Fill( fitTrk.getNumStubs(), fitTrk.getPurity() );
 
-	const vector<const Stub*> stubs = fitTrk.getStubs();
+	const vector<const Stub*>& stubs = fitTrk.getStubs();
 	for (const Stub* s : stubs) {
 	  // Was this stub produced by correct truth particle?
 	  const set<const TP*> stubTPs = s->assocTPs();
@@ -2436,7 +2481,7 @@ void Histos::fillTrackFitting( const InputData& inputData, const map<string,vect
 	float recalcChiSquared_1_rphi = 0.;
 	float recalcChiSquared_1_rz = 0.;
 	float recalcChiSquared_2 = 0.;
-	const vector<const Stub*> stubs = fitTrk.getStubs();
+	const vector<const Stub*>& stubs = fitTrk.getStubs();
 	if (recalc_debug) cout<<"RECALC loop stubs : HT cell=("<<fitTrk.getCellLocationHT().first<<","<<fitTrk.getCellLocationHT().second<<")   TP PDG_ID="<<tp->pdgId()<<endl;
 	for (const Stub* s : stubs) {
 	  // Was this stub produced by correct truth particle?
@@ -3003,15 +3048,23 @@ void Histos::endJobAnalysis() {
   // Don't bother producing summary if user didn't request histograms via TFileService in their cfg.
   if ( ! this->enabled() ) return;
 
-  // Produce plots of tracking efficiency using track candidates found after HT.
-  this->plotTrackEfficiency(false);
+  // The efficiency plots & performance summaries need the truth particle histograms booked with the track candidates.
+  const bool doTrackCands   = this->enabled("TrackCands");
+  const bool doTrackFitting = this->enabled("TrackFitting") && doTrackCands;
 
-  // Optionally produce plots of tracking efficiency using track candidates found after r-z track filter.
-  if (ranRZfilter_) this->plotTrackEfficiency(true);
+  if (doTrackCands) {
+    // Produce plots of tracking efficiency using track candidates found after HT.
+    this->plotTrackEfficiency(false);
+
+    // Optionally produce plots of tracking efficiency using track candidates found after r-z track filter.
+    if (ranRZfilter_) this->plotTrackEfficiency(true);
+  }
 
   // Produce more plots of tracking efficiency using track candidates after track fit.
-  for (auto &fitName : trackFitters_) {
-    this->plotTrackEffAfterFit(fitName);
+  if (doTrackFitting) {
+    for (auto &fitName : trackFitters_) {
+      this->plotTrackEffAfterFit(fitName);
+    }
   }
 
   cout << "=========================================================================" << endl;
@@ -3083,14 +3136,18 @@ void Histos::endJobAnalysis() {
   }
   cout<<endl;
 
-  //--- Print summary of track-finding performance after HT
-  this->printTrackPerformance(false);
-  //--- Optionally print summary of track-finding performance after r-z track filter.
-  if (ranRZfilter_) this->printTrackPerformance(true);
+  if (doTrackCands) {
+    //--- Print summary of track-finding performance after HT
+    this->printTrackPerformance(false);
+    //--- Optionally print summary of track-finding performance after r-z track filter.
+    if (ranRZfilter_) this->printTrackPerformance(true);
+  }
 
   //--- Print summary of track-finding performance after helix fit, for each track fitting algorithm used.
-  for (const string& fitName : trackFitters_) {
-    this->printFitTrackPerformance(fitName);   
+  if (doTrackFitting) {
+    for (const string& fitName : trackFitters_) {
+      this->printFitTrackPerformance(fitName);   
+    }
   }
   cout << "=========================================================================" << endl;
 
@@ -3113,14 +3170,16 @@ void Histos::endJobAnalysis() {
     cout<<"This fraction = "<<HTrphi::fracErrorsTypeB()<<" for r-phi HT"<<endl;   
   }
 
-  // Check for presence of common MC bug.
+  if (this->enabled("InputData")) {
+    // Check for presence of common MC bug.
 
-  float meanShared = hisFracStubsSharingClus0_->GetMean();
-  if (meanShared > 0.01) cout<<endl<<"WARNING: You are using buggy MC. A fraction "<<meanShared<<" of stubs share clusters in the module seed sensor, which front-end electronics forbids."<<endl;
+    float meanShared = hisFracStubsSharingClus0_->GetMean();
+    if (meanShared > 0.01) cout<<endl<<"WARNING: You are using buggy MC. A fraction "<<meanShared<<" of stubs share clusters in the module seed sensor, which front-end electronics forbids."<<endl;
 
-  // Check that the constants in class DegradeBend are up to date.
-  float meanFracStubsLost = hisStubKillDegradeBend_->GetMean(2);
-  if (meanFracStubsLost > 0.001) cout<<endl<<"WARNING: You should update the constants in class DegradeBend, since some stubs had bend outside the expected window range."<<endl; 
+    // Check that the constants in class DegradeBend are up to date.
+    float meanFracStubsLost = hisStubKillDegradeBend_->GetMean(2);
+    if (meanFracStubsLost > 0.001) cout<<endl<<"WARNING: You should update the constants in class DegradeBend, since some stubs had bend outside the expected window range."<<endl; 
+  }
 
   // Check if GP B approximation cfg params are inconsistent.
   if (bApproxMistake_) cout<<endl<<"WARNING: BApprox cfg params are inconsistent - see printout above."<<endl;
@@ -3128,7 +3187,7 @@ void Histos::endJobAnalysis() {
 
 //=== Determine "B" parameter, used in GP firmware to allow for tilted modules.
 
-void Histos::trackerGeometryAnalysis( const TrackerGeometryInfo trackerGeometryInfo ) {
+void Histos::trackerGeometryAnalysis( const TrackerGeometryInfo& trackerGeometryInfo ) {
 
   // Don't bother producing summary if user didn't request histograms via TFileService in their cfg.
   if ( ! this->enabled() ) return;
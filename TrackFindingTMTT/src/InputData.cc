@@ -34,7 +34,8 @@ InputData::InputData(const edm::Event& iEvent, const edm::EventSetup& iSetup, Se
   const edm::EDGetTokenT<DetSetVec> stubInputTag,
   const edm::EDGetTokenT<TTStubAssMap> stubTruthInputTag,
   const edm::EDGetTokenT<TTClusterAssMap> clusterTruthInputTag,
-  const edm::EDGetTokenT< reco::GenJetCollection > genJetInputTag
+  const edm::EDGetTokenT< reco::GenJetCollection > genJetInputTag,
+  const ModuleInfoCache* moduleInfoCache
    )
   {
 
@@ -77,14 +78,14 @@ InputData::InputData(const edm::Event& iEvent, const edm::EventSetup& iSetup, Se
     }
   }
 
-  // Also create map relating edm::Ptr<TrackingParticle> to TP.
+  // Also create table relating edm::Ptr<TrackingParticle> to TP.
 
-  map<edm::Ptr< TrackingParticle >, const TP* > translateTP;
+  TPtranslator translateTP;
 
   if (enableMCtruth_) {
+    translateTP.init(tpHandle.id(), tpHandle->size());
     for (const TP& tp : vTPs_) {
-      TrackingParticlePtr tpPtr(tp);
-      translateTP[tpPtr] = &tp;
+      translateTP.add(tp);
     }
   }
 
@@ -119,7 +120,7 @@ InputData::InputData(const edm::Event& iEvent, const edm::EventSetup& iSetup, Se
       TTStubRef ttStubRef = edmNew::makeRefTo(ttStubHandle, p_ttstub );
 
       // Store the Stub info, using class Stub to provide easy access to the most useful info.
-      Stub stub(ttStubRef, stubCount, settings, trackerGeometry, trackerTopology );
+      Stub stub(ttStubRef, stubCount, settings, trackerGeometry, trackerTopology, moduleInfoCache );
       // Also fill truth associating stubs to tracking particles.
       if (enableMCtruth_) stub.fillTruth(translateTP, mcTruthTTStubHandle, mcTruthTTClusterHandle); 
       vAllStubs_.push_back( stub );
@@ -139,9 +140,15 @@ InputData::InputData(const edm::Event& iEvent, const edm::EventSetup& iSetup, Se
   // (By passing vAllStubs_ here instead of vStubs_, it means that any algorithmic efficiencies
   // measured will be reduced if the tightened frontend electronics cuts, specified in section StubCuts
   // of Analyze_Defaults_cfi.py, are not 100% efficient).
+  // These are found in a single pass over the stubs, using the truth already stored in each stub,
+  // instead of scanning all stubs for each tracking particle.
   if (enableMCtruth_) {
+    vector< vector<const Stub*> > tpAssocStubs(vTPs_.size());
+    for (const Stub& s : vAllStubs_) {
+      for (const TP* tp : s.assocTPs()) tpAssocStubs[tp->index()].push_back(&s);
+    }
     for (unsigned int j = 0; j < vTPs_.size(); j++) {
-      vTPs_[j].fillTruth(vAllStubs_);
+      vTPs_[j].fillTruth(std::move(tpAssocStubs[j]));
     }
   }
 }
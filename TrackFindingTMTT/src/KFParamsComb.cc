@@ -435,8 +435,8 @@ bool KFParamsComb::isGoodState( const kalmanState &state )const
 
   }
 
-  if ( (getSettings()->kalmanDebugLevel() >= 2 && tpa_ != nullptr) ||
-       (getSettings()->kalmanDebugLevel() >= 2 && getSettings()->hybrid()) ) {
+  if ( (TMTT_DEBUG_ON(2, getSettings()->kalmanDebugLevel()) && tpa_ != nullptr) ||
+       (TMTT_DEBUG_ON(2, getSettings()->kalmanDebugLevel()) && getSettings()->hybrid()) ) {
     if (not goodState) cout<<"State veto: nlay="<<nStubLayers;
     if (goodState)     cout<<"State kept: nlay="<<nStubLayers; 
     cout<<" chi2="<<state.chi2()<<" pt="<<pt;
@@ -2,6 +2,7 @@
 #include "L1Trigger/TrackFindingTMTT/interface/Settings.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include <map>
+#include <unordered_set>
 
 namespace TMTT {
 
@@ -66,7 +67,8 @@ vector<L1fittedTrack> KillDupFitTrks::filterAlg50(const vector<L1fittedTrack>& t
   // Make a first pass through the tracks, doing initial identification of duplicate tracks.
   // N.B. BY FILLING THIS WITH CELLS AROUND SELECTED TRACKS, RATHER THAN JUST THE CELL CONTAINING THE
   // TRACK, ONE CAN REDUCE THE DUPLICATE RATE FURTHER, AT COST TO EFFICIENCY.
-  set< pair<unsigned int, unsigned int> > htCellUsed;
+  // (Hashed by cellKey(), so each check for a used cell is a single lookup).
+  unordered_set<unsigned long long> htCellUsed;
   vector<const L1fittedTrack*> tracksRejected;
 
   // For checking if multiple tracks corresponding to same TP are accepted by duplicate removal.
@@ -89,16 +91,16 @@ vector<L1fittedTrack> KillDupFitTrks::filterAlg50(const vector<L1fittedTrack>& t
 	  // Memorize HT cell location corresponding to this track (identical for HT track & fitted track).
 	  if ( ! memorizeAllHTcells) {
 	    pair<unsigned int, unsigned int> htCell = trk.getCellLocationHT();
-	    htCellUsed.insert( htCell );
+	    htCellUsed.insert( cellKey(htCell) );
    	    if (trk.getL1track3D().mergedHTcell()) {
 	      // If this is a merged cell, block the other elements too, in case a track found by the HT in an unmerged cell
 	      // has a fitted cell there.
 	      pair<unsigned int, unsigned int> htCell10( htCell.first + 1, htCell.second);
 	      pair<unsigned int, unsigned int> htCell01( htCell.first    , htCell.second + 1);
 	      pair<unsigned int, unsigned int> htCell11( htCell.first + 1, htCell.second + 1);
-	      htCellUsed.insert( htCell10 );
-	      htCellUsed.insert( htCell01 );
-	      htCellUsed.insert( htCell11 );
+	      htCellUsed.insert( cellKey(htCell10) );
+	      htCellUsed.insert( cellKey(htCell01) );
+	      htCellUsed.insert( cellKey(htCell11) );
 	    }
 	  }
 
@@ -127,7 +129,7 @@ vector<L1fittedTrack> KillDupFitTrks::filterAlg50(const vector<L1fittedTrack>& t
 	// Memorize HT cell location corresponding to this track, even if it was not accepted by first pass..
 	if (memorizeAllHTcells) {
 	  pair<unsigned int, unsigned int> htCell = trk.getCellLocationFit(); // Intentionally used fit instead of HT here.
-	  htCellUsed.insert( htCell );
+	  htCellUsed.insert( cellKey(htCell) );
 	  if (trk.getL1track3D().mergedHTcell()) {
 	    // If this is a merged cell, block the other elements too, in case a track found by the HT in an unmerged cell
 	    // has a fitted cell there.
@@ -135,9 +137,9 @@ vector<L1fittedTrack> KillDupFitTrks::filterAlg50(const vector<L1fittedTrack>& t
 	    pair<unsigned int, unsigned int> htCell10( htCell.first + 1, htCell.second);
 	    pair<unsigned int, unsigned int> htCell01( htCell.first    , htCell.second + 1);
 	    pair<unsigned int, unsigned int> htCell11( htCell.first + 1, htCell.second + 1);
-	    htCellUsed.insert( htCell10 );
-	    htCellUsed.insert( htCell01 );
-	    htCellUsed.insert( htCell11 );
+	    htCellUsed.insert( cellKey(htCell10) );
+	    htCellUsed.insert( cellKey(htCell01) );
+	    htCellUsed.insert( cellKey(htCell11) );
 	  }
 	}
       }
@@ -155,11 +157,11 @@ vector<L1fittedTrack> KillDupFitTrks::filterAlg50(const vector<L1fittedTrack>& t
       pair<unsigned int, unsigned int> htCell = trk->getCellLocationFit();
       // If this HT cell was not already memorized, rescue this track, since it is probably not a duplicate,
       // but just a track whose fitted helix parameters are a bit wierd for some reason.
-      if (std::count(htCellUsed.begin(), htCellUsed.end(), htCell) == 0) {
+      if (htCellUsed.count( cellKey(htCell) ) == 0) {
 	tracksFiltered.push_back(*trk); // Rescue track.
 	// Optionally store cell location to avoid rescuing other tracks at the same location, which may be duplicates of this track. 
 	bool outsideCheck =( goOutsideArray || trk->pt() > settings_->houghMinPt() );
-	if (reduceDups && outsideCheck) htCellUsed.insert( htCell );
+	if (reduceDups && outsideCheck) htCellUsed.insert( cellKey(htCell) );
 
 	if (debug && tp != nullptr) {
 	  cout<<"SECOND PASS: m="<<trk->getCellLocationHT().first<<"/"<<trk->getCellLocationFit().first<<" c="<<trk->getCellLocationHT().second<<"/"<<trk->getCellLocationFit().second<<" Delta(m,c)=("<<int(trk->getCellLocationHT().first) - int(trk->getCellLocationFit().first)<<","<<int(trk->getCellLocationHT().second) - int(trk->getCellLocationFit().second)<<") pure="<<trk->getPurity()<<" merged="<<trk->getL1track3D().mergedHTcell()<<" #layers="<<trk->getL1track3D().getNumLayers()<<" tp="<<tp->index()<<" dupCell=("<<tpFound[tp->index()].first<<","<<tpFound[tp->index()].second<<") dup="<<tpFoundAtPass[tp->index()]<<endl;
@@ -189,17 +191,17 @@ vector<L1fittedTrack> KillDupFitTrks::filterAlg51(const vector<L1fittedTrack>& t
   if (debug && tracks.size() > 0) cout<<"START "<<tracks.size()<<endl;
 
   vector<L1fittedTrack> tracksFiltered;
-  set< pair<unsigned int, unsigned int> > htCellUsed;
+  unordered_set<unsigned long long> htCellUsed;
 
   for (const L1fittedTrack& trk : tracks) {
       // Get location in HT array corresponding to fitted track helix parameters.
       pair<unsigned int, unsigned int> htCell = trk.getCellLocationFit();
       // If this HT cell was not already memorized, rescue this track, since it is probably not a duplicate,
       // but just a track whose fitted helix parameters are a bit wierd for some reason.
-      if (std::count(htCellUsed.begin(), htCellUsed.end(), htCell) == 0) {
+      if (htCellUsed.count( cellKey(htCell) ) == 0) {
 	tracksFiltered.push_back(trk); // Rescue track.
 	// Store cell location to avoid rescuing other tracks at the same location, which may be duplicates of this track. 
-	htCellUsed.insert( htCell );
+	htCellUsed.insert( cellKey(htCell) );
 	if (debug) {
 	  const TP* tp = trk.getMatchedTP();
 	  int tpIndex = (tp != nullptr) ? tp->index() : -999;
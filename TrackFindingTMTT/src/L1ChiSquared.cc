@@ -3,27 +3,17 @@
 ///=== Written by: Sioni Summers and Alexander D. Morton
 
 #include "L1Trigger/TrackFindingTMTT/interface/L1ChiSquared.h"
-#include "L1Trigger/TrackFindingTMTT/interface/Matrix.h"
 #include "L1Trigger/TrackFindingTMTT/interface/Stub.h"
 #include "L1Trigger/TrackFindingTMTT/interface/L1fittedTrack.h"
 #include "L1Trigger/TrackFindingTMTT/interface/L1track3D.h"
 #include "L1Trigger/TrackFindingTMTT/interface/Utility.h"
  
-#include <algorithm>
-#include <functional>
+#include <cassert>
  
 namespace TMTT {
 
-template <typename T>
-std::vector<T> operator-(const std::vector<T>& a, const std::vector<T>& b){
-    assert(a.size() == b.size());
-    std::vector<T> result;
-    result.reserve(a.size());
-    std::transform(a.begin(), a.end(), b.begin(), std::back_inserter(result), std::minus<T>());
-    return result;
-}
- 
-L1ChiSquared::L1ChiSquared(const Settings* settings, const uint nPar) : TrackFitGeneric(settings), chiSq_ (0.0){
+template <unsigned int NPAR>
+L1ChiSquared<NPAR>::L1ChiSquared(const Settings* settings, const uint nPar) : TrackFitGeneric(settings), chiSq_ (0.0){
   // Bad stub killing settings
   numFittingIterations_ = getSettings()->numTrackFitIterations();
   killTrackFitWorstHit_ = getSettings()->killTrackFitWorstHit();
@@ -33,9 +23,35 @@ L1ChiSquared::L1ChiSquared(const Settings* settings, const uint nPar) : TrackFit
   //--- These two parameters are used to check if after the fit, there are still enough stubs on the track
   minStubLayers_ = getSettings()->minStubLayers();
   nPar_ = nPar;
+  assert(nPar_ == NPAR);
 }
- 
-void L1ChiSquared::calculateChiSq( std::vector<double> resids ){
+
+template <unsigned int NPAR>
+bool L1ChiSquared<NPAR>::fitIteration( ParamVec& x, ParamVec& deltaX, ParamVec& covX ){
+  this->D(x, derivs_); // Calculate derivatives
+  this->Vinv(vInv_);
+  this->residuals(x, resids_); // Calculate residuals
+
+  // Build the normal equations M*deltaX = covX, with M = dtVinv * dtVinv^T and covX = dtVinv * resids,
+  // where dtVinv = D^T * Vinv. (M matches tracklet code, but not literature, which uses D^T * Vinv * D).
+  // As Vinv is diagonal, each residual contributes one column of dtVinv.
+  SymMatrix<NPAR> M;
+  covX.fill(0.);
+  for ( uint k=0; k<resids_.size(); k++ ){
+    ParamVec dtVinvCol;
+    for ( uint p=0; p<NPAR; p++ ) dtVinvCol[p] = derivs_[k][p]*vInv_[k];
+    M.addOuter(dtVinvCol);
+    for ( uint p=0; p<NPAR; p++ ) covX[p] += dtVinvCol[p]*resids_[k];
+  }
+
+  deltaX.fill(0.);
+  if ( ! M.solve(covX, deltaX) ) return false;
+  for ( uint p=0; p<NPAR; p++ ) x[p] -= deltaX[p];
+  return true;
+}
+
+template <unsigned int NPAR>
+void L1ChiSquared<NPAR>::calculateChiSq( const std::vector<double>& resids ){
   chiSq_ = 0.0;
   uint j=0;
   for ( uint i=0; i<stubs_.size(); i++ ){
@@ -44,37 +60,32 @@ void L1ChiSquared::calculateChiSq( std::vector<double> resids ){
   }
 }
 
-void L1ChiSquared::calculateDeltaChiSq( std::vector<double> delX, std::vector<double> covX ){
-  for ( uint i=0; i<covX.size(); i++ ){
+template <unsigned int NPAR>
+void L1ChiSquared<NPAR>::calculateDeltaChiSq( const ParamVec& delX, const ParamVec& covX ){
+  for ( uint i=0; i<NPAR; i++ ){
     chiSq_ += (-delX[i])*covX[i];
   }
 }
 
-L1fittedTrack L1ChiSquared::fit(const L1track3D& l1track3D){
+template <unsigned int NPAR>
+L1fittedTrack L1ChiSquared<NPAR>::fit(const L1track3D& l1track3D){
   
   stubs_ = l1track3D.getStubs();
 
   // Get cut on number of layers including variation due to dead sectors, pt dependence etc.
   minStubLayersRed_ = Utility::numLayerCut("FIT", getSettings(), l1track3D.iPhiSec(), l1track3D.iEtaReg(), fabs(l1track3D.qOverPt()), l1track3D.eta());
   
-  std::vector<double> x = seed(l1track3D);
-  
-  Matrix<double> d = D(x);
-  Matrix<double> dtVinv = d.transpose() * Vinv();
-//  Matrix<double> M = dtVinv * d;
-  Matrix<double> M = dtVinv * (dtVinv.transpose()); //TODO this match tracklet code, but not literature:w
-
-  std::vector<double> resids = residuals(x);
-//  std::cout << "resids.size(): " << resids.size() << std::endl;
-  std::vector<double> deltaX = M.inverse() * dtVinv * resids;
-  x = x - deltaX;
-  std::vector<double> covX = d.transpose() * Vinv() * resids;  
-
-  calculateChiSq(resids);
-  calculateDeltaChiSq (deltaX, covX);
-  resids = residuals(x); // update resids.
-
-  for (int i=1;i<numFittingIterations_+1;++i) {
+  ParamVec x = seed(l1track3D);
+  ParamVec deltaX, covX;
+
+  bool solved = this->fitIteration(x, deltaX, covX);
+  if ( solved ){
+    calculateChiSq(resids_);
+    calculateDeltaChiSq (deltaX, covX);
+    this->residuals(x, resids_); // update resids.
+  }
+
+  for (int i=1;i<numFittingIterations_+1 && solved;++i) {
     if (i>1) {
       /*
       // Original buggy code of 18th April 2018
@@ -113,28 +124,23 @@ L1fittedTrack L1ChiSquared::fit(const L1track3D& l1track3D){
 	}
       }
 
-      d = D(x); // Calculate derivatives
-      dtVinv = d.transpose() * Vinv();
-      M = dtVinv * (dtVinv.transpose()); 
-      resids = residuals(x); // Calculate new residuals
-      std::vector<double> deltaX = M.inverse() * dtVinv * resids;
-      x = x - deltaX;
-      std::vector<double> covX = d.transpose() * Vinv() * resids;  
-      resids = residuals(x); // update resids.
+      solved = this->fitIteration(x, deltaX, covX);
+      if ( ! solved ) break;
+      this->residuals(x, resids_); // update resids.
 
-      calculateChiSq(resids);
+      calculateChiSq(resids_);
       calculateDeltaChiSq (deltaX, covX);
     }
   }  
 
-  std::map<std::string, double> tp = convertParams(x); // tp = track params
+  L1ChiSquaredParams tp = convertParams(x); // tp = track params
 
-  // Reject tracks with too many killed stubs
+  // Reject tracks with too many killed stubs, or whose fit matrix could not be inverted.
   unsigned int nLayers = Utility::countLayers( getSettings(), stubs_ ); // Count tracker layers with stubs
-  bool valid4par = nLayers >= minStubLayersRed_;
+  bool valid4par = nLayers >= minStubLayersRed_ && solved;
 
   if ( valid4par ){
-    return L1fittedTrack(getSettings(), l1track3D, stubs_, tp["qOverPt"], 0, tp["phi0"], tp["z0"], tp["t"], chiSq_, nPar_, valid4par);
+    return L1fittedTrack(getSettings(), l1track3D, stubs_, tp.qOverPt, 0, tp.phi0, tp.z0, tp.t, chiSq_, nPar_, valid4par);
   }
   else{ 
     return L1fittedTrack (getSettings(), l1track3D, stubs_, l1track3D.qOverPt(), 0., l1track3D.phi0(), l1track3D.z0(), l1track3D.tanLambda(), 999999., 4, valid4par);
@@ -142,4 +148,7 @@ L1fittedTrack L1ChiSquared::fit(const L1track3D& l1track3D){
 }
  
 
+template class L1ChiSquared<4>;
+template class L1ChiSquared<5>;
+
 }
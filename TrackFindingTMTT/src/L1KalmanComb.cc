@@ -222,7 +222,7 @@ L1fittedTrack L1KalmanComb::fit(const L1track3D& l1track3D){
   //dump flag
   static unsigned nthFit(0);
   nthFit++;
-  if( getSettings()->kalmanDebugLevel() >= 3 && nthFit <= maxNfitForDump_ ){
+  if( TMTT_DEBUG_ON(3, getSettings()->kalmanDebugLevel()) && nthFit <= maxNfitForDump_ ){
     if( tpa ) dump_ = true; 
     else dump_ = false;
   }
@@ -355,7 +355,7 @@ L1fittedTrack L1KalmanComb::fit(const L1track3D& l1track3D){
 
 
   //track information dump
-  if( getSettings()->kalmanDebugLevel() >= 1 ){
+  if( TMTT_DEBUG_ON(1, getSettings()->kalmanDebugLevel()) ){
 
     std::cout << "===============================================================================" << endl;
     std::cout << "Input track cand: [phiSec,etaReg]=[" << l1track3D.iPhiSec() << "," << l1track3D.iEtaReg() << "]";
@@ -364,7 +364,7 @@ L1fittedTrack L1KalmanComb::fit(const L1track3D& l1track3D){
 	      <<l1track3D.qOverPt()<<" tanL="<<l1track3D.tanLambda()<< " z0="<<l1track3D.z0()<< " phi0="<<l1track3D.phi0()
                                 <<" nStubs="<<l1track3D.getNumStubs()<<std::endl;
     if (not getSettings()->hybrid()) printTP( cout, tpa );
-    if( getSettings()->kalmanDebugLevel() >= 2 ){
+    if( TMTT_DEBUG_ON(2, getSettings()->kalmanDebugLevel()) ){
       printStubLayers( cout, stubs );
       printStubClusters( cout, stubcls );
     }
@@ -386,7 +386,7 @@ L1fittedTrack L1KalmanComb::fit(const L1track3D& l1track3D){
 
     L1fittedTrack returnTrk(getSettings(), l1track3D, cand->stubs(), trackParams["qOverPt"], trackParams["d0"], trackParams["phi0"], trackParams["z0"], trackParams["t"], cand->chi2(), nPar_, true);
 
-    if( getSettings()->kalmanDebugLevel() >= 3 ){
+    if( TMTT_DEBUG_ON(3, getSettings()->kalmanDebugLevel()) ){
       if (this->isHLS()) {
         // Check if (m,c) corresponding to helix params are correctly calculated by HLS code.
         unsigned int mBinHelixHLS, cBinHelixHLS;
@@ -422,7 +422,7 @@ L1fittedTrack L1KalmanComb::fit(const L1track3D& l1track3D){
     }
 
     //candidate dump
-    if( getSettings()->kalmanDebugLevel() >= 3 ){
+    if( TMTT_DEBUG_ON(3, getSettings()->kalmanDebugLevel()) ){
       cout << "------------------------------------" << endl;
       if( tpa && tpa->useForAlgEff() ){
 	cout << "TP for eff. : index " << tpa->index() << endl;
@@ -442,7 +442,7 @@ L1fittedTrack L1KalmanComb::fit(const L1track3D& l1track3D){
 
   } else {
 
-    if (getSettings()->kalmanDebugLevel() >= 1) {
+    if (TMTT_DEBUG_ON(1, getSettings()->kalmanDebugLevel())) {
       bool goodTrack =  ( tpa && tpa->useForAlgEff() ); // Matches truth particle.
       if(goodTrack) {
 	// Debug printout for Mark to understand why tracks are lost.
@@ -487,7 +487,7 @@ L1fittedTrack L1KalmanComb::fit(const L1track3D& l1track3D){
     }
 			
     //dump on the missed TP for efficiency calculation.
-    if( getSettings()->kalmanDebugLevel() >= 3 ){
+    if( TMTT_DEBUG_ON(3, getSettings()->kalmanDebugLevel()) ){
       if( tpa && tpa->useForAlgEff() ){
 	cout << "TP for eff. missed addr. index : " << tpa << " " << tpa->index() << endl;
 	printStubClusters( cout, stubcls );
@@ -653,7 +653,7 @@ std::vector<const kalmanState *> L1KalmanComb::doKF( const L1track3D& l1track3D,
 
       // If track was not rejected by isGoodState() is previous iteration, failure here usually means the tracker ran out of layers to explore.
       // (Due to "kalmanLayer" not having unique ID for each layer within a given eta sector).
-      if ( getSettings()->kalmanDebugLevel() >= 2 && best_state_by_nstubs.size() == 0 && stubs.size() == 0 && next_stubs.size() == 0) cout<<"State is lost by start of iteration "<<iteration<<" : #stubs="<<stubs.size()<<" #next_stubs="<<next_stubs.size()<<" layer="<<layer<<" eta="<<l1track3D.iEtaReg()<<endl;
+      if ( TMTT_DEBUG_ON(2, getSettings()->kalmanDebugLevel()) && best_state_by_nstubs.size() == 0 && stubs.size() == 0 && next_stubs.size() == 0) cout<<"State is lost by start of iteration "<<iteration<<" : #stubs="<<stubs.size()<<" #next_stubs="<<next_stubs.size()<<" layer="<<layer<<" eta="<<l1track3D.iEtaReg()<<endl;
 
       // If we skipped over a dead layer, only increment "skipped" after the stubs in next+1 layer have been obtained
       skipped += nSkippedDeadLayers;
@@ -791,7 +791,7 @@ std::vector<const kalmanState *> L1KalmanComb::doKF( const L1track3D& l1track3D,
     // Success. We have at least one state that passes all cuts. Save best state found with this number of stubs.
     if (nStubs >= getSettings()->kalmanMinNumStubs() && new_states.size() > 0) best_state_by_nstubs[nStubs] = new_states[0]; 
 
-    //if ( getSettings()->kalmanDebugLevel() >= 1 && best_state_by_nstubs.size() == 0 && new_states.size() == 0) cout<<"Track is lost by end iteration "<<iteration<<" : eta="<<l1track3D.iEtaReg()<<endl;
+    //if ( TMTT_DEBUG_ON(1, getSettings()->kalmanDebugLevel()) && best_state_by_nstubs.size() == 0 && new_states.size() == 0) cout<<"Track is lost by end iteration "<<iteration<<" : eta="<<l1track3D.iEtaReg()<<endl;
 
     if( nStubs == getSettings()->kalmanMaxNumStubs() ){ 
       // We're done.
@@ -827,7 +827,7 @@ std::vector<const kalmanState *> L1KalmanComb::doKF( const L1track3D& l1track3D,
     // Select state with largest number of stubs.
     const kalmanState* stateFinal = best_state_by_nstubs.begin()->second; // First element has largest number of stubs.
     finished_states.push_back(stateFinal);
-    if ( getSettings()->kalmanDebugLevel() >= 1 ) {
+    if ( TMTT_DEBUG_ON(1, getSettings()->kalmanDebugLevel()) ) {
       cout<<"Track found! final state selection: nLay="<<stateFinal->nStubLayers()<<" etaReg="<<l1track3D.iEtaReg();
       std::map<std::string, double> y = getTrackParams( stateFinal );
       cout<<" q/pt="<<y["qOverPt"]<<" tanL="<<y["t"]<<" z0="<<y["z0"]<<" phi0="<<y["phi0"];
@@ -838,7 +838,7 @@ std::vector<const kalmanState *> L1KalmanComb::doKF( const L1track3D& l1track3D,
       cout<<endl;
     }
   } else {
-    if ( getSettings()->kalmanDebugLevel() >= 1 ) {
+    if ( TMTT_DEBUG_ON(1, getSettings()->kalmanDebugLevel()) ) {
       cout<<"Track lost"<<endl;
     }
   }
@@ -852,7 +852,7 @@ std::vector<const kalmanState *> L1KalmanComb::doKF( const L1track3D& l1track3D,
 
 const kalmanState *L1KalmanComb::kalmanUpdate( unsigned skipped, unsigned layer, const StubCluster *stubCluster, const kalmanState &state, const TP *tpa ){
 
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "---------------" << endl;
     cout << "kalmanUpdate" << endl;
     cout << "---------------" << endl;
@@ -865,14 +865,14 @@ const kalmanState *L1KalmanComb::kalmanUpdate( unsigned skipped, unsigned layer,
   std::vector<double> xa     = state.xa();
   TMatrixD            cov_xa = state.pxxa(); 
   if( state.barrel() && !stubCluster->barrel() ){ 
-    if( getSettings()->kalmanDebugLevel() >= 4 ) {
+    if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ) {
       cout << "STATE BARREL TO ENDCAP BEFORE " << endl;
       cout << "state : " << xa.at(0) << " " << xa.at(1) << " " << xa.at(2) << " " << xa.at(3) << endl;
       cout << "cov(x): " << endl; 
       cov_xa.Print();
     }
     barrelToEndcap( state.r(), stubCluster, xa, cov_xa );
-    if( getSettings()->kalmanDebugLevel() >= 4 ){
+    if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
       cout << "STATE BARREL TO ENDCAP AFTER " << endl;
       cout << "state : " << xa.at(0) << " " << xa.at(1) << " " << xa.at(2) << " " << xa.at(3) << endl;
       cout << "cov(x): " << endl; 
@@ -882,7 +882,7 @@ const kalmanState *L1KalmanComb::kalmanUpdate( unsigned skipped, unsigned layer,
   // Matrix to propagate helix params from one layer to next (=identity matrix).
   TMatrixD f = F(stubCluster, &state );
   TMatrixD ft(TMatrixD::kTransposed, f );
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "f" << endl;
     f.Print();
     cout << "ft" << endl;
@@ -890,50 +890,50 @@ const kalmanState *L1KalmanComb::kalmanUpdate( unsigned skipped, unsigned layer,
   }
 
   std::vector<double> fx = Fx( f, xa ); // Multiply matrices to get helix params at next layer.
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "fx = ["; 
     for( unsigned i = 0; i < nPar_; i++ ) cout << fx.at(i) << ", ";
     cout << "]" << endl;
   }
 
   std::vector<double> delta = residual(stubCluster, fx, state.candidate().qOverPt() );
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "delta = " << delta[0] << ", " << delta[1] << endl;
   }
 
   // Derivative of predicted (phi,z) intercept with layer w.r.t. helix params.
   TMatrixD h = H(stubCluster);
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "h" << endl;
     h.Print();
   }
 
 
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "previous state covariance" << endl;
     cov_xa.Print();
   }
   // Get contribution to helix parameter covariance from scattering (NOT USED).
   TMatrixD pxxm = PxxModel( &state, stubCluster );
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "model xcov" << endl;
     pxxm.Print();
   }
   // Get covariance on helix parameters.
   TMatrixD pxcov = f * cov_xa * ft + pxxm;
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "forcast xcov + model xcov" << endl;
     pxcov.Print();
   }
   // Get hit position covariance matrix.
   TMatrixD dcov = PddMeas( stubCluster, &state );
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "dcov" << endl;
     dcov.Print();
   }
   // Calculate Kalman Gain matrix.
   TMatrixD k = GetKalmanMatrix( h, pxcov, dcov );  
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "k" << endl;
     k.Print();
   }
@@ -941,7 +941,7 @@ const kalmanState *L1KalmanComb::kalmanUpdate( unsigned skipped, unsigned layer,
   std::vector<double> new_xa(nPar_);
   TMatrixD new_pxxa;
   GetAdjustedState( k, pxcov, fx, stubCluster, delta, new_xa, new_pxxa );
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     if( nPar_ == 4 )
       cout << "adjusted x = " << new_xa[0] << ", " << new_xa[1] << ", " << new_xa[2] << ", " << new_xa[3] << endl;
     else if( nPar_ == 5 )
@@ -951,7 +951,7 @@ const kalmanState *L1KalmanComb::kalmanUpdate( unsigned skipped, unsigned layer,
   }
 
   const kalmanState *new_state = mkState( state.candidate(), skipped, layer, stubCluster->layerId(), &state, new_xa, new_pxxa, k, dcov, stubCluster, 0 );
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "new state" << endl;
     new_state->dump( cout, tpa  );
   }
@@ -963,7 +963,7 @@ const kalmanState *L1KalmanComb::kalmanUpdate( unsigned skipped, unsigned layer,
 
 double L1KalmanComb::calcChi2( const kalmanState &state )const{
 
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "calcChi2 " << endl;
   }
   double chi2(0), chi2_p(0);
@@ -985,7 +985,7 @@ double L1KalmanComb::calcChi2( const kalmanState &state )const{
       cout<<"    FITTER SIGMA:      rphi="<<1000*sqrt(dcov(0,0))<<" rz="<<sqrt(dcov(1,1))<<" ID="<<ID<<endl;
 #endif
 
-      if( getSettings()->kalmanDebugLevel() >= 4 ){
+      if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
 	cout << "dcov" << endl;
 	dcov.Print();
 	cout << "xcov" << endl;
@@ -993,14 +993,14 @@ double L1KalmanComb::calcChi2( const kalmanState &state )const{
       }
       TMatrixD h = H(stubCluster);
       TMatrixD hxxh = HxxH( h, state.last_state()->pxxa() );
-      if( getSettings()->kalmanDebugLevel() >= 4 ){
+      if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
 	cout << "h" << endl;
 	h.Print();
 	cout << "hxcovh" << endl;
 	hxxh.Print();
       }
       TMatrixD covR = dcov + hxxh;
-      if( getSettings()->kalmanDebugLevel() >= 4 ){
+      if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
 	cout << "covR" << endl;
 	covR.Print();
 	cout << "---" << endl;
@@ -1021,7 +1021,7 @@ double L1KalmanComb::calcChi2( const kalmanState &state )const{
 
 double L1KalmanComb::Chi2( const TMatrixD &dcov, const std::vector<double> &delta, bool debug )const
 {
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "dcov" << endl;
     dcov.Print();
   }
@@ -1128,7 +1128,7 @@ TMatrixD L1KalmanComb::GetKalmanMatrix( const TMatrixD &h, const TMatrixD &pxcov
       }
     }
   }
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "pxcovht" << endl;
     pxcovht.Print();
   }
@@ -1137,7 +1137,7 @@ TMatrixD L1KalmanComb::GetKalmanMatrix( const TMatrixD &h, const TMatrixD &pxcov
   TMatrixD hxxh = HxxH( h, pxcov );
   tmp = dcov + hxxh; 
 
-  if( getSettings()->kalmanDebugLevel() >= 4 ){
+  if( TMTT_DEBUG_ON(4, getSettings()->kalmanDebugLevel()) ){
     cout << "hxxh" << endl;
     hxxh.Print();
     cout << "dcov + hxxh " << endl;
@@ -61,10 +61,8 @@ void MiniHTstage::exec( matrix< HTrphi >& mHtRphis ) const {
 		const bool mergedCell = false; // This represents mini cell.
 		htCell.init( settings_, iPhiSec, iEtaReg, sector.etaMin(), sector.etaMax(), qOverPtBin, cell.first + mBin, mergedCell );
 
+		// N.B. The stubs are this sector's copies, so are already digitized with respect to the current phi sector.
 		for ( auto& stub: stubs ) {
-		  // Ensure stubs are digitized with respect to the current phi sector.
-		  if ( settings_->enableDigitize() )
-		    ( const_cast< Stub* >( stub ) )->digitizeForHTinput( iPhiSec );
 		  float phiStub = reco::deltaPhi( stub->phi() + invPtToDphi_ * qOverPtBin * ( stub->r() - chosenRofPhi_ ) - phiCentre, 0. );
 		  float dPhi = reco::deltaPhi( phiBin - phiStub, 0. );
 		  float dPhiMax = binSizePhiTrkAxis_ / miniHoughNbinsPhi_ / 2. + invPtToDphi_ * binSizeQoverPtAxis_ / (float)miniHoughNbinsPt_ * fabs( stub->r() - chosenRofPhi_ ) / 2.;
@@ -0,0 +1,106 @@
+#include "L1Trigger/TrackFindingTMTT/interface/ModuleInfo.h"
+
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "DataFormats/TrackerCommon/interface/TrackerTopology.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+#include "Geometry/CommonTopologies/interface/PixelTopology.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+namespace TMTT {
+
+//=== Get the module info from the tracker geometry, given the DetId of the lower sensor in the module.
+
+ModuleInfo::ModuleInfo(const TrackerGeometry* trackerGeometry, const TrackerTopology* trackerTopology, const DetId& detId) {
+
+  detId_ = detId;
+
+  // Note if module is PS or 2S, and whether in barrel or endcap.
+  psModule_ = trackerGeometry->getDetectorType( detId ) == TrackerGeometry::ModuleType::Ph2PSP; // From https://github.com/cms-sw/cmssw/blob/CMSSW_8_1_X/Geometry/TrackerGeometryBuilder/README.md
+  barrel_ = detId.subdetId()==StripSubdetector::TOB || detId.subdetId()==StripSubdetector::TIB;
+
+  // Get min & max (r,phi,z) coordinates of the centre of the two sensors containing this stub.
+  const GeomDetUnit* det0 = trackerGeometry->idToDetUnit( detId );
+  const GeomDetUnit* det1 = trackerGeometry->idToDetUnit( trackerTopology->partnerDetId( detId ) );
+
+  geomDet_  = dynamic_cast< const PixelGeomDetUnit* >( det0 );
+  topology_ = dynamic_cast< const PixelTopology* >( &(geomDet_->specificTopology()) );
+  endcap_   = GeomDetEnumerators::isEndcap( det0->subDetector() );
+
+  float R0 = det0->position().perp();
+  float R1 = det1->position().perp();
+  float PHI0 = det0->position().phi();
+  float PHI1 = det1->position().phi();
+  float Z0 = det0->position().z();
+  float Z1 = det1->position().z();
+  moduleMinR_   = std::min(R0,R1);
+  moduleMaxR_   = std::max(R0,R1);
+  moduleMinPhi_ = std::min(PHI0,PHI1);
+  moduleMaxPhi_ = std::max(PHI0,PHI1);
+  moduleMinZ_   = std::min(Z0,Z1);
+  moduleMaxZ_   = std::max(Z0,Z1);
+
+  // Note if tilted barrel module & get title angle (in range 0 to PI).
+  tiltedBarrel_ = barrel_ && (trackerTopology->tobSide(detId) != 3);
+  float deltaR = fabs(R1 - R0);
+  float deltaZ = (R1 - R0 > 0)  ?  (Z1 - Z0)  :  - (Z1 - Z0);
+  moduleTilt_  = atan2( deltaR, deltaZ);
+  if (moduleTilt_ >  M_PI/2.) moduleTilt_ -= M_PI; // Put in range -PI/2 to +PI/2.
+  if (moduleTilt_ < -M_PI/2.) moduleTilt_ += M_PI; // 
+
+  // Encode layer ID.
+  if (barrel_) {
+    layerId_ = trackerTopology->layer( detId ); // barrel layer 1-6 encoded as 1-6
+  } else {
+    // layerId_ = 10*detId.iSide() + detId.iDisk(); // endcap layer 1-5 encoded as 11-15 (endcap A) or 21-25 (endcapB)
+    // EJC This seems to give the same encoding as what we had in CMSSW6
+    layerId_ = 10*trackerTopology->side( detId ) + trackerTopology->tidWheel( detId );
+  }
+
+  // Note module ring & wheel in endcap
+  endcapRing_  = barrel_  ?  0  :  trackerTopology->tidRing( detId );
+  endcapWheel_ = barrel_  ?  0  :  trackerTopology->tidWheel( detId );
+
+  // Get sensor strip or pixel pitch using innermost sensor of pair.
+
+  const PixelGeomDetUnit* unit = reinterpret_cast<const PixelGeomDetUnit*>( det0 );
+  const PixelTopology& topo = unit->specificTopology();
+  const Bounds& bounds = det0->surface().bounds();
+
+  std::pair<float, float> pitch = topo.pitch();
+  stripPitch_ = pitch.first; // Strip pitch (or pixel pitch along shortest axis)
+  stripLength_ = pitch.second;  //  Strip length (or pixel pitch along longest axis)
+  nStrips_ = topo.nrows(); // No. of strips in sensor
+  sensorWidth_ = bounds.width(); // Width of sensitive region of sensor (= stripPitch * nStrips).
+
+  // Note if modules are flipped back-to-front.
+  outerModuleAtSmallerR_ = ( det0->position().mag() > det1->position().mag() );
+
+  sigmaPerp_ = stripPitch_/sqrt(12.); // resolution perpendicular to strip (or to longest pixel axis)
+  sigmaPar_  = stripLength_/sqrt(12.); // resolution parallel to strip (or to longest pixel axis)
+}
+
+//=== Fill the cache (at the start of each run).
+
+void ModuleInfoCache::init(const TrackerGeometry* trackerGeometry, const TrackerTopology* trackerTopology) {
+
+  modules_.clear();
+  index_.clear();
+
+  for (const GeomDetUnit* gd : trackerGeometry->detUnits()) {
+    DetId detId = gd->geographicalId();
+    if (detId.subdetId() != StripSubdetector::TOB && detId.subdetId() != StripSubdetector::TID) continue; // Phase 2 Outer Tracker uses TOB for entire barrel & TID for entire endcap.
+    if ( ! trackerTopology->isLower(detId) ) continue; // Select only lower of the two sensors in a module.
+    // Stub.cc takes the lower sensor to have DetId one greater than the stacked module. Only cache modules for which this is true.
+    DetId stackDetId = trackerTopology->stack(detId);
+    if (detId.rawId() != stackDetId.rawId() + 1) continue;
+
+    index_[stackDetId.rawId()] = modules_.size();
+    modules_.push_back( ModuleInfo(trackerGeometry, trackerTopology, detId) );
+  }
+}
+
+}
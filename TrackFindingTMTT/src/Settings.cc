@@ -1,5 +1,7 @@
 #include <L1Trigger/TrackFindingTMTT/interface/Settings.h>
+#include "L1Trigger/TrackFindingTMTT/interface/DebugLevel.h"
 #include "FWCore/Utilities/interface/Exception.h"
+#include <iostream>
 #include <set>
 
 namespace TMTT {
@@ -43,6 +45,7 @@ Settings::Settings() {
   kalmanFillInternalHists_=false;
   kalmanMultiScattTerm_=0.00075;
   kalmanMultiScattFactor_=0.0;
+  printStageTiming_=false;
 
   // Cfg params & constants required only for HYBRID tracking (as taken from DB for TMTT).
   hybrid_=true;
@@ -93,6 +96,7 @@ Settings::Settings(const edm::ParameterSet& iConfig) :
 
   enableMCtruth_          ( iConfig.getParameter<bool>                        ( "EnableMCtruth"          ) ),
   enableHistos_           ( iConfig.getParameter<bool>                        ( "EnableHistos"           ) ),
+  disabledHistosGroups_   ( iConfig.getParameter<vector<string> >             ( "DisabledHistosGroups"   ) ),
 
   //=== Cuts on MC truth tracks used for tracking efficiency measurements.
 
@@ -322,6 +326,12 @@ Settings::Settings(const edm::ParameterSet& iConfig) :
   // tmtt_tf_analysis_cfg.py .
   writeOutEdmFile_        ( iConfig.getUntrackedParameter<bool>               ( "WriteOutEdmFile", true) ),
 
+  // Print CPU time per processing stage at end of job (for benchmarking).
+  printStageTiming_       ( iConfig.getUntrackedParameter<bool>               ( "PrintStageTiming", false) ),
+
+  // File to which the digests of the fitted tracks of each event are written (none if empty).
+  digestFileName_         ( iConfig.getUntrackedParameter<string>             ( "DigestFileName", "") ),
+
   // Bfield in Tesla. (Unknown at job initiation. Set to true value for each event
   bField_                 (0.),
 
@@ -414,6 +424,7 @@ Settings::Settings(const edm::ParameterSet& iConfig) :
 
   // Check Kalman fit params.
   if (kalmanMaxNumStubs_ < kalmanMinNumStubs_) throw cms::Exception("Settings.cc: Invalid cfg parameters - KalmanMaxNumStubs is less than KalmanMaxNumStubs.");
+  if (kalmanDebugLevel_ > TMTT_MAX_DEBUG_LEVEL) std::cout<<"Settings.cc: WARNING - KalmanDebugLevel = "<<kalmanDebugLevel_<<" but debug printout above level "<<TMTT_MAX_DEBUG_LEVEL<<" is not compiled in (see DebugLevel.h)"<<std::endl;
 
   if (firmwareType_ != 1) throw cms::Exception("Settings.cc: Invalid cfg parameter - unknown FirmwareType.");
 }
@@ -14,11 +14,6 @@
 
 using namespace TMTT;
 
-static bool pair_compare( std::pair<const Stub*, float> a, std::pair<const Stub*, float> b)
-{
-    return ( a.second < b.second);
-}
-
 // Initialize some parameters
 void SimpleLR::initRun(){
   phiMult_                    = pow(2., settings_->phiSBits())/settings_->phiSRange();
@@ -59,69 +54,188 @@ void SimpleLR::initRun(){
 }
 
 
+//=== Fit a single track candidate. 
+//=== This uses the same code as fitTracks(), with the stubs of just this track packed into the arrays.
+
 L1fittedTrack SimpleLR::fit( const L1track3D& l1track3D) {
   if(settings_->debug()==6) cout << "=============== FITTING TRACK ====================" << endl;
-  phiSectorCentre = phiSectorWidth_ * (0.5 + double(l1track3D.iPhiSec())) - M_PI; 
 
-  if(digitize_) phiSectorCentre = floor(phiSectorCentre*phiTMult_)/phiTMult_;
+  this->packStubs(&l1track3D, 1);
+  this->firstHelices();
+  return this->fitPacked(l1track3D, 0);
+}
 
-  // Inizialise track fit parameters
-  double qOverPt = 0.;
-  double phiT = 0.;
-  double phi0 = 0.;
-  double z0 = 0.;
-  double zT = 0.;
-  double tanLambda = 0.;
 
-  // Inizialise Sums
-  double SumRPhi = 0.;
-  double SumR = 0.;
-  double SumPhi = 0.;
-  double SumR2 = 0.;
-  double SumRZ = 0.;
-  double SumZ = 0.;
+//=== Fit several track candidates at once, with their stubs packed into arrays.
+//=== The arithmetic is the same as when fitting them one at a time with fit(), so the results are identical, 
+//=== but the calculations done for each stub are in loops over the stubs of all the tracks, which the compiler can vectorize.
 
-  unsigned int numStubs = 0;
-  // Calc helix parameters on Rphi Plane (STEP 1)
-  // This loop calculates the sums needed to calculate the numerators and the denominator to compute the helix parameters in the R-Phi plane (q/pT, phiT)
-  for(const Stub* stub : l1track3D.getStubs()){
-    // if((const_cast<Stub*>(stub))->psModule()){
-      numStubs++;
+vector<L1fittedTrack> SimpleLR::fitTracks(const vector<L1track3D>& l1tracks3D) {
+
+  // Fit one track at a time when debugging, so the printout of each track stays together.
+  if(settings_->debug() == 6) return TrackFitGeneric::fitTracks(l1tracks3D);
+
+  this->packStubs(l1tracks3D.data(), l1tracks3D.size());
+  this->firstHelices();
+
+  // Remove outliers & fit each track again (STEP 2)
+  vector<L1fittedTrack> fittedTracks;
+  fittedTracks.reserve(l1tracks3D.size());
+  for(unsigned int iTrk = 0; iTrk < l1tracks3D.size(); iTrk++){
+    fittedTracks.push_back( this->fitPacked(l1tracks3D[iTrk], iTrk) );
+  }
+  return fittedTracks;
+}
+
+//=== Pack the stubs of the given track candidates into the arrays used by firstHelices() & fitPacked().
+
+void SimpleLR::packStubs(const L1track3D* l1tracks3D, unsigned int nTrks) {
+  trkFirstStub_.clear();
+  bStub_.clear();
+  bTrk_.clear();
+  bR_.clear();
+  bPhi_.clear();
+  bZ_.clear();
+  bStubPhi_.clear();
+  bIPhiS_.clear();
+  bIRt_.clear();
+  bPS_.clear();
+  bBarrel_.clear();
+
+  for(unsigned int iTrk = 0; iTrk < nTrks; iTrk++){
+    const L1track3D& l1track3D = l1tracks3D[iTrk];
+    trkFirstStub_.push_back(bStub_.size());
+
+    for(const Stub* stub : l1track3D.getStubs()){
+      bStub_.push_back(stub);
+      bTrk_.push_back(iTrk);
 
       if(digitize_){
-        (const_cast<Stub*>(stub))->digitizeForHTinput(l1track3D.iPhiSec());
+        // N.B. The stubs are the copies owned by this sector, so can be redigitized here.
         (const_cast<Stub*>(stub))->digitizeForSFinput();
-        const DigitalStub digiStub = (const_cast<Stub*>(stub))->digitalStub();
-
-        SumRPhi = SumRPhi + digiStub.rt()*digiStub.phiS();
-        SumR = SumR + digiStub.rt();
-        SumPhi = SumPhi + digiStub.phiS();
-        SumR2 = SumR2 + digiStub.rt()*digiStub.rt();
-        if(settings_->debug() == 6) cout << "phiS " << digiStub.iDigi_PhiS() << " rT " << digiStub.iDigi_Rt() << " z "<< digiStub.iDigi_Z()<< endl;
+        const DigitalStub& digiStub = stub->digitalStub();
+        bR_.push_back(digiStub.rt());
+        bPhi_.push_back(digiStub.phiS());
+        bZ_.push_back(digiStub.z());
+        bIPhiS_.push_back(digiStub.iDigi_PhiS());
+        bIRt_.push_back(digiStub.iDigi_Rt());
       } else{
         float phi = 0;
-        if(l1track3D.iPhiSec() == 0 and (const_cast<Stub*>(stub))->phi() > 0){
-          phi = (const_cast<Stub*>(stub))->phi() - 2*M_PI;
-        } else if(l1track3D.iPhiSec() == settings_->numPhiSectors() and (const_cast<Stub*>(stub))->phi() < 0){
-          phi = (const_cast<Stub*>(stub))->phi() + 2*M_PI;
+        if(l1track3D.iPhiSec() == 0 and stub->phi() > 0){
+          phi = stub->phi() - 2*M_PI;
+        } else if(l1track3D.iPhiSec() == settings_->numPhiSectors() and stub->phi() < 0){
+          phi = stub->phi() + 2*M_PI;
         } else{
-          phi = (const_cast<Stub*>(stub))->phi();
+          phi = stub->phi();
         }
-        SumRPhi = SumRPhi + (const_cast<Stub*>(stub))->r()*phi;
-        SumR = SumR + (const_cast<Stub*>(stub))->r();
-        SumPhi = SumPhi + phi;
-        SumR2 = SumR2 + (const_cast<Stub*>(stub))->r()*(const_cast<Stub*>(stub))->r();
-        if(settings_->debug() == 6) cout << "phi " << phi << " r " << (const_cast<Stub*>(stub))->r() << " z "<< (const_cast<Stub*>(stub))->z()<< endl;
+        bR_.push_back(stub->r());
+        bPhi_.push_back(phi);
+        bZ_.push_back(stub->z());
+        bIPhiS_.push_back(0);
+        bIRt_.push_back(0);
       }
-    // }
+
+      bStubPhi_.push_back(stub->phi());
+      bPS_.push_back(stub->psModule());
+      bBarrel_.push_back(stub->barrel());
+    }
   }
-  
+  trkFirstStub_.push_back(bStub_.size());
+}
+
+//=== Debug printout of the coordinates of packed stub i.
+
+void SimpleLR::printPackedStub(unsigned int i) const {
+  if(digitize_){
+    const DigitalStub& digiStub = bStub_[i]->digitalStub();
+    cout << "phiS " << digiStub.iDigi_PhiS() << " rT " << digiStub.iDigi_Rt() << " z "<< digiStub.iDigi_Z()<< endl;
+  } else{
+    cout << "phi " << bPhi_[i] << " r " << bR_[i] << " z "<< bZ_[i]<< endl;
+  }
+}
+
+//=== First helix params. of each packed track candidate & residuals of its stubs w.r.t. them.
+
+void SimpleLR::firstHelices() {
+  const unsigned int nTrks  = trkFirstStub_.size() - 1;
+  const unsigned int nStubs = bStub_.size();
+
+  // Products of stub coordinates needed by the regression sums.
+  bRPhi_.resize(nStubs);
+  bR2_.resize(nStubs);
+  bRZ_.resize(nStubs);
+  for(unsigned int i = 0; i < nStubs; i++){
+    bRPhi_[i] = bR_[i]*bPhi_[i];
+    bR2_[i]   = bR_[i]*bR_[i];
+    bRZ_[i]   = bR_[i]*bZ_[i];
+  }
+
+  // Calc helix parameters on Rphi Plane of each track (STEP 1)
+  // The sums are those needed to calculate the numerators and the denominator to compute the helix parameters in the R-Phi plane (q/pT, phiT)
+  trkQoverPt_.assign(nTrks, 0.);
+  trkPhiT_.assign(nTrks, 0.);
+  trkPhi0_.assign(nTrks, 0.);
+  for(unsigned int iTrk = 0; iTrk < nTrks; iTrk++){
+    double SumRPhi = 0.;
+    double SumR = 0.;
+    double SumPhi = 0.;
+    double SumR2 = 0.;
+    for(unsigned int i = trkFirstStub_[iTrk]; i < trkFirstStub_[iTrk + 1]; i++){
+      SumRPhi += bRPhi_[i];
+      SumR    += bR_[i];
+      SumPhi  += bPhi_[i];
+      SumR2   += bR2_[i];
+    }
+    unsigned int numStubs = trkFirstStub_[iTrk + 1] - trkFirstStub_[iTrk];
+    this->firstHelix(numStubs, SumRPhi, SumR, SumPhi, SumR2, trkQoverPt_[iTrk], trkPhiT_[iTrk], trkPhi0_[iTrk]);
+
+    if(settings_->debug() == 6){
+      for(unsigned int i = trkFirstStub_[iTrk]; i < trkFirstStub_[iTrk + 1]; i++) this->printPackedStub(i);
+      const double qOverPt = trkQoverPt_[iTrk];
+      const double phiT    = trkPhiT_[iTrk];
+      if(digitize_) cout << setw(10) << "First Helix parameters: qOverPt = "<< qOverPt << " ("<< floor(qOverPt*qOverPtMult_) << "), phiT = "<< phiT <<" ("<< floor(phiT*phiTMult_)<<") "<< endl;
+      else cout << "First Helix Parameters: qOverPt = "<< qOverPt << " phi0 "<< trkPhi0_[iTrk] << endl;
+    }
+  }
+
+  // ================== RESIDUAL CALCULATION ON RPHI ========================
+  bRes_.resize(nStubs);
+  if(digitize_){
+    const double phiSFactor = pow(2., shiftingBitsDenRPhi_- shiftingBitsPt_);
+    const double phiTFactor = pow(2., shiftingBitsDenRPhi_- shiftingBitsPt_ - settings_->slr_phi0Bits() + settings_->phiSBits() );
+    for(unsigned int i = 0; i < nStubs; i++){
+      const unsigned int iTrk = bTrk_[i];
+      double ResPhi = bIPhiS_[i]*phiSFactor - floor(trkPhiT_[iTrk]*phiTMult_)*phiTFactor - floor(trkQoverPt_[iTrk]*qOverPtMult_)*bIRt_[i];
+      ResPhi = floor(ResPhi)/resMult_;
+      bRes_[i] = fabs(ResPhi);
+    }
+  } else{
+    for(unsigned int i = 0; i < nStubs; i++){
+      const unsigned int iTrk = bTrk_[i];
+      double ResPhi = reco::deltaPhi(bStubPhi_[i], trkPhi0_[iTrk] + trkQoverPt_[iTrk]*bR_[i]);
+      bRes_[i] = fabs(ResPhi);
+    }
+  }
+
+  if(settings_->debug() == 6){
+    for(unsigned int i = 0; i < nStubs; i++){
+      if(digitize_) cout << "DIGI RESIDUAL "<< bRes_[i]*resMult_ << endl;
+      if(bStub_[i]->assocTP() != nullptr) cout << " Stub Residual " << bRes_[i] << " TP " << bStub_[i]->assocTP()->index() << endl;
+      else cout << " Stub Residual " << bRes_[i] << " TP nullptr" << endl;
+    }
+  }
+
+  bKeep_.assign(nStubs, 1);
+}
+
+//=== Helix parameters from the regression sums (before outlier rejection).
+
+void SimpleLR::firstHelix(unsigned int numStubs, double SumRPhi, double SumR, double SumPhi, double SumR2,
+                          double& qOverPt, double& phiT, double& phi0) const {
   double numeratorPt, digiNumeratorPt;
   double denominator, digiDenominator;
   double numeratorPhi, digiNumeratorPhi;
   double reciprocal, digiReciprocal;
-  double numeratorZ0, digiNumeratorZ0     ;
-  double numeratorLambda, digiNumeratorLambda ;
 
   digiNumeratorPt = (numStubs*SumRPhi - SumR*SumPhi);
   digiDenominator = (numStubs*SumR2 - SumR*SumR);
@@ -146,166 +260,107 @@ L1fittedTrack SimpleLR::fit( const L1track3D& l1track3D) {
     digiReciprocal = floor(digiReciprocal/denominatorMult_);
     reciprocal = digiReciprocal*denominatorMult_;
 
-
     qOverPt = numeratorPt*reciprocal/pow(2., dividerBitsHelix_ + shiftingBitsDenRPhi_ - shiftingBitsPt_);
     phiT = numeratorPhi*reciprocal/pow(2., dividerBitsHelix_ + shiftingBitsDenRPhi_ - shiftingBitsPhi_);
-    
+
     qOverPt = floor(qOverPt*qOverPtMult_)/(qOverPtMult_);
     phiT = floor(phiT*phiTMult_)/phiTMult_;
   }
+}
 
-  if(settings_->debug() == 6 and digitize_) cout << setw(10) << "First Helix parameters: qOverPt = "<< qOverPt << " ("<< floor(qOverPt*qOverPtMult_) << "), phiT = "<< phiT <<" ("<< floor(phiT*phiTMult_)<<") "<< endl;
-
-  if(settings_->debug() == 6 and !digitize_) cout << "First Helix Parameters: qOverPt = "<< qOverPt << " phi0 "<< phi0 << endl;
-    
-
-  // ================== RESIDUAL CALCULATION ON RPHI ========================
-  std::vector<std::pair< const Stub*, double > > vRes;
-  unsigned int psStubs = 0;
-  for(const Stub* stub : l1track3D.getStubs()){
-    if((const_cast<Stub*>(stub))->psModule()) psStubs++;
-    double ResPhi;
-    
-
-    if(digitize_){
-      (const_cast<Stub*>(stub))->digitizeForHTinput(l1track3D.iPhiSec());
-      (const_cast<Stub*>(stub))->digitizeForSFinput();
-      const DigitalStub digiStub = (const_cast<Stub*>(stub))->digitalStub();
-      
-      ResPhi = digiStub.iDigi_PhiS()*pow(2., shiftingBitsDenRPhi_- shiftingBitsPt_) - floor(phiT*phiTMult_)*pow(2., shiftingBitsDenRPhi_- shiftingBitsPt_ - settings_->slr_phi0Bits() + settings_->phiSBits() ) - floor(qOverPt*qOverPtMult_)*digiStub.iDigi_Rt();
-
+//=== Fit track candidate iTrk of those packed by packStubs(), after firstHelices() has been run.
 
-      if(settings_->debug() == 6) {       
-        // cout << "floor(phiT*phiTMult_) " << floor(phiT*phiTMult_) << endl;
-        // cout << "dsp_PhiSPhiT "<< digiStub.iDigi_PhiS() - floor(phiT*phiTMult_) << " shift_right(dsp_QoverPt_Rt,divider_shift- divider_pt) "<< floor(qOverPt*qOverPtMult_)*digiStub.iDigi_Rt()/(pow(2., ShiftingBits_- shiftingBitsPt_ ) )<< " settings_->rtRange() "<< settings_->rtRange() << endl;
-       cout << "DIGI RESIDUAL "<< ResPhi << endl;}
-      ResPhi = floor(ResPhi)/resMult_;
-    } 
+L1fittedTrack SimpleLR::fitPacked(const L1track3D& l1track3D, unsigned int iTrk) {
+  const unsigned int first = trkFirstStub_[iTrk];
+  const unsigned int last  = trkFirstStub_[iTrk + 1];
 
-    else{
-      ResPhi = reco::deltaPhi((const_cast<Stub*>(stub))->phi(), phi0 + qOverPt*(const_cast<Stub*>(stub))->r());
-    }
-
-    double Res = fabs(ResPhi) ;
-    // if(digitize_) Res = floor(Res*phiMult_)/phiMult_;
+  float phiSectorCentre = phiSectorWidth_ * (0.5 + double(l1track3D.iPhiSec())) - M_PI; 
+  if(digitize_) phiSectorCentre = floor(phiSectorCentre*phiTMult_)/phiTMult_;
 
-    std::pair< const Stub*, double > ResStubPair (stub, Res);
-    vRes.push_back(ResStubPair);
-    if(settings_->debug()==6){
-      if(const_cast<Stub*>(stub)->assocTP()!= nullptr) cout << " Stub Residual " << Res << " TP " << const_cast<Stub*>(stub)->assocTP()->index() << endl;
-      else cout << " Stub Residual " << Res << " TP nullptr" << endl;    
-    }
+  // Remove stubs with largest residuals, keeping at least 4 stubs & 2 PS stubs.
+  unsigned int psStubs = 0;
+  for(unsigned int i = first; i < last; i++){
+    if(bPS_[i]) psStubs++;
   }
+  unsigned int numKept = last - first;
 
   double LargResidual = 9999.;
-  // Find largest residuals
-  while(vRes.size() > 4 and LargResidual > settings_->ResidualCut() ){
-    std::vector<std::pair< const Stub*, double > >::iterator maxResIt = max_element(vRes.begin(), vRes.end(), pair_compare );
-    LargResidual = (*maxResIt).second;
+  while(numKept > 4 and LargResidual > settings_->ResidualCut() ){
+    // Find (first) stub with largest residual, comparing them as floats, which decides ties between residuals that only differ beyond float precision.
+    unsigned int iMax = last;
+    for(unsigned int i = first; i < last; i++){
+      if(bKeep_[i] and (iMax == last or float(bRes_[iMax]) < float(bRes_[i]))) iMax = i;
+    }
+    LargResidual = bRes_[iMax];
     if(settings_->debug() == 6) cout << "Largest Residual "<< LargResidual << endl;
 
     if(LargResidual > settings_->ResidualCut()){
-      if((*maxResIt).first->psModule()){
+      if(bPS_[iMax]){
         if(psStubs > 2){
-          if(settings_->debug() == 6) cout << "removing PS residual "<< (*maxResIt).second << endl;
-          vRes.erase(maxResIt);
+          if(settings_->debug() == 6) cout << "removing PS residual "<< bRes_[iMax] << endl;
+          bKeep_[iMax] = 0;
+          numKept--;
           psStubs--;
         } else{
-          if(settings_->debug() == 6) cout << "residual "<< (*maxResIt).second << " set to -1. "<< endl;
-          (*maxResIt).second = -1.;
-
+          if(settings_->debug() == 6) cout << "residual "<< bRes_[iMax] << " set to -1. "<< endl;
+          bRes_[iMax] = -1.;
         }
       } else{
-        vRes.erase(maxResIt);
-        if(settings_->debug() == 6) cout << "removing residual "<< (*maxResIt).second << endl;
+        if(settings_->debug() == 6) cout << "removing residual "<< bRes_[iMax] << endl;
+        bKeep_[iMax] = 0;
+        numKept--;
       }
     }
-
-
   }
 
-
-
+  // Sums for the final helix params, using the remaining stubs.
   std::vector<const Stub*> fitStubs;
-  for( std::pair< const Stub*, double > ResStubPair : vRes ){
-    fitStubs.push_back(ResStubPair.first);
-  }
-
-  qOverPt = 0.;
-  phi0 = 0.;
-  phiT = 0.;
-  z0 = 0.;
-  zT = 0.;
-  tanLambda = 0.;
-  
-  SumRPhi = 0.;
-  SumR = 0.;
-  SumPhi = 0.;
-  SumR2 = 0.;
-  SumRZ = 0.;
-  SumZ = 0.;
+  double SumRPhi = 0.;
+  double SumR = 0.;
+  double SumPhi = 0.;
+  double SumR2 = 0.;
+  double SumRZ = 0.;
+  double SumZ = 0.;
   double SumR_ps = 0.;
   double SumR2_ps = 0.;
 
-  numStubs = 0;
+  unsigned int numStubs = 0;
   psStubs = 0;
 
-  for(const Stub* stub : fitStubs){
-    if((const_cast<Stub*>(stub))->psModule())
-      psStubs++;
-    
+  for(unsigned int i = first; i < last; i++){
+    if(not bKeep_[i]) continue;
+    fitStubs.push_back(bStub_[i]);
+    if(bPS_[i]) psStubs++;
     numStubs++;
-    if(digitize_){
-      (const_cast<Stub*>(stub))->digitizeForHTinput(l1track3D.iPhiSec());
-      // (const_cast<Stub*>(stub))->digitizeForSFinput();
-      const DigitalStub digiStub = (const_cast<Stub*>(stub))->digitalStub();
-      SumRPhi  += digiStub.rt()*digiStub.phiS();
-      SumR     += digiStub.rt();
-      SumPhi   += digiStub.phiS();
-      SumR2    += digiStub.rt()*digiStub.rt();
-      if((const_cast<Stub*>(stub))->psModule() ){
-        SumRZ    += digiStub.rt()*digiStub.z();
-        SumZ     += digiStub.z();
-        SumR_ps  += digiStub.rt();
-        SumR2_ps += digiStub.rt()*digiStub.rt();
-      }
-      if(settings_->debug() == 6) {
-        cout << "phiS " << digiStub.iDigi_PhiS() << " rT " << digiStub.iDigi_Rt() << " z "<< digiStub.iDigi_Z()<< endl;
-      }
-    } else{
 
-      float phi = 0;
-      if(l1track3D.iPhiSec() == 0 and (const_cast<Stub*>(stub))->phi() > 0){
-        phi = (const_cast<Stub*>(stub))->phi() - 2*M_PI;
-      } else if(l1track3D.iPhiSec() == settings_->numPhiSectors() and (const_cast<Stub*>(stub))->phi() < 0){
-        phi = (const_cast<Stub*>(stub))->phi() + 2*M_PI;
-      } else{
-        phi = (const_cast<Stub*>(stub))->phi();
-      }
-
-      SumRPhi += (const_cast<Stub*>(stub))->r()*phi;
-      SumR    += (const_cast<Stub*>(stub))->r();
-      SumPhi  += phi;
-      SumR2   += (const_cast<Stub*>(stub))->r()*(const_cast<Stub*>(stub))->r();
-      if((const_cast<Stub*>(stub))->psModule() ){
-        SumRZ   += (const_cast<Stub*>(stub))->r()*(const_cast<Stub*>(stub))->z();
-        SumZ    += (const_cast<Stub*>(stub))->z();
-        SumR_ps  += (const_cast<Stub*>(stub))->r();
-        SumR2_ps += (const_cast<Stub*>(stub))->r()*(const_cast<Stub*>(stub))->r();
-
-      }
-      if(settings_->debug() == 6) cout << "phi " << phi << " r " << (const_cast<Stub*>(stub))->r() << " z "<< (const_cast<Stub*>(stub))->z()<< endl;   }
-    
-    // }
+    SumRPhi += bRPhi_[i];
+    SumR    += bR_[i];
+    SumPhi  += bPhi_[i];
+    SumR2   += bR2_[i];
+    if(bPS_[i]){
+      SumRZ    += bRZ_[i];
+      SumZ     += bZ_[i];
+      SumR_ps  += bR_[i];
+      SumR2_ps += bR2_[i];
+    }
+    if(settings_->debug() == 6) this->printPackedStub(i);
   }
 
-  numeratorZ0       = (SumR2_ps * SumZ - SumR_ps*SumRZ);
-  numeratorLambda   = (psStubs*SumRZ - SumR_ps*SumZ);
-  numeratorPt       = (numStubs*SumRPhi - SumR*SumPhi);
-  denominator       = (numStubs*SumR2 - SumR*SumR);
-  double denominatorZ = (psStubs*SumR2_ps - SumR_ps*SumR_ps);
-  numeratorPhi      = ( SumR2 * SumPhi - SumR*SumRPhi );
-  double reciprocalZ ;
+  double qOverPt = 0.;
+  double phiT = 0.;
+  double phi0 = 0.;
+  double z0 = 0.;
+  double zT = 0.;
+  double tanLambda = 0.;
+
+  double numeratorZ0       = (SumR2_ps * SumZ - SumR_ps*SumRZ);
+  double numeratorLambda   = (psStubs*SumRZ - SumR_ps*SumZ);
+  double numeratorPt       = (numStubs*SumRPhi - SumR*SumPhi);
+  double denominator       = (numStubs*SumR2 - SumR*SumR);
+  double denominatorZ      = (psStubs*SumR2_ps - SumR_ps*SumR_ps);
+  double numeratorPhi      = ( SumR2 * SumPhi - SumR*SumRPhi );
+  double reciprocal = 0.;
+  double reciprocalZ = 0.;
   if(!digitize_){
     z0 = numeratorZ0/denominatorZ;
     tanLambda = numeratorLambda/denominatorZ;
@@ -347,11 +402,6 @@ L1fittedTrack SimpleLR::fit( const L1track3D& l1track3D) {
     phiT = floor(phiT*phiTMult_)/phiTMult_;
   }
 
-  // cout << "z0"
-
-  // qOverPt /= -invPtToDPhi_;
-
-  
   if(settings_->debug() == 6 and digitize_) {
     cout << "HT mbin "<< int(l1track3D.getCellLocationHT().first) - 16 << " cbin "<< int(l1track3D.getCellLocationHT().second) - 32 << " iPhi "<< l1track3D.iPhiSec() << " iEta "<< l1track3D.iEtaReg() << endl;
     cout << "Second Helix variables: numeratorPt = "<< numeratorPt << ", numeratorPhi = "<< numeratorPhi <<", numeratorZ0 = " << numeratorZ0 <<" numeratorLambda = " << numeratorLambda << " denominator =  "<< denominator <<" reciprocal = "<< reciprocal << " denominatorZ =  "<< denominatorZ <<" reciprocalZ = "<< reciprocalZ << endl;
@@ -360,74 +410,50 @@ L1fittedTrack SimpleLR::fit( const L1track3D& l1track3D) {
     cout << setw(10) << "Final Helix parameters: qOverPt = "<< qOverPt <<", phi0 = "<< phi0 <<", z0 = "<< z0 << ", tanLambda = "<<tanLambda << endl;
   }
 
+  // Chi2 in r-phi.
   double chi2_phi = 0.;
-  double chi2_z = 0.;
-
-  for(const Stub* stub : fitStubs){  
+  double chi2_z = 0.; // Only used by debug printout.
+  for(unsigned int i = first; i < last; i++){
+    if(not bKeep_[i]) continue;
     double ResPhi = 0.;
-    double ResZ= 0.;
     if(digitize_){
-      (const_cast<Stub*>(stub))->digitizeForHTinput(l1track3D.iPhiSec());
-      (const_cast<Stub*>(stub))->digitizeForSFinput();
-      const DigitalStub digiStub = (const_cast<Stub*>(stub))->digitalStub();
-      ResPhi = digiStub.phiS() - phiT - qOverPt*digiStub.rt();
-      ResZ   = digiStub.z() - zT - tanLambda*digiStub.rt();
-      // ResZ = digiStub.z() - z0 - tanLambda*digiStub.r();
+      ResPhi = bPhi_[i] - phiT - qOverPt*bR_[i];
     } else{
-      ResPhi = reco::deltaPhi((const_cast<Stub*>(stub))->phi(), phi0 + qOverPt*(const_cast<Stub*>(stub))->r());    
-      ResZ   = (const_cast<Stub*>(stub))->z() - z0 - tanLambda*(const_cast<Stub*>(stub))->r();
+      ResPhi = reco::deltaPhi(bStubPhi_[i], phi0 + qOverPt*bR_[i]);
     }
 
     double RPhiSigma = 0.0002;
-    float RZSigma = (const_cast<Stub*>(stub))->zErr() + fabs(tanLambda)*(const_cast<Stub*>(stub))->rErr();
-
-    if ( not (const_cast<Stub*>(stub))->barrel() )
-      RPhiSigma = 0.0004;
-
-    if(digitize_){
-      RPhiSigma = floor(RPhiSigma*phiMult_)/phiMult_;
-    }
-
-    // if(!(const_cast<Stub*>(stub))->psModule()) RZSigma = 5;
+    if(not bBarrel_[i]) RPhiSigma = 0.0004;
+    if(digitize_) RPhiSigma = floor(RPhiSigma*phiMult_)/phiMult_;
 
     ResPhi /= RPhiSigma;
-    // cout << "zT "<< zT << " tanLambda "<< t<< RZSigma << endl;
-    ResZ /= RZSigma;
-
     chi2_phi += fabs(ResPhi*ResPhi);
-    chi2_z += fabs(ResZ*ResZ);
-    if(settings_->debug()==6 ){ 
+
+    if(settings_->debug() == 6){
+      double ResZ = digitize_  ?  bZ_[i] - zT - tanLambda*bR_[i]  :  bZ_[i] - z0 - tanLambda*bR_[i];
+      float RZSigma = bStub_[i]->zErr() + fabs(tanLambda)*bStub_[i]->rErr();
+      ResZ /= RZSigma;
+      chi2_z += fabs(ResZ*ResZ);
       cout << "Stub ResPhi "<< ResPhi*RPhiSigma << " ResSigma " << RPhiSigma << " Res "<< ResPhi << " chi2 "<< chi2_phi << endl;
       cout << "Stub ResZ "<< ResZ*RZSigma << " ResSigma " << RZSigma << " Res "<< ResZ << " chi2 "<< chi2_z << endl;
-    } 
-
+    }
   }
   qOverPt /= invPtToDPhi_;
 
   bool accepted = false;
-  // double chi2 = (chi2_phi + chi2_z)/2.;
-  // double chi2 = sqrt(chi2_phi*chi2_phi + chi2_z*chi2_z)/2;
 
   double chi2 = chi2_phi;
   if(digitize_) chi2 = floor(chi2*chi2Mult_)/chi2Mult_;
-
-
-
-  // cout << "chi2 "<< chi2 << " phi "<< chi2_phi << " z "<< chi2_z << endl;
-  float dof = 2*fitStubs.size() - 4; 
-  float chi2dof = chi2/dof;
   if(chi2 < chi2cut_) accepted = true;
-  
+
   if(settings_->debug()==6) cout << "qOverPt "<< qOverPt << " phiT "<< phiT << endl;
-   
+
   // This condition can only happen if cfg param TrackFitCheat = True.
   if (fitStubs.size() < 4) accepted = false;
 
   // Kinematic cuts -- NOT YET IN FIRMWARE!!!
-  const float tolerance = 0.1;
   if (fabs(qOverPt) > 1./(settings_->houghMinPt() - 0.1)) accepted = false;
   if (fabs(z0) > 20.) accepted = false;
-  
 
   // Create the L1fittedTrack object
   L1fittedTrack fitTrk(settings_, l1track3D, fitStubs,
@@ -436,17 +462,18 @@ L1fittedTrack SimpleLR::fit( const L1track3D& l1track3D) {
 
   if(settings_->enableDigitize()) fitTrk.digitizeTrack("SimpleLR");
 
-  if(settings_->debug() == 6 and digitize_) {
-    cout << "Digitized parameters "<< endl;
-    cout << "HT mbin "<< int(l1track3D.getCellLocationHT().first) - 16 << " cbin "<< int(l1track3D.getCellLocationHT().second) - 32 << " iPhi "<< l1track3D.iPhiSec() << " iEta "<< l1track3D.iEtaReg() << endl;
-    cout << setw(10) << "First Helix parameters: qOverPt = "<< fitTrk.qOverPt() << " oneOver2r "<< fitTrk.digitaltrack().oneOver2r() <<" ("<< floor(fitTrk.digitaltrack().oneOver2r()*qOverPtMult_) << "), phi0 = "<< fitTrk.digitaltrack().phi0() <<" ("<< fitTrk.digitaltrack().iDigi_phi0rel() <<"), zT = "<< zT << " ("<<floor(zT*z0Mult_)<< "), tanLambda = "<<tanLambda<<" (" << floor(tanLambda*tanLambdaMult_) << ")"<< endl;
-  }
-  
-  if(settings_->debug()==6){
+  if(settings_->debug() == 6){
+    float dof = 2*fitStubs.size() - 4; 
+    float chi2dof = chi2/dof;
+    if(digitize_) {
+      cout << "Digitized parameters "<< endl;
+      cout << "HT mbin "<< int(l1track3D.getCellLocationHT().first) - 16 << " cbin "<< int(l1track3D.getCellLocationHT().second) - 32 << " iPhi "<< l1track3D.iPhiSec() << " iEta "<< l1track3D.iEtaReg() << endl;
+      cout << setw(10) << "First Helix parameters: qOverPt = "<< fitTrk.qOverPt() << " oneOver2r "<< fitTrk.digitaltrack().oneOver2r() <<" ("<< floor(fitTrk.digitaltrack().oneOver2r()*qOverPtMult_) << "), phi0 = "<< fitTrk.digitaltrack().phi0() <<" ("<< fitTrk.digitaltrack().iDigi_phi0rel() <<"), zT = "<< zT << " ("<<floor(zT*z0Mult_)<< "), tanLambda = "<<tanLambda<<" (" << floor(tanLambda*tanLambdaMult_) << ")"<< endl;
+    }
+
     cout << "FitTrack helix parameters "<< int(fitTrk.getCellLocationFit().first)-16 << ", "<< int(fitTrk.getCellLocationFit().second)-32 << " HT parameters "<< int(fitTrk.getCellLocationHT().first)-16 << ", " <<int(fitTrk.getCellLocationHT().second)-32 << endl;
 
     if(fitTrk.getMatchedTP() != nullptr){
-  
       cout << "VERY GOOD! "<< chi2dof << endl;
       cout << "TP qOverPt "<< fitTrk.getMatchedTP()->qOverPt() << " phi0 "<< fitTrk.getMatchedTP()->phi0() << endl;
       if(!accepted) cout << "BAD CHI2 "<< chi2 << " chi2/ndof " << chi2dof << endl;
@@ -460,4 +487,3 @@ L1fittedTrack SimpleLR::fit( const L1track3D& l1track3D) {
 
   return fitTrk;
 }
-
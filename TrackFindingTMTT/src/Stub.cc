@@ -11,8 +11,10 @@
 #include "L1Trigger/TrackFindingTMTT/interface/Stub.h"
 #include "L1Trigger/TrackFindingTMTT/interface/TP.h"
 #include "L1Trigger/TrackFindingTMTT/interface/DeadModuleDB.h"
+#include "L1Trigger/TrackFindingTMTT/interface/ModuleInfo.h"
 
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
@@ -48,7 +50,8 @@ Stub::Stub(double phi, double r, double z, double bend, int layerid, bool psModu
 //=== Store useful info about stub (for use with TMTT code).
 
 Stub::Stub(const TTStubRef& ttStubRef, unsigned int index_in_vStubs, const Settings* settings, 
-           const TrackerGeometry*  trackerGeometry, const TrackerTopology*  trackerTopology) : 
+           const TrackerGeometry*  trackerGeometry, const TrackerTopology*  trackerTopology,
+           const ModuleInfoCache* moduleInfoCache) : 
   TTStubRef(ttStubRef), 
   settings_(settings), 
   index_in_vStubs_(index_in_vStubs), 
@@ -93,17 +96,20 @@ Stub::Stub(const TTStubRef& ttStubRef, unsigned int index_in_vStubs, const Setti
   if (geoDetId.null()) throw cms::Exception("Stub: Det ID corresponding to Stub not found");
   */
 
-  // This is a faster way we found of doing the conversion. It seems to work ...
+  // Get info about the module, preferably from the cache filled at the start of the run.
   DetId stackDetid = ttStubRef->getDetId();
-  DetId geoDetId(stackDetid.rawId() + 1);
-  if ( not (trackerTopology->isLower(geoDetId) && trackerTopology->stack(geoDetId) == stackDetid) ) throw cms::Exception("Stub: determination of detId went wrong");
-
-  const GeomDetUnit* det0 = trackerGeometry->idToDetUnit( geoDetId );
-  // To get other module, can do this
-  // const GeomDetUnit* det1 = trackerGeometry->idToDetUnit( trackerTopology->partnerDetId( geoDetId ) );
-
-  const PixelGeomDetUnit* theGeomDet = dynamic_cast< const PixelGeomDetUnit* >( det0 );
-  const PixelTopology* topol = dynamic_cast< const PixelTopology* >( &(theGeomDet->specificTopology()) );
+  const ModuleInfo* moduleInfo = (moduleInfoCache != nullptr)  ?  moduleInfoCache->moduleInfo(stackDetid)  :  nullptr;
+  std::unique_ptr<ModuleInfo> uncachedModuleInfo;
+  if (moduleInfo == nullptr) {
+    // This is a faster way we found of doing the conversion. It seems to work ...
+    DetId geoDetId(stackDetid.rawId() + 1);
+    if ( not (trackerTopology->isLower(geoDetId) && trackerTopology->stack(geoDetId) == stackDetid) ) throw cms::Exception("Stub: determination of detId went wrong");
+    uncachedModuleInfo.reset( new ModuleInfo(trackerGeometry, trackerTopology, geoDetId) );
+    moduleInfo = uncachedModuleInfo.get();
+  }
+
+  const PixelGeomDetUnit* theGeomDet = moduleInfo->geomDet_;
+  const PixelTopology* topol = moduleInfo->topology_;
   MeasurementPoint measurementPoint = ttStubRef->getClusterRef(0)->findAverageLocalCoordinatesCentered();
   LocalPoint clustlp   = topol->localPosition(measurementPoint);
   GlobalPoint pos  =  theGeomDet->surface().toGlobal(clustlp);
@@ -117,7 +123,7 @@ Stub::Stub(const TTStubRef& ttStubRef, unsigned int index_in_vStubs, const Setti
   }
 
   // Set info about the module this stub is in
-  this->setModuleInfo(trackerGeometry, trackerTopology, geoDetId);
+  this->setModuleInfo(*moduleInfo);
   // Uncertainty in stub coordinates due to strip or pixel length in r-z.
   if (barrel_) {
     rErr_ = 0.;
@@ -174,7 +180,7 @@ Stub::Stub(const TTStubRef& ttStubRef, unsigned int index_in_vStubs, const Setti
   // Get stub bend that is available in front-end electronics, where bend is displacement between 
   // two hits in stubs in units of strip pitch.
   bendInFrontend_ = ttStubRef->getTriggerBend();
-  bool isEndcap = GeomDetEnumerators::isEndcap( trackerGeometry->idToDetUnit( geoDetId )->subDetector() );
+  bool isEndcap = moduleInfo->endcap_;
   if (isEndcap && pos.z() > 0) bendInFrontend_ *= -1;
   // EJC Bend in barrel seems to be flipped in tilted geom.
   if (barrel_) bendInFrontend_ *= -1;
@@ -468,9 +474,9 @@ double Stub::getApproxB() {
 }
 
 //=== Note which tracking particle(s), if any, produced this stub.
-//=== The 1st argument is a map relating TrackingParticles to TP.
+//=== The 1st argument relates TrackingParticles to TP.
 
-void Stub::fillTruth(const map<edm::Ptr< TrackingParticle >, const TP* >& translateTP, const edm::Handle<TTStubAssMap>& mcTruthTTStubHandle, const edm::Handle<TTClusterAssMap>& mcTruthTTClusterHandle){
+void Stub::fillTruth(const TPtranslator& translateTP, const edm::Handle<TTStubAssMap>& mcTruthTTStubHandle, const edm::Handle<TTClusterAssMap>& mcTruthTTClusterHandle){
 
   TTStubRef ttStubRef(*this); // Cast to base class
 
@@ -482,10 +488,8 @@ void Stub::fillTruth(const map<edm::Ptr< TrackingParticle >, const TP* >& transl
   // Require same TP contributed to both clusters.
   if ( genuine ) {
     edm::Ptr< TrackingParticle > tpPtr = mcTruthTTStubHandle->findTrackingParticlePtr(ttStubRef);
-    if (translateTP.find(tpPtr) != translateTP.end()) {
-      assocTP_ = translateTP.at(tpPtr);
-      // N.B. Since not all tracking particles are stored in InputData::vTPs_, sometimes no match will be found.
-    }
+    assocTP_ = translateTP.find(tpPtr);
+    // N.B. Since not all tracking particles are stored in InputData::vTPs_, sometimes no match will be found.
   }
 
   // Fill assocTPs_ info.
@@ -505,11 +509,10 @@ void Stub::fillTruth(const map<edm::Ptr< TrackingParticle >, const TP* >& transl
       // Now identify all TP's contributing to either cluster in stub.
       vector< edm::Ptr< TrackingParticle > > vecTpPtr = mcTruthTTClusterHandle->findTrackingParticlePtrs(ttClusterRef);
 
-      for (edm::Ptr< TrackingParticle> tpPtr : vecTpPtr) {
-  if (translateTP.find(tpPtr) != translateTP.end()) {
-    assocTPs_.insert( translateTP.at(tpPtr) );
-    // N.B. Since not all tracking particles are stored in InputData::vTPs_, sometimes no match will be found.
-  }
+      for (const edm::Ptr< TrackingParticle>& tpPtr : vecTpPtr) {
+        const TP* tp = translateTP.find(tpPtr);
+        if (tp != nullptr) assocTPs_.insert( tp );
+        // N.B. Since not all tracking particles are stored in InputData::vTPs_, sometimes no match will be found.
       }
     }
   }
@@ -525,11 +528,8 @@ void Stub::fillTruth(const map<edm::Ptr< TrackingParticle >, const TP* >& transl
     // Only consider clusters produced by just one TP.
     if ( genuineCluster ) {
       edm::Ptr< TrackingParticle > tpPtr = mcTruthTTClusterHandle->findTrackingParticlePtr(ttClusterRef);
-
-      if (translateTP.find(tpPtr) != translateTP.end()) {
-  assocTPofCluster_[iClus] = translateTP.at(tpPtr);
-  // N.B. Since not all tracking particles are stored in InputData::vTPs_, sometimes no match will be found.
-      }
+      assocTPofCluster_[iClus] = translateTP.find(tpPtr);
+      // N.B. Since not all tracking particles are stored in InputData::vTPs_, sometimes no match will be found.
     }
   }
 
@@ -606,84 +606,44 @@ unsigned int Stub::layerIdReduced() const {
 
 //=== Set info about the module that this stub is in.
 
-void Stub::setModuleInfo(const TrackerGeometry* trackerGeometry, const TrackerTopology* trackerTopology, const DetId& detId) {
-
-  idDet_ = detId;
-
-  // Note if module is PS or 2S, and whether in barrel or endcap.
-  psModule_ = trackerGeometry->getDetectorType( detId ) == TrackerGeometry::ModuleType::Ph2PSP; // From https://github.com/cms-sw/cmssw/blob/CMSSW_8_1_X/Geometry/TrackerGeometryBuilder/README.md
-  barrel_ = detId.subdetId()==StripSubdetector::TOB || detId.subdetId()==StripSubdetector::TIB;
-
-  // Get min & max (r,phi,z) coordinates of the centre of the two sensors containing this stub.
-  const GeomDetUnit* det0 = trackerGeometry->idToDetUnit( detId );
-  const GeomDetUnit* det1 = trackerGeometry->idToDetUnit( trackerTopology->partnerDetId( detId ) );
-
-  float R0 = det0->position().perp();
-  float R1 = det1->position().perp();
-  float PHI0 = det0->position().phi();
-  float PHI1 = det1->position().phi();
-  float Z0 = det0->position().z();
-  float Z1 = det1->position().z();
-  moduleMinR_   = std::min(R0,R1);
-  moduleMaxR_   = std::max(R0,R1);
-  moduleMinPhi_ = std::min(PHI0,PHI1);
-  moduleMaxPhi_ = std::max(PHI0,PHI1);
-  moduleMinZ_   = std::min(Z0,Z1);
-  moduleMaxZ_   = std::max(Z0,Z1);
-
-  // Note if tilted barrel module & get title angle (in range 0 to PI).
-  tiltedBarrel_ = barrel_ && (trackerTopology->tobSide(detId) != 3);
-  float deltaR = fabs(R1 - R0);
-  float deltaZ = (R1 - R0 > 0)  ?  (Z1 - Z0)  :  - (Z1 - Z0);
-  moduleTilt_  = atan2( deltaR, deltaZ);
-  if (moduleTilt_ >  M_PI/2.) moduleTilt_ -= M_PI; // Put in range -PI/2 to +PI/2.
-  if (moduleTilt_ < -M_PI/2.) moduleTilt_ += M_PI; // 
-
-  // cout<<"DEBUG STUB "<<barrel_<<" "<<psModule_<<"  sep(r,z)=( "<<moduleMaxR_ - moduleMinR_<<" , "<<moduleMaxZ_ - moduleMinZ_<<" )    stub(r,z)=( "<<0.5*(moduleMaxR_ + moduleMinR_) - r_<<" , "<<0.5*(moduleMaxZ_ + moduleMinZ_) - z_<<" )"<<endl;
-
-  // Encode layer ID.
-  if (barrel_) {
-    layerId_ = trackerTopology->layer( detId ); // barrel layer 1-6 encoded as 1-6
-  } else {
-    // layerId_ = 10*detId.iSide() + detId.iDisk(); // endcap layer 1-5 encoded as 11-15 (endcap A) or 21-25 (endcapB)
-    // EJC This seems to give the same encoding as what we had in CMSSW6
-    layerId_ = 10*trackerTopology->side( detId ) + trackerTopology->tidWheel( detId );
-  }
+void Stub::setModuleInfo(const ModuleInfo& moduleInfo) {
+
+  idDet_ = moduleInfo.detId_;
+
+  psModule_ = moduleInfo.psModule_;
+  barrel_   = moduleInfo.barrel_;
+
+  moduleMinR_   = moduleInfo.moduleMinR_;
+  moduleMaxR_   = moduleInfo.moduleMaxR_;
+  moduleMinPhi_ = moduleInfo.moduleMinPhi_;
+  moduleMaxPhi_ = moduleInfo.moduleMaxPhi_;
+  moduleMinZ_   = moduleInfo.moduleMinZ_;
+  moduleMaxZ_   = moduleInfo.moduleMaxZ_;
+
+  tiltedBarrel_ = moduleInfo.tiltedBarrel_;
+  moduleTilt_   = moduleInfo.moduleTilt_;
 
-  // Note module ring in endcap
-  endcapRing_ = barrel_  ?  0  :  trackerTopology->tidRing( detId );
+  layerId_    = moduleInfo.layerId_;
+  endcapRing_ = moduleInfo.endcapRing_;
 
   if (trackerGeometryVersion_ == "T5") {
     if ( ! barrel_) {
       // Apply bodge, since Topology class annoyingly starts ring count at 1, even in endcap wheels where
       // inner rings are absent.
-      unsigned int iWheel = trackerTopology->tidWheel( detId );
+      unsigned int iWheel = moduleInfo.endcapWheel_;
       if (iWheel >= 3 && iWheel <=5) endcapRing_ += 3;
     }
   }
 
-  // Get sensor strip or pixel pitch using innermost sensor of pair.
+  stripPitch_  = moduleInfo.stripPitch_;
+  stripLength_ = moduleInfo.stripLength_;
+  nStrips_     = moduleInfo.nStrips_;
+  sensorWidth_ = moduleInfo.sensorWidth_;
 
-  const PixelGeomDetUnit* unit = reinterpret_cast<const PixelGeomDetUnit*>( det0 );
-  const PixelTopology& topo = unit->specificTopology();
-  const Bounds& bounds = det0->surface().bounds();
-
-  std::pair<float, float> pitch = topo.pitch();
-  stripPitch_ = pitch.first; // Strip pitch (or pixel pitch along shortest axis)
-  stripLength_ = pitch.second;  //  Strip length (or pixel pitch along longest axis)
-  nStrips_ = topo.nrows(); // No. of strips in sensor
-  sensorWidth_ = bounds.width(); // Width of sensitive region of sensor (= stripPitch * nStrips).
-
-  // Note if modules are flipped back-to-front.
-  outerModuleAtSmallerR_ = ( det0->position().mag() > det1->position().mag() );
-  /*
-  if ( barrel_ && det0->position().perp() > det1->position().perp() ) {
-    outerModuleAtSmallerR_ = true;
-  }
-  */
+  outerModuleAtSmallerR_ = moduleInfo.outerModuleAtSmallerR_;
 
-  sigmaPerp_ = stripPitch_/sqrt(12.); // resolution perpendicular to strip (or to longest pixel axis)
-  sigmaPar_  = stripLength_/sqrt(12.); // resolution parallel to strip (or to longest pixel axis)
+  sigmaPerp_ = moduleInfo.sigmaPerp_;
+  sigmaPar_  = moduleInfo.sigmaPar_;
 }
 
 //=== Determine tracker geometry version by counting modules.
@@ -0,0 +1,135 @@
+#include "L1Trigger/TrackFindingTMTT/interface/StubSectorAssigner.h"
+#include "L1Trigger/TrackFindingTMTT/interface/Stub.h"
+#include "L1Trigger/TrackFindingTMTT/interface/Settings.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace TMTT {
+
+//=== Initialize constants from configuration parameters.
+
+StubSectorAssigner::StubSectorAssigner(const Settings* settings) :
+  numPhiSectors_     ( settings->numPhiSectors() ),
+  numEtaRegions_     ( settings->numEtaRegions() ),
+  sectorHalfWidth_   ( M_PI / float(numPhiSectors_) ), // Sector half width excluding overlaps, as in Sector.cc
+  chosenRofPhi_      ( settings->chosenRofPhi() ),
+  minPt_             ( settings->houghMinPt() ),
+  useStubPhi_        ( settings->useStubPhi() ),
+  useStubPhiTrk_     ( settings->useStubPhiTrk() ),
+  assumedPhiTrkRes_  ( settings->assumedPhiTrkRes() ),
+  handleStripsPhiSec_( settings->handleStripsPhiSec() ),
+  chosenRofZ_        ( settings->chosenRofZ() ),
+  beamWindowZ_       ( settings->beamWindowZ() ),
+  handleStripsEtaSec_( settings->handleStripsEtaSec() ),
+  candidates_        ( numPhiSectors_, numEtaRegions_ )
+{
+  // Range in z at r = ChosenRofZ covered by each eta region, as in Sector.cc. These increase with the region number.
+  for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
+    float etaMin = settings->etaRegions()[iEtaReg];
+    float etaMax = settings->etaRegions()[iEtaReg + 1];
+    zOuterMin_.push_back( chosenRofZ_ / tan( 2. * atan(exp(-etaMin)) ) );
+    zOuterMax_.push_back( chosenRofZ_ / tan( 2. * atan(exp(-etaMax)) ) );
+  }
+}
+
+//=== Find the candidate sectors of all the stubs.
+
+void StubSectorAssigner::assign(const vector<const Stub*>& vStubs) {
+  for (unsigned int iPhiSec = 0; iPhiSec < numPhiSectors_; iPhiSec++) {
+    for (unsigned int iEtaReg = 0; iEtaReg < numEtaRegions_; iEtaReg++) {
+      candidates_(iPhiSec, iEtaReg).clear();
+    }
+  }
+
+  for (const Stub* stub : vStubs) {
+    const pair<int, unsigned int>          phiRange = this->phiSecRange(stub);
+    const pair<unsigned int, unsigned int> etaRange = this->etaRegRange(stub);
+    for (unsigned int i = 0; i < phiRange.second; i++) {
+      int iPhi = (phiRange.first + int(i)) % int(numPhiSectors_);
+      if (iPhi < 0) iPhi += numPhiSectors_;
+      for (unsigned int iEtaReg = etaRange.first; iEtaReg < etaRange.first + etaRange.second; iEtaReg++) {
+        candidates_(iPhi, iEtaReg).push_back(stub);
+      }
+    }
+  }
+}
+
+//=== Range of candidate phi sectors of a stub (first sector & number of sectors, to be taken modulo the number of phi sectors).
+
+pair<int, unsigned int> StubSectorAssigner::phiSecRange(const Stub* stub) const {
+
+  // Sector::insidePhi() requires the stub phi and/or the track phi estimated from the stub bend to be within
+  // the sector half-width plus a tolerance of the sector centre. Use whichever of these gives the narrowest range.
+  float phiRef  = 0.;
+  float halfArc = M_PI;
+  if (useStubPhi_) {
+    phiRef  = stub->phi();
+    halfArc = sectorHalfWidth_ + stub->phiDiff(chosenRofPhi_, minPt_);
+  }
+  if (useStubPhiTrk_) {
+    pair<float, float> phiTrk = stub->trkPhiAtR( chosenRofPhi_ );
+    // Sector::insidePhi() may reduce this tolerance (CalcPhiTrkRes), but never increases it.
+    float halfArcTrk = sectorHalfWidth_ + assumedPhiTrkRes_ * (2*sectorHalfWidth_);
+    if (handleStripsPhiSec_) halfArcTrk += phiTrk.second;
+    if ( ( ! useStubPhi_) || halfArcTrk < halfArc) {
+      phiRef  = phiTrk.first;
+      halfArc = halfArcTrk;
+    }
+  }
+  if ( ! (useStubPhi_ || useStubPhiTrk_) ) return pair<int, unsigned int>(0, numPhiSectors_);
+
+  // Allow for the change in stub phi, bend & r caused by digitisation for the phi sector.
+  halfArc += sectorHalfWidth_;
+
+  // Sector i has its centre at phi = (i + 0.5)*sectorWidth - PI.
+  const float sectorWidth = 2*sectorHalfWidth_;
+  int iMin = int(ceil ( (phiRef - halfArc + M_PI)/sectorWidth - 0.5 ));
+  int iMax = int(floor( (phiRef + halfArc + M_PI)/sectorWidth - 0.5 ));
+  if (iMax - iMin + 1 >= int(numPhiSectors_)) return pair<int, unsigned int>(0, numPhiSectors_);
+  if (iMax < iMin) return pair<int, unsigned int>(0, 0);
+  return pair<int, unsigned int>(iMin, iMax - iMin + 1);
+}
+
+//=== Range of candidate eta regions of a stub (first region & number of regions).
+
+pair<unsigned int, unsigned int> StubSectorAssigner::etaRegRange(const Stub* stub) const {
+
+  // A track from z0 (|z0| < beamWindowZ) through the stub at (r,z) has z = z0 + (z - z0)*chosenRofZ/r at r = chosenRofZ.
+  // Find the range of this, allowing for the uncertainty in the stub (r,z) if Sector::insideEta() does so.
+  // (The extremes are at the corners of the (r,z) uncertainty region, as z at r = chosenRofZ is monotonic in both).
+  float rMin = stub->r();
+  float rMax = stub->r();
+  float zMin = stub->z();
+  float zMax = stub->z();
+  if (handleStripsEtaSec_) {
+    rMin = max(rMin - stub->rErr(), float(1.));
+    rMax += stub->rErr();
+    zMin -= stub->zErr();
+    zMax += stub->zErr();
+  }
+  float zTrkMin =  999999.;
+  float zTrkMax = -999999.;
+  const float rStub[2] = {rMin, rMax};
+  const float zStub[2] = {zMin, zMax};
+  for (unsigned int i = 0; i < 2; i++) {
+    for (unsigned int j = 0; j < 2; j++) {
+      float zTrk   = zStub[j] * chosenRofZ_ / rStub[i];
+      float spread = beamWindowZ_ * fabs(1. - chosenRofZ_ / rStub[i]);
+      zTrkMin = min(zTrkMin, zTrk - spread);
+      zTrkMax = max(zTrkMax, zTrk + spread);
+    }
+  }
+
+  // The stub can be inside eta regions with zOuterMax > zTrkMin and zOuterMin < zTrkMax.
+  int iMin = upper_bound(zOuterMax_.begin(), zOuterMax_.end(), zTrkMin) - zOuterMax_.begin();
+  int iMax = int(lower_bound(zOuterMin_.begin(), zOuterMin_.end(), zTrkMax) - zOuterMin_.begin()) - 1;
+
+  // Allow for the change in stub (r,z) caused by digitisation.
+  iMin = max(iMin - 1, 0);
+  iMax = min(iMax + 1, int(numEtaRegions_) - 1);
+  if (iMax < iMin) return pair<unsigned int, unsigned int>(0, 0);
+  return pair<unsigned int, unsigned int>(iMin, iMax - iMin + 1);
+}
+
+}
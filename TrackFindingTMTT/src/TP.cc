@@ -40,13 +40,9 @@ TP::TP(const TrackingParticlePtr& tpPtr, unsigned int index_in_vTPs, const Setti
 
 //=== Fill truth info with association from tracking particle to stubs.
 
-void TP::fillTruth(const vector<Stub>& vStubs) {
+void TP::fillTruth(vector<const Stub*> assocStubs) {
 
-  for (const Stub& s : vStubs) {
-    for (const TP* tp_i : s.assocTPs()) {
-      if (tp_i -> index() == this->index()) assocStubs_.push_back(&s);
-    }
-  }
+  assocStubs_ = std::move(assocStubs);
 
   this->fillUseForAlgEff(); // Fill useForAlgEff_ flag.
 
@@ -0,0 +1,63 @@
+#include "L1Trigger/TrackFindingTMTT/interface/TrackDigest.h"
+#include "L1Trigger/TrackFindingTMTT/interface/L1fittedTrack.h"
+#include "L1Trigger/TrackFindingTMTT/interface/Stub.h"
+
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+
+namespace TMTT {
+
+//=== Add a fitted track.
+
+void TrackDigest::add(const L1fittedTrack& fitTrk) {
+  this->addWord(fitTrk.iPhiSec());
+  this->addWord(fitTrk.iEtaReg());
+  this->addFloat(fitTrk.qOverPt());
+  this->addFloat(fitTrk.d0());
+  this->addFloat(fitTrk.phi0());
+  this->addFloat(fitTrk.z0());
+  this->addFloat(fitTrk.tanLambda());
+  this->addFloat(fitTrk.chi2());
+  const vector<const Stub*>& stubs = fitTrk.getStubs();
+  this->addWord(stubs.size());
+  for (const Stub* s : stubs) {
+    this->addWord(s->index());
+  }
+  n_++;
+}
+
+//=== Add all fitted tracks of a collection.
+
+void TrackDigest::add(const vector<L1fittedTrack>& fitTrks) {
+  for (const L1fittedTrack& fitTrk : fitTrks) {
+    this->add(fitTrk);
+  }
+}
+
+//=== Digest as 16 digit hexadecimal string.
+
+string TrackDigest::str() const {
+  ostringstream oss;
+  oss << hex << setw(16) << setfill('0') << hash_;
+  return oss.str();
+}
+
+//=== Hash one 64 bit word (little endian byte order).
+
+void TrackDigest::addWord(uint64_t word) {
+  for (unsigned int i = 0; i < 8; i++) {
+    hash_ ^= (word >> (8*i)) & 0xff;
+    hash_ *= 1099511628211ULL;
+  }
+}
+
+//=== Hash the bit pattern of a float, so the digest only agrees if the values are identical.
+
+void TrackDigest::addFloat(float x) {
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  this->addWord(bits);
+}
+
+}
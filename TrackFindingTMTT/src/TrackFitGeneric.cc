@@ -29,6 +29,17 @@ TrackFitGeneric::TrackFitGeneric( const Settings* settings, const string &fitter
 L1fittedTrack TrackFitGeneric::fit(const L1track3D& l1track3D) {
   return L1fittedTrack (settings_, l1track3D, l1track3D.getStubs(), 0, 0, 0, 0, 0, 999999., 0);
 }
+
+//=== Fit several track candidates, returning one fitted track for each.
+
+vector<L1fittedTrack> TrackFitGeneric::fitTracks(const vector<L1track3D>& l1tracks3D) {
+  vector<L1fittedTrack> fittedTracks;
+  fittedTracks.reserve(l1tracks3D.size());
+  for (const L1track3D& l1track3D : l1tracks3D) {
+    fittedTracks.push_back( this->fit(l1track3D) );
+  }
+  return fittedTracks;
+}
  
 TrackFitGeneric* TrackFitGeneric::create(std::string fitter, const Settings* settings) {
     if (fitter.compare("ChiSquared4ParamsApprox")==0) {
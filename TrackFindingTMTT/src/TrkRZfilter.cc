@@ -63,6 +63,14 @@ void TrkRZfilter::init(const Settings* settings, unsigned int iPhiSec, unsigned
   // Reject tracks whose estimated rapidity from seed filter is inconsistent range of with eta sector. (Kills some duplicate tracks).
   zTrkSectorCheck_     = settings->zTrkSectorCheck();
 
+  // Layers allowed for the first & second seeding stubs.
+  const unsigned int firstSeedLayers[]  = {1,2,11,21,3,12,22,4};
+  const unsigned int secondSeedLayers[] = {1,2,11,3,21,22,12,23,13,4};
+  firstSeedLayerMask_ = 0;
+  secondSeedLayerMask_ = 0;
+  for (unsigned int layerId : firstSeedLayers)  firstSeedLayerMask_  |= (1u << layerId);
+  for (unsigned int layerId : secondSeedLayers) secondSeedLayerMask_ |= (1u << layerId);
+
   // For debugging
   minNumMatchLayers_ = settings->minNumMatchLayers();
 
@@ -138,128 +146,150 @@ vector<L1track3D> TrkRZfilter::filterTracks(const vector<L1track2D>& tracks) {
   return filteredTracks;
 }
 
+//=== Sort the stubs of a track candidate by layer, and copy their coordinates into the arrays used by the Seed Filter.
+
+void TrkRZfilter::fillSeedFilterArrays(const vector<const Stub*>& stubs) {
+  sfStubs_ = stubs;
+  std::sort(sfStubs_.begin(), sfStubs_.end(), SortStubsInLayer());
+
+  const unsigned int nStubs = sfStubs_.size();
+  sfR_.resize(nStubs);
+  sfZ_.resize(nStubs);
+  sfRErr_.resize(nStubs);
+  sfZErr_.resize(nStubs);
+  sfLayerId_.resize(nStubs);
+  sfOnSeedLine_.resize(nStubs);
+  sfLayerRange_.clear();
+  sfFirstSeeds_.clear();
+  sfSecondSeeds_.clear();
+
+  for (unsigned int i = 0; i < nStubs; i++) {
+    const Stub* s = sfStubs_[i];
+    sfR_[i]       = s->r();
+    sfZ_[i]       = s->z();
+    sfRErr_[i]    = s->rErr();
+    sfZErr_[i]    = s->zErr();
+    sfLayerId_[i] = s->layerId();
+
+    // Note range of stubs in each layer (which are contiguous after sorting).
+    if (i == 0 || sfLayerId_[i] != sfLayerId_[i - 1]) sfLayerRange_.push_back( pair<unsigned int, unsigned int>(i, i) );
+    sfLayerRange_.back().second = i + 1;
+
+    // Note if stub can be used for seeding.
+    if (s->psModule() && sfLayerId_[i] < 32) {
+      const unsigned int layerBit = (1u << sfLayerId_[i]);
+      if (firstSeedLayerMask_  & layerBit) sfFirstSeeds_.push_back(i);
+      if (secondSeedLayerMask_ & layerBit) sfSecondSeeds_.push_back(i);
+    }
+  }
+}
+
 //=== Use Seed Filter to produce a filtered collection of stubs on this track candidate that are consistent with a straight line 
 //=== in r-z using tracklet algo.
 
 vector<const Stub*> TrkRZfilter::seedFilter(const std::vector<const Stub*>& stubs, float trkQoverPt, bool print) {
     unsigned int numLayers; //Num of Layers in the cell after that filter has been applied 
-    std::vector<const Stub*> filtStubs = stubs;   // Copy stubs vector in filtStubs
     bool FirstSeed = true;
-    const int FirstSeedLayers[] = {1,2,11,21,3,12,22,4}; //Allowed layers for the first seeding stubs
-    const int SecondSeedLayers[] = {1,2,11,3,21,22,12,23,13,4};//Allowed layers for the second seeding stubs
     set<const Stub*> uniqueFilteredStubs;
 
     unsigned int numSeedCombinations = 0; // Counter for number of seed combinations considered.
     unsigned int numGoodSeedCombinations = 0; // Counter for number of seed combinations considered with z0 within beam spot length.
     vector<const Stub*> filteredStubs; // Filter Stubs vector to be returned
+    vector<const Stub*> tempStubs;  // Temporary container for stubs on current seed
   
     unsigned int oldNumLay = 0; //Number of Layers counter, used to keep the seed with more layers 
-  
-    std::sort(filtStubs.begin(), filtStubs.end(), SortStubsInLayer());
-
-    // Loop over stubs in the HT Cell
-    for(const Stub* s0: filtStubs){
-        // Select the first available seeding stub (r<70)
-        if(s0->psModule() && std::find(std::begin(FirstSeedLayers), std::end(FirstSeedLayers), s0->layerId()) != std::end(FirstSeedLayers)) {
-            unsigned int numSeedsPerStub = 0;
-
-            for(const Stub* s1: filtStubs){ 
-                if (numGoodSeedCombinations < maxGoodSeedCombinations_ && numSeedCombinations < maxSeedCombinations_ && numSeedsPerStub < maxSeedsPerStub_) {
-                    // Select the second seeding stub (r<90)
-                    if(s1->psModule() && s1->layerId() > s0->layerId() &&  std::find(std::begin(SecondSeedLayers), std::end(SecondSeedLayers), s1->layerId()) != std::end(SecondSeedLayers) ){
-                        numSeedsPerStub++;
-                        numSeedCombinations++; //Increase filter cycles counter
-                        if(print) cout << "s0: "<< "z: "<< s0->z() << ", r: "<< s0->r() << ", id:" << s0->layerId() << " ****** s1: "<< "z: "<< s1->z() << ", r: "<< s1->r() << ", id:" << s1->layerId() << endl;
-                        double sumSeedDist = 0., oldSumSeedDist = 1000000.; //Define variable used to estimate the quality of seeds
-                        vector<const Stub*> tempStubs;  //Create a temporary container for stubs
-                        tempStubs.push_back(s0); //Store the first seeding stub in the temporary container
-                        tempStubs.push_back(s1); //Store the second seeding stub in the temporary container
-
-                        double z0 = s1->z() + (-s1->z()+s0->z())*s1->r()/(s1->r()-s0->r()); // Estimate a value of z at the beam spot using the two seeding stubs
-                        //double z0err = s1->zErr() + ( s1->zErr() + s0->zErr() )*s1->r()/fabs(s1->r()-s0->r()) + fabs(-s1->z()+s0->z())*(s1->rErr()*fabs(s1->r()-s0->r()) + s1->r()*(s1->rErr() + s0->rErr()) )/((s1->r()-s0->r())*(s1->r()-s0->r())); 
-                        float zTrk = s1->z() + (-s1->z()+s0->z())*(s1->r()-chosenRofZ_)/(s1->r()-s0->r()); // Estimate a value of z at a chosen Radius using the two seeding stubs
-                        float zTrkErr = s1->zErr() + ( s1->zErr() + s0->zErr() )*fabs(s1->r()-chosenRofZ_)/fabs(s1->r()-s0->r()) + fabs(-s1->z()+s0->z())*(s1->rErr()*fabs(s1->r()-s0->r()) + fabs(s1->r()-chosenRofZ_)*(s1->rErr() + s0->rErr()) )/((s1->r()-s0->r())*(s1->r()-s0->r()));
-                        float leftZtrk = zTrk*fabs(s1->r()-s0->r());
-                        float rightZmin = zTrkMinSector_*fabs(s1->r()-s0->r());
-                        float rightZmax = zTrkMaxSector_*fabs(s1->r()-s0->r());
-
-                        // If z0 is within the beamspot range loop over the other stubs in the cell
-                        //if (fabs(z0)<=beamWindowZ_+z0err) {
-                        if (fabs(z0)<=beamWindowZ_) {
-                            // Check track r-z helix parameters are consistent with it being assigned to current rapidity sector (kills duplicates due to overlapping sectors).
-                            // if ( (! zTrkSectorCheck_) || (zTrk > zTrkMinSector_ - zTrkErr && zTrk < zTrkMaxSector_ + zTrkErr) ) {
-                            if ( (! zTrkSectorCheck_) || (leftZtrk > rightZmin  && leftZtrk < rightZmax ) ) {
-                                numGoodSeedCombinations++;
-                                unsigned int LiD = 0; //Store the layerId of the stub (KEEP JUST ONE STUB PER LAYER)
-//                                double oldseed = 1000.; //Store the seed value of the current stub (KEEP JUST ONE STUB PER LAYER)
-
-                                // Loop over stubs in vector different from the seeding stubs
-                                for(const Stub* s: filtStubs){
-                                    // if(s!= s0 && s!= s1){
-                                        // Calculate the seed and its tolerance
-                                        double seedDist = (s->z() - s1->z())*(s1->r()-s0->r()) - (s->r() - s1->r())*(s1->z() - s0->z());                        
-                                        double seedDistRes = (s->zErr()+ s1->zErr() )*fabs(s1->r()-s0->r()) + (s->rErr()+s1->rErr())*fabs(s1->z() - s0->z()) + (s0->zErr()+s1->zErr())*fabs(s->r() - s1->r()) + (s0->rErr()+s1->rErr())*fabs(s->z() - s1->z());
-                                        seedDistRes += seedResolution_; // Add extra configurable contribution to assumed resolution.
-                                        //If seed is lower than the tolerance push back the stub (KEEP JUST ONE STUB PER LAYER, NOT ENABLED BY DEFAULT)
-                                        if(fabs(seedDist) <= seedDistRes){
-                                           // if(s->layerId()==LiD){
-                                                //if(fabs(seedDist)<fabs(oldseed)){
-                                                    //tempStubs.pop_back();
-                                                    //tempStubs.push_back(s);
-                                                    //LiD = s->layerId();
-                                                   // sumSeedDist = sumSeedDist + fabs(seedDist) - fabs(oldseed);
-                                                   // oldseed = seedDist;
-                                                //}
-                                           // } else {
-                                           if(s->layerId() != LiD and s->layerId() != s0->layerId() and s->layerId() != s1->layerId()){
-                                                tempStubs.push_back(s);
-                                                LiD = s->layerId();
-                                              //  oldseed = seedDist;
-                                                //sumSeedDist = sumSeedDist + fabs(seedDist);
-                                            }        
-                                        }      
-           
-                                        //If stub lies on the seeding line, store it in the tempstubs vector                          
-                                        // if(fabs(seedDist) <= seedDistRes){
-                                        //   tempStubs.push_back(s);
-                                        //   sumSeedDist = sumSeedDist + fabs(seedDist); //Increase the seed quality variable
-                                        // }
-                                    // }
-                                }
-                            }
-                        }
 
-                        numLayers = Utility::countLayers(settings_, tempStubs); // Count the number of layers in the temporary stubs container
-                        //sumSeedDist = sumSeedDist/(tempStubs.size()); //Measure the average seed quality per stub for the current seed
-
-                        // Check if the current seed has more layers then the previous one (Keep the best seed)
-                        if(keepAllSeed_ == false){
-                            if(numLayers > oldNumLay ){
-                                // Check if the current seed has better quality than the previous one
-                                //if(sumSeedDist < oldSumSeedDist){
-                                    filteredStubs = tempStubs; //Copy the temporary stubs vector in the filteredStubs vector, which will be returned
-                                  //  oldSumSeedDist = sumSeedDist; //Update value of oldSumSeedDist
-                                    oldNumLay = numLayers; //Update value of oldNumLay
-                                    rzHelix_z0_ = z0; //Store estimated z0
-                                    rzHelix_tanL_ = (s1->z() -s0->z())/(s1->r()-s0->r()); // Store estimated tanLambda
-                                    rzHelix_set_ = true; 
-                                }
-                            //}
-                        } else {
-                            // Check if the current seed satisfies the minimum layers requirement (Keep all seed algorithm)
-                            if (numLayers >= Utility::numLayerCut("SEED", settings_, iPhiSec_, iEtaReg_, fabs(trkQoverPt))) {
-                                uniqueFilteredStubs.insert(tempStubs.begin(), tempStubs.end()); //Insert the uniqueStub set
-                                
-                                // If these are the first seeding stubs store the values of z0 and tanLambda
-                                if(FirstSeed){
-                                    FirstSeed = false; 
-                                    rzHelix_z0_ = z0; //Store estimated z0
-                                    rzHelix_tanL_ = (s1->z() -s0->z())/(s1->r()-s0->r()); // Store estimated tanLambda
-                                    rzHelix_set_ = true;
-                                }
+    // Sort stubs by layer, noting their coordinates and which of them can be used as seeding stubs.
+    this->fillSeedFilterArrays(stubs);
+    const unsigned int nStubs = sfStubs_.size();
+
+    // Loop over stubs that can be the first seeding stub (PS with r<70).
+    for (unsigned int i0 : sfFirstSeeds_) {
+        // Stop if maximum number of seed combinations reached.
+        if (numGoodSeedCombinations >= maxGoodSeedCombinations_ || numSeedCombinations >= maxSeedCombinations_) break;
+
+        const Stub* s0 = sfStubs_[i0];
+        unsigned int numSeedsPerStub = 0;
+
+        // Loop over stubs that can be the second seeding stub (PS with r<90), which must be in a later layer.
+        for (unsigned int i1 : sfSecondSeeds_) {
+            if (sfLayerId_[i1] <= sfLayerId_[i0]) continue;
+            if (numGoodSeedCombinations >= maxGoodSeedCombinations_ || numSeedCombinations >= maxSeedCombinations_ || numSeedsPerStub >= maxSeedsPerStub_) break;
+
+            const Stub* s1 = sfStubs_[i1];
+            numSeedsPerStub++;
+            numSeedCombinations++; //Increase filter cycles counter
+            if(print) cout << "s0: "<< "z: "<< s0->z() << ", r: "<< s0->r() << ", id:" << s0->layerId() << " ****** s1: "<< "z: "<< s1->z() << ", r: "<< s1->r() << ", id:" << s1->layerId() << endl;
+            tempStubs.clear();
+            tempStubs.push_back(s0); //Store the first seeding stub in the temporary container
+            tempStubs.push_back(s1); //Store the second seeding stub in the temporary container
+
+            double z0 = s1->z() + (-s1->z()+s0->z())*s1->r()/(s1->r()-s0->r()); // Estimate a value of z at the beam spot using the two seeding stubs
+            float zTrk = s1->z() + (-s1->z()+s0->z())*(s1->r()-chosenRofZ_)/(s1->r()-s0->r()); // Estimate a value of z at a chosen Radius using the two seeding stubs
+            float leftZtrk = zTrk*fabs(s1->r()-s0->r());
+            float rightZmin = zTrkMinSector_*fabs(s1->r()-s0->r());
+            float rightZmax = zTrkMaxSector_*fabs(s1->r()-s0->r());
+
+            // If z0 is within the beamspot range loop over the other stubs in the cell
+            if (fabs(z0)<=beamWindowZ_) {
+                // Check track r-z helix parameters are consistent with it being assigned to current rapidity sector (kills duplicates due to overlapping sectors).
+                if ( (! zTrkSectorCheck_) || (leftZtrk > rightZmin  && leftZtrk < rightZmax ) ) {
+                    numGoodSeedCombinations++;
+
+                    // Check which stubs lie on the seeding line, within the tolerance. 
+                    // (Done for all stubs at once, in a loop without branches, so it can be vectorized).
+                    const float r1 = s1->r();
+                    const float z1 = s1->z();
+                    const float dr01 = s1->r() - s0->r();
+                    const float dz01 = s1->z() - s0->z();
+                    const float zErr1 = s1->zErr();
+                    const float rErr1 = s1->rErr();
+                    const float zErr01 = s0->zErr() + s1->zErr();
+                    const float rErr01 = s0->rErr() + s1->rErr();
+                    for (unsigned int i = 0; i < nStubs; i++) {
+                        double seedDist = (sfZ_[i] - z1)*dr01 - (sfR_[i] - r1)*dz01;
+                        double seedDistRes = (sfZErr_[i] + zErr1)*fabs(dr01) + (sfRErr_[i] + rErr1)*fabs(dz01) + zErr01*fabs(sfR_[i] - r1) + rErr01*fabs(sfZ_[i] - z1);
+                        seedDistRes += seedResolution_; // Add extra configurable contribution to assumed resolution.
+                        sfOnSeedLine_[i] = (fabs(seedDist) <= seedDistRes);
+                    }
+
+                    // Keep the first stub on the seeding line in each layer, other than the layers of the seeding stubs.
+                    for (const pair<unsigned int, unsigned int>& range : sfLayerRange_) {
+                        const unsigned int layerId = sfLayerId_[range.first];
+                        if (layerId == sfLayerId_[i0] || layerId == sfLayerId_[i1]) continue;
+                        for (unsigned int i = range.first; i < range.second; i++) {
+                            if (sfOnSeedLine_[i]) {
+                                tempStubs.push_back(sfStubs_[i]);
+                                break;
                             }
                         }
-                    }   
+                    }
+                }
+            }
+
+            numLayers = Utility::countLayers(settings_, tempStubs); // Count the number of layers in the temporary stubs container
+
+            // Check if the current seed has more layers then the previous one (Keep the best seed)
+            if(keepAllSeed_ == false){
+                if(numLayers > oldNumLay ){
+                    filteredStubs = tempStubs; //Copy the temporary stubs vector in the filteredStubs vector, which will be returned
+                    oldNumLay = numLayers; //Update value of oldNumLay
+                    rzHelix_z0_ = z0; //Store estimated z0
+                    rzHelix_tanL_ = (s1->z() -s0->z())/(s1->r()-s0->r()); // Store estimated tanLambda
+                    rzHelix_set_ = true; 
+                }
+            } else {
+                // Check if the current seed satisfies the minimum layers requirement (Keep all seed algorithm)
+                if (numLayers >= Utility::numLayerCut("SEED", settings_, iPhiSec_, iEtaReg_, fabs(trkQoverPt))) {
+                    uniqueFilteredStubs.insert(tempStubs.begin(), tempStubs.end()); //Insert the uniqueStub set
+                    
+                    // If these are the first seeding stubs store the values of z0 and tanLambda
+                    if(FirstSeed){
+                        FirstSeed = false; 
+                        rzHelix_z0_ = z0; //Store estimated z0
+                        rzHelix_tanL_ = (s1->z() -s0->z())/(s1->r()-s0->r()); // Store estimated tanLambda
+                        rzHelix_set_ = true;
+                    }
                 }
             }
         }
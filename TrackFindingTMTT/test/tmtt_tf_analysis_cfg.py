@@ -46,6 +46,9 @@ options.register('makeStubs',0,VarParsing.VarParsing.multiplicity.singleton,VarP
 # (Warning: you may need to edit the associator python below to specify which track fitter you are using).
 options.register('outputDataset',0,VarParsing.VarParsing.multiplicity.singleton,VarParsing.VarParsing.varType.int,"Create GEN-SIM-DIGI-RAW dataset containing TMTT L1 tracks")
 
+#--- Specify whether to print the time spent in each stage of the TMTT chain at the end of the job (for benchmarking).
+options.register('stageTiming',0,VarParsing.VarParsing.multiplicity.singleton,VarParsing.VarParsing.varType.int,"Print time per processing stage")
+
 options.parseArguments()
 
 #--- input and output
@@ -93,6 +96,9 @@ process.load('L1Trigger.TrackFindingTMTT.TMTrackProducer_cff')
 #                                "KF4ParamsComb"
 #                                )
 
+if options.stageTiming == 1:
+  process.TMTrackProducer.PrintStageTiming = cms.untracked.bool(True)
+
 # If the input samples contain stubs and the truth association, then you can just use the following path
 process.p = cms.Path(process.TMTrackProducer)
 
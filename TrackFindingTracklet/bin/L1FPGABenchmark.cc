@@ -0,0 +1,461 @@
+//////////////////////////////////////////////////////////////////
+//                                                              //
+//  Standalone benchmark of the tracklet emulation.             //
+//                                                              //
+//  Runs the full sector chain (FPGA.icc) on events read from   //
+//  an ASCII stub file, as written by the L1FPGATrackProducer   //
+//  with asciiFileName, without the framework. All events are   //
+//  read into memory before processing. The first 'warmup'      //
+//  events are processed and not timed, then the event sample   //
+//  is processed 'repeat' times and the throughput and the      //
+//  per stage timing are reported.                              //
+//                                                              //
+//  The digests of the output tracks of each event and of the   //
+//  run can be written with -digest and compared to a stored    //
+//  reference with -reference. The job fails (exit code 2) if   //
+//  the tracks differ from the reference or between passes.     //
+//                                                              //
+//  L1FPGABenchmark -events <file> [-nevents N] [-warmup N]     //
+//     [-repeat N] [-memories <file>] [-processes <file>]       //
+//     [-wires <file>] [-fitpattern <file>] [-dtclinks <file>]  //
+//     [-modulecabling <file>] [-hybrid 0|1] [-doKF 0|1]        //
+//     [-validateTC 0|1] [-profile <file>]                      //
+//     [-memorystats <file>] [-digest <file>]                   //
+//     [-reference <file>]                                      //
+//                                                              //
+//////////////////////////////////////////////////////////////////
+
+#include "L1Trigger/TrackFindingTracklet/interface/slhcevent.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/L1TBarrel.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/L1TDisk.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/L1TStub.hh"
+
+#include "L1Trigger/TrackFindingTracklet/interface/FPGAConstants.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGASettings.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGASector.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGASetup.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGAWord.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGATimer.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGAProfiler.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGAStatistics.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGATrackDigest.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGATrackletCalculator.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/IMATH_TrackletCalculator.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGACabling.hh"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <sys/resource.h>
+
+using namespace std;
+
+class L1FPGABenchmark{
+
+public:
+
+  L1FPGABenchmark(){
+    context=0;
+    scratch=0;
+    sectors=0;
+    profiler_=0;
+    statistics_=0;
+  }
+
+  ~L1FPGABenchmark(){
+    delete profiler_;
+    delete statistics_;
+    delete context;
+    delete scratch;
+  }
+
+  void init(string memoryModulesFile, string processingModulesFile,
+	    string wiresFile, string fitPatternFile,
+	    string DTCLinkFile, string moduleCablingFile,
+	    string profileFileName, string memoryStatsFileName) {
+
+    settings.check();
+
+    FPGAInitConstants();
+
+    cout << "cabling DTC links :     "<<DTCLinkFile<<endl;
+    cout << "module cabling :     "<<moduleCablingFile<<endl;
+
+    cabling.init(DTCLinkFile.c_str(),moduleCablingFile.c_str());
+
+    cout << "fit pattern :     "<<fitPatternFile<<endl;
+    cout << "process modules : "<<processingModulesFile<<endl;
+    cout << "memory modules :  "<<memoryModulesFile<<endl;
+    cout << "wires          :  "<<wiresFile<<endl;
+
+    fitpatternfile=fitPatternFile;
+
+    context=new FPGAContext(&settings);
+    scratch=new FPGAScratch();
+
+    sectors=FPGACreateSectors(&settings,context,scratch,memoryModulesFile,processingModulesFile,wiresFile);
+
+    if (profileFileName!="") {
+      profiler_=new FPGAProfiler();
+      profiler_->addStage("clean",&cleanTimer);
+      profiler_->addStage("addStub",&addStubTimer);
+      profiler_->addStage("VMRouter",&VMRouterTimer);
+      profiler_->addStage("TrackletEngine",&TETimer);
+      profiler_->addStage("TrackletCalculator",&TCTimer);
+      profiler_->addStage("ProjectionTransceiver",&PTTimer);
+      profiler_->addStage("ProjectionRouter",&PRTimer);
+      profiler_->addStage("MatchEngine",&METimer);
+      profiler_->addStage("MatchCalculator",&MCTimer);
+      profiler_->addStage("MatchProcessor",&MPTimer);
+      profiler_->addStage("MatchTransceiver",&MTTimer);
+      profiler_->addStage("FitTrack",&FTTimer);
+      profiler_->addStage("PurgeDuplicate",&PDTimer);
+      for (unsigned int i=0;i<NSector;i++) {
+	sectors[i]->setProfiler(profiler_);
+      }
+    }
+
+    if (memoryStatsFileName!="") {
+      statistics_=new FPGAStatistics();
+      for (unsigned int i=0;i<NSector;i++) {
+	sectors[i]->setStatistics(statistics_);
+      }
+    }
+
+  }
+
+  //Runs the emulation on one event and returns the number of
+  //tracks after duplicate removal. The digest of the tracks is
+  //returned in digest.
+  unsigned int process(SLHCEvent& ev, FPGATrackDigest& digest) {
+
+    if (profiler_) profiler_->beginEvent();
+
+    bool first=true;
+
+    std::vector<FPGATrack*> tracks;
+
+    int selectmu=0;
+    L1SimTrack simtrk(0,0,0,0.0,0.0,0.0,0.0,0.0,0.0);
+
+    ofstream outres;
+
+    int nlayershit=0;
+
+#include "L1Trigger/TrackFindingTracklet/plugins/FPGA.icc"
+
+    if (statistics_) statistics_->fillEvent();
+
+    digest.reset();
+    digest.add(tracks);
+
+    return digest.n();
+
+  }
+
+  //Clears the stage and module timers, e.g. after the warm-up
+  void resetTimers() {
+    if (profiler_) profiler_->reset();
+    cleanTimer=FPGATimer();
+    addStubTimer=FPGATimer();
+    VMRouterTimer=FPGATimer();
+    TETimer=FPGATimer();
+    TCTimer=FPGATimer();
+    PTTimer=FPGATimer();
+    PRTimer=FPGATimer();
+    METimer=FPGATimer();
+    MCTimer=FPGATimer();
+    MPTimer=FPGATimer();
+    MTTimer=FPGATimer();
+    FTTimer=FPGATimer();
+    PDTimer=FPGATimer();
+  }
+
+  void printStage(string name, const FPGATimer& timer, double total) const {
+    cout << setw(24) << name
+	 << setw(10) << timer.ntimes()
+	 << setw(14) << timer.avgtime()*1.0e3
+	 << setw(14) << timer.rms()*1.0e3
+	 << setw(14) << timer.tottime()
+	 << setw(10) << (total>0.0?100.0*timer.tottime()/total:0.0)
+	 << endl;
+  }
+
+  void printStages(double total) const {
+    cout << setw(24) << "stage"
+	 << setw(10) << "ncalls"
+	 << setw(14) << "avg [ms]"
+	 << setw(14) << "rms [ms]"
+	 << setw(14) << "total [s]"
+	 << setw(10) << "%"
+	 << endl;
+    printStage("clean",cleanTimer,total);
+    printStage("addStub",addStubTimer,total);
+    printStage("VMRouter",VMRouterTimer,total);
+    printStage("TrackletEngine",TETimer,total);
+    printStage("TrackletCalculator",TCTimer,total);
+    printStage("ProjectionTransceiver",PTTimer,total);
+    printStage("ProjectionRouter",PRTimer,total);
+    printStage("MatchEngine",METimer,total);
+    printStage("MatchCalculator",MCTimer,total);
+    printStage("MatchProcessor",MPTimer,total);
+    printStage("MatchTransceiver",MTTimer,total);
+    printStage("FitTrack",FTTimer,total);
+    printStage("PurgeDuplicate",PDTimer,total);
+  }
+
+  FPGASettings settings;
+  FPGAContext* context;
+  FPGAScratch* scratch;
+  FPGASector** sectors;
+  FPGACabling cabling;
+
+  FPGAProfiler* profiler_;
+  FPGAStatistics* statistics_;
+
+  FPGATimer cleanTimer;
+  FPGATimer addStubTimer;
+  FPGATimer VMRouterTimer;
+  FPGATimer TETimer;
+  FPGATimer TCTimer;
+  FPGATimer PTTimer;
+  FPGATimer PRTimer;
+  FPGATimer METimer;
+  FPGATimer MCTimer;
+  FPGATimer MPTimer;
+  FPGATimer MTTimer;
+  FPGATimer FTTimer;
+  FPGATimer PDTimer;
+
+};
+
+
+void usage() {
+  cout << "Usage: L1FPGABenchmark -events <file> [-nevents N] [-warmup N] [-repeat N]"<<endl;
+  cout << "         [-memories <file>] [-processes <file>] [-wires <file>]"<<endl;
+  cout << "         [-fitpattern <file>] [-dtclinks <file>] [-modulecabling <file>]"<<endl;
+  cout << "         [-hybrid 0|1] [-doKF 0|1] [-validateTC 0|1]"<<endl;
+  cout << "         [-profile <file>] [-memorystats <file>]"<<endl;
+  cout << "         [-digest <file>] [-reference <file>]"<<endl;
+}
+
+
+//Peak resident set size of the process in MB
+double peakRSS() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF,&usage)!=0) return 0.0;
+  return usage.ru_maxrss/1024.0;
+}
+
+
+//Reads the event digests and the run digest written with -digest. The
+//file has one line 'event <ntracks> <digest>' per event followed by a
+//line 'run <nevents> <digest>'. Returns false if it can not be read.
+bool readDigests(string fileName, std::vector<string>& eventDigests, string& runDigest) {
+  ifstream in(fileName.c_str());
+  if (!in.good()) return false;
+  string key, digest;
+  unsigned int n;
+  while (in>>key>>n>>digest) {
+    if (key=="event") eventDigests.push_back(digest);
+    if (key=="run") runDigest=digest;
+  }
+  return runDigest!="";
+}
+
+
+int main(int argc, char** argv) {
+
+  string eventsFile="";
+  unsigned int nevents=100;
+  unsigned int nwarmup=5;
+  unsigned int nrepeat=3;
+
+  string memoryModulesFile="memorymodules_hourglass.dat";
+  string processingModulesFile="processingmodules_hourglass.dat";
+  string wiresFile="wires_hourglass.dat";
+  string fitPatternFile="fitpattern.txt";
+  string DTCLinkFile="calcNumDTCLinks.txt";
+  string moduleCablingFile="modules_T5v3_27SP_nonant_tracklet.dat";
+
+  string profileFileName="";
+  string memoryStatsFileName="";
+  string digestFileName="";
+  string referenceFileName="";
+
+  L1FPGABenchmark bench;
+
+  for (int i=1;i<argc;i++) {
+    string opt=argv[i];
+    if (i+1>=argc) {
+      cout << "Missing value for option "<<opt<<endl;
+      usage();
+      return 1;
+    }
+    string val=argv[++i];
+    if (opt=="-events") eventsFile=val;
+    else if (opt=="-nevents") nevents=atoi(val.c_str());
+    else if (opt=="-warmup") nwarmup=atoi(val.c_str());
+    else if (opt=="-repeat") nrepeat=atoi(val.c_str());
+    else if (opt=="-memories") memoryModulesFile=val;
+    else if (opt=="-processes") processingModulesFile=val;
+    else if (opt=="-wires") wiresFile=val;
+    else if (opt=="-fitpattern") fitPatternFile=val;
+    else if (opt=="-dtclinks") DTCLinkFile=val;
+    else if (opt=="-modulecabling") moduleCablingFile=val;
+    else if (opt=="-hybrid") bench.settings.setHybrid(atoi(val.c_str())!=0);
+    else if (opt=="-doKF") bench.settings.setDoKF(atoi(val.c_str())!=0);
+    else if (opt=="-validateTC") bench.settings.setValidateTC(atoi(val.c_str())!=0);
+    else if (opt=="-profile") profileFileName=val;
+    else if (opt=="-memorystats") memoryStatsFileName=val;
+    else if (opt=="-digest") digestFileName=val;
+    else if (opt=="-reference") referenceFileName=val;
+    else {
+      cout << "Unknown option "<<opt<<endl;
+      usage();
+      return 1;
+    }
+  }
+
+  if (eventsFile=="") {
+    usage();
+    return 1;
+  }
+
+  bench.init(memoryModulesFile,processingModulesFile,wiresFile,fitPatternFile,
+	     DTCLinkFile,moduleCablingFile,profileFileName,memoryStatsFileName);
+
+  cout << "Will read events from "<<eventsFile<<endl;
+
+  ifstream in(eventsFile.c_str());
+  if (!in.good()) {
+    cout << "Could not open "<<eventsFile<<endl;
+    return 1;
+  }
+
+  std::vector<SLHCEvent> events;
+  while (in.good()&&events.size()<nevents) {
+    SLHCEvent ev(in);
+    if (in.fail()) break;
+    events.push_back(ev);
+  }
+
+  cout << "Read "<<events.size()<<" events"<<endl;
+  if (events.empty()) return 1;
+
+  FPGATrackDigest digest;
+
+  for (unsigned int i=0;i<nwarmup;i++) {
+    bench.process(events[i%events.size()],digest);
+  }
+
+  bench.resetTimers();
+
+  FPGATimer eventTimer;
+  unsigned long ntracks=0;
+
+  std::vector<FPGATrackDigest> eventDigests(events.size());
+  std::vector<unsigned int> eventTracks(events.size());
+  unsigned int nunstable=0;
+
+  for (unsigned int irepeat=0;irepeat<nrepeat;irepeat++) {
+    for (unsigned int i=0;i<events.size();i++) {
+      eventTimer.start();
+      unsigned int n=bench.process(events[i],digest);
+      eventTimer.stop();
+      if (irepeat==0) {
+	ntracks+=n;
+	eventDigests[i]=digest;
+	eventTracks[i]=n;
+      } else if (digest.value()!=eventDigests[i].value()) {
+	if (nunstable<10) {
+	  cout << "Event "<<i<<" : tracks in pass "<<irepeat
+	       <<" differ from the first pass"<<endl;
+	}
+	nunstable++;
+      }
+    }
+  }
+
+  FPGATrackDigest runDigest;
+  for (unsigned int i=0;i<events.size();i++) {
+    runDigest.add(eventDigests[i]);
+  }
+
+  cout << endl;
+  cout << "Events per pass     : "<<events.size()<<endl;
+  cout << "Warm-up events      : "<<nwarmup<<endl;
+  cout << "Timed passes        : "<<nrepeat<<endl;
+  cout << "Tracks per pass     : "<<ntracks<<endl;
+  cout << "Time per event [ms] : "<<eventTimer.avgtime()*1.0e3
+       <<" +- "<<eventTimer.rms()*1.0e3<<endl;
+  cout << "Events/s            : "
+       <<(eventTimer.tottime()>0.0?eventTimer.ntimes()/eventTimer.tottime():0.0)<<endl;
+  cout << "Peak RSS [MB]       : "<<peakRSS()<<endl;
+  cout << "Track digest        : "<<runDigest.str()<<endl;
+  cout << endl;
+
+  bench.printStages(eventTimer.tottime());
+
+  if (bench.profiler_!=0) {
+    cout << "Writing profiling report to "<<profileFileName<<endl;
+    bench.profiler_->writeReport(profileFileName);
+  }
+  if (bench.statistics_!=0) {
+    cout << "Writing memory statistics to "<<memoryStatsFileName<<endl;
+    bench.statistics_->writeReport(memoryStatsFileName);
+  }
+
+  if (digestFileName!="") {
+    cout << "Writing track digests to "<<digestFileName<<endl;
+    ofstream out(digestFileName.c_str());
+    for (unsigned int i=0;i<events.size();i++) {
+      out << "event "<<eventTracks[i]<<" "<<eventDigests[i].str()<<endl;
+    }
+    out << "run "<<events.size()<<" "<<runDigest.str()<<endl;
+  }
+
+  bool failed=false;
+
+  if (nunstable!=0) {
+    cout << "ERROR: the tracks of "<<nunstable
+	 <<" events differ between passes"<<endl;
+    failed=true;
+  }
+
+  if (referenceFileName!="") {
+    std::vector<string> refEventDigests;
+    string refRunDigest;
+    if (!readDigests(referenceFileName,refEventDigests,refRunDigest)) {
+      cout << "ERROR: could not read reference digests from "<<referenceFileName<<endl;
+      failed=true;
+    } else if (refEventDigests.size()!=events.size()) {
+      cout << "ERROR: reference "<<referenceFileName<<" has "<<refEventDigests.size()
+	   <<" events, processed "<<events.size()<<endl;
+      failed=true;
+    } else if (refRunDigest!=runDigest.str()) {
+      unsigned int ndiff=0;
+      for (unsigned int i=0;i<events.size();i++) {
+	if (refEventDigests[i]==eventDigests[i].str()) continue;
+	if (ndiff<10) {
+	  cout << "Event "<<i<<" : digest "<<eventDigests[i].str()
+	       <<" reference "<<refEventDigests[i]<<endl;
+	}
+	ndiff++;
+      }
+      cout << "ERROR: tracks of "<<ndiff<<" events differ from the reference "
+	   <<referenceFileName<<endl;
+      failed=true;
+    } else {
+      cout << "Tracks agree with the reference "<<referenceFileName<<endl;
+    }
+  }
+
+  if (failed) return 2;
+
+  return 0;
+
+}
@@ -10,9 +10,9 @@ class FPGAAllProjections:public FPGAMemoryBase{
 
 public:
 
-  FPGAAllProjections(string name, unsigned int iSector, 
+  FPGAAllProjections(string name, const FPGASettings* settings, unsigned int iSector, 
 		     double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
     string subname=name.substr(8,2);
@@ -55,6 +55,7 @@ public:
   }
 
   unsigned int nTracklets() const {return tracklets_.size();}
+  unsigned int nEntries() const {return nTracklets();}
 
   FPGATracklet* getFPGATracklet(unsigned int i) const {return tracklets_[i];}
 
@@ -14,9 +14,9 @@ class FPGAAllStubs:public FPGAMemoryBase{
 
 public:
 
-  FPGAAllStubs(string name, unsigned int iSector, 
+  FPGAAllStubs(string name, const FPGASettings* settings, unsigned int iSector, 
 	       double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
     string subname=name.substr(3,2);
@@ -59,6 +59,7 @@ public:
   }
 
   unsigned int nStubs() const {return stubs_.size();}
+  unsigned int nEntries() const {return nStubs();}
 
   FPGAStub* getFPGAStub(unsigned int i) const {return stubs_[i].first;}
   L1TStub* getL1TStub(unsigned int i) const {return stubs_[i].second;}
@@ -13,9 +13,9 @@ class FPGACandidateMatch:public FPGAMemoryBase{
 
 public:
 
-  FPGACandidateMatch(string name, unsigned int iSector, 
+  FPGACandidateMatch(string name, const FPGASettings* settings, unsigned int iSector, 
 		     double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
     string subname=name.substr(8,2);
@@ -67,6 +67,7 @@ public:
   }
 
   unsigned int nMatches() const {return matches_.size();}
+  unsigned int nEntries() const {return nMatches();}
 
   FPGATracklet* getFPGATracklet(unsigned int i) const {return matches_[i].first;}
   std::pair<FPGAStub*,L1TStub*> getStub(unsigned int i) const {return matches_[i].second;}
@@ -11,9 +11,9 @@ class FPGACleanTrack:public FPGAMemoryBase{
 
 public:
 
-  FPGACleanTrack(string name, unsigned int iSector, 
+  FPGACleanTrack(string name, const FPGASettings* settings, unsigned int iSector, 
 	       double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
   }
@@ -23,6 +23,7 @@ public:
   }
 
   unsigned int nTracks() const {return tracks_.size();}
+  unsigned int nEntries() const {return nTracks();}
 
   void clean() {
     //cout << "Cleaning tracks : "<<tracks_.size()<<endl;
@@ -4,25 +4,19 @@
 //Uncomment if you want root output
 //#define USEROOT
 
-//Uncomment to run the hybrid algorithm
-#define USEHYBRID
+//The hybrid/tracklet choice, doKF, nHelixPar, TMUX, the truncation
+//limits and the duplicate removal options are run time settings,
+//see FPGASettings.hh
 
 //Uncomment to run the HLS version of the KF if using the Hybrid (instead of the C++ KF).
 //(Please also follow the instructions in L1Trigger/TrackFindingTMTT/README_HLS.txt).
 //#define USE_HLS
 
-static unsigned int nHelixPar = 4; // 4 or 5 param helix fit.
-
-static bool doKF=true; //true if using KF (and USEHYBRID uncommented)
-static bool printDebugKF=false; // if true print lots of debugging statements related to the KF fit
-
 static bool hourglass=true;
 
 //Gemetry extensions
 static std::string geomext=hourglass?"hourglass":"new";  
 
-static int TMUX = 6;
-
 static std::string fitpatternfile="fitpattern.txt";
 
 //If this string is non-empty we will write ascii file with
@@ -34,18 +28,12 @@ static std::string skimfile="";
 static bool dumppars=false;
 static bool dumpproj=false;
 
-static bool writeVerilog=false;     //Write out Verilog mudules for TCs
-static bool writeHLS=false;         //Write out HLS mudules for TCs
-static bool writeInvTable=false;    //Write out tables of drinv and invt in tracklet calculator for Verilog module
-static bool writeHLSInvTable=false; //Write out tables of drinv and invt in tracklet calculator for HLS module
-
 static bool writeFitDerTable=false; //Write out track derivative tables
 
 static int nbitsd0=13;
 static double kd0 = 2*10./(1<<nbitsd0);
 
 
-static bool writeDTCLinks=false;
 static bool writeIL=false;
 static bool writeStubsLayer=false;
 static bool writeStubsLayerperSector=false;
@@ -80,10 +68,7 @@ static bool writeTrackletParsDisk=false;
 
 static bool writeAllCT=false; //write out .dat file containing all output tracks in bitwise format
 
-static bool writeVariance=false; //write out residuals for variand matrix determination
 static bool writeResEff=false; //write files for making resolution & efficiency plots for standable code version
-static bool writePars=false; //write files for making plots of track parameters
-static bool writeMatchEff=false; //write files for making plots with truth matched efficiency
 
 
 
@@ -101,6 +86,7 @@ static int alphaBitsTable=2; //For number of bits in track derivative table
 static int nrinvBitsTable=3; //number of bits for tabulating rinv dependence
 static bool writetrace=false; //Print out details about startup
 static bool debug1=false; //Print detailed debug information about tracking
+                          //(needs -DFPGA_LOG_LEVEL=2, see FPGALog.hh)
 static bool writeoutReal = false; 
 static bool writemem=false; //Note that for 'full' detector this will open
                             //a LOT of files, and the program will run excruciatingly slow
@@ -122,8 +108,6 @@ static bool doD3D4=true;
 static bool doL1D1=true;
 static bool doL2D1=true;
 
-static bool allSector=false; //if true duplicate stubs in all sectors
-
 static bool doProjections=true;
 
 static const int MEBinsBits=3;
@@ -278,19 +262,7 @@ static const double routerPSdisk=65.0;
 //static int NMAXstub  = 250;
 //static int NMAXroute = 250;
 
-static unsigned int MAXOFFSET=10000; //set to 0 for regular truncation
-
-static unsigned int MAXSTUBSLINK = (hourglass?108:54) + MAXOFFSET; //Max stubs per link
-static unsigned int MAXLAYERROUTER = (hourglass?108:54) + MAXOFFSET; //Max stubs handled by layer router
-static unsigned int MAXDISKROUTER = (hourglass?108:54) + MAXOFFSET; //Max stubs handled by disk router
-static unsigned int MAXVMROUTER = (hourglass?108:54) + MAXOFFSET; //Max stubs handled by VM router
-static unsigned int MAXTE = (hourglass?108:54) + MAXOFFSET; //Maximum number of stub pairs to try in TE 
-static unsigned int MAXTC = (hourglass?108:54) + MAXOFFSET; //Maximum number of tracklet parameter calculations
-//static unsigned int MAXPROJECTIONTRANSCEIVER = 10000; //Maximum number of projections to neighbor
-static unsigned int MAXPROJROUTER = (hourglass?108:54) + MAXOFFSET; //Maximum number of projections to route
-static unsigned int MAXME = (hourglass?108:54) + MAXOFFSET; //Maximum number of stub-projection matches to try
-static unsigned int MAXMC = (hourglass?108:54) + MAXOFFSET; //Maximum number of match calculations
-static unsigned int MAXFIT = (hourglass?108:54) + MAXOFFSET; //Maximum number of track fits
+//The truncation limits (MAXOFFSET, MAXVMROUTER, MAXTE, ...) are in FPGASettings
 
 
 static double dphisector=two_pi/NSector;
@@ -389,7 +361,7 @@ const int SS_rderD_shift   = -6;
 //constants derivative from the above
 static double krinvpars, kphi0pars, kd0pars, ktpars, kz0pars;
 static double kphiproj123, kphiproj456, kzproj, kphider, kzder;
-static double krprojshiftdisk, kphiprojdisk,krprojderdisk;
+static double krprojshiftdisk, kphiprojdisk, kphiprojderdisk, krprojderdisk;
 static double krdisk,krprojderdiskshift, kzpars;
 
 //numbers needed for matches & fit, unclear what they are.
@@ -397,7 +369,6 @@ static int idrinvbits=19;
 static int phi0bitshift=1;
 static int rinvbitshift=13;
 static int tbitshift=9;
-static int z0bitshift=0;
 static int phiderbitshift=7;
 static int zderbitshift=6;
 static int t2bits=23;
@@ -428,10 +399,7 @@ static int rcorrbits=6;
 static int chisqphifactbits=14;
 static int chisqzfactbits=14;
 
-//Duplicate Removal
-static int minIndStubs=3;
-static bool AdjacentRemoval=true;
-static std::string RemovalType="ichi";
+//Duplicate Removal options are in FPGASettings:
 //"ichi" (pairwise, keep track with best ichisq), "nstub" (pairwise, keep track with more stubs), "grid" (TMTT-like removal), "" (no removal)
 
 #endif
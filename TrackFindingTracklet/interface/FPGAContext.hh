@@ -0,0 +1,162 @@
+//This class holds the lookup tables and configuration objects that are
+//shared by all sectors. It is filled once, after the constants have been
+//set, and is only read during the event processing, so it can be shared
+//by threads that process different sectors. The mutable state is owned by
+//the processing modules (e.g. the KF fitters) or is per-thread scratch
+//(FPGAScratch: the IMATH calculators and the debug files).
+#ifndef FPGACONTEXT_H
+#define FPGACONTEXT_H
+
+#include <iostream>
+#include <cassert>
+
+#include "FPGAConstants.hh"
+#include "FPGASettings.hh"
+#include "FPGAStub.hh"
+#include "FPGAVMRouterPhiCorrTable.hh"
+#include "FPGATrackDerTable.hh"
+#include "FPGATETableOuter.hh"
+#include "FPGATETableInner.hh"
+#include "FPGATETableOuterDisk.hh"
+#include "FPGATETableInnerDisk.hh"
+#include "FPGATETableInnerOverlap.hh"
+#include "FPGAProjectionRouterBendTable.hh"
+
+#include "L1Trigger/TrackFindingTMTT/interface/Settings.h"
+
+using namespace std;
+
+class FPGAContext{
+
+public:
+
+  FPGAContext(const FPGASettings* settings){
+
+    for (int l=0;l<6;l++){
+      int nbits=3;
+      if (l>=3) nbits=4;
+      phiCorrLayers_[l].init(l+1,nbits,3);
+    }
+
+    //TE tables of the layers, disks and overlaps that seed
+    innerTableLayers_[0].init(1,2,7,4);
+    innerTableLayers_[1].init(2,3,7,4);
+    innerTableLayers_[2].init(3,4,7,4);
+    innerTableLayers_[4].init(5,6,7,4);
+    outerTableLayers_[1].init(2,7,4);
+    outerTableLayers_[2].init(3,7,4);
+    outerTableLayers_[3].init(4,7,4);
+    outerTableLayers_[5].init(6,7,4);
+    innerTableDisks_[0].init(1,2,7,3);
+    innerTableDisks_[2].init(3,4,7,3);
+    outerTableDisks_[1].init(2,7,3);
+    outerTableDisks_[3].init(4,7,3);
+    innerTableOverlapLayers_[0].init(1,1,7,3);
+    innerTableOverlapLayers_[1].init(2,1,7,3);
+    outerTableOverlapD1_.init(1,7,3);
+
+    prBendTable_.init(5,6);
+
+    tmttSettings_=0;
+
+    if (settings->hybrid()&&settings->doKF()) {
+      tmttSettings_=new TMTT::Settings();
+    } else {
+      derTable_.readPatternFile(fitpatternfile);
+      derTable_.fillTable();
+      cout << "Number of entries in derivative table: "
+	   <<derTable_.getEntries()<<endl;
+      assert(derTable_.getEntries()!=0);
+      if (useMSFit) derTable_.readVarianceFile("variance.dat");
+    }
+
+  }
+
+  ~FPGAContext(){
+    delete tmttSettings_;
+  }
+
+  //Stub phi correction tables for the barrel layers (layer 1-6)
+  const FPGAVMRouterPhiCorrTable& phiCorrLayer(unsigned int layer) const {
+    assert(layer>=1&&layer<=6);
+    return phiCorrLayers_[layer-1];
+  }
+
+  //Applies the bend and radius dependent phi correction to a barrel stub
+  void applyPhiCorr(FPGAStub& stub) const {
+    if (stub.layer().value()==-1) return;
+    FPGAWord r=stub.r();
+    int bendbin=stub.bend().value();
+    int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-3);
+    stub.setPhiCorr(phiCorrLayer(stub.layer().value()+1).getphiCorrValue(bendbin,rbin));
+  }
+
+  //TE tables of the VM routers, for the inner layers 1, 2, 3 and 5
+  const FPGATETableInner& innerTableLayer(int layer) const {
+    assert(layer==1||layer==2||layer==3||layer==5);
+    return innerTableLayers_[layer-1];
+  }
+
+  //TE tables of the outer layers 2, 3, 4 and 6
+  const FPGATETableOuter& outerTableLayer(int layer) const {
+    assert(layer==2||layer==3||layer==4||layer==6);
+    return outerTableLayers_[layer-1];
+  }
+
+  //TE tables of the inner disks 1 and 3
+  const FPGATETableInnerDisk& innerTableDisk(int disk) const {
+    assert(disk==1||disk==3);
+    return innerTableDisks_[disk-1];
+  }
+
+  //TE tables of the outer disks 2 and 4
+  const FPGATETableOuterDisk& outerTableDisk(int disk) const {
+    assert(disk==2||disk==4);
+    return outerTableDisks_[disk-1];
+  }
+
+  //TE tables of the layers 1 and 2 of the overlap seeds
+  const FPGATETableInnerOverlap& innerTableOverlapLayer(int layer) const {
+    assert(layer==1||layer==2);
+    return innerTableOverlapLayers_[layer-1];
+  }
+
+  //TE table of disk 1 of the overlap seeds
+  const FPGATETableOuterDisk& outerTableOverlapD1() const {return outerTableOverlapD1_;}
+
+  //Projected bend of the disk projections, used by the ProjectionRouter
+  const FPGAProjectionRouterBendTable& projectionRouterBendTable() const {return prBendTable_;}
+
+  //Derivative table of the linearized fit (not filled when the KF is used)
+  const FPGATrackDerTable& derTable() const {return derTable_;}
+
+  //TMTT settings used by the KF (only when the KF is used)
+  const TMTT::Settings* tmttSettings() const {
+    assert(tmttSettings_!=0);
+    return tmttSettings_;
+  }
+
+private:
+
+  FPGAContext(const FPGAContext&);
+  FPGAContext& operator=(const FPGAContext&);
+
+  FPGAVMRouterPhiCorrTable phiCorrLayers_[6];
+
+  //Only the entries of the layers and disks listed in the accessors are filled
+  FPGATETableInner innerTableLayers_[6];
+  FPGATETableOuter outerTableLayers_[6];
+  FPGATETableInnerDisk innerTableDisks_[4];
+  FPGATETableOuterDisk outerTableDisks_[4];
+  FPGATETableInnerOverlap innerTableOverlapLayers_[2];
+  FPGATETableOuterDisk outerTableOverlapD1_;
+
+  FPGAProjectionRouterBendTable prBendTable_;
+
+  FPGATrackDerTable derTable_;
+
+  TMTT::Settings* tmttSettings_;
+
+};
+
+#endif
@@ -0,0 +1,53 @@
+//This class holds the debug output files written by the sectors and the
+//processing modules when the write* flags are set. A file is opened at its
+//first use and is then shared by everything writing to the same name.
+//It is part of the FPGAScratch.
+#ifndef FPGADEBUGFILES_H
+#define FPGADEBUGFILES_H
+
+#include <fstream>
+#include <string>
+#include <map>
+
+using namespace std;
+
+class FPGADebugFiles{
+
+public:
+
+  //The suffix is inserted before the file extension
+  FPGADebugFiles(string suffix=""){
+    suffix_=suffix;
+  }
+
+  ~FPGADebugFiles(){
+    for (map<string, ofstream*>::iterator it=files_.begin();it!=files_.end();++it){
+      delete it->second;
+    }
+  }
+
+  ofstream& file(const string& name) {
+    ofstream*& out=files_[name];
+    if (out==0) out=new ofstream(fileName(name).c_str());
+    return *out;
+  }
+
+private:
+
+  FPGADebugFiles(const FPGADebugFiles&);
+  FPGADebugFiles& operator=(const FPGADebugFiles&);
+
+  string fileName(const string& name) const {
+    if (suffix_=="") return name;
+    size_t dot=name.rfind('.');
+    if (dot==string::npos) return name+suffix_;
+    return name.substr(0,dot)+suffix_+name.substr(dot);
+  }
+
+  string suffix_;
+
+  map<string, ofstream*> files_;
+
+};
+
+#endif
@@ -3,13 +3,14 @@
 #define FPGAFITTRACK_H
 
 #include "FPGAProcessBase.hh"
+#include "FPGAContext.hh"
 #include "FPGATrackDerTable.hh"
+#include "FPGALinearFit.hh"
 
 #include "DataFormats/L1TrackTrigger/interface/TTStub.h"
 #include "DataFormats/L1TrackTrigger/interface/TTCluster.h"
 #include "SimTracker/TrackTriggerAssociation/interface/TTStubAssociationMap.h"
 #include "SimTracker/TrackTriggerAssociation/interface/TTClusterAssociationMap.h"
-#ifdef USEHYBRID
 #include "L1Trigger/TrackFindingTMTT/interface/L1track3D.h"
 #include "L1Trigger/TrackFindingTMTT/interface/KFParamsComb.h"
 #ifdef USE_HLS
@@ -18,7 +19,6 @@
 #include "L1Trigger/TrackFindingTMTT/interface/Settings.h"
 #include "L1Trigger/TrackFindingTMTT/interface/L1fittedTrack.h"
 #include "L1Trigger/TrackFindingTMTT/interface/KFTrackletTrack.h"
-#endif
 
 using namespace std;
 
@@ -26,11 +26,18 @@ class FPGAFitTrack:public FPGAProcessBase{
 
  public:
 
-  FPGAFitTrack(string name, unsigned int iSector):
-   FPGAProcessBase(name,iSector){
+  FPGAFitTrack(string name, const FPGASettings* settings, unsigned int iSector,
+	       const FPGAContext* context):
+   FPGAProcessBase(name,settings,iSector){
+    context_=context;
     trackfit_=0;
+    for (unsigned int i=0;i<6;i++) fitterKFs_[i]=0;
    }
 
+  ~FPGAFitTrack(){
+   for (unsigned int i=0;i<6;i++) delete fitterKFs_[i];
+  }
+
   void addOutput(FPGAMemoryBase* memory,string output){
    if (writetrace) {
     cout << "In "<<name_<<" adding output to "<<memory->getName()
@@ -170,16 +177,15 @@ class FPGAFitTrack:public FPGAProcessBase{
 
   void trackFitNew(FPGATracklet* tracklet){
 
-#ifdef USEHYBRID
-   if (doKF) {
+   if (settings_->hybrid()&&settings_->doKF()) {
 
     std::vector<const TMTT::Stub*> stubs;
     std::map<unsigned int, L1TStub*> stubIndices;
     unsigned int stubID = 0;
 
-    static TMTT::Settings* settings = new TMTT::Settings();
+    const TMTT::Settings* settings=context_->tmttSettings();
 
-    if (printDebugKF) cout << "Will make stub" << endl;
+    FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"Will make stub");
 
     double kfphi=tracklet->innerStub()->phi();
     double kfr=tracklet->innerStub()->r();
@@ -198,7 +204,7 @@ class FPGAFitTrack:public FPGAProcessBase{
      if (kfz<0.0) kflayer+=10;
     }
 
-    if (printDebugKF) cout << "Will create stub with : "<<kfphi<<" "<<kfr<<" "<<kfz<<" "<<kfbend<<" "<<kflayer<<" "<<barrel<<" "<<psmodule<<" "<<endl;
+    FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"Will create stub with : "<<kfphi<<" "<<kfr<<" "<<kfz<<" "<<kfbend<<" "<<kflayer<<" "<<barrel<<" "<<psmodule<<" ");
     TMTT::Stub* stubptr= new TMTT::Stub(kfphi,kfr,kfz,kfbend,kflayer, psmodule, barrel, iphi, -alpha, settings, nullptr, stubID);
     stubs.push_back(stubptr);
     stubIndices[stubID++] = tracklet->innerStub();
@@ -219,7 +225,7 @@ class FPGAFitTrack:public FPGAProcessBase{
     }
 
 
-    if (printDebugKF) cout << "Will create stub with : "<<kfphi<<" "<<kfr<<" "<<kfz<<" "<<kfbend<<" "<<kflayer<<" "<<barrel<<" "<<psmodule<<" "<<endl;
+    FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"Will create stub with : "<<kfphi<<" "<<kfr<<" "<<kfz<<" "<<kfbend<<" "<<kflayer<<" "<<barrel<<" "<<psmodule<<" ");
     stubptr= new TMTT::Stub(kfphi,kfr,kfz,kfbend,kflayer, psmodule ,barrel, iphi, -alpha, settings, nullptr, stubID);
     stubs.push_back(stubptr);
     stubIndices[stubID++] = tracklet->outerStub();
@@ -278,8 +284,6 @@ class FPGAFitTrack:public FPGAProcessBase{
       barrel = true;
       kflayer=l1stubptr->layer()+1;
 
-      if (printDebugKF) cout << "Will create layer stub with : ";
-
      } else {  // disk-specific
       barrel = false;
       kflayer=abs(l1stubptr->disk());
@@ -289,8 +293,6 @@ class FPGAFitTrack:public FPGAProcessBase{
        kflayer+=20;
       }
 
-      if (printDebugKF) cout << "Will create disk stub with : ";
-
      }
 
      /* edm::ESHandle<TrackerGeometry> trackerGeometryHandle;
@@ -304,13 +306,13 @@ class FPGAFitTrack:public FPGAProcessBase{
 */	
 
 
-     if (printDebugKF) cout <<kfphi<<" "<<kfr<<" "<<kfz<<" "<<kfbend<<" "<<kflayer<<" "<<barrel<<" "<<psmodule<<" "<<endl;
+     FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"Will create "<<(barrel?"layer":"disk")<<" stub with : "<<kfphi<<" "<<kfr<<" "<<kfz<<" "<<kfbend<<" "<<kflayer<<" "<<barrel<<" "<<psmodule<<" ");
      stubptr= new TMTT::Stub(kfphi,kfr,kfz,kfbend,kflayer,psmodule,barrel, iphi, -alpha, settings, nullptr, stubID);
      stubs.push_back(stubptr);
      stubIndices[stubID++] = l1stubptr;
     }
 
-    if (printDebugKF) cout << "Made stubs: stublist.size() = " << stublist.size()<< endl;
+    FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"Made stubs: stublist.size() = " << stublist.size());
 
 
     double kfrinv=tracklet->rinvapprox();
@@ -318,11 +320,9 @@ class FPGAFitTrack:public FPGAProcessBase{
     double kfz0=tracklet->z0approx();
     double kft=tracklet->tapprox();
 
-    if (printDebugKF) {
-     std::cout << "tracklet phi0 = "<< kfphi0 << std::endl;
-     std::cout << "iSector = " << iSector_ << std::endl;
-     std::cout << "dphisectorHG = " << dphisectorHG << std::endl;
-    }
+    FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"tracklet phi0 = "<< kfphi0 << std::endl
+		<< "iSector = " << iSector_ << std::endl
+		<< "dphisectorHG = " << dphisectorHG);
 
     // IRT bug fix
     //kfphi0 = kfphi0 + iSector_*2*M_PI/NSector - 0.5*dphisectorHG - M_PI;
@@ -372,16 +372,19 @@ class FPGAFitTrack:public FPGAProcessBase{
 
     TMTT::L1track3D l1track3d(settings,stubs,celllocation,helixrphi,helixrz,kf_phi_sec,kf_eta_reg,1,false);
 
-    // Create Kalman track fitter.
-    static bool firstPrint = true;
+    // Create Kalman track fitter (one per number of helix parameters).
+    // The fitters keep state during the fit and are owned by this module.
+    unsigned int nHelixPar=settings_->nHelixPar();
+    if (fitterKFs_[nHelixPar]==0) {
 #ifdef USE_HLS
-    if (firstPrint) cout << "Will make KFParamsCombHLS for " << nHelixPar << " param fit" << endl;
-    static TMTT::TrackFitGeneric* fitterKF = new TMTT::KFParamsCombCallHLS(settings, nHelixPar, "KFfitterHLS");
+      cout << "Will make KFParamsCombHLS for " << nHelixPar << " param fit" << endl;
+      fitterKFs_[nHelixPar] = new TMTT::KFParamsCombCallHLS(settings, nHelixPar, "KFfitterHLS");
 #else
-    if (firstPrint) cout << "Will make KFParamsComb for " << nHelixPar << " param fit"<< endl;
-    static TMTT::TrackFitGeneric* fitterKF = new TMTT::KFParamsComb(settings, nHelixPar, "KFfitter");
+      cout << "Will make KFParamsComb for " << nHelixPar << " param fit"<< endl;
+      fitterKFs_[nHelixPar] = new TMTT::KFParamsComb(settings, nHelixPar, "KFfitter");
 #endif
-    firstPrint = false;
+    }
+    TMTT::TrackFitGeneric* fitterKF = fitterKFs_[nHelixPar];
 
     //  cout << "Will call fit" << endl;
     //fitterKF->fit(l1track3d,1,kf_eta_reg);
@@ -390,7 +393,7 @@ class FPGAFitTrack:public FPGAProcessBase{
    
     TMTT::KFTrackletTrack trk = fittedTrk.returnKFTrackletTrack();
 
-    if (printDebugKF) cout << "Done with Kalman fit. Pars: pt = " << trk.pt() << ", 1/2R = " << 3.8*3*trk.qOverPt()/2000 << ", phi0 = " << trk.phi0() << ", eta = " << trk.eta() << ", z0 = " << trk.z0() << ", chi2 = "<<trk.chi2()  << ", accepted = "<< trk.accepted() << endl;
+    FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"Done with Kalman fit. Pars: pt = " << trk.pt() << ", 1/2R = " << 3.8*3*trk.qOverPt()/2000 << ", phi0 = " << trk.phi0() << ", eta = " << trk.eta() << ", z0 = " << trk.z0() << ", chi2 = "<<trk.chi2()  << ", accepted = "<< trk.accepted());
 
     // IRT bug fix
     //double tracklet_phi0=M_PI+trk.phi0()-iSector_*2*M_PI/NSector+0.5*dphisectorHG;
@@ -401,8 +404,6 @@ class FPGAFitTrack:public FPGAProcessBase{
 
     double rinvfit=0.01*0.3*settings->getBfield()*trk.qOverPt();
 
-    int id0fit   = trk.d0()  / kd0;
-
     if(trk.accepted()){
       const vector<const TMTT::Stub*>& stubsFromFit = trk.getStubs();
       vector<L1TStub*> l1stubsFromFit;
@@ -412,7 +413,7 @@ class FPGAFitTrack:public FPGAProcessBase{
 	l1stubsFromFit.push_back(l1s);
       }
 
-      if (printDebugKF) cout<<"#stubs before/after KF fit = "<<stubs.size()<<"/"<<l1stubsFromFit.size()<<endl;
+      FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"#stubs before/after KF fit = "<<stubs.size()<<"/"<<l1stubsFromFit.size());
 
       // TO DO. trk.chi2() provides chi2, whereas setFitPars() expects chi2/ndf.
       // It is setFitPars() which should be changed.
@@ -424,28 +425,13 @@ class FPGAFitTrack:public FPGAProcessBase{
        sinh(trk.eta())/ktpars,trk.z0()/kz0pars,trk.chi2(),
        l1stubsFromFit);
     } else {
-     if (printDebugKF) cout << "FPGAFitTrack:KF rejected track"<<endl;
+     FPGA_LOG_IF(FPGALOG_DEBUG,settings_->printDebugKF(),"FPGAFitTrack:KF rejected track");
     }
     return;
 
    }
-#endif
 
-   static FPGATrackDerTable derTable;
-
-
-   //test
-   static bool first=true;
-   if (first) {
-    derTable.readPatternFile(fitpatternfile);
-    derTable.fillTable();
-    cout << "Number of entries in derivative table: "
-     <<derTable.getEntries()<<endl;
-    assert(derTable.getEntries()!=0);
-
-    //testDer();
-    first=false;
-   }
+   const FPGATrackDerTable& derTable=context_->derTable();
 
    //First step is to build list of layers and disks.
 
@@ -479,8 +465,6 @@ class FPGAFitTrack:public FPGAProcessBase{
    }
 
 
-   static ofstream out2;
-   if (writeHitPattern) out2.open("hitpattern.txt");
 
    char matches[8]="000000\0";
    char matches2[12]="0000000000\0";
@@ -562,7 +546,7 @@ class FPGAFitTrack:public FPGAProcessBase{
 
     if (mult<=1<<(3*alphaBitsTable)) {
      if (writeHitPattern) {
-      out2<<matches<<" "<<matches2<<" "<<mult<<endl;
+      debugFile("hitpattern.txt")<<matches<<" "<<matches2<<" "<<mult<<endl;
      }
     }
 
@@ -733,7 +717,7 @@ class FPGAFitTrack:public FPGAProcessBase{
    if (fabs(rinv)<0.0057/4) ptbin=2;
    if (fabs(rinv)<0.0057/8) ptbin=3;
 
-   FPGATrackDer* derivatives=derTable.getDerivatives(layermask, diskmask,alphaindex,rinvindex);
+   const FPGATrackDer* derivatives=derTable.getDerivatives(layermask, diskmask,alphaindex,rinvindex);
 
    if (derivatives==0) {
     FPGAWord tmpl,tmpd;
@@ -748,9 +732,7 @@ class FPGAFitTrack:public FPGAProcessBase{
    if (t<0.0) ttabi=-ttabi;
    double ttab=ttabi;
 
-   if (debug1) {
-    cout << "Doing trackfit in  "<<getName()<<endl;
-   }
+   FPGA_DEBUG("Doing trackfit in  "<<getName());
 
    int sign=1;
    if (t<0.0) sign=-1;
@@ -802,7 +784,7 @@ class FPGAFitTrack:public FPGAProcessBase{
    } else {
     if (exactderivativesforfloating) {
      if (useMSFit) {
-      FPGATrackDerTable::calculateDerivativesMS(nlayers,r,ndisks,z,alpha,
+      derTable.calculateDerivativesMS(nlayers,r,ndisks,z,alpha,
 	t,rinv,D,iD,MinvDt,iMinvDt,
 	sigma,kfactor,ptbin);
      } else {
@@ -904,133 +886,34 @@ class FPGAFitTrack:public FPGAProcessBase{
    }
    assert(j<=12);
 
-   double drinv=0.0;
-   double dphi0=0.0;
-   double dt=0.0;
-   double dz0=0.0;
-
-   double drinvexact=0.0;
-   double dphi0exact=0.0;
-   double dtexact=0.0;
-   double dz0exact=0.0;
-
-   int idrinv=0;
-   int idphi0=0;
-   int idt=0;
-   int idz0=0;
-
-
-   double drinv_cov=0.0;
-   double dphi0_cov=0.0;
-   double dt_cov=0.0;
-   double dz0_cov=0.0;
+   double dpar[4];
+   double dparexact[4];
+   double dparexact_cov[4];
+   int idpar[4];
+   double chisqfit;
+   unsigned int ichisqfit;
 
-   double drinv_covexact=0.0;
-   double dphi0_covexact=0.0;
-   double dt_covexact=0.0;
-   double dz0_covexact=0.0;
-
-
-
-   for(unsigned int j=0;j<2*n;j++) {
-
-    drinv-=MinvDt[0][j]*delta[j];
-    dphi0-=MinvDt[1][j]*delta[j];
-    dt-=MinvDt[2][j]*delta[j];
-    dz0-=MinvDt[3][j]*delta[j];
-
-    drinv_cov+=D[0][j]*delta[j];
-    dphi0_cov+=D[1][j]*delta[j];
-    dt_cov+=D[2][j]*delta[j];
-    dz0_cov+=D[3][j]*delta[j];
-
-
-    drinvexact-=MinvDt[0][j]*deltaexact[j];
-    dphi0exact-=MinvDt[1][j]*deltaexact[j];
-    dtexact-=MinvDt[2][j]*deltaexact[j];
-    dz0exact-=MinvDt[3][j]*deltaexact[j];
-
-    drinv_covexact+=D[0][j]*deltaexact[j];
-    dphi0_covexact+=D[1][j]*deltaexact[j];
-    dt_covexact+=D[2][j]*deltaexact[j];
-    dz0_covexact+=D[3][j]*deltaexact[j];
-
-    idrinv+=((iMinvDt[0][j]*idelta[j]));
-    idphi0+=((iMinvDt[1][j]*idelta[j]));
-    idt+=((iMinvDt[2][j]*idelta[j]));
-    idz0+=((iMinvDt[3][j]*idelta[j]));
-
-    /*
-
-       double drinvtmp=MinvDt[0][j]*delta[j];
-       double idrinvtmp=krinvpars*((iMinvDt[0][j]*idelta[j]+(1<<(fitrinvbitshift-1)))>>fitrinvbitshift);
-
-       if (fabs(drinvtmp-idrinvtmp)>0.000001) {
-       cout << "WARNING large fp vs. int difference for drinv "<<tracklet->layer()<<" "<<tracklet->disk()<<" "
-       <<j<<" "<<drinvtmp<<" "
-       <<idrinvtmp<<" "<<drinvtmp-idrinvtmp<<"  "<<delta[j]<<" "<<idelta[j]*kphiproj123<<" "<<iMinvDt[0][j]<<" "<<idelta[j]<<endl;
-       }
-
-
-       double dz0tmp=MinvDt[3][j]*delta[j];
-       double idz0tmp=kz*((iMinvDt[3][j]*idelta[j])>>fitz0bitshift);
-
-       if (fabs(dz0tmp-idz0tmp)>1.0) {
-       cout << "WARNING large fp vs. int difference for dz0 "<<tracklet->layer()<<" "<<tracklet->disk()<<" "
-       <<j<<" "<<dz0tmp<<" "
-       <<idz0tmp<<" "<<dz0tmp-idz0tmp<<"  "<<delta[j]<<" "<<idelta[j]*kz<<endl;
-       }
-
-*/
+   FPGALinearFit::fit(1,n,MinvDt,iMinvDt,D,iD,rstub,sigma,kfactor,
+		      &delta,&idelta,&dpar,&idpar,&chisqfit,&ichisqfit);
 
-    /*
-       if (j%2==0) {
-       cout << "j dt idt : "<<j<<" "<<MinvDt[2][j]*delta[j]<<" "<<((iMinvDt[2][j]*idelta[j])>>fittbitshift)*ktpars<<endl;
-       if (j/2>=nlayers) {
-       cout << "alpha : "<<alpha[j/2-nlayers]*rstub[j/2]*rstub[j/2]<<endl;
-       cout << "MinvDt iMinvDt : "<<MinvDt[2][j]<<" "<<iMinvDt[2][j]*ktparsdisk/(1<<fittbitshift)/kphiproj123<<endl;
-       cout << "delta idelta : "<<delta[j]<<" "<<idelta[j]*kphiproj123<<endl;
-       } else {
-       cout << "MinvDt iMinvDt : "<<MinvDt[2][j]<<" "<<iMinvDt[2][j]*ktpars/(1<<fittbitshift)/kphi1<<endl;
-       cout << "delta idelta : "<<delta[j]<<" "<<idelta[j]*kphi1<<endl;
-       }
-       }
-       */
-
-    //cout <<  "------------------------------------"<<endl;
-    //cout << "j delta idelta : "<<j<<" "<<delta[j]<<" "<<idelta[j]*kfactor[j]<<endl;
-    //cout << "j dt idt : "<<j<<" "<<MinvDt[2][j]*delta[j]<<" "<<((iMinvDt[2][j]*idelta[j])>>fittbitshift)*ktpars<<endl;
-    //cout << "kfactor kphiproj123 : "<<kfactor[j]<<" "<<kphiproj123<<endl;
-    //cout << "j Minv iMinv : "<<j<<" "<<MinvDt[2][j]<<" "<<iMinvDt[2][j]<<" "<<iMinvDt[2][j]*ktpars/kphiproj123/(1<<fittbitshift)<<" "
-    //   <<MinvDt[2][j]/(iMinvDt[2][j]*ktpars/kphiproj123/(1<<fittbitshift))<<endl;
-
-    if (0&&j%2==0) {
-
-     cout << "DUMPFITLINNEW1"<<" "<<j
-      <<" "<<rinvseed
-      <<" + "<<MinvDt[0][j]*delta[j]
-      <<" "<<MinvDt[0][j]
-      <<" "<<delta[j]*rstub[j/2]*10000
-      <<endl;
-
-     cout << "DUMPFITLINNEW2"<<" "<<j
-      <<" "<<tracklet->fpgarinv().value()*krinvpars
-      <<" + "<<((iMinvDt[0][j]*idelta[j]))*krinvpars/1024.0
-      <<" "<<iMinvDt[0][j]*krinvpars/kphiprojdisk/1024.0
-      <<" "<<idelta[j]*kphiproj123*rstub[j/2]*10000
-      <<" "<<idelta[j]
-      <<endl;
+   FPGALinearFit::corrections(2*n,MinvDt,deltaexact,dparexact);
+   FPGALinearFit::projections(2*n,D,deltaexact,dparexact_cov);
 
-    }
+   double drinv=dpar[0];
+   double dphi0=dpar[1];
+   double dt=dpar[2];
+   double dz0=dpar[3];
 
+   int idrinv=idpar[0];
+   int idphi0=idpar[1];
+   int idt=idpar[2];
+   int idz0=idpar[3];
 
+   double deltaChisqexact=0.0;
+   for (unsigned int i=0;i<4;i++) {
+    deltaChisqexact+=dparexact[i]*dparexact_cov[i];
    }
 
-   double deltaChisqexact=drinvexact*drinv_covexact+
-    dphi0exact*dphi0_covexact+
-    dtexact*dt_covexact+
-    dz0exact*dz0_covexact;
-
 
    int irinvseed=tracklet->fpgarinv().value();
    int iphi0seed=tracklet->fpgaphi0().value();
@@ -1051,111 +934,20 @@ class FPGAFitTrack:public FPGAProcessBase{
    double tfit=tseed-dt;
    double z0fit=z0seed-dz0;
 
-   double rinvfitexact=rinvseedexact-drinvexact;
-   double phi0fitexact=phi0seedexact-dphi0exact;
+   double rinvfitexact=rinvseedexact-dparexact[0];
+   double phi0fitexact=phi0seedexact-dparexact[1];
 
-   double tfitexact=tseedexact-dtexact;
-   double z0fitexact=z0seedexact-dz0exact;
+   double tfitexact=tseedexact-dparexact[2];
+   double z0fitexact=z0seedexact-dparexact[3];
 
    double chisqfitexact=chisqseedexact+deltaChisqexact;
 
-   ////////////// NEW CHISQ /////////////////////
-   bool NewChisqDebug=false;
-   double chisqfit=0.0;
-   uint ichisqfit=0;
-
-   double phifactor;
-   double rzfactor;
-   double iphifactor;
-   double irzfactor;
-   int k=0; // column index of D matrix
-
-   if(NewChisqDebug){
-    cout << "OG chisq:" << endl;
-    cout << "drinv/cov = " << drinv << "/" << drinv_cov << endl;
-    cout << "dphi0/cov = " << drinv << "/" << dphi0_cov << endl;
-    cout << "dt/cov = " << drinv << "/" << dt_cov << endl;
-    cout << "dz0/cov = " << drinv << "/" << dz0_cov << endl << endl;
-    cout << "D[0][k]= ";
-    for(unsigned int i=0;i<2*n;i++) {
-     cout << D[0][i] << ", ";
-    }
-    cout << endl;
-   }
-
-
-
-   for(unsigned int i=0;i<n;i++) { // loop over stubs
-
-    phifactor=rstub[k/2]*delta[k]/sigma[k]
-     +D[0][k]*drinv+D[1][k]*dphi0+D[2][k]*dt+D[3][k]*dz0;
-
-
-    iphifactor=kfactor[k]*rstub[k/2]*idelta[k]*(1<<chisqphifactbits)/sigma[k]
-     -iD[0][k]*idrinv-iD[1][k]*idphi0-iD[2][k]*idt-iD[3][k]*idz0;
-
-    //double kchisqphi=1.0/(1<<chisqphifactbits);
-    //cout << "=================================================="<<endl;
-    //cout << "*** old phi resid iresid : "<<rstub[k/2]*delta[k]/sigma[k]<<" "<<kfactor[k]*rstub[k/2]*idelta[k]*(1<<chisqphifactbits)/sigma[k]/(1<<chisqphifactbits)<<" rstub "<<rstub[k/2]<<endl;
-    //cout << "phi k  D "<<k<<" "<<D[0][k]*drinv<<" "<<D[1][k]*dphi0<<" "<<D[2][k]*dt<<" "<<D[3][k]*dz0<<endl;
-    //cout << "phi k iD "<<k<<" "<<iD[0][k]*idrinv*kchisqphi<<" "<<iD[1][k]*idphi0*kchisqphi<<" "<<iD[2][k]*idt*kchisqphi<<" "<<iD[3][k]*idz0*kchisqphi<<endl;
-    //cout << "### new phi resid iresid : "<<phifactor<<" "<<iphifactor*kchisqphi<<endl;
-
-    if(NewChisqDebug){
-     cout << "delta[k]/sigma = " << delta[k]/sigma[k] << "  delta[k] = " << delta[k]  << endl;
-     cout << "sum = " << phifactor-delta[k]/sigma[k] << "    drinvterm = " << D[0][k]*drinv << "  dphi0term = " << D[1][k]*dphi0 << "  dtterm = " << D[2][k]*dt << "  dz0term = " << D[3][k]*dz0 << endl;
-     cout << "  phifactor = " << phifactor << endl;
-    }
-
-    chisqfit+=phifactor*phifactor;
-    ichisqfit+=iphifactor*iphifactor/(1<<(2*chisqphifactbits-4));
-
-    //cout << "i phi chisq :" << i << " " << phifactor*phifactor << " " << iphifactor*iphifactor/(1<<(2*chisqphifactbits-4))/16.0 << endl;
-
-    k++;
-
-
-    rzfactor=delta[k]/sigma[k]+D[0][k]*drinv+D[1][k]*dphi0+D[2][k]*dt+D[3][k]*dz0;
-
-
-    irzfactor=kfactor[k]*idelta[k]*(1<<chisqzfactbits)/sigma[k]-iD[0][k]*idrinv-iD[1][k]*idphi0-iD[2][k]*idt-iD[3][k]*idz0;
-
-    //double kchisqz=1.0/(1<<chisqzfactbits);
-    //cout << "idrinv: "<<iD[0][k]<<" "<<idrinv<<endl;
-    //cout << "idphi0: "<<iD[1][k]<<" "<<idphi0<<endl;
-    //cout << "idt:    "<<iD[2][k]<<" "<<idt<<endl;
-    //cout << "idz0:   "<<iD[3][k]<<" "<<idz0<<endl;
-
-    //cout << "dt idt : "<<dt<<" "<<idt*ktpars/(1<<fittbitshift)<<endl;
-
-    //cout << "old z resid : "<<delta[k]/sigma[k]<<" "<<kfactor[k]*idelta[k]/sigma[k]<<endl;
-    //cout << "r-z k  D "<<k<<" "<<D[0][k]*drinv<<" "<<D[1][k]*dphi0<<" "<<D[2][k]*dt<<" "<<D[3][k]*dz0<<endl;
-    //cout << "r-z k iD "<<k<<" "<<iD[0][k]*idrinv*kchisqz<<" "<<iD[1][k]*idphi0*kchisqz<<" "<<iD[2][k]*idt*kchisqz<<" "<<iD[3][k]*idz0*kchisqz<<endl;
-
-    //cout << "new z resid: "<<rzfactor<<" "<<irzfactor*kchisqz<<endl;
-
-    if(NewChisqDebug){
-     cout << "delta[k]/sigma = " << delta[k]/sigma[k] << "  delta[k] = " << delta[k]  << endl;
-     cout << "sum = " << rzfactor-delta[k]/sigma[k] << "    drinvterm = " << D[0][k]*drinv << "  dphi0term = " << D[1][k]*dphi0 << "  dtterm = " << D[2][k]*dt << "  dz0term = " << D[3][k]*dz0 << endl;
-     cout << "  rzfactor = " << rzfactor << endl;
-    }
-
-    chisqfit+=rzfactor*rzfactor;
-    ichisqfit+=irzfactor*irzfactor/(1<<(2*chisqzfactbits-4));
-
-    //cout << "i z chisq   :" << i << " " << rzfactor*rzfactor << " " << irzfactor*irzfactor/(1<<(2*chisqzfactbits-4))/16.0 << endl;
-
-
-
-    k++;
-   }
 
    //cout <<"chisq ichisq : "<< chisqfit << " " << ichisqfit/16.0<<endl;
 
 
    if (writeChiSq) {
-    static ofstream out("chisq.txt");
-    out << asinh(itfit*ktpars)<<" "<<chisqfit << " " << ichisqfit/16.0<<endl;
+    debugFile("chisq.txt") << asinh(itfit*ktpars)<<" "<<chisqfit << " " << ichisqfit/16.0<<endl;
    }
 
    // Divide by degrees of freedom
@@ -1206,7 +998,7 @@ class FPGAFitTrack:public FPGAProcessBase{
 
    std::vector<unsigned int> indexArray;
    for (unsigned int i=0;i<fullmatch.size();i++) {
-    if(debug1 && fullmatch[i]->nMatches()!=0) cout<<"orderedMatches: "<<fullmatch[i]->getName()<<" "<< fullmatch[i]->nMatches()<<"\n";
+    FPGA_LOG_IF(FPGALOG_DEBUG,debug1&&fullmatch[i]->nMatches()!=0,"orderedMatches: "<<fullmatch[i]->getName()<<" "<< fullmatch[i]->nMatches());
 
     indexArray.push_back(0);
     for (unsigned int j=0;j<fullmatch[i]->nMatches();j++){
@@ -1260,7 +1052,7 @@ class FPGAFitTrack:public FPGAProcessBase{
    std::vector<FPGATracklet*> matches3=orderedMatches(fullmatch3_);
    std::vector<FPGATracklet*> matches4=orderedMatches(fullmatch4_);
 
-   if (debug1&&(matches1.size()+matches2.size()+matches3.size()+matches4.size())>0) {
+   if (FPGA_DEBUG_ON&&(matches1.size()+matches2.size()+matches3.size()+matches4.size())>0) {
     for (unsigned int i=0;i<fullmatch1_.size();i++) {
      cout << fullmatch1_[i]->getName()<<" "<<fullmatch1_[i]->nMatches()<<endl;
     }
@@ -1351,7 +1143,7 @@ class FPGAFitTrack:public FPGAProcessBase{
     }
 
 
-    if(debug1) cout<<getName()<<" : nMatches = "<<nMatches<<" "<<asinh(bestTracklet->t())<<"\n";
+    FPGA_DEBUG(getName()<<" : nMatches = "<<nMatches<<" "<<asinh(bestTracklet->t()));
 
     if (nMatches>=1) { // aedit , should've been >=2
      countFit++;
@@ -1366,8 +1158,7 @@ class FPGAFitTrack:public FPGAProcessBase{
    } while (bestTracklet!=0);
 
    if (writeFitTrack) {
-    static ofstream out("fittrack.txt");
-    out<<getName()<<" "<<countAll<<" "<<countFit<<endl;
+    debugFile("fittrack.txt")<<getName()<<" "<<countAll<<" "<<countFit<<endl;
    }
 
   }
@@ -1375,6 +1166,10 @@ class FPGAFitTrack:public FPGAProcessBase{
 
  private:
 
+  const FPGAContext* context_;
+
+  TMTT::TrackFitGeneric* fitterKFs_[6];
+
   vector<FPGATrackletParameters*> seedtracklet_;
   vector<FPGAFullMatch*> fullmatch1_;
   vector<FPGAFullMatch*> fullmatch2_;
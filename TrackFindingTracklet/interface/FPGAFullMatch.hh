@@ -13,9 +13,9 @@ class FPGAFullMatch:public FPGAMemoryBase{
 
 public:
 
-  FPGAFullMatch(string name, unsigned int iSector, 
+  FPGAFullMatch(string name, const FPGASettings* settings, unsigned int iSector, 
 		double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
     string subname=name.substr(8,2);
@@ -50,7 +50,7 @@ public:
 
   void addMatch(FPGATracklet* tracklet,std::pair<FPGAStub*,L1TStub*> stub) {
 
-    if (!doKF) { //When using KF we allow multiple matches
+    if (!settings_->doKF()) { //When using KF we allow multiple matches
       for(unsigned int i=0;i<matches_.size();i++){
 	if (matches_[i].first==tracklet){ //Better match, replace
 	  matches_[i].second=stub;
@@ -61,8 +61,8 @@ public:
     std::pair<FPGATracklet*,std::pair<FPGAStub*,L1TStub*> > tmp(tracklet,stub);
     //Check that we have the right TCID order
     if (matches_.size()>0) {
-      if ( (!doKF && matches_[matches_.size()-1].first->TCID()>=tracklet->TCID()) || 
-	   (doKF && matches_[matches_.size()-1].first->TCID()>tracklet->TCID()) ) {
+      if ( (!settings_->doKF() && matches_[matches_.size()-1].first->TCID()>=tracklet->TCID()) || 
+	   (settings_->doKF() && matches_[matches_.size()-1].first->TCID()>tracklet->TCID()) ) {
 	cout << "Wrong TCID ordering in "<<getName()<<" : "
 	     <<matches_[matches_.size()-1].first->TCID()
 	     <<" "<<tracklet->TCID()
@@ -85,6 +85,7 @@ public:
   }
 
   unsigned int nMatches() const {return matches_.size();}
+  unsigned int nEntries() const {return nMatches();}
 
   FPGATracklet* getFPGATracklet(unsigned int i) const {return matches_[i].first;}
 
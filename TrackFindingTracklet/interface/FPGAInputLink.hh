@@ -10,7 +10,7 @@
 #include "L1TStub.hh"
 #include "FPGAStub.hh"
 #include "FPGAMemoryBase.hh"
-#include "FPGAVMRouterPhiCorrTable.hh"
+#include "FPGAContext.hh"
 #include <math.h>
 #include <sstream>
 #include <ctype.h>
@@ -21,9 +21,10 @@ class FPGAInputLink:public FPGAMemoryBase{
 
 public:
 
-  FPGAInputLink(string name, unsigned int iSector, 
-		double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+  FPGAInputLink(string name, const FPGASettings* settings, unsigned int iSector, 
+		double phimin, double phimax, const FPGAContext* context):
+    FPGAMemoryBase(name,settings,iSector){
+    context_=context;
     phimin_=phimin;
     phimax_=phimax;
 
@@ -57,33 +58,9 @@ public:
 
   void addStub(L1TStub& al1stub, FPGAStub& stub, string dtc="") {
 
-    static bool first=true;
-    static FPGAVMRouterPhiCorrTable phiCorrLayers[6];
-
-    if (first) {
-      for (int l=0;l<6;l++){
-	int nbits=3;
-	if (l>=3) nbits=4;
-        phiCorrLayers[l].init(l+1,nbits,3);
-      }
-      first=false;
-    }
-    
     //cout << getName()<<" addStub "<<stub.layer().value()+1<<" "<<al1stub.phi()<<" "<<al1stub.z()<<endl;
     
-    if (stub.layer().value()!=-1) {
-
-      FPGAWord r=stub.r();
-      FPGAWord bend=stub.bend();
-      int bendbin=bend.value();
-      //cout << "bend:"<<bend.value()<<" "<<bend.nbits()<<" "<<bendbin<<endl;
-      int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-3);
-      
-      int iphicorr=phiCorrLayers[stub.layer().value()].getphiCorrValue(bendbin,rbin);
-
-      stub.setPhiCorr(iphicorr);
-
-    }
+    context_->applyPhiCorr(stub);
     
     bool add=false;
     unsigned int asindex = 0;
@@ -92,63 +69,13 @@ public:
     
     if (hourglass) {
 
-      //cout << getName()<<" layer = "<<stub.layer().value()+1<<endl;
-      
-      if (stub.layer().value()==-1 && isLayer() ) return; 
-      if (stub.layer().value()!=-1 && isDisk() ) return;
-      if (stub.layer().value()!=-1){
-	if (stub.layer().value()+1!=layerdisk()) return;
-      } else {
-	if (abs(stub.disk().value())!=layerdisk()) return;
-      }
-
-      int phibin=-1;
-      if (stub.layer().value()!=-1) {
-	if (phiregionoverlap()==-1) {
-	  phibin=iphivmRaw/(32/nallstubslayers[layerdisk()-1]);
-	} else {
-	  phibin=iphivmRaw/(32/nallstubsoverlaplayers[layerdisk()-1]);
-	}
-      } else {
-	phibin=iphivmRaw/(32/nallstubsdisks[layerdisk()-1]); 
-      }
-
-      //cout << getName()<<" "<<iSector_<<" phibin phiregion : "<<phibin<<" "<<phiregion()<<endl;
-      
-      if (phibin!=phiregion() && phibin!=phiregionoverlap()) return;
-
-
-      
- 
-      //cout << getName()<<" "<<getName().substr(10,dtc.size())<<" "<<dtc<<endl;
-      
-      if (getName().substr(10,dtc.size())!=dtc) return;
-
-      string half=getName().substr(getName().size()-3,3);
-      if (half[1]!='n') {
-	half=getName().substr(getName().size()-1,1);
-      }
-      //cout << "iSector half iphivmRaw: "<<iSector_<<" "<<half<<" "<<iphivmRaw<<endl;
-      assert(half[0]=='A' || half[0]=='B');
-
-
-      double sectorphi=al1stub.phi();
-      if (sectorphi<0.0) sectorphi+=two_pi;
+      int layerdisk=stub.layer().value();
+      if (layerdisk==-1) layerdisk=5+abs(stub.disk().value());
 
-      while (sectorphi>3*two_pi/(2*NSector)) {
-	sectorphi-=(two_pi/NSector);
-      }
-      
-      
-      if (half[0]=='B' && iphivmRaw<=15) return;
-      if (half[0]=='A' && iphivmRaw>15) return;
-      
+      if (!routes(dtc,layerdisk,iphivmRaw)) return;
 
-      
-      //cout << getName() << " adding stub to phibin : "<<phibin<<" iphivmRaw "<<iphivmRaw<<endl;
       add=true;
 
-
     } else {
       if (stub.layer().value()!=-1) {
 	string subname=getName().substr(5,7);
@@ -426,10 +353,59 @@ public:
       //cout << "Will not add stub" << endl;
       return;
     }
-    if (debug1) {
-      cout << "Will add stub in "<<getName()<<" phimin_ phimax_ "<<phimin_<<" "<<phimax_<<" "<<"iphiwmRaw = "<<iphivmRaw<<" phi="<<al1stub.phi()<<" z="<<al1stub.z()<<" r="<<al1stub.r()<<endl;
+
+    storeStub(al1stub,stub,asindex);
+
+  }
+
+  //Returns true if a stub from the DTC in the given layer/disk (0-5 for
+  //the layers, 6-10 for the disks) and raw VM phi bin belongs in this
+  //input link (hourglass)
+  bool routes(const string& dtc, int layerdisk, int iphivmRaw) const {
+
+    bool layer=layerdisk<6;
+
+    if (!layer && isLayer()) return false;
+    if (layer && isDisk()) return false;
+    if (layer){
+      if (layerdisk+1!=layerdisk_) return false;
+    } else {
+      if (layerdisk-5!=layerdisk_) return false;
     }
-    if (stubs_.size()<MAXSTUBSLINK) {
+
+    int phibin=-1;
+    if (layer) {
+      if (phiregionoverlap()==-1) {
+	phibin=iphivmRaw/(32/nallstubslayers[layerdisk_-1]);
+      } else {
+	phibin=iphivmRaw/(32/nallstubsoverlaplayers[layerdisk_-1]);
+      }
+    } else {
+      phibin=iphivmRaw/(32/nallstubsdisks[layerdisk_-1]);
+    }
+
+    if (phibin!=phiregion() && phibin!=phiregionoverlap()) return false;
+
+    if (getName().substr(10,dtc.size())!=dtc) return false;
+
+    string half=getName().substr(getName().size()-3,3);
+    if (half[1]!='n') {
+      half=getName().substr(getName().size()-1,1);
+    }
+    assert(half[0]=='A' || half[0]=='B');
+
+    if (half[0]=='B' && iphivmRaw<=15) return false;
+    if (half[0]=='A' && iphivmRaw>15) return false;
+
+    return true;
+
+  }
+
+  //Stores a stub that has already been routed to this link. The phi
+  //correction has to be applied to the stub.
+  void storeStub(L1TStub& al1stub, FPGAStub& stub, unsigned int asindex=0) {
+    FPGA_DEBUG("Will add stub in "<<getName()<<" phimin_ phimax_ "<<phimin_<<" "<<phimax_<<" "<<"iphiwmRaw = "<<stub.iphivmRaw()<<" phi="<<al1stub.phi()<<" z="<<al1stub.z()<<" r="<<al1stub.r());
+    if (stubs_.size()<settings_->maxStubsLink()) {
       L1TStub* l1stub=new L1TStub(al1stub);
       //FPGAStub* stub=new FPGAStub(*l1stub,phimin_,phimax_);
       FPGAStub* stubptr=new FPGAStub(stub);
@@ -442,10 +418,13 @@ public:
       
       std::pair<FPGAStub*,L1TStub*> tmp(stubptr,l1stub);
       stubs_.push_back(tmp);
+    } else {
+      ndropped_++;
     }
   }
 
   unsigned int nStubs() const {return stubs_.size();}
+  unsigned int nEntries() const {return nStubs();}
 
   vector<unsigned int> getASPhiIndices() const {return indexphi_;}
 
@@ -517,9 +496,9 @@ public:
     }
 
     unsigned int maxstubslink=0;
-    if (TMUX==4) maxstubslink=21;
-    else if (TMUX==6) maxstubslink=33;
-    else if (TMUX==8) maxstubslink=45;
+    if (settings_->TMUX()==4) maxstubslink=21;
+    else if (settings_->TMUX()==6) maxstubslink=33;
+    else if (settings_->TMUX()==8) maxstubslink=45;
     else {
       cout << "ERROR! Only TMUX=4/6/8 are supported! Exiting..." << endl;
       return;
@@ -973,6 +952,8 @@ public:
   
 private:
 
+  const FPGAContext* context_;
+
   double phimin_;
   double phimax_;
   vector<std::pair<FPGAStub*,L1TStub*> > stubs_;
@@ -0,0 +1,117 @@
+//Linearized track fit kernel used by the FitTrack. The derivative
+//matrices (MinvDt, D and their integer versions) are stored with one
+//contiguous row of 2*n entries per helix parameter, as produced by
+//FPGATrackDer::fill and FPGATrackDerTable::calculateDerivatives, so the
+//inner loops run over contiguous memory and can be vectorized by the
+//compiler. The integer functions reproduce the bit-accurate firmware fit.
+#ifndef FPGALINEARFIT_H
+#define FPGALINEARFIT_H
+
+#include <cassert>
+
+#include "FPGAConstants.hh"
+
+using namespace std;
+
+class FPGALinearFit{
+
+public:
+
+  //Parameter corrections dpar[i]=-sum_j MinvDt[i][j]*delta[j], j<ncol
+  static void corrections(unsigned int ncol, const double MinvDt[4][12],
+			  const double delta[12], double dpar[4]) {
+    assert(ncol<=12);
+    for (unsigned int i=0;i<4;i++) {
+      double d=0.0;
+      for (unsigned int j=0;j<ncol;j++) {
+	d-=MinvDt[i][j]*delta[j];
+      }
+      dpar[i]=d;
+    }
+  }
+
+  //Integer parameter corrections idpar[i]=sum_j iMinvDt[i][j]*idelta[j]
+  //before the fit*bitshift shifts
+  static void corrections(unsigned int ncol, const int iMinvDt[4][12],
+			  const int idelta[12], int idpar[4]) {
+    assert(ncol<=12);
+    for (unsigned int i=0;i<4;i++) {
+      int id=0;
+      for (unsigned int j=0;j<ncol;j++) {
+	id+=iMinvDt[i][j]*idelta[j];
+      }
+      idpar[i]=id;
+    }
+  }
+
+  //Projections of the residuals on the derivatives, D*delta
+  static void projections(unsigned int ncol, const double D[4][12],
+			  const double delta[12], double proj[4]) {
+    assert(ncol<=12);
+    for (unsigned int i=0;i<4;i++) {
+      double p=0.0;
+      for (unsigned int j=0;j<ncol;j++) {
+	p+=D[i][j]*delta[j];
+      }
+      proj[i]=p;
+    }
+  }
+
+  //chi2 of the fitted track for n stubs (not divided by the number of
+  //degrees of freedom)
+  static double chisq(unsigned int n, const double D[4][12],
+		      const double rstub[6], const double sigma[12],
+		      const double delta[12], const double dpar[4]) {
+    double chisq=0.0;
+    for (unsigned int k=0;k<2*n;k+=2) {
+      double phifactor=rstub[k/2]*delta[k]/sigma[k]
+	+D[0][k]*dpar[0]+D[1][k]*dpar[1]+D[2][k]*dpar[2]+D[3][k]*dpar[3];
+      double rzfactor=delta[k+1]/sigma[k+1]
+	+D[0][k+1]*dpar[0]+D[1][k+1]*dpar[1]+D[2][k+1]*dpar[2]+D[3][k+1]*dpar[3];
+      chisq+=phifactor*phifactor;
+      chisq+=rzfactor*rzfactor;
+    }
+    return chisq;
+  }
+
+  //Integer chi2 in units of 1/16 (not divided by the number of degrees
+  //of freedom). idpar are the unshifted integer corrections.
+  static unsigned int ichisq(unsigned int n, const int iD[4][12],
+			     const double rstub[6], const double sigma[12],
+			     const double kfactor[12], const int idelta[12],
+			     const int idpar[4]) {
+    unsigned int ichisq=0;
+    for (unsigned int k=0;k<2*n;k+=2) {
+      double iphifactor=kfactor[k]*rstub[k/2]*idelta[k]*(1<<chisqphifactbits)/sigma[k]
+	-iD[0][k]*idpar[0]-iD[1][k]*idpar[1]-iD[2][k]*idpar[2]-iD[3][k]*idpar[3];
+      ichisq+=iphifactor*iphifactor/(1<<(2*chisqphifactbits-4));
+      double irzfactor=kfactor[k+1]*idelta[k+1]*(1<<chisqzfactbits)/sigma[k+1]
+	-iD[0][k+1]*idpar[0]-iD[1][k+1]*idpar[1]-iD[2][k+1]*idpar[2]-iD[3][k+1]*idpar[3];
+      ichisq+=irzfactor*irzfactor/(1<<(2*chisqzfactbits-4));
+    }
+    return ichisq;
+  }
+
+  //Fits ntrk tracks that share the same derivatives (same hit pattern,
+  //t bin and stub radii). delta[itrk] and idelta[itrk] are the residuals
+  //of track itrk; the corrections and chi2 are returned per track.
+  static void fit(unsigned int ntrk, unsigned int n,
+		  const double MinvDt[4][12], const int iMinvDt[4][12],
+		  const double D[4][12], const int iD[4][12],
+		  const double rstub[6], const double sigma[12],
+		  const double kfactor[12],
+		  const double (*delta)[12], const int (*idelta)[12],
+		  double (*dpar)[4], int (*idpar)[4],
+		  double* chisqfit, unsigned int* ichisqfit) {
+    assert(n<=6);
+    for (unsigned int itrk=0;itrk<ntrk;itrk++) {
+      corrections(2*n,MinvDt,delta[itrk],dpar[itrk]);
+      corrections(2*n,iMinvDt,idelta[itrk],idpar[itrk]);
+      chisqfit[itrk]=chisq(n,D,rstub,sigma,delta[itrk],dpar[itrk]);
+      ichisqfit[itrk]=ichisq(n,iD,rstub,sigma,kfactor,idelta[itrk],idpar[itrk]);
+    }
+  }
+
+};
+
+#endif
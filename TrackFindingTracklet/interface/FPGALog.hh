@@ -0,0 +1,37 @@
+//Printout of errors and debug information. The amount of printout that
+//is compiled in is set by FPGA_LOG_LEVEL (0: none, 1: errors, 2: debug),
+//e.g. compile with -DFPGA_LOG_LEVEL=2 to get the debug1 printout. A
+//message above the compiled level is removed by the compiler together
+//with its run time condition, and the streamed arguments of a message
+//are only evaluated when it is printed, so the macros can be used in the
+//hot loops of the processing modules.
+#ifndef FPGALOG_H
+#define FPGALOG_H
+
+#include <iostream>
+
+#define FPGALOG_ERROR 1
+#define FPGALOG_DEBUG 2
+
+#ifndef FPGA_LOG_LEVEL
+#define FPGA_LOG_LEVEL FPGALOG_ERROR
+#endif
+
+//Prints msg (a sequence of << arguments) if level is compiled in and cond is true
+#define FPGA_LOG_IF(level,cond,msg)					\
+  do {									\
+    if ((level)<=FPGA_LOG_LEVEL && (cond)) {				\
+      std::cout << msg << std::endl;					\
+    }									\
+  } while(0)
+
+#define FPGA_ERROR(msg) FPGA_LOG_IF(FPGALOG_ERROR,true,msg)
+
+//Debug printout, enabled at run time by debug1 (FPGAConstants.hh)
+#define FPGA_DEBUG(msg) FPGA_LOG_IF(FPGALOG_DEBUG,debug1,msg)
+
+//True if the debug1 printout is compiled in and enabled, for debug code
+//that is more than a single message
+#define FPGA_DEBUG_ON (FPGALOG_DEBUG<=FPGA_LOG_LEVEL && debug1)
+
+#endif
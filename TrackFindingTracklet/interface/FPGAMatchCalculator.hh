@@ -10,8 +10,8 @@ class FPGAMatchCalculator:public FPGAProcessBase{
 
 public:
 
-  FPGAMatchCalculator(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAMatchCalculator(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
     
     fullmatchesToPlus_=0;
     fullmatchesToMinus_=0;
@@ -71,10 +71,10 @@ public:
 
     //to adjust globaly the phi and rz matching cuts
     phifact_=1.0;
-    if (doKF) phifact_=1.0;
+    if (settings_->doKF()) phifact_=1.0;
     rzfact_=1.0;
 
-    for(unsigned int seedindex=0;seedindex<7;seedindex++){
+    for(unsigned int seedindex=0;seedindex<8;seedindex++){
       phimatchcut_[seedindex]=-1;
       zmatchcut_[seedindex]=-1;
     }
@@ -130,7 +130,7 @@ public:
       zmatchcut_[1]=9.5/kz;
     }
 
-    for(int iseedindex=0;iseedindex<7;iseedindex++){
+    for(int iseedindex=0;iseedindex<8;iseedindex++){
       rphicutPS_[iseedindex]=-1.0;
       rphicut2S_[iseedindex]=-1.0;
       rcutPS_[iseedindex]=-1.0;
@@ -267,6 +267,25 @@ public:
 
     }
 
+    //Integer cut tables applied to the integer residuals. For the layers
+    //the cuts are |ideltaphi|<=iphicut and |ideltaz*fact|<=izcut, for the
+    //disks |ideltaphi*irstub|<=irphicut and |ideltar|<=ircut, separately
+    //for PS (0) and 2S (1) modules. Negative values mark missing cuts.
+    for(int iseedindex=0;iseedindex<8;iseedindex++){
+      iphicut_[iseedindex]=-1;
+      izcut_[iseedindex]=-1;
+      if (phimatchcut_[iseedindex]>0) iphicut_[iseedindex]=floor(phifact_*phimatchcut_[iseedindex]);
+      if (zmatchcut_[iseedindex]>0) izcut_[iseedindex]=floor(rzfact_*zmatchcut_[iseedindex]);
+      for(int module=0;module<2;module++){
+	double drphicut=(module==0)?rphicutPS_[iseedindex]:rphicut2S_[iseedindex];
+	double drcut=(module==0)?rcutPS_[iseedindex]:rcut2S_[iseedindex];
+	irphicut_[module][iseedindex]=-1;
+	ircut_[module][iseedindex]=-1;
+	if (drphicut<0.0 || drcut<0.0) continue;
+	irphicut_[module][iseedindex]=ceil(phifact_*drphicut/(kphiproj123*kr))-1;
+	ircut_[module][iseedindex]=ceil(rzfact_*drcut/krprojshiftdisk)-1;
+      }
+    }
     
   }
 
@@ -348,21 +367,26 @@ public:
     
     assert(fullmatches_.size()!=0);
 
-    unsigned int countall=0;
-    unsigned int countsel=0;
-
     FPGATracklet* oldTracklet=0;
 
     std::vector<std::pair<FPGATracklet*,std::pair<FPGAStub*,L1TStub*> > > mergedMatches=mergeMatches(matches_);
-    
-    for(unsigned int j=0;j<mergedMatches.size();j++){
+
+    unsigned int countall=mergedMatches.size();
+    if (countall>settings_->maxMC()) countall=settings_->maxMC();
+    unsigned int countsel=0;
+
+    candideltaphi_.resize(countall);
+    candideltarz_.resize(countall);
+    candphiscale_.resize(countall);
+    candphicut_.resize(countall);
+    candrzcut_.resize(countall);
+    candpass_.resize(countall);
+
+    //First pass: integer residuals and cuts of all candidate matches
+    for(unsigned int j=0;j<countall;j++){
 	
-      if (debug1&&j==0) {
-        cout << getName() <<" has "<<mergedMatches.size()<<" candidate matches"<<endl;
-      }
+      FPGA_LOG_IF(FPGALOG_DEBUG,debug1&&j==0,getName() <<" has "<<mergedMatches.size()<<" candidate matches");
       
-      countall++;
-	
       L1TStub* stub=mergedMatches[j].second.second;
       FPGAStub* fpgastub=mergedMatches[j].second.first;
       FPGATracklet* tracklet=mergedMatches[j].first;
@@ -375,12 +399,73 @@ public:
 	}
       }
       oldTracklet=tracklet;
+
+      int seedindex=seedIndex(tracklet);
+
+      if (layer_!=0) {
+
+	assert(phimatchcut_[seedindex]>0);
+	assert(zmatchcut_[seedindex]>0);
+
+	layerResidual(tracklet,fpgastub,candideltaphi_[j],candideltarz_[j]);
+	candphiscale_[j]=1;
+	candphicut_[j]=iphicut_[seedindex];
+	candrzcut_[j]=izcut_[seedindex];
+
+      } else {
+
+	//check that stubs and projections in same half of detector
+	assert(stub->z()*tracklet->t()>0.0);
+
+	int disk=disk_;
+	if (tracklet->t()<0) disk=-disk_;
+
+	int iphi,ir;
+	diskResidual(tracklet,stub,fpgastub,disk,candideltaphi_[j],candideltarz_[j],
+		     candphiscale_[j],iphi,ir);
+
+	int module=stub->isPSmodule()?0:1;
+	if (irphicut_[module][seedindex]<0 || ircut_[module][seedindex]<0) {
+	  cout << "drphicut drcut : "<<(module==0?rphicutPS_[seedindex]:rphicut2S_[seedindex])
+	       <<" "<<(module==0?rcutPS_[seedindex]:rcut2S_[seedindex])<<endl;
+	  cout << "disk_ isPS seedindex : "<<disk_<<" "<<stub->isPSmodule()<<" "<<seedindex<<endl;
+	  assert(0);
+	}
+	candphicut_[j]=irphicut_[module][seedindex];
+	candrzcut_[j]=ircut_[module][seedindex];
+
+      }
+
+    }
+
+    //Second pass: the match decisions
+    int rzscale=(layer_!=0)?fact_:1;
+    for(unsigned int j=0;j<countall;j++){
+      candpass_[j]=(abs(candideltaphi_[j]*candphiscale_[j])<=candphicut_[j])&
+	(abs(candideltarz_[j]*rzscale)<=candrzcut_[j]);
+    }
+
+    //Third pass: floating point residuals and output of the accepted matches
+    for(unsigned int j=0;j<countall;j++){
+
+      bool imatch=candpass_[j];
+
+      if ((!imatch)&&(!writeResiduals)&&(!writeDiskMatch1)&&(!FPGA_DEBUG_ON)) continue;
+
+      L1TStub* stub=mergedMatches[j].second.second;
+      FPGAStub* fpgastub=mergedMatches[j].second.first;
+      FPGATracklet* tracklet=mergedMatches[j].first;
+
+      int seedindex=seedIndex(tracklet);
+      int seedlayer=tracklet->layer();
+      int seeddisk=tracklet->disk();
+
+      int ideltaphi=candideltaphi_[j];
       
       if (layer_!=0) {
 	  
-	int seedlayer=tracklet->layer();
-	int seeddisk=tracklet->disk();
-	
+	int ideltaz=candideltarz_[j];
+
 	double phi=stub->phi();
 	double r=stub->r();
 	double z=stub->z();
@@ -399,34 +484,6 @@ public:
 
       	assert(fabs(dr)<drmax);
 
-	int ir=fpgastub->r().value();
-       	int iphi=tracklet->fpgaphiproj(layer_).value();
-
-	int icorr=(ir*tracklet->fpgaphiprojder(layer_).value())>>icorrshift_;
-
-	//cout << "ir phider : "<<ir<<" "<<tracklet->fpgaphiprojder(layer_).value()<<" "<<tracklet->fpgarinv().value()
-	//    <<" "<<((1.0*tracklet->fpgaphiprojder(layer_).value())/tracklet->fpgarinv().value())<<endl;
-	
-	iphi+=icorr;
-	
-	int iz=tracklet->fpgazproj(layer_).value();
-
-	
-	int izcor=(ir*tracklet->fpgazprojder(layer_).value()+(1<<(icorzshift_-1)))>>icorzshift_;
-
-	//cout << "layer iphi iphicor : "<<layer_<<" "<<(tracklet->fpgaphiproj(layer_).value()<<phi0shift_)*kphi1<<" "<<(icorr<<phi0shift_)*kphi1
-	//<<"   FP : "<<tracklet->phiproj(layer_)<<" "<<dr*tracklet->phiprojder(layer_)<<endl;
-
-	//cout << "layer iz izcor : "<<layer_<<" "<<fact_*tracklet->fpgazproj(layer_).value()*kz<<" "<<fact_*izcor*kz<<"  FP : "<<tracklet->zproj(layer_)<<" "<<dr*tracklet->zprojder(layer_)<<endl;
-	
-	iz+=izcor;	
-
-	int ideltaz=fpgastub->z().value()-iz;
-
-	int ideltaphi=(fpgastub->phi().value()<<phi0shift_)-(iphi<<(phi0bitshift-1+phi0shift_)); 
-	
-	assert(fabs(dr)<drmax);
-
 	double dphi=phi-(tracklet->phiproj(layer_)+
 			 dr*tracklet->phiprojder(layer_));
 
@@ -457,34 +514,8 @@ public:
 	double dzapprox=z-(tracklet->zprojapprox(layer_)+
 				   dr*tracklet->zprojderapprox(layer_));
 	
-	//if (layer_<3) {
-	//  cout << "dz: "<<layer_<<" "<<tracklet->zproj(layer_)-
-	//    tracklet->zprojapprox(layer_)<<endl;
-	//}
-
-	
-	int seedindex=-1;
-
-	if (seedlayer==1&&seeddisk==0) seedindex=0;  //L1L2
-	if (seedlayer==3&&seeddisk==0) seedindex=1;  //L3L4
-	if (seedlayer==5&&seeddisk==0) seedindex=2;  //L5L6
-	if (seedlayer==0&&abs(seeddisk)==1) seedindex=3;  //D1D2
-	if (seedlayer==0&&abs(seeddisk)==3) seedindex=4;  //D3D4
-	if (seedlayer==1&&abs(seeddisk)==1) seedindex=5;  //L1D1
-	if (seedlayer==2&&abs(seeddisk)==1) seedindex=6;  //L2D1
-	if (seedlayer==2&&seeddisk==0) seedindex=7;  //L2L3
-
-	if (seedindex<0) {
-	  cout << "seedlayer abs(seeddisk) : "<<seedlayer<<" "<<abs(seeddisk)<<endl;
-	  assert(0);
-	}
-
-	assert(phimatchcut_[seedindex]>0);
-	assert(zmatchcut_[seedindex]>0);
-
-	
 	if (writeResiduals) {
-	  static ofstream out("layerresiduals.txt");
+	  ofstream& out=debugFile("layerresiduals.txt");
 	  
 	  double pt=0.003*3.8/fabs(tracklet->rinv());
 	  
@@ -493,16 +524,8 @@ public:
 	      <<"   "<<ideltaz*fact_*kz<<" "<<dz<<" "<<zmatchcut_[seedindex]*kz<<endl;	  
 	}
 
-	bool imatch=(fabs(ideltaphi)<=phifact_*phimatchcut_[seedindex])&&(fabs(ideltaz*fact_)<=rzfact_*zmatchcut_[seedindex]);
-
-	//if (!imatch) {
-	//  cout << "Match fail in layer "<<layer_<<" dphi dz : "<< (fabs(ideltaphi)<=phifact_*phimatchcut_[seedindex])<<" "<<(fabs(ideltaz*fact_)<=rzfact_*zmatchcut_[seedindex])<<" "<<(fabs(ideltaphi)/(phifact_*phimatchcut_[seedindex]))<<" "<<fabs(ideltaz*fact_)/(rzfact_*zmatchcut_[seedindex])<<endl;
-	//}
-	
-	if (debug1) {
-	  cout << getName()<<" imatch = "<<imatch<<" ideltaphi cut "<<ideltaphi<<" "<<phimatchcut_[seedindex]
-	       <<" ideltaz*fact cut "<<ideltaz*fact_<<" "<<zmatchcut_[seedindex]<<endl;
-	}
+	FPGA_DEBUG(getName()<<" imatch = "<<imatch<<" ideltaphi cut "<<ideltaphi<<" "<<phimatchcut_[seedindex]
+	       <<" ideltaz*fact cut "<<ideltaz*fact_<<" "<<zmatchcut_[seedindex]);
 	
 	if (imatch) {
 	  
@@ -516,11 +539,9 @@ public:
 			     stub->r(),tmp);
 	  
 
-	  if (debug1) {
-	    cout << "Accepted full match in layer " <<getName()
+	  FPGA_DEBUG("Accepted full match in layer " <<getName()
 		 << " "<<tracklet
-		 << " "<<iSector_<<endl;	   
-	  }
+		 << " "<<iSector_);
 	      
 	  if (tracklet->plusNeighbor(layer_)){
 	    
@@ -538,11 +559,8 @@ public:
 	    fullmatchesToPlus_->addMatch(tracklet,tmp);
 	  } else {
 	    for (unsigned int l=0;l<fullmatches_.size();l++){
-	      if (debug1) {
-		cout << getName()<< " Trying to add match to: "<<fullmatches_[l]->getName()<<" "
-		     <<tracklet->layer()<<" "<<tracklet->disk()<<" "<<fullmatches_[l]->getName().substr(3,4)
-		     <<endl;
-	      }
+	      FPGA_DEBUG(getName()<< " Trying to add match to: "<<fullmatches_[l]->getName()<<" "
+		     <<tracklet->layer()<<" "<<tracklet->disk()<<" "<<fullmatches_[l]->getName().substr(3,4));
 	      if (hourglass) {
 		int layer=tracklet->layer();
 		int disk=abs(tracklet->disk());
@@ -555,9 +573,7 @@ public:
 		    (layer==1&&disk==1&&fullmatches_[l]->getName().substr(3,4)=="L1D1")||
 		    (layer==2&&disk==1&&fullmatches_[l]->getName().substr(3,4)=="L2D1")){
 		  assert(tracklet->homeSector()==iSector_);
-		  if (debug1) {
-		    cout << getName()<<" adding match to "<<fullmatches_[l]->getName()<<endl;
-		  }
+		  FPGA_DEBUG(getName()<<" adding match to "<<fullmatches_[l]->getName());
 		  fullmatches_[l]->addMatch(tracklet,tmp);
 		} 
 	      } else {
@@ -575,10 +591,8 @@ public:
 	
       } else {  //disk matches
 	
-	
-	//check that stubs and projections in same half of detector
-	assert(stub->z()*tracklet->t()>0.0);
-	
+	int ideltar=candideltarz_[j];
+
 	int disk=disk_;
 	if (tracklet->t()<0) disk=-disk_;
 	
@@ -586,27 +600,12 @@ public:
 	  
 	double phi=stub->phi();
 	if (phi<0) phi+=two_pi;
-	if (hourglass) {
-	  phi-=phioffset_;
-	} else {
-	  phi-=phioffset_;
-	}
+	phi-=phioffset_;
 	  
 	double dz=stub->z()-tracklet->zprojdisk(disk);
 	
 	assert(fabs(dz)<dzmax);
 	
-	int iz=fpgastub->z().value();
-	  
-	int iphi=tracklet->fpgaphiprojdisk(disk).value();
-
-	int shifttmp=t2bits+tbitshift+phi0bitshift+2-rinvbitshiftdisk-phiderdiskbitshift-PS_phiderD_shift;
-
-	assert(shifttmp>=0);
-	int iphicorr=(iz*tracklet->fpgaphiprojderdisk(disk).value())>>shifttmp;
-	
-	iphi+=iphicorr;
-	  
 	double phicorr=dz*tracklet->phiprojderdisk(disk);
 
 	assert(fabs(tracklet->phiprojderdisk(disk))<0.1);
@@ -614,35 +613,12 @@ public:
 	
 	double phiproj=tracklet->phiprojdisk(disk)+phicorr;
 	
-	int ir=tracklet->fpgarprojdisk(disk).value();
-	
-	  
-	int shifttmp2=rprojdiskbitshift+t3shift-rderdiskbitshift;
-	
-	assert(shifttmp2>=0);
-	int ircorr=(iz*tracklet->fpgarprojderdisk(disk).value())>>shifttmp2;
-										
-	ir+=ircorr;
-
 	double rcorr=dz*tracklet->rprojderdisk(disk);
 
 	double rproj=tracklet->rprojdisk(disk)+rcorr;
 	
-	int ideltaphi=fpgastub->phi().value()*kphi/kphiproj123-iphi; 
-	
 	double deltar=stub->r()-rproj;
 	  
-	int irstub = fpgastub->r().value();
-	if(!stub->isPSmodule()){
-	  if (disk_<=2) {
-	    irstub = rDSSinner[irstub]/kr;
-	  } else {
-	    irstub = rDSSouter[irstub]/kr;
-	  }
-	}
-	
-	int ideltar=(irstub*krdisk)/krprojshiftdisk-ir;
-	
 	double dr=stub->r()-(tracklet->rprojdisk(disk)+
 			     dz*tracklet->rprojderdisk(disk));
 	
@@ -662,8 +638,6 @@ public:
 	  while (dphi<-0.5*two_pi/NSector) dphi+=two_pi/NSector;
 	}
 	  
-	//cout << getName()<<" "<<phi<<" "<<tracklet->phiprojapproxdisk(disk)<<endl;
-	
 	double dphiapprox=phi-(tracklet->phiprojapproxdisk(disk)+
 			       dz*tracklet->phiprojderapproxdisk(disk));
 
@@ -680,9 +654,6 @@ public:
 	  while (dphiapprox<-0.5*two_pi/NSector) dphiapprox+=two_pi/NSector;
 	}
 	  
-	//cout << getName() << "dphiapprox "<<dphiapprox<<endl;
-
-	  
 	double drapprox=stub->r()-(tracklet->rprojapproxdisk(disk)+
 				   dz*tracklet->rprojderapproxdisk(disk));
 	
@@ -701,38 +672,6 @@ public:
 	  double alphanew=stub->alphanew();
 	  drphi+=dr*alphanew*4.57/stub->r();
 	  drphiapprox+=dr*alphanew*4.57/stub->r();
-
-	  
-	  int ialphanew=fpgastub->alphanew().value();
-
-	  int alphashift=12;
-	  double fact=(1<<alphashift)*krprojshiftdisk*4.57/(1<<(nbitsalpha-1))/stub->r2()/kphiproj123;
-	  int ifact=fact;
-	  
-	  int iphialphacor=((ideltar*ialphanew*ifact)>>alphashift);
-
-	  ideltaphi+=iphialphacor;
-	}
-	
-
-
-	int seedlayer=tracklet->layer();
-	int seeddisk=tracklet->disk();
-
-	int seedindex=-1;
-
-	if (seedlayer==1&&seeddisk==0) seedindex=0;  //L1L2
-	if (seedlayer==3&&seeddisk==0) seedindex=1;  //L3L4
-	if (seedlayer==5&&seeddisk==0) seedindex=2;  //L5L6
-	if (seedlayer==0&&abs(seeddisk)==1) seedindex=3;  //D1D2
-	if (seedlayer==0&&abs(seeddisk)==3) seedindex=4;  //D3D4
-	if (seedlayer==1&&abs(seeddisk)==1) seedindex=5;  //L1D1
-	if (seedlayer==2&&abs(seeddisk)==1) seedindex=6;  //L2D1
-	if (seedlayer==2&&seeddisk==0) seedindex=7;  //L2L3
-
-	if (seedindex<0) {
-	  cout << "seedlayer abs(seeddisk) : "<<seedlayer<<" "<<abs(seeddisk)<<endl;
-	  assert(0);
 	}
 	
 	double drphicut=rphicutPS_[seedindex];
@@ -742,15 +681,8 @@ public:
 	  drcut=rcut2S_[seedindex]; 
 	}
 	
-
-	if (drphicut<0.0 || drcut<0.0) {
-	  cout << "drphicut drcut : "<<drphicut<<" "<<drcut<<endl;
-	  cout << "disk_ isPS seedindex : "<<disk_<<" "<<stub->isPSmodule()<<" "<<seedindex<<endl;
-	  assert(0);
-	}
-	
 	if (writeResiduals) {
-	  static ofstream out("diskresiduals.txt");
+	  ofstream& out=debugFile("diskresiduals.txt");
 	  
 	  double pt=0.003*3.8/fabs(tracklet->rinv());
 	  
@@ -764,12 +696,8 @@ public:
 	      <<endl;	  
 	}
 
-	
-	bool match=(fabs(drphi)<drphicut)&&(fabs(deltar)<drcut);
-	
-	bool imatch=(fabs(ideltaphi*irstub)<phifact_*drphicut/(kphiproj123*kr))&&(fabs(ideltar)<rzfact_*drcut/krprojshiftdisk);
-
-	if (debug1) {
+	if (FPGA_DEBUG_ON) {
+	  bool match=(fabs(drphi)<drphicut)&&(fabs(deltar)<drcut);
 	  cout << "imatch match disk: "<<imatch<<" "<<match<<" "
 	       <<fabs(ideltaphi)<<" "<<drphicut/(kphiproj123*stub->r())<<" "
 	       <<fabs(ideltar)<<" "<<drcut/krprojshiftdisk<<" r = "<<stub->r()<<endl;
@@ -777,7 +705,10 @@ public:
 	
 	if (writeDiskMatch1) {
 
-	  static ofstream out1("diskmatch1.txt");
+	  ofstream& out1=debugFile("diskmatch1.txt");
+
+	  int ideltaphitmp,ideltartmp,irstubtmp,iphi,ir;
+	  diskResidual(tracklet,stub,fpgastub,disk,ideltaphitmp,ideltartmp,irstubtmp,iphi,ir);
 	  
 	  out1 << disk<<" "
 	       << phiproj<<" "
@@ -799,9 +730,7 @@ public:
 	    
 	  countsel++;
 	  
-	  if (debug1) {
-	    cout << "FPGAMatchCalculator found match in disk "<<getName()<<endl;
-	  }
+	  FPGA_DEBUG("FPGAMatchCalculator found match in disk "<<getName());
 
 
 	  assert(fabs(dphi)<0.2);
@@ -812,18 +741,14 @@ public:
 				 stub->alpha(),
 				 (fpgastub->phiregion().value()<<7)+fpgastub->stubindex().value(),
 				 stub->z(),tmp);
-	  if (debug1) {
-	    cout << "Accepted full match in disk " <<getName()
+	  FPGA_DEBUG("Accepted full match in disk " <<getName()
 		 << " "<<tracklet
-		 << " "<<iSector_<<endl;	   
-	  }
+		 << " "<<iSector_);
 	  
 	  if (tracklet->plusNeighborDisk(disk)){
 	    fullmatchesToMinus_->addMatch(tracklet,tmp);
-	    if (debug1) {
-	      cout << "Accepted full match to minus in disk " <<getName()<<" "<<tracklet
-		   <<" "<<fullmatchesToMinus_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("Accepted full match to minus in disk " <<getName()<<" "<<tracklet
+		   <<" "<<fullmatchesToMinus_->getName());
 	    int nmatch=fullmatchesToMinus_->nMatches();
 	    if (nmatch>1) {
 	      assert(fullmatchesToMinus_->getFPGATracklet(nmatch-2)->TCID()<
@@ -831,10 +756,8 @@ public:
 	    }
 	  } else if (tracklet->minusNeighborDisk(disk)) {
 	    fullmatchesToPlus_->addMatch(tracklet,tmp);
-	    if (debug1) {
-	      cout << "Accepted full match to plus in disk " <<getName()<<" "<<tracklet
-		   <<" "<<fullmatchesToPlus_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("Accepted full match to plus in disk " <<getName()<<" "<<tracklet
+		   <<" "<<fullmatchesToPlus_->getName());
 	  } else {
 	    for (unsigned int l=0;l<fullmatches_.size();l++){
 	      if (hourglass) {
@@ -849,9 +772,7 @@ public:
 		    (layer==2&&disk==1&&fullmatches_[l]->getName().substr(3,4)=="L2D1")||
 		    (layer==2&&disk==0&&fullmatches_[l]->getName().substr(3,4)=="L2L3")){
 		  assert(tracklet->homeSector()==iSector_);
-		  if (debug1) {
-		    cout << getName()<<" adding match to "<<fullmatches_[l]->getName()<<endl;
-		  }
+		  FPGA_DEBUG(getName()<<" adding match to "<<fullmatches_[l]->getName());
 		  fullmatches_[l]->addMatch(tracklet,tmp);
 		}
 	      } else {
@@ -862,21 +783,20 @@ public:
 		    ((tracklet->disk()==0&&tracklet->layer()==3)&&fullmatches_[l]->getName().substr(3,4)=="L3L4")||
 		    ((abs(tracklet->disk())==3&&tracklet->layer()==0)&&fullmatches_[l]->getName().substr(3,4)=="D3D4")){
 		  fullmatches_[l]->addMatch(tracklet,tmp);
-		  if (debug1) {
-		    cout << "In "<<getName()<<" added match to "<<fullmatches_[l]->getName()<<endl;
-		  }
+		  FPGA_DEBUG("In "<<getName()<<" added match to "<<fullmatches_[l]->getName());
 		}
 	      }
 	    }
 	  }
 	}
       }
-      if (countall>=MAXMC) break;
     }
 
 
+    countIterations(countall,mergedMatches.size()-countall);
+
     if (writeMatchCalculator) {
-      static ofstream out("matchcalculator.txt");
+      ofstream& out=debugFile("matchcalculator.txt");
       out << getName()<<" "<<countall<<" "<<countsel<<endl;
     }
 
@@ -884,6 +804,106 @@ public:
   }
 
 
+  int seedIndex(FPGATracklet* tracklet) const {
+
+    int seedlayer=tracklet->layer();
+    int seeddisk=tracklet->disk();
+
+    int seedindex=-1;
+
+    if (seedlayer==1&&seeddisk==0) seedindex=0;  //L1L2
+    if (seedlayer==3&&seeddisk==0) seedindex=1;  //L3L4
+    if (seedlayer==5&&seeddisk==0) seedindex=2;  //L5L6
+    if (seedlayer==0&&abs(seeddisk)==1) seedindex=3;  //D1D2
+    if (seedlayer==0&&abs(seeddisk)==3) seedindex=4;  //D3D4
+    if (seedlayer==1&&abs(seeddisk)==1) seedindex=5;  //L1D1
+    if (seedlayer==2&&abs(seeddisk)==1) seedindex=6;  //L2D1
+    if (seedlayer==2&&seeddisk==0) seedindex=7;  //L2L3
+
+    if (seedindex<0) {
+      cout << "seedlayer abs(seeddisk) : "<<seedlayer<<" "<<abs(seeddisk)<<endl;
+      assert(0);
+    }
+
+    return seedindex;
+  }
+
+  //Integer phi and z residuals of a stub and a projection to a layer
+  void layerResidual(FPGATracklet* tracklet, FPGAStub* fpgastub,
+		     int& ideltaphi, int& ideltaz) const {
+
+    int ir=fpgastub->r().value();
+    int iphi=tracklet->fpgaphiproj(layer_).value();
+
+    int icorr=(ir*tracklet->fpgaphiprojder(layer_).value())>>icorrshift_;
+
+    iphi+=icorr;
+	
+    int iz=tracklet->fpgazproj(layer_).value();
+	
+    int izcor=(ir*tracklet->fpgazprojder(layer_).value()+(1<<(icorzshift_-1)))>>icorzshift_;
+
+    iz+=izcor;	
+
+    ideltaz=fpgastub->z().value()-iz;
+
+    ideltaphi=(fpgastub->phi().value()<<phi0shift_)-(iphi<<(phi0bitshift-1+phi0shift_)); 
+
+  }
+
+  //Integer phi and r residuals of a stub and a projection to a disk. Also
+  //returns the stub radius used in the phi cut and the projected phi and r.
+  void diskResidual(FPGATracklet* tracklet, L1TStub* stub, FPGAStub* fpgastub,
+		    int disk, int& ideltaphi, int& ideltar, int& irstub,
+		    int& iphi, int& ir) const {
+
+    int iz=fpgastub->z().value();
+	  
+    iphi=tracklet->fpgaphiprojdisk(disk).value();
+
+    int shifttmp=t2bits+tbitshift+phi0bitshift+2-rinvbitshiftdisk-phiderdiskbitshift-PS_phiderD_shift;
+
+    assert(shifttmp>=0);
+    int iphicorr=(iz*tracklet->fpgaphiprojderdisk(disk).value())>>shifttmp;
+	
+    iphi+=iphicorr;
+	  
+    ir=tracklet->fpgarprojdisk(disk).value();
+	
+    int shifttmp2=rprojdiskbitshift+t3shift-rderdiskbitshift;
+	
+    assert(shifttmp2>=0);
+    int ircorr=(iz*tracklet->fpgarprojderdisk(disk).value())>>shifttmp2;
+										
+    ir+=ircorr;
+
+    ideltaphi=fpgastub->phi().value()*kphi/kphiproj123-iphi; 
+	
+    irstub = fpgastub->r().value();
+    if(!stub->isPSmodule()){
+      if (disk_<=2) {
+	irstub = rDSSinner[irstub]/kr;
+      } else {
+	irstub = rDSSouter[irstub]/kr;
+      }
+    }
+	
+    ideltar=(irstub*krdisk)/krprojshiftdisk-ir;
+	
+    if (!stub->isPSmodule()) {
+      int ialphanew=fpgastub->alphanew().value();
+
+      int alphashift=12;
+      double fact=(1<<alphashift)*krprojshiftdisk*4.57/(1<<(nbitsalpha-1))/stub->r2()/kphiproj123;
+      int ifact=fact;
+	  
+      int iphialphacor=((ideltar*ialphanew*ifact)>>alphashift);
+
+      ideltaphi+=iphialphacor;
+    }
+
+  }
+
     std::vector<std::pair<FPGATracklet*,std::pair<FPGAStub*,L1TStub*> > > mergeMatches(vector<FPGACandidateMatch*>& candmatch) {
 
     std::vector<std::pair<FPGATracklet*,std::pair<FPGAStub*,L1TStub*> > >  tmp;
@@ -1028,6 +1048,20 @@ private:
   double rcutPS_[8];
   double rcut2S_[8];
 
+  int iphicut_[8];
+  int izcut_[8];
+  int irphicut_[2][8];
+  int ircut_[2][8];
+
+  //Per candidate match integer residuals, scale factor of the phi
+  //residual, cuts and decisions; reused from event to event
+  std::vector<int> candideltaphi_;
+  std::vector<int> candideltarz_;
+  std::vector<int> candphiscale_;
+  std::vector<int> candphicut_;
+  std::vector<int> candrzcut_;
+  std::vector<int> candpass_;
+
   double phifact_;
   double rzfact_;
   
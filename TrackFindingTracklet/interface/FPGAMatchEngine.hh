@@ -11,8 +11,8 @@ class FPGAMatchEngine:public FPGAProcessBase{
 
 public:
 
-  FPGAMatchEngine(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAMatchEngine(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
     layer_=0;
     disk_=0;
     string subname=name.substr(3,2);
@@ -113,15 +113,14 @@ public:
 
     unsigned int countall=0;
     unsigned int countpass=0;
+    unsigned int countdropped=0; //stubs not tried because of the maxME limit
 
     for(unsigned int j=0;j<vmprojs_->nTracklets();j++){
       FPGATracklet* proj=vmprojs_->getFPGATracklet(j);
 
       int nmatches=0;
       
-      if (debug1) {
-	cout << "Found projection in "<<getName()<<endl;
-      }
+      FPGA_DEBUG("Found projection in "<<getName());
      	
       if (layer_>0){
 
@@ -137,9 +136,7 @@ public:
 	  unsigned int nstub=vmstubs_->nStubsBin(ibin);
 	  
 	  for(unsigned int i=0;i<nstub;i++){
-	    if (debug1) {
-	      cout << "Found stub in "<<getName()<<endl;
-	    }
+	    FPGA_DEBUG("Found stub in "<<getName());
 	    std::pair<FPGAStub*,L1TStub*> stub=vmstubs_->getStubBin(ibin,i);
 	    countall++;
 
@@ -174,10 +171,8 @@ public:
 	      //   <<((stub.first->z().value()>>(stub.first->z().nbits()-6))&7)
 	      //   <<" "<<z<<endl;
 	      if (abs(idz)>2) {
-		if (debug1) {
-		  cout << getName()<<" Match rejected for L1L2 seed with dz = "
-		       <<dz<<" idz = "<<idz<<endl;
-		}
+		FPGA_DEBUG(getName()<<" Match rejected for L1L2 seed with dz = "
+		       <<dz<<" idz = "<<idz);
 		continue;
 	      }
 	    } else {
@@ -196,22 +191,21 @@ public:
 	    bool pass=table_[index];
 
 	    if (!pass) {
-	      if (debug1) {
-		cout << "Match rejected with bend lookup index = "
-		     <<index<<endl; 
-	      }
+	      FPGA_DEBUG("Match rejected with bend lookup index = "
+		     <<index);
 	      continue;
 	    }
-	    if (debug1) {
-	      cout << "Adding match in "<<getName()<<endl;
-	    }
+	    FPGA_DEBUG("Adding match in "<<getName());
 	    
 	    countpass++;
 	    if (nmatches<1000) {
 	      candmatches_->addMatch(proj,stub);
 	    }
 	    nmatches++;
-	    if (countall>=MAXME) break;
+	    if (countall>=settings_->maxME()) {
+	      countdropped+=nstub-i-1;
+	      break;
+	    }
 	  }
 	}
       } // if (layer_>0)      
@@ -229,9 +223,7 @@ public:
 	  unsigned int nstub=vmstubs_->nStubsBin(ibin);
 
 	  for(unsigned int i=0;i<nstub;i++){
-	    if (debug1) {
-	      cout << "Found stub in "<<getName()<<endl;
-	    }
+	    FPGA_DEBUG("Found stub in "<<getName());
 	    std::pair<FPGAStub*,L1TStub*> stub=vmstubs_->getStubBin(ibin,i);
 	    countall++;
 
@@ -256,16 +248,12 @@ public:
 
 	    if (stub.first->isPSmodule()){
 	      if (abs(idr)>1) {
-		if (debug1) {
-		  cout << getName() << "PS stub rejected with idr = "<<idr<<endl;
-		}
+		FPGA_DEBUG(getName() << "PS stub rejected with idr = "<<idr);
 		continue;
 	      }
 	    } else {
 	      if (abs(idr)>5) {
-		if (debug1) {
-		  cout << getName() << "2S stub rejected with idr = "<<idr<<endl;
-		}
+		FPGA_DEBUG(getName() << "2S stub rejected with idr = "<<idr);
 		continue;
 	      }
 	    }
@@ -290,9 +278,7 @@ public:
 	    }
 	    
 	    if (!pass) {
-	      if (debug1) {
-		cout << getName() << "stub rejected with index = "<<index<<endl;
-	      }
+	      FPGA_DEBUG(getName() << "stub rejected with index = "<<index);
 	      continue;
 	    }
 	    
@@ -300,13 +286,14 @@ public:
 	    
 	    countpass++;
 	    if (nmatches<1000) {
-	      if (debug1) {
-		cout << getName() << " adding match "<<endl;
-	      }
+	      FPGA_DEBUG(getName() << " adding match ");
 	      candmatches_->addMatch(proj,stub);
 	    }
 	    nmatches++;
-	    if (countall>=MAXME) break;
+	    if (countall>=settings_->maxME()) {
+	      countdropped+=nstub-i-1;
+	      break;
+	    }
 	    
 	  }
 	}
@@ -320,8 +307,10 @@ public:
     } // outer for loop
      
     
+    countIterations(countall,countdropped);
+
     if (writeME) {
-      static ofstream out("matchengine.txt");
+      ofstream& out=debugFile("matchengine.txt");
       out << getName()<<" "<<countall<<" "<<countpass<<endl;
     }
 
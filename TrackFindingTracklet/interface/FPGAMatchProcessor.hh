@@ -10,8 +10,8 @@ class FPGAMatchProcessor:public FPGAProcessBase{
 
 public:
 
-  FPGAMatchProcessor(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAMatchProcessor(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
     
     fullmatchesToPlus_=0;
     fullmatchesToMinus_=0;
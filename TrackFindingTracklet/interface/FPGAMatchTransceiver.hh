@@ -10,8 +10,8 @@ class FPGAMatchTransceiver:public FPGAProcessBase{
 
 public:
 
-  FPGAMatchTransceiver(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAMatchTransceiver(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
     
   }
 
@@ -156,7 +156,7 @@ public:
 	}
 
     if (writeMatchTransceiver) {
-      static ofstream out("matchtransceiver.txt");
+      ofstream& out=debugFile("matchtransceiver.txt");
       out << getName() << " " 
 	  << count << endl;
     }
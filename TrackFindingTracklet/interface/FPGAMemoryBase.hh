@@ -2,17 +2,21 @@
 #ifndef FPGAMEMORYBASE_H
 #define FPGAMEMORYBASE_H
 
+#include "FPGASettings.hh"
+
 using namespace std;
 
 class FPGAMemoryBase{
 
 public:
 
-  FPGAMemoryBase(string name, unsigned int iSector){
+  FPGAMemoryBase(string name, const FPGASettings* settings, unsigned int iSector){
     name_=name;
+    settings_=settings;
     iSector_=iSector;
     bx_=0;
     event_=0;
+    ndropped_=0;
   }
 
   virtual ~FPGAMemoryBase(){}
@@ -21,15 +25,32 @@ public:
 
   virtual void clean()=0;
 
+  //Number of entries (stubs, stub pairs, tracklets, matches or tracks)
+  //currently stored in the memory
+  virtual unsigned int nEntries() const=0;
+
+  unsigned int getSector() const {return iSector_;}
+
+  //Number of entries dropped in the current event because the memory was full
+  unsigned int nDropped() const {return ndropped_;}
+  void resetDropped() {ndropped_=0;}
+
+  //Number of entries in the current event beyond the memory depth
+  //(only the fixed depth memories count overflows)
+  virtual unsigned int nOverflow() const {return 0;}
+
 protected:
 
   string name_;
+  const FPGASettings* settings_;
   unsigned int iSector_;
 
   ofstream out_;
   int bx_;
   int event_;
 
+  unsigned int ndropped_;
+
 
 };
 
@@ -0,0 +1,73 @@
+//This class implements a fixed depth memory page. The storage is
+//allocated once and reused from event to event; reset() only rewinds
+//the write pointer. Entries written beyond the depth are counted as
+//overflows and either dropped (truncation enabled) or kept by growing
+//the storage (emulation without truncation).
+#ifndef FPGAMEMORYBUFFER_H
+#define FPGAMEMORYBUFFER_H
+
+#include <vector>
+#include <cassert>
+
+using namespace std;
+
+template<class T>
+class FPGAMemoryBuffer{
+
+public:
+
+  FPGAMemoryBuffer(){
+    depth_=0;
+    truncate_=false;
+    n_=0;
+    noverflow_=0;
+  }
+
+  void init(unsigned int depth, bool truncate) {
+    depth_=depth;
+    truncate_=truncate;
+    data_.resize(depth_);
+    n_=0;
+    noverflow_=0;
+  }
+
+  //Returns false if the entry was dropped
+  bool push_back(const T& entry) {
+    if (n_<data_.size()) {
+      if (n_>=depth_) noverflow_++;
+      data_[n_++]=entry;
+      return true;
+    }
+    noverflow_++;
+    if (truncate_) return false;
+    data_.push_back(entry);
+    n_++;
+    return true;
+  }
+
+  void reset() {
+    n_=0;
+    noverflow_=0;
+  }
+
+  unsigned int size() const {return n_;}
+  bool empty() const {return n_==0;}
+  unsigned int depth() const {return depth_;}
+  unsigned int nOverflow() const {return noverflow_;}
+
+  const T& operator[](unsigned int i) const {
+    assert(i<n_);
+    return data_[i];
+  }
+
+private:
+
+  unsigned int depth_;
+  bool truncate_;
+  unsigned int n_;
+  unsigned int noverflow_;
+  std::vector<T> data_;
+
+};
+
+#endif
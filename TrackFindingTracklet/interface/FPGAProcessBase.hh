@@ -2,15 +2,27 @@
 #ifndef FPGAPROCESSBASE_H
 #define FPGAPROCESSBASE_H
 
+#include "FPGASettings.hh"
+#include "FPGAMemoryBase.hh"
+#include "FPGATimer.hh"
+#include "FPGAScratch.hh"
+#include "FPGALog.hh"
+
 using namespace std;
 
 class FPGAProcessBase{
 
 public:
 
-  FPGAProcessBase(string name, unsigned int iSector){
+  FPGAProcessBase(string name, const FPGASettings* settings, unsigned int iSector){
     name_=name;
+    settings_=settings;
     iSector_=iSector;
+    nitems_=0;
+    nitemsstart_=0;
+    niterations_=0;
+    ntruncated_=0;
+    scratch_=0;
   }
 
   virtual ~FPGAProcessBase() { } 
@@ -21,6 +33,58 @@ public:
 
   string getName() const {return name_;}
 
+  unsigned int getSector() const {return iSector_;}
+
+  //The module type is the prefix of the name, e.g. TE for TE_L1PHIA1_L2PHIA1
+  string getType() const {return name_.substr(0,name_.find('_'));}
+
+  //Output memories are registered by FPGASector::addWire so that the
+  //profiling can count the number of items produced by the module
+  void registerOutput(FPGAMemoryBase* memory) {outputmems_.push_back(memory);}
+
+  unsigned int nOutputEntries() const {
+    unsigned int n=0;
+    for (unsigned int i=0;i<outputmems_.size();i++){
+      n+=outputmems_[i]->nEntries();
+    }
+    return n;
+  }
+
+  void startTimer() {
+    nitemsstart_=nOutputEntries();
+    timer_.start();
+  }
+
+  void stopTimer() {
+    timer_.stop();
+    nitems_+=nOutputEntries()-nitemsstart_;
+  }
+
+  const FPGATimer& timer() const {return timer_;}
+  unsigned long nItems() const {return nitems_;}
+  void resetTimer() {timer_=FPGATimer(); nitems_=0;}
+
+  //Iteration and truncation counters for the current event. ntruncated is
+  //the number of items left unprocessed by the MAX* limits, so it stays 0
+  //if a loop reaches the limit with nothing pending. They are read and
+  //reset by FPGAStatistics.
+  void countIterations(unsigned int niterations, unsigned int ntruncated) {
+    niterations_+=niterations;
+    ntruncated_+=ntruncated;
+  }
+  unsigned int nIterations() const {return niterations_;}
+  unsigned int nTruncated() const {return ntruncated_;}
+  void resetCounters() {niterations_=0; ntruncated_=0;}
+
+  //Set by FPGASector when the module is created
+  void setScratch(FPGAScratch* scratch) {scratch_=scratch;}
+
+  //Debug output file shared with the other modules writing to it
+  ofstream& debugFile(const string& name) {
+    assert(scratch_!=0);
+    return scratch_->debugFile(name);
+  }
+
   unsigned int nbits(unsigned int power) {
 
     if (power==2) return 1;
@@ -40,8 +104,19 @@ public:
 protected:
 
   string name_;
+  const FPGASettings* settings_;
   unsigned int iSector_;
 
+  std::vector<FPGAMemoryBase*> outputmems_;
+
+  FPGATimer timer_;
+  unsigned long nitems_;
+  unsigned int nitemsstart_;
+
+  unsigned int niterations_;
+  unsigned int ntruncated_;
+
+  FPGAScratch* scratch_;
 
 };
 
@@ -0,0 +1,159 @@
+//This class collects the per processing module timing and writes
+//the end of job report and (optionally) a Chrome trace-format file
+#ifndef FPGAPROFILER_H
+#define FPGAPROFILER_H
+
+#include "FPGATimer.hh"
+#include "FPGAProcessBase.hh"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class FPGAProfiler{
+
+public:
+
+  FPGAProfiler(){
+    t0_=FPGATimer::clock::now();
+    nevents_=0;
+    maxTraceEvents_=0;
+  }
+
+  ~FPGAProfiler(){}
+
+  //Record individual module executions for the first maxevents events
+  void enableTrace(unsigned int maxevents) {maxTraceEvents_=maxevents;}
+
+  void beginEvent() {nevents_++;}
+
+  //Clears the module timers, the event count and the trace, e.g. after
+  //warm-up events. The stage timers are owned and reset by the caller.
+  void reset() {
+    t0_=FPGATimer::clock::now();
+    nevents_=0;
+    trace_.clear();
+    for (unsigned int i=0;i<procs_.size();i++){
+      procs_[i]->resetTimer();
+    }
+  }
+
+  unsigned int nEvents() const {return nevents_;}
+
+  void start(FPGAProcessBase* proc) {
+    proc->startTimer();
+  }
+
+  void stop(FPGAProcessBase* proc) {
+    proc->stopTimer();
+    if (nevents_<=maxTraceEvents_) {
+      TraceEntry entry;
+      entry.name=proc->getName();
+      entry.type=proc->getType();
+      entry.sector=proc->getSector();
+      entry.start=proc->timer().starttime(t0_);
+      entry.duration=proc->timer().lasttime();
+      trace_.push_back(entry);
+    }
+  }
+
+  //Stage level timers (covering all sectors) are owned by the caller,
+  //they are only registered here to be included in the report
+  void addStage(string name, const FPGATimer* timer) {
+    stagenames_.push_back(name);
+    stages_.push_back(timer);
+  }
+
+  void addProcess(FPGAProcessBase* proc) {
+    procs_.push_back(proc);
+  }
+
+  //Writes a JSON report with one entry per stage and per processing
+  //module instance. Times are in seconds.
+  void writeReport(string filename) const {
+
+    ofstream out(filename.c_str());
+
+    out << "{" << endl;
+    out << "  \"nevents\": " << nevents_ << "," << endl;
+
+    out << "  \"stages\": [" << endl;
+    for (unsigned int i=0;i<stages_.size();i++){
+      const FPGATimer* timer=stages_[i];
+      out << "    {\"name\": \"" << stagenames_[i] << "\""
+	  << ", \"ncalls\": " << timer->ntimes()
+	  << ", \"tottime\": " << timer->tottime()
+	  << ", \"avgtime\": " << timer->avgtime()
+	  << ", \"rms\": " << timer->rms() << "}"
+	  << (i+1<stages_.size()?",":"") << endl;
+    }
+    out << "  ]," << endl;
+
+    out << "  \"modules\": [" << endl;
+    for (unsigned int i=0;i<procs_.size();i++){
+      const FPGAProcessBase* proc=procs_[i];
+      const FPGATimer& timer=proc->timer();
+      out << "    {\"name\": \"" << proc->getName() << "\""
+	  << ", \"type\": \"" << proc->getType() << "\""
+	  << ", \"sector\": " << proc->getSector()
+	  << ", \"ncalls\": " << timer.ntimes()
+	  << ", \"nitems\": " << proc->nItems()
+	  << ", \"tottime\": " << timer.tottime()
+	  << ", \"avgtime\": " << timer.avgtime()
+	  << ", \"rms\": " << timer.rms() << "}"
+	  << (i+1<procs_.size()?",":"") << endl;
+    }
+    out << "  ]" << endl;
+    out << "}" << endl;
+
+  }
+
+  //Writes the recorded module executions in the Chrome trace event format
+  //(load in chrome://tracing or Perfetto). Sectors are shown as threads.
+  void writeTrace(string filename) const {
+
+    ofstream out(filename.c_str());
+
+    out << "{\"traceEvents\":[" << endl;
+    for (unsigned int i=0;i<trace_.size();i++){
+      const TraceEntry& entry=trace_[i];
+      out << "{\"name\":\"" << entry.name << "\""
+	  << ",\"cat\":\"" << entry.type << "\""
+	  << ",\"ph\":\"X\""
+	  << ",\"ts\":" << entry.start*1.0e6
+	  << ",\"dur\":" << entry.duration*1.0e6
+	  << ",\"pid\":0"
+	  << ",\"tid\":" << entry.sector << "}"
+	  << (i+1<trace_.size()?",":"") << endl;
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}" << endl;
+
+  }
+
+private:
+
+  struct TraceEntry{
+    string name;
+    string type;
+    unsigned int sector;
+    double start;
+    double duration;
+  };
+
+  FPGATimer::clock::time_point t0_;
+
+  unsigned int nevents_;
+  unsigned int maxTraceEvents_;
+
+  std::vector<string> stagenames_;
+  std::vector<const FPGATimer*> stages_;
+
+  std::vector<FPGAProcessBase*> procs_;
+
+  std::vector<TraceEntry> trace_;
+
+};
+
+#endif
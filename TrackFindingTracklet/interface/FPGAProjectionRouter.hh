@@ -3,6 +3,7 @@
 #define FPGAPROJECTIONROUTER_H
 
 #include "FPGAProcessBase.hh"
+#include "FPGAContext.hh"
 
 using namespace std;
 
@@ -10,8 +11,10 @@ class FPGAProjectionRouter:public FPGAProcessBase{
 
 public:
 
-  FPGAProjectionRouter(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAProjectionRouter(string name, const FPGASettings* settings, unsigned int iSector,
+		       const FPGAContext* context):
+    FPGAProcessBase(name,settings,iSector){
+    context_=context;
     string subname=name.substr(8,2);
     if (hourglass) {
       subname=name.substr(3,2);
@@ -43,8 +46,8 @@ public:
     assert(disk_!=0||layer_!=0);
     allproj_=0;
 
-    nrbits_=5;
-    nphiderbits_=6;
+    nrbits_=context_->projectionRouterBendTable().nrbits();
+    nphiderbits_=context_->projectionRouterBendTable().nphiderbits();
 
     
   }
@@ -235,7 +238,7 @@ public:
 	for (unsigned int i=0;i<inputproj_[j]->nTracklets();i++){
 
 	  count++;
-	  if (count>MAXPROJROUTER) continue;
+	  if (count>settings_->maxProjRouter()) continue;
 
 	  FPGAWord fpgaphi=inputproj_[j]->getFPGATracklet(i)->fpgaphiproj(layer_);
 	  FPGAWord fpgaz=inputproj_[j]->getFPGATracklet(i)->fpgazproj(layer_);
@@ -322,65 +325,49 @@ public:
 	  
 	  if (iphi==0) {
 	    assert(vmprojPHI1_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI1_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI1_->getName());
 	    vmprojPHI1_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 
 	  if (iphi==1) {
 	    assert(vmprojPHI2_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI2_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI2_->getName());
 	    vmprojPHI2_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 
 	  if (iphi==2) {
 	    assert(vmprojPHI3_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI3_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI3_->getName());
 	    vmprojPHI3_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 
 	  if (iphi==3) {
 	    assert(vmprojPHI4_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI4_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI4_->getName());
 	    vmprojPHI4_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 
 	  if (iphi==4) {
 	    assert(vmprojPHI5_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI5_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI5_->getName());
 	    vmprojPHI5_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 	  
 	  if (iphi==5) {
 	    assert(vmprojPHI6_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI6_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI6_->getName());
 	    vmprojPHI6_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 	  
 	  if (iphi==6) {
 	    assert(vmprojPHI7_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI7_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI7_->getName());
 	    vmprojPHI7_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 	  
 	  if (iphi==7) {
 	    assert(vmprojPHI8_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI8_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI8_->getName());
 	    vmprojPHI8_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 	  
@@ -391,7 +378,7 @@ public:
 
 	for (unsigned int i=0;i<inputproj_[j]-> nTracklets();i++){
 	  count++;
-	  if (count>MAXPROJROUTER) continue;
+	  if (count>settings_->maxProjRouter()) continue;
 
 	  int disk=disk_;
 	  if (inputproj_[j]->getFPGATracklet(i)->t()<0.0) disk=-disk_;
@@ -443,71 +430,55 @@ public:
 	    (rindex<<(nphiderbits_))+
 	    phiderindex;
 	  
-	  int ibendproj=bendTable(abs(disk_)-1,bendindex);
+	  int ibendproj=context_->projectionRouterBendTable().lookup(abs(disk_)-1,bendindex);
 
 	  tracklet->setBendIndex(ibendproj,disk_);
 	  
 	  if (iphi==0) {
 	    assert(vmprojPHI1_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI1_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI1_->getName());
 	    vmprojPHI1_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 
 	  if (iphi==1) {
 	    assert(vmprojPHI2_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI2_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI2_->getName());
 	    vmprojPHI2_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 
 	  if (iphi==2) {
 	    assert(vmprojPHI3_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI3_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI3_->getName());
 	    vmprojPHI3_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }
 
 	  if (iphi==3) {
 	    assert(vmprojPHI4_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI4_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI4_->getName());
 	    vmprojPHI4_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }	  
 
 	  if (iphi==4) {
 	    assert(vmprojPHI5_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI5_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI5_->getName());
 	    vmprojPHI5_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }	  
 
 	  if (iphi==5) {
 	    assert(vmprojPHI6_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI6_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI6_->getName());
 	    vmprojPHI6_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }	  
 
 	  if (iphi==6) {
 	    assert(vmprojPHI7_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI7_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI7_->getName());
 	    vmprojPHI7_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }	  
 
 	  if (iphi==7) {
 	    assert(vmprojPHI8_!=0);
-	    if (debug1){
-	      cout << "FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI8_->getName()<<endl;
-	    }
+	    FPGA_DEBUG("FPGAProjectionRouter "<<getName()<<" add projection to : "<<vmprojPHI8_->getName());
 	    vmprojPHI8_->addTracklet(inputproj_[j]->getFPGATracklet(i),index);
 	  }	  
 	}
@@ -516,14 +487,16 @@ public:
 
     //cout << "Done in "<<getName()<<endl;
     
+    countIterations(count,count>settings_->maxProjRouter()?count-settings_->maxProjRouter():0);
+
     if (writeAllProjections) {
-      static ofstream out("allprojections.txt"); 
+      ofstream& out=debugFile("allprojections.txt"); 
       out << getName() << " " << allproj_->nTracklets() << endl;
     } 
    
 
     if (writeVMProjections) {
-      static ofstream out("vmprojections.txt"); 
+      ofstream& out=debugFile("vmprojections.txt"); 
       if (vmprojPHI1_!=0) out << vmprojPHI1_->getName() << " " << vmprojPHI1_->nTracklets() << endl;
       if (vmprojPHI2_!=0) out << vmprojPHI2_->getName() << " " << vmprojPHI2_->nTracklets() << endl;
       if (vmprojPHI3_!=0) out << vmprojPHI3_->getName() << " " << vmprojPHI3_->nTracklets() << endl;
@@ -535,76 +508,10 @@ public:
     }
   }
 
-  double bend(double r, double rinv) {
-    
-    double dr=0.18;
-    
-    double delta=r*dr*0.5*rinv;
-    
-    double bend=-delta/0.009;
-    if (r<55.0) bend=-delta/0.01;
-    
-    return bend;
-    
-  }
-  
-  int bendTable(int diskindex,int bendindex) {
-
-    static vector<int> bendtable[5];
-
-    static bool first=true;
-
-    if (first) {
-      first=false;
-    
-      for (unsigned int idisk=0;idisk<5;idisk++) {
-
-	unsigned int nsignbins=2;
-	unsigned int nrbins=1<<(nrbits_);
-	unsigned int nphiderbins=1<<(nphiderbits_);
-      
-	for(unsigned int isignbin=0;isignbin<nsignbins;isignbin++) {
-	  for(unsigned int irbin=0;irbin<nrbins;irbin++) {
-	    int ir=irbin;
-	    if (ir>(1<<(nrbits_-1))) ir-=(1<<nrbits_);
-	    ir=ir<<(nrbitsprojdisk-nrbits_);
-	    for(unsigned int iphiderbin=0;iphiderbin<nphiderbins;iphiderbin++) {
-	      int iphider=iphiderbin;
-	      if (iphider>(1<<(nphiderbits_-1))) iphider-=(1<<nphiderbits_);
-	      iphider=iphider<<(nbitsphiprojderL123-nphiderbits_);
-	      
-	      double rproj=ir*krprojshiftdisk;
-	      double phider=iphider*FPGATrackletCalculator::ITC_L1L2.der_phiD_final.get_K();
-	      double t=zmean[idisk]/rproj;
-	      
-	      if (isignbin) t=-t;
-	  
-	      double rinv=-phider*(2.0*t);
-
-	      double bendproj=0.5*bend(rproj,rinv);
-
-	    
-	      int ibendproj=2.0*bendproj+15.5;
-	      if (ibendproj<0) ibendproj=0;
-	      if (ibendproj>31) ibendproj=31;
-	      
-	      bendtable[idisk].push_back(ibendproj);
-
-	    }
-	  }
-	}
-      }
-    }
-
-    
-
-    return bendtable[diskindex][bendindex];
-
-  }
-  
-  
 private:
 
+  const FPGAContext* context_;
+
   int layer_; 
   int disk_; 
 
@@ -0,0 +1,104 @@
+//This class holds the table of the projected bend of the disk projections,
+//indexed by the sign of t, the projected r and the phi derivative
+#ifndef FPGAPROJECTIONROUTERBENDTABLE_H
+#define FPGAPROJECTIONROUTERBENDTABLE_H
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "FPGAConstants.hh"
+
+using namespace std;
+
+class FPGAProjectionRouterBendTable{
+
+public:
+
+  FPGAProjectionRouterBendTable() {
+    nrbits_=0;
+    nphiderbits_=0;
+  }
+
+  ~FPGAProjectionRouterBendTable() {
+
+  }
+
+  //Needs krprojshiftdisk and kphiprojderdisk, set by FPGAInitConstants
+  void init(int nrbits, int nphiderbits) {
+
+    nrbits_=nrbits;
+    nphiderbits_=nphiderbits;
+
+    for (unsigned int idisk=0;idisk<5;idisk++) {
+
+      unsigned int nsignbins=2;
+      unsigned int nrbins=1<<(nrbits_);
+      unsigned int nphiderbins=1<<(nphiderbits_);
+
+      for(unsigned int isignbin=0;isignbin<nsignbins;isignbin++) {
+	for(unsigned int irbin=0;irbin<nrbins;irbin++) {
+	  int ir=irbin;
+	  if (ir>(1<<(nrbits_-1))) ir-=(1<<nrbits_);
+	  ir=ir<<(nrbitsprojdisk-nrbits_);
+	  for(unsigned int iphiderbin=0;iphiderbin<nphiderbins;iphiderbin++) {
+	    int iphider=iphiderbin;
+	    if (iphider>(1<<(nphiderbits_-1))) iphider-=(1<<nphiderbits_);
+	    iphider=iphider<<(nbitsphiprojderL123-nphiderbits_);
+
+	    double rproj=ir*krprojshiftdisk;
+	    double phider=iphider*kphiprojderdisk;
+	    double t=zmean[idisk]/rproj;
+
+	    if (isignbin) t=-t;
+
+	    double rinv=-phider*(2.0*t);
+
+	    double bendproj=0.5*bend(rproj,rinv);
+
+
+	    int ibendproj=2.0*bendproj+15.5;
+	    if (ibendproj<0) ibendproj=0;
+	    if (ibendproj>31) ibendproj=31;
+
+	    bendtable_[idisk].push_back(ibendproj);
+
+	  }
+	}
+      }
+    }
+
+  }
+
+  int nrbits() const {return nrbits_;}
+  int nphiderbits() const {return nphiderbits_;}
+
+  int lookup(int diskindex,int bendindex) const {
+    assert(diskindex>=0&&diskindex<5);
+    assert(bendindex<(int)bendtable_[diskindex].size());
+    return bendtable_[diskindex][bendindex];
+  }
+
+private:
+
+  double bend(double r, double rinv) const {
+
+    double dr=0.18;
+
+    double delta=r*dr*0.5*rinv;
+
+    double bend=-delta/0.009;
+    if (r<55.0) bend=-delta/0.01;
+
+    return bend;
+
+  }
+
+  int nrbits_;
+  int nphiderbits_;
+
+  vector<int> bendtable_[5];
+
+};
+
+#endif
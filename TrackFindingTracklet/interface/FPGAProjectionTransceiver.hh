@@ -10,8 +10,8 @@ class FPGAProjectionTransceiver:public FPGAProcessBase{
 
 public:
 
-  FPGAProjectionTransceiver(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAProjectionTransceiver(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
 
     outputprojLPHI1=0;
     outputprojLPHI2=0;
@@ -314,7 +314,7 @@ public:
     }
 
     if (writeProjectionTransceiver) {
-      static ofstream out("projectiontransceiver.txt");
+      ofstream& out=debugFile("projectiontransceiver.txt");
       out << getName() << " " 
 	  << count << endl;
     }
@@ -328,9 +328,7 @@ public:
 	cout << "FPGAProjectionTransceiver in : "<<getName()<< " outputproj to "<<name<<" is zero  - will skip"<<endl;
       }
     } else {
-      if (debug1) {
-	cout << "Adding tracklet "<<otherProj<<" to "<<outputproj->getName()<<endl;
-      }
+      FPGA_DEBUG("Adding tracklet "<<otherProj<<" to "<<outputproj->getName());
       outputproj->addProj(otherProj);
     }
   }
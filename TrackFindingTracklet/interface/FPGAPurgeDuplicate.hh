@@ -4,14 +4,16 @@
 
 #include "FPGAProcessBase.hh"
 
+#include <algorithm>
+
 using namespace std;
 
 class FPGAPurgeDuplicate:public FPGAProcessBase{
 
 public:
 
-  FPGAPurgeDuplicate(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAPurgeDuplicate(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
   }
 
   void addOutput(FPGAMemoryBase* memory,string output){
@@ -83,7 +85,7 @@ public:
     }
 
     // Grid removal
-    if(RemovalType=="grid") {
+    if(settings_->removalType()=="grid") {
 
       // Sort tracks by ichisq so that removal will keep the lower ichisq track
       std::sort(inputtracks_.begin(), inputtracks_.end(), [](const FPGATrack* lhs, const FPGATrack* rhs)
@@ -115,7 +117,7 @@ public:
 
 
     // Removal by comparing pairs of tracks
-    if(RemovalType=="ichi" || RemovalType=="nstub") {
+    if(settings_->removalType()=="ichi" || settings_->removalType()=="nstub") {
       //print tracks for debugging
       for(unsigned int itrk=0; itrk<numTrk; itrk++) {
         std::map<int, int> stubsTrk1 = inputtracks_[itrk]->stubID();
@@ -161,8 +163,8 @@ public:
           if(inputtracks_[jtrk]->duplicate()==1) continue;
 	  
           // Chi2 duplicate removal
-          if(RemovalType=="ichi") {
-            if((nStubP-nShare[jtrk] < minIndStubs) || (nStubS[jtrk]-nShare[jtrk] < minIndStubs)) {
+          if(settings_->removalType()=="ichi") {
+            if((nStubP-nShare[jtrk] < settings_->minIndStubs()) || (nStubS[jtrk]-nShare[jtrk] < settings_->minIndStubs())) {
               if((int)inputtracks_[itrk]->ichisq() > (int)inputtracks_[jtrk]->ichisq()) {
                 inputtracks_[itrk]->setDuplicate(true);
               }
@@ -174,11 +176,11 @@ public:
           } // end ichi removal
 
           // nStub duplicate removal
-          if(RemovalType=="nstub") {
-            if((nStubP-nShare[jtrk] < minIndStubs) && (nStubP <  nStubS[jtrk])) {
+          if(settings_->removalType()=="nstub") {
+            if((nStubP-nShare[jtrk] < settings_->minIndStubs()) && (nStubP <  nStubS[jtrk])) {
               inputtracks_[itrk]->setDuplicate(true);
             }
-            if((nStubS[jtrk]-nShare[jtrk] < minIndStubs) && (nStubS[jtrk] <= nStubP)) {
+            if((nStubS[jtrk]-nShare[jtrk] < settings_->minIndStubs()) && (nStubS[jtrk] <= nStubP)) {
               inputtracks_[jtrk]->setDuplicate(true);
             }
           } // end nstub removal
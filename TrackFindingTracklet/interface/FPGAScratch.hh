@@ -0,0 +1,97 @@
+//This class holds the mutable state that the processing modules use while
+//processing an event: the IMATH calculators of the TrackletCalculator,
+//which keep the values of their intermediate variables, and the debug
+//files. Unlike the FPGAContext it must only be used by one thread at a
+//time. If sectors are processed concurrently each thread needs its own
+//instance, and the sectors have to be created with the instance of the
+//thread that processes them.
+#ifndef FPGASCRATCH_H
+#define FPGASCRATCH_H
+
+#include <fstream>
+#include <string>
+#include <cassert>
+
+#include "FPGADebugFiles.hh"
+#include "IMATH_TrackletCalculator.hh"
+#include "IMATH_TrackletCalculatorDisk.hh"
+#include "IMATH_TrackletCalculatorOverlap.hh"
+
+using namespace std;
+
+class FPGAScratch{
+
+public:
+
+  //The debug file suffix makes the file names of the instance distinct,
+  //e.g. "_3" for trackletcalculator_3.txt
+  FPGAScratch(string debugFileSuffix=""):
+    debugFiles_(debugFileSuffix),
+    ITC_L1L2_(1,2),
+    ITC_L2L3_(2,3),
+    ITC_L3L4_(3,4),
+    ITC_L5L6_(5,6),
+    ITC_F1F2_(1,2),
+    ITC_F3F4_(3,4),
+    ITC_B1B2_(-1,-2),
+    ITC_B3B4_(-3,-4),
+    ITC_L1F1_(1,1),
+    ITC_L2F1_(2,1),
+    ITC_L1B1_(1,-1),
+    ITC_L2B1_(2,-1){
+  }
+
+  ofstream& debugFile(const string& name) {return debugFiles_.file(name);}
+
+  //Barrel seeds, by the inner layer (1, 2, 3 or 5)
+  IMATH_TrackletCalculator* trackletCalculator(int layer) {
+    if (layer==1) return &ITC_L1L2_;
+    if (layer==2) return &ITC_L2L3_;
+    if (layer==3) return &ITC_L3L4_;
+    assert(layer==5);
+    return &ITC_L5L6_;
+  }
+
+  //Disk seeds, by the signed inner disk (1, 3, -1 or -3)
+  IMATH_TrackletCalculatorDisk* trackletCalculatorDisk(int disk) {
+    if (disk==1) return &ITC_F1F2_;
+    if (disk==3) return &ITC_F3F4_;
+    if (disk==-1) return &ITC_B1B2_;
+    assert(disk==-3);
+    return &ITC_B3B4_;
+  }
+
+  //Overlap seeds, by the layer (1 or 2) and the signed disk (1 or -1)
+  IMATH_TrackletCalculatorOverlap* trackletCalculatorOverlap(int layer, int disk) {
+    if (layer==1&&disk==1) return &ITC_L1F1_;
+    if (layer==2&&disk==1) return &ITC_L2F1_;
+    if (layer==1&&disk==-1) return &ITC_L1B1_;
+    assert(layer==2&&disk==-1);
+    return &ITC_L2B1_;
+  }
+
+private:
+
+  FPGAScratch(const FPGAScratch&);
+  FPGAScratch& operator=(const FPGAScratch&);
+
+  FPGADebugFiles debugFiles_;
+
+  IMATH_TrackletCalculator ITC_L1L2_;
+  IMATH_TrackletCalculator ITC_L2L3_;
+  IMATH_TrackletCalculator ITC_L3L4_;
+  IMATH_TrackletCalculator ITC_L5L6_;
+
+  IMATH_TrackletCalculatorDisk ITC_F1F2_;
+  IMATH_TrackletCalculatorDisk ITC_F3F4_;
+  IMATH_TrackletCalculatorDisk ITC_B1B2_;
+  IMATH_TrackletCalculatorDisk ITC_B3B4_;
+
+  IMATH_TrackletCalculatorOverlap ITC_L1F1_;
+  IMATH_TrackletCalculatorOverlap ITC_L2F1_;
+  IMATH_TrackletCalculatorOverlap ITC_L1B1_;
+  IMATH_TrackletCalculatorOverlap ITC_L2B1_;
+
+};
+
+#endif
@@ -31,6 +31,8 @@
 #include "FPGAMatchTransceiver.hh"
 #include "FPGAFitTrack.hh"
 #include "FPGAPurgeDuplicate.hh"
+#include "FPGAProfiler.hh"
+#include "FPGAStatistics.hh"
 
 using namespace std;
 
@@ -38,8 +40,14 @@ class FPGASector{
 
 public:
 
-  FPGASector(unsigned int i){
+  FPGASector(unsigned int i, const FPGASettings* settings, const FPGAContext* context,
+	     FPGAScratch* scratch){
     isector_=i;
+    settings_=settings;
+    context_=context;
+    scratch_=scratch;
+    layerDiskLinksFilled_=false;
+    profiler_=0;
     double dphi=two_pi/NSector;
     double dphiHG=0.0;
     if (hourglass) {
@@ -61,59 +69,34 @@ public:
     if (hourglass) {
       double phi=stub.phi();
       //cout << "FPGASector::addStub layer phi phimin_ phimax_ : "<<stub.layer()+1<<" "<<" "<<dtc<<" "<<phi<<" "<<phimin_<<" "<<phimax_<<endl;
-      double dphi=two_pi/NSector/6.0;
-      if (hourglass) {
-	dphi=0.5*(dphisectorHG-two_pi/NSector);
-      }
+      double dphi=0.5*(dphisectorHG-two_pi/NSector);
 
-      static std::map<string,std::vector<int> > ILindex;
-      std::vector<int>& tmp=ILindex[dtc];
-      if (tmp.size()==0){
-	//cout << "Adding entries for dtc : "<<dtc;
-	for (unsigned int i=0;i<IL_.size();i++){
-	  if (IL_[i]->getName().find("_"+dtc)!=string::npos){
-	    //cout << " Adding link "<<IL_[i]->getName()<<endl;
-	    tmp.push_back(i);
-	  }
-	}
-	//cout << endl;
-      }
+      const DTCRouting& routing=dtcRouting(dtc);
       
       if (((phi>phimin_-dphi)&&(phi<phimax_+dphi))||
 	  ((phi>two_pi+phimin_-dphi)&&(phi<two_pi+phimax_+dphi))) {
+	assert(routing.nlinks!=0);
 	FPGAStub fpgastub(stub,phimin_,phimax_);
-	std::vector<int>& tmp=ILindex[dtc];
-	assert(tmp.size()!=0);
-	for (unsigned int i=0;i<tmp.size();i++){
-	  //cout << "Add stub to link"<<IL_[tmp[i]]->getName()<<endl;
-	  IL_[tmp[i]]->addStub(stub,fpgastub,dtc);
+	context_->applyPhiCorr(fpgastub);
+	int layerdisk=fpgastub.layer().value();
+	if (layerdisk==-1) layerdisk=5+abs(fpgastub.disk().value());
+	const std::vector<int>& links=routing.links[layerdisk][fpgastub.iphivmRaw()];
+	for (unsigned int i=0;i<links.size();i++){
+	  //cout << "Add stub to link"<<IL_[links[i]]->getName()<<endl;
+	  IL_[links[i]]->storeStub(stub,fpgastub);
 	}
       }
     }  else {
       
       double phi=stub.phi();
-      int layer=stub.layer()+1;
       //cout << "FPGASector::addStub phi phimin_ phimax_ : "<<phi<<" "<<phimin_<<" "<<phimax_<<endl;
       double dphi=two_pi/NSector/6.0;
-      if (layer<999) {
-	if (((phi>phimin_-dphi)&&(phi<phimax_+dphi))||
-	    ((phi>two_pi+phimin_-dphi)&&(phi<two_pi+phimax_+dphi))) {
-	  FPGAStub fpgastub(stub,phimin_,phimax_);
-	  //cout << "Trying to add stub in sector : "<<isector_<<" layer = "<<layer<<endl;
-	  for (unsigned int i=0;i<IL_.size();i++){
-	    //cout << i<<" "<<IL_[i]->getName()<<" "<<isector_<<endl;
-	    IL_[i]->addStub(stub,fpgastub);
-	  }
-	}
-      } else {
-	//int disk=stub.disk();
-	if (((phi>phimin_-dphi)&&(phi<phimax_+dphi))||
-	    ((phi>two_pi+phimin_-dphi)&&(phi<two_pi+phimax_+dphi))) {
-	  //cout << "Trying to add stub in sector : "<<isector_<<" disk = "<<disk<<endl;
-	  for (unsigned int i=0;i<IL_.size();i++){
-	    FPGAStub fpgastub(stub,phimin_,phimax_);
-	    IL_[i]->addStub(stub,fpgastub);
-	  }      
+      if (((phi>phimin_-dphi)&&(phi<phimax_+dphi))||
+	  ((phi>two_pi+phimin_-dphi)&&(phi<two_pi+phimax_+dphi))) {
+	FPGAStub fpgastub(stub,phimin_,phimax_);
+	const std::vector<int>& links=layerDiskLinks(stub);
+	for (unsigned int i=0;i<links.size();i++){
+	  IL_[links[i]]->addStub(stub,fpgastub);
 	}
       }
     }
@@ -122,55 +105,55 @@ public:
     
   void addMem(string memType,string memName){
     if (memType=="InputLink:") {
-      IL_.push_back(new FPGAInputLink(memName,isector_,phimin_,phimax_));
+      IL_.push_back(new FPGAInputLink(memName,settings_,isector_,phimin_,phimax_,context_));
       Memories_[memName]=IL_.back();
       MemoriesV_.push_back(IL_.back());
     } else if (memType=="AllStubs:") {
-      AS_.push_back(new FPGAAllStubs(memName,isector_,phimin_,phimax_));
+      AS_.push_back(new FPGAAllStubs(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=AS_.back();
       MemoriesV_.push_back(AS_.back());
     } else if (memType=="VMStubsTE:") {
-      VMSTE_.push_back(new FPGAVMStubsTE(memName,isector_,phimin_,phimax_));
+      VMSTE_.push_back(new FPGAVMStubsTE(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=VMSTE_.back();
       MemoriesV_.push_back(VMSTE_.back());
     } else if (memType=="VMStubsME:") {
-      VMSME_.push_back(new FPGAVMStubsME(memName,isector_,phimin_,phimax_));
+      VMSME_.push_back(new FPGAVMStubsME(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=VMSME_.back();
       MemoriesV_.push_back(VMSME_.back());
     } else if (memType=="StubPairs:") {
-      SP_.push_back(new FPGAStubPairs(memName,isector_,phimin_,phimax_));
+      SP_.push_back(new FPGAStubPairs(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=SP_.back();
       MemoriesV_.push_back(SP_.back());
     } else if (memType=="TrackletParameters:") {
-      TPAR_.push_back(new FPGATrackletParameters(memName,isector_,phimin_,phimax_));
+      TPAR_.push_back(new FPGATrackletParameters(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=TPAR_.back();
       MemoriesV_.push_back(TPAR_.back());
     } else if (memType=="TrackletProjections:") {
-      TPROJ_.push_back(new FPGATrackletProjections(memName,isector_,phimin_,phimax_));
+      TPROJ_.push_back(new FPGATrackletProjections(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=TPROJ_.back();
       MemoriesV_.push_back(TPROJ_.back());
     } else if (memType=="AllProj:") {
-      AP_.push_back(new FPGAAllProjections(memName,isector_,phimin_,phimax_));
+      AP_.push_back(new FPGAAllProjections(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=AP_.back();
       MemoriesV_.push_back(AP_.back());
     } else if (memType=="VMProjections:") {
-      VMPROJ_.push_back(new FPGAVMProjections(memName,isector_,phimin_,phimax_));
+      VMPROJ_.push_back(new FPGAVMProjections(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=VMPROJ_.back();
       MemoriesV_.push_back(VMPROJ_.back());
     } else if (memType=="CandidateMatch:") {
-      CM_.push_back(new FPGACandidateMatch(memName,isector_,phimin_,phimax_));
+      CM_.push_back(new FPGACandidateMatch(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=CM_.back();
       MemoriesV_.push_back(CM_.back());
     } else if (memType=="FullMatch:") {
-      FM_.push_back(new FPGAFullMatch(memName,isector_,phimin_,phimax_));
+      FM_.push_back(new FPGAFullMatch(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=FM_.back();
       MemoriesV_.push_back(FM_.back());
     } else if (memType=="TrackFit:") {
-      TF_.push_back(new FPGATrackFit(memName,isector_,phimin_,phimax_));
+      TF_.push_back(new FPGATrackFit(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=TF_.back();
       MemoriesV_.push_back(TF_.back());
     } else if (memType=="CleanTrack:") {
-      CT_.push_back(new FPGACleanTrack(memName,isector_,phimin_,phimax_));
+      CT_.push_back(new FPGACleanTrack(memName,settings_,isector_,phimin_,phimax_));
       Memories_[memName]=CT_.back();
       MemoriesV_.push_back(CT_.back());
     } else {
@@ -182,50 +165,51 @@ public:
 
   void addProc(string procType,string procName){
     if (procType=="VMRouter:") {
-      VMR_.push_back(new FPGAVMRouter(procName,isector_));
+      VMR_.push_back(new FPGAVMRouter(procName,settings_,isector_,context_));
       Processes_[procName]=VMR_.back();
     } else if (procType=="VMRouterTE:") {
-      VMRTE_.push_back(new FPGAVMRouterTE(procName,isector_));
+      VMRTE_.push_back(new FPGAVMRouterTE(procName,settings_,isector_,context_));
       Processes_[procName]=VMRTE_.back();
     } else if (procType=="VMRouterME:") {
-      VMRME_.push_back(new FPGAVMRouterME(procName,isector_));
+      VMRME_.push_back(new FPGAVMRouterME(procName,settings_,isector_));
       Processes_[procName]=VMRME_.back();
     } else if (procType=="TrackletEngine:") {
-      TE_.push_back(new FPGATrackletEngine(procName,isector_));
+      TE_.push_back(new FPGATrackletEngine(procName,settings_,isector_));
       Processes_[procName]=TE_.back();
     } else if (procType=="TrackletCalculator:"||
 	       procType=="TrackletDiskCalculator:") {
-      TC_.push_back(new FPGATrackletCalculator(procName,isector_));
+      TC_.push_back(new FPGATrackletCalculator(procName,settings_,isector_));
       Processes_[procName]=TC_.back();
     } else if (procType=="ProjectionRouter:") {
-      PR_.push_back(new FPGAProjectionRouter(procName,isector_));
+      PR_.push_back(new FPGAProjectionRouter(procName,settings_,isector_,context_));
       Processes_[procName]=PR_.back();
     } else if (procType=="ProjectionTransceiver:") {
-      PT_.push_back(new FPGAProjectionTransceiver(procName,isector_));
+      PT_.push_back(new FPGAProjectionTransceiver(procName,settings_,isector_));
       Processes_[procName]=PT_.back();
     } else if (procType=="MatchEngine:") {
-      ME_.push_back(new FPGAMatchEngine(procName,isector_));
+      ME_.push_back(new FPGAMatchEngine(procName,settings_,isector_));
       Processes_[procName]=ME_.back();
     } else if (procType=="MatchCalculator:"||
 	       procType=="DiskMatchCalculator:") {
-      MC_.push_back(new FPGAMatchCalculator(procName,isector_));
+      MC_.push_back(new FPGAMatchCalculator(procName,settings_,isector_));
       Processes_[procName]=MC_.back();
     } else if (procType=="MatchProcessor:") {
-      MP_.push_back(new FPGAMatchProcessor(procName,isector_));
+      MP_.push_back(new FPGAMatchProcessor(procName,settings_,isector_));
       Processes_[procName]=MP_.back();
     } else if (procType=="MatchTransceiver:") {
-      MT_.push_back(new FPGAMatchTransceiver(procName,isector_));
+      MT_.push_back(new FPGAMatchTransceiver(procName,settings_,isector_));
       Processes_[procName]=MT_.back();
     } else if (procType=="FitTrack:") {
-      FT_.push_back(new FPGAFitTrack(procName,isector_));
+      FT_.push_back(new FPGAFitTrack(procName,settings_,isector_,context_));
       Processes_[procName]=FT_.back();
     } else if (procType=="PurgeDuplicate:") {
-      PD_.push_back(new FPGAPurgeDuplicate(procName,isector_));
+      PD_.push_back(new FPGAPurgeDuplicate(procName,settings_,isector_));
       Processes_[procName]=PD_.back();
     } else {
       cout << "Don't know of processing type: "<<procType<<endl;
       exit(0);      
     }
+    Processes_[procName]->setScratch(scratch_);
   }
 
   void addWire(string mem,string procinfull,string procoutfull){
@@ -251,6 +235,7 @@ public:
     if (procin!="") {
       FPGAProcessBase* inProc=getProc(procin);
       inProc->addOutput(memory,output);
+      inProc->registerOutput(memory);
       }
 
     if (procout!="") {
@@ -376,10 +361,9 @@ public:
       int matchesL3=0;
       int matchesL5=0;
       for(unsigned int i=0;i<TPAR_.size();i++) {
-	TPAR_[i]->writeMatches(matchesL1,matchesL3,matchesL5);
+	TPAR_[i]->writeMatches(scratch_->debugFile("nmatches.txt"),matchesL1,matchesL3,matchesL5);
       }
-      static ofstream out("nmatchessector.txt");
-      out <<matchesL1<<" "<<matchesL3<<" "<<matchesL5<<endl;
+      scratch_->debugFile("nmatchessector.txt") <<matchesL1<<" "<<matchesL3<<" "<<matchesL5<<endl;
     }
     
     
@@ -391,69 +375,91 @@ public:
   void executeVMR(){
 
     if (writeIL) {
-      static ofstream out("inputlink.txt");
+      ofstream& out=scratch_->debugFile("inputlink.txt");
       for (unsigned int i=0;i<IL_.size();i++){
 	out<<IL_[i]->getName()<<" "<<IL_[i]->nStubs()<<endl;
       } 
     }
     
     for (unsigned int i=0;i<VMR_.size();i++){
+      if (profiler_) profiler_->start(VMR_[i]);
       VMR_[i]->execute();
+      if (profiler_) profiler_->stop(VMR_[i]);
     }
     for (unsigned int i=0;i<VMRTE_.size();i++){
+      if (profiler_) profiler_->start(VMRTE_[i]);
       VMRTE_[i]->execute();
+      if (profiler_) profiler_->stop(VMRTE_[i]);
     }
     for (unsigned int i=0;i<VMRME_.size();i++){
+      if (profiler_) profiler_->start(VMRME_[i]);
       VMRME_[i]->execute();
+      if (profiler_) profiler_->stop(VMRME_[i]);
     }
   }
 
   void executeTE(){
     for (unsigned int i=0;i<TE_.size();i++){
+      if (profiler_) profiler_->start(TE_[i]);
       TE_[i]->execute();
+      if (profiler_) profiler_->stop(TE_[i]);
     }
   }
 
   void executeTC(){
     for (unsigned int i=0;i<TC_.size();i++){
+      if (profiler_) profiler_->start(TC_[i]);
       TC_[i]->execute();
+      if (profiler_) profiler_->stop(TC_[i]);
     }
   }
 
   void executePR(){
     for (unsigned int i=0;i<PR_.size();i++){
+      if (profiler_) profiler_->start(PR_[i]);
       PR_[i]->execute();
+      if (profiler_) profiler_->stop(PR_[i]);
     }
   }
 
   void executeME(){
     for (unsigned int i=0;i<ME_.size();i++){
+      if (profiler_) profiler_->start(ME_[i]);
       ME_[i]->execute();
+      if (profiler_) profiler_->stop(ME_[i]);
     }
   }
 
   void executeMC(){
     for (unsigned int i=0;i<MC_.size();i++){
+      if (profiler_) profiler_->start(MC_[i]);
       MC_[i]->execute();
+      if (profiler_) profiler_->stop(MC_[i]);
     }
   }
 
   void executeMP(){
     for (unsigned int i=0;i<MP_.size();i++){
+      if (profiler_) profiler_->start(MP_[i]);
       MP_[i]->execute();
+      if (profiler_) profiler_->stop(MP_[i]);
     }
   }
 
   void executeFT(){
     fpgatracks_.clear();
     for (unsigned int i=0;i<FT_.size();i++){
+      if (profiler_) profiler_->start(FT_[i]);
       FT_[i]->execute(fpgatracks_);
+      if (profiler_) profiler_->stop(FT_[i]);
     }
   }
 
   void executePD(std::vector<FPGATrack*>& tracks){
     for (unsigned int i=0;i<PD_.size();i++){
+      if (profiler_) profiler_->start(PD_[i]);
       PD_[i]->execute(tracks);
+      if (profiler_) profiler_->stop(PD_[i]);
     }
   }
 
@@ -468,7 +474,9 @@ public:
 	//cout << "New name : "<<name<<endl;
 	for (unsigned int j=0;j<sectorMinus->PT_.size();j++){
 	  if (sectorMinus->PT_[j]->getName()==name) {
+	    if (profiler_) profiler_->start(PT_[i]);
 	    PT_[i]->execute(sectorMinus->PT_[j]);
+	    if (profiler_) profiler_->stop(PT_[i]);
 	  }
 	}
       } else if (name.find("Plus")!=std::string::npos) {
@@ -476,7 +484,9 @@ public:
 	//cout << "New name : "<<name<<endl;
 	for (unsigned int j=0;j<sectorPlus->PT_.size();j++){
 	  if (sectorPlus->PT_[j]->getName()==name) {
+	    if (profiler_) profiler_->start(PT_[i]);
 	    PT_[i]->execute(sectorPlus->PT_[j]);
+	    if (profiler_) profiler_->stop(PT_[i]);
 	  }
 	}
       } else {
@@ -486,7 +496,7 @@ public:
     }
 
     if (writeTrackProjOcc) {
-      static ofstream out("trackprojocc.txt");
+      ofstream& out=scratch_->debugFile("trackprojocc.txt");
       for (unsigned int i=0; i<TPROJ_.size();i++){
 	out << TPROJ_[i]->getName()<<" "<<TPROJ_[i]->nTracklets()<<endl;
       }
@@ -506,7 +516,9 @@ public:
 	//cout << "New name : "<<name<<endl;
 	for (unsigned int j=0;j<sectorMinus->MT_.size();j++){
 	  if (sectorMinus->MT_[j]->getName()==name) {
+	    if (profiler_) profiler_->start(MT_[i]);
 	    MT_[i]->execute(sectorMinus->MT_[j]);
+	    if (profiler_) profiler_->stop(MT_[i]);
 	  }
 	}
       } else if (name.find("Plus")!=std::string::npos) {
@@ -514,7 +526,9 @@ public:
 	//cout << "New name : "<<name<<endl;
 	for (unsigned int j=0;j<sectorPlus->MT_.size();j++){
 	  if (sectorPlus->MT_[j]->getName()==name) {
+	    if (profiler_) profiler_->start(MT_[i]);
 	    MT_[i]->execute(sectorPlus->MT_[j]);
+	    if (profiler_) profiler_->stop(MT_[i]);
 	  }
 	}
       } else {
@@ -558,14 +572,40 @@ public:
   double phimin() const {return phimin_;}
   double phimax() const {return phimax_;}
 
+  //Enables the per module timing; all processing modules of the sector
+  //are registered with the profiler for the end of job report
+  void setProfiler(FPGAProfiler* profiler) {
+    profiler_=profiler;
+    if (profiler_==0) return;
+    for (map<string, FPGAProcessBase*>::iterator it=Processes_.begin();it!=Processes_.end();++it){
+      profiler_->addProcess(it->second);
+    }
+  }
+
+  //Registers all memories and processing modules of the sector for the
+  //occupancy and truncation statistics
+  void setStatistics(FPGAStatistics* statistics) {
+    for(unsigned int i=0;i<MemoriesV_.size();i++) {
+      statistics->addMemory(MemoriesV_[i]);
+    }
+    for (map<string, FPGAProcessBase*>::iterator it=Processes_.begin();it!=Processes_.end();++it){
+      statistics->addProcess(it->second);
+    }
+  }
+
 private:
 
   int isector_;
+  const FPGASettings* settings_;
+  const FPGAContext* context_;
+  FPGAScratch* scratch_;
   double phimin_;
   double phimax_;
 
   std::vector<FPGATrack*> fpgatracks_;
 
+  FPGAProfiler* profiler_;
+
 
   std::map<string, FPGAMemoryBase*> Memories_;
   std::vector<FPGAMemoryBase*> MemoriesV_;
@@ -598,8 +638,62 @@ private:
   std::vector<FPGAFitTrack*> FT_;
   std::vector<FPGAPurgeDuplicate*> PD_;
 
+  //Input links that receive the stubs of a DTC, indexed by layer/disk
+  //(0-5 for the layers, 6-10 for the disks) and raw VM phi bin
+  struct DTCRouting{
+    DTCRouting() {nlinks=0;}
+    unsigned int nlinks;
+    std::vector<int> links[11][32];
+  };
+  std::map<string,DTCRouting> routing_;
+  //Input links (non hourglass) for the layers (0-5) and the forward
+  //(6-10) and backward (11-15) disks
+  std::vector<int> layerDiskLinks_[16];
+  bool layerDiskLinksFilled_;
+
+  //Returns the routing of the stubs of the DTC to the input links. It is
+  //built from the link names the first time a stub from the DTC is seen.
+  const DTCRouting& dtcRouting(const string& dtc) {
+    std::map<string,DTCRouting>::const_iterator it=routing_.find(dtc);
+    if (it!=routing_.end()) return it->second;
+    DTCRouting& routing=routing_[dtc];
+    for (unsigned int i=0;i<IL_.size();i++){
+      if (IL_[i]->getName().find("_"+dtc)==string::npos) continue;
+      routing.nlinks++;
+      for (int layerdisk=0;layerdisk<11;layerdisk++){
+	for (int iphivmRaw=0;iphivmRaw<32;iphivmRaw++){
+	  if (IL_[i]->routes(dtc,layerdisk,iphivmRaw)) {
+	    routing.links[layerdisk][iphivmRaw].push_back(i);
+	  }
+	}
+      }
+    }
+    return routing;
+  }
+
+  //Returns the input links (non hourglass) that can receive the stub
+  const std::vector<int>& layerDiskLinks(const L1TStub& stub) {
+    if (!layerDiskLinksFilled_) {
+      for (unsigned int i=0;i<IL_.size();i++){
+	string subnamelayer=IL_[i]->getName().substr(3,2);
+	int n=subnamelayer[1]-'0';
+	if (subnamelayer[0]=='L'&&n>=1&&n<=6) layerDiskLinks_[n-1].push_back(i);
+	if (subnamelayer[0]=='F'&&n>=1&&n<=5) layerDiskLinks_[n+5].push_back(i);
+	if (subnamelayer[0]=='B'&&n>=1&&n<=5) layerDiskLinks_[n+10].push_back(i);
+      }
+      layerDiskLinksFilled_=true;
+    }
+    int layer=stub.layer()+1;
+    if (layer<999) {
+      assert(layer>=1&&layer<=6);
+      return layerDiskLinks_[layer-1];
+    }
+    int disk=stub.disk();
+    assert(disk!=0&&abs(disk)<=5);
+    if (disk>0) return layerDiskLinks_[disk+5];
+    return layerDiskLinks_[-disk+10];
+  }
 
-  
 };
 
 #endif
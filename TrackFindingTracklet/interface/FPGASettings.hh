@@ -0,0 +1,159 @@
+//This class holds the run time configuration of the tracklet emulation.
+//It is created once by the producer and passed (read only) to the
+//sectors and to all memory and processing modules. The defaults
+//reproduce the settings previously hardcoded in FPGAConstants.hh.
+#ifndef FPGASETTINGS_H
+#define FPGASETTINGS_H
+
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <math.h>
+
+#include "FPGAConstants.hh"
+#include "FPGALog.hh"
+
+using namespace std;
+
+class FPGASettings{
+
+public:
+
+  FPGASettings(){
+    hybrid_=true;
+    doKF_=true;
+    nHelixPar_=4;
+    printDebugKF_=false;
+    TMUX_=6;
+    validateTC_=true;
+
+    maxOffset_=10000;
+    setTruncation(hourglass?108:54);
+    vmStubsDepth_=hourglass?108:54;
+    vmStubsBinDepth_=16;
+
+    adjacentRemoval_=true;
+    removalType_="ichi";
+    minIndStubs_=3;
+  }
+
+  ~FPGASettings(){}
+
+  //Sets all the per module truncation limits to nmax+maxOffset
+  //(call setMaxOffset first)
+  void setTruncation(unsigned int nmax) {
+    maxStubsLink_=nmax+maxOffset_;
+    maxVMRouter_=nmax+maxOffset_;
+    maxTE_=nmax+maxOffset_;
+    maxTC_=nmax+maxOffset_;
+    maxProjRouter_=nmax+maxOffset_;
+    maxME_=nmax+maxOffset_;
+    maxMC_=nmax+maxOffset_;
+    maxFit_=nmax+maxOffset_;
+  }
+
+  //Checks that the combination of settings is supported
+  void check() const {
+    if (doKF_&&!hybrid_) {
+      cout << "FPGASettings: the KF can only be used with the hybrid algorithm" << endl;
+      assert(0);
+    }
+    if (nHelixPar_!=4&&nHelixPar_!=5) {
+      cout << "FPGASettings: nHelixPar = " << nHelixPar_ << " not supported" << endl;
+      assert(0);
+    }
+    if (TMUX_!=4&&TMUX_!=6&&TMUX_!=8) {
+      cout << "FPGASettings: only TMUX=4/6/8 are supported, TMUX = " << TMUX_ << endl;
+      assert(0);
+    }
+    if (removalType_!="ichi"&&removalType_!="nstub"&&removalType_!="grid"&&removalType_!="") {
+      cout << "FPGASettings: unknown duplicate removal type " << removalType_ << endl;
+      assert(0);
+    }
+    if (printDebugKF_&&FPGA_LOG_LEVEL<FPGALOG_DEBUG) {
+      cout << "FPGASettings: WARNING - printDebugKF = true but debug printout is not compiled in"
+	   << " (FPGA_LOG_LEVEL = " << FPGA_LOG_LEVEL << ", see FPGALog.hh)" << endl;
+    }
+  }
+
+  //Algorithm
+  bool hybrid() const {return hybrid_;}
+  bool doKF() const {return doKF_;}
+  unsigned int nHelixPar() const {return nHelixPar_;}
+  bool printDebugKF() const {return printDebugKF_;}
+  int TMUX() const {return TMUX_;}
+
+  void setHybrid(bool hybrid) {hybrid_=hybrid;}
+  void setDoKF(bool doKF) {doKF_=doKF;}
+  void setNHelixPar(unsigned int nHelixPar) {nHelixPar_=nHelixPar;}
+  void setPrintDebugKF(bool printDebugKF) {printDebugKF_=printDebugKF;}
+  void setTMUX(int TMUX) {TMUX_=TMUX;}
+
+  //If true the TrackletCalculator also does the exact (floating point)
+  //and approximate calculations, otherwise only the bit-accurate one
+  bool validateTC() const {return validateTC_;}
+  void setValidateTC(bool validateTC) {validateTC_=validateTC;}
+
+  //Truncation
+  unsigned int maxOffset() const {return maxOffset_;}
+  unsigned int maxStubsLink() const {return maxStubsLink_;}
+  unsigned int maxVMRouter() const {return maxVMRouter_;}
+  unsigned int maxTE() const {return maxTE_;}
+  unsigned int maxTC() const {return maxTC_;}
+  unsigned int maxProjRouter() const {return maxProjRouter_;}
+  unsigned int maxME() const {return maxME_;}
+  unsigned int maxMC() const {return maxMC_;}
+  unsigned int maxFit() const {return maxFit_;}
+
+  void setMaxOffset(unsigned int maxOffset) {maxOffset_=maxOffset;}
+
+  //Memories are only truncated to their depth when the regular
+  //truncation is enabled (maxOffset=0); otherwise entries beyond the
+  //depth are kept and only counted as overflows.
+  bool truncateMemories() const {return maxOffset_==0;}
+
+  //Depth of a VM stub memory page and of the individual bins
+  unsigned int vmStubsDepth() const {return vmStubsDepth_;}
+  unsigned int vmStubsBinDepth() const {return vmStubsBinDepth_;}
+
+  void setVMStubsDepth(unsigned int depth) {vmStubsDepth_=depth;}
+  void setVMStubsBinDepth(unsigned int depth) {vmStubsBinDepth_=depth;}
+
+  //Duplicate removal
+  bool adjacentRemoval() const {return adjacentRemoval_;}
+  string removalType() const {return removalType_;}
+  int minIndStubs() const {return minIndStubs_;}
+
+  void setAdjacentRemoval(bool adjacentRemoval) {adjacentRemoval_=adjacentRemoval;}
+  void setRemovalType(string removalType) {removalType_=removalType;}
+  void setMinIndStubs(int minIndStubs) {minIndStubs_=minIndStubs;}
+
+private:
+
+  bool hybrid_;
+  bool doKF_;
+  unsigned int nHelixPar_;
+  bool printDebugKF_;
+  int TMUX_;
+  bool validateTC_;
+
+  unsigned int maxOffset_;
+  unsigned int maxStubsLink_;
+  unsigned int maxVMRouter_;
+  unsigned int maxTE_;
+  unsigned int maxTC_;
+  unsigned int maxProjRouter_;
+  unsigned int maxME_;
+  unsigned int maxMC_;
+  unsigned int maxFit_;
+
+  unsigned int vmStubsDepth_;
+  unsigned int vmStubsBinDepth_;
+
+  bool adjacentRemoval_;
+  string removalType_;
+  int minIndStubs_;
+
+};
+
+#endif
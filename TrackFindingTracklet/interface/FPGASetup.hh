@@ -0,0 +1,137 @@
+//Common setup of the tracklet emulation: derived constants and the
+//creation of the sectors from the memory, processing module and wiring
+//files. Used by the L1FPGATrackProducer and the standalone benchmark.
+#ifndef FPGASETUP_H
+#define FPGASETUP_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cassert>
+
+#include "FPGAConstants.hh"
+#include "FPGASettings.hh"
+#include "FPGAContext.hh"
+#include "FPGAScratch.hh"
+#include "FPGASector.hh"
+#include "IMATH_TrackletCalculator.hh"
+
+using namespace std;
+
+//Sets the constants derived from the TrackletCalculator integer emulation
+inline void FPGAInitConstants() {
+
+  IMATH_TrackletCalculator ITC(1,2);
+
+  krinvpars = ITC.rinv_final.get_K();
+  kphi0pars = ITC.phi0_final.get_K();
+  ktpars    = ITC.t_final.get_K();
+  kz0pars   = ITC.z0_final.get_K();
+  kd0pars   = kd0;
+
+  krdisk = kr;
+  kzpars = kz;
+  krprojshiftdisk = ITC.rD_0_final.get_K();
+  kphiprojderdisk = ITC.der_phiD_final.get_K();
+
+  //those can be made more transparent...
+  kphiproj123=kphi0pars*4;
+  kphiproj456=kphi0pars/2;
+  kzproj=kz;
+  kphider=krinvpars*(1<<phiderbitshift);
+  kzder=ktpars*(1<<zderbitshift);
+  kphiprojdisk=kphi0pars*4.0;
+  krprojderdiskshift=krprojderdisk*(1<<rderdiskbitshift);
+  krprojderdisk=(1.0/ktpars)/(1<<t2bits);
+
+}
+
+//Creates the NSector sectors and adds the memories, processing modules
+//and wires read from the configuration files. The context and the scratch
+//are used by all sectors and have to outlive them.
+inline FPGASector** FPGACreateSectors(const FPGASettings* settings,
+				      const FPGAContext* context,
+				      FPGAScratch* scratch,
+				      string memoryModulesFile,
+				      string processingModulesFile,
+				      string wiresFile) {
+
+  FPGASector** sectors=new FPGASector*[NSector];
+
+  for (unsigned int i=0;i<NSector;i++) {
+    sectors[i]=new FPGASector(i,settings,context,scratch);
+  }
+
+  cout << "Will read memory modules file"<<endl;
+
+  ifstream inmem(memoryModulesFile.c_str());
+  assert(inmem.good());
+
+  while (inmem.good()){
+    string memType, memName, size;
+    inmem >>memType>>memName>>size;
+    if (!inmem.good()) continue;
+    if (writetrace) {
+      cout << "Read memory: "<<memType<<" "<<memName<<endl;
+    }
+    for (unsigned int i=0;i<NSector;i++) {
+      sectors[i]->addMem(memType,memName);
+    }
+
+  }
+
+
+  cout << "Will read processing modules file"<<endl;
+
+  ifstream inproc(processingModulesFile.c_str());
+  assert(inproc.good());
+
+  while (inproc.good()){
+    string procType, procName;
+    inproc >>procType>>procName;
+    if (!inproc.good()) continue;
+    if (writetrace) {
+      cout << "Read process: "<<procType<<" "<<procName<<endl;
+    }
+    for (unsigned int i=0;i<NSector;i++) {
+      sectors[i]->addProc(procType,procName);
+    }
+
+  }
+
+
+  cout << "Will read wiring information"<<endl;
+
+  ifstream inwire(wiresFile.c_str());
+  assert(inwire.good());
+
+  while (inwire.good()){
+    string line;
+    getline(inwire,line);
+    if (!inwire.good()) continue;
+    if (writetrace) {
+      cout << "Line : "<<line<<endl;
+    }
+    stringstream ss(line);
+    string mem,tmp1,procin,tmp2,procout;
+    ss>>mem>>tmp1>>procin;
+    if (procin=="output=>") {
+      procin="";
+      ss>>procout;
+    }
+    else{
+      ss>>tmp2>>procout;
+    }
+
+    for (unsigned int i=0;i<NSector;i++) {
+      sectors[i]->addWire(mem,procin,procout);
+    }
+
+  }
+
+  return sectors;
+
+}
+
+#endif
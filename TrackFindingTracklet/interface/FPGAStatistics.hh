@@ -0,0 +1,152 @@
+//This class collects per event occupancy histograms for the memory modules
+//and iteration and truncation counts for the processing modules
+#ifndef FPGASTATISTICS_H
+#define FPGASTATISTICS_H
+
+#include "FPGAMemoryBase.hh"
+#include "FPGAProcessBase.hh"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class FPGAStatistics{
+
+public:
+
+  //Occupancies above maxbin are accumulated in the last (overflow) bin
+  FPGAStatistics(unsigned int maxbin=256){
+    maxbin_=maxbin;
+    nevents_=0;
+  }
+
+  ~FPGAStatistics(){}
+
+  void addMemory(FPGAMemoryBase* memory) {
+    memories_.push_back(memory);
+    occupancy_.push_back(std::vector<unsigned int>(maxbin_+1,0));
+    memsum_.push_back(MemorySummary());
+  }
+
+  void addProcess(FPGAProcessBase* proc) {
+    procs_.push_back(proc);
+    iterations_.push_back(std::vector<unsigned int>(maxbin_+1,0));
+    procsum_.push_back(ProcessSummary());
+    proc->resetCounters();
+  }
+
+  //Called once per event after all processing modules have run and
+  //before the memories are cleaned for the next event
+  void fillEvent() {
+
+    nevents_++;
+
+    for (unsigned int i=0;i<memories_.size();i++){
+      FPGAMemoryBase* memory=memories_[i];
+      unsigned int n=memory->nEntries();
+      occupancy_[i][n<maxbin_?n:maxbin_]++;
+      MemorySummary& sum=memsum_[i];
+      sum.nentries+=n;
+      if (n>sum.maxentries) sum.maxentries=n;
+      if (memory->nDropped()>0) {
+	sum.ndropped+=memory->nDropped();
+	sum.neventsdropped++;
+      }
+      if (memory->nOverflow()>0) {
+	sum.noverflow+=memory->nOverflow();
+	sum.neventsoverflow++;
+      }
+      memory->resetDropped();
+    }
+
+    for (unsigned int i=0;i<procs_.size();i++){
+      FPGAProcessBase* proc=procs_[i];
+      unsigned int n=proc->nIterations();
+      iterations_[i][n<maxbin_?n:maxbin_]++;
+      ProcessSummary& sum=procsum_[i];
+      sum.niterations+=n;
+      if (n>sum.maxiterations) sum.maxiterations=n;
+      if (proc->nTruncated()>0) {
+	sum.ntruncated+=proc->nTruncated();
+	sum.neventstruncated++;
+      }
+      proc->resetCounters();
+    }
+
+  }
+
+  unsigned int nEvents() const {return nevents_;}
+
+  //Writes one line per memory and processing module:
+  //  MEM  name sector nevents sum max ndropped neventsdropped noverflow neventsoverflow : histogram
+  //  PROC name sector nevents sum max ntruncated neventstruncated : histogram
+  //Trailing empty bins of the histograms are not written.
+  void writeReport(string filename) const {
+
+    ofstream out(filename.c_str());
+
+    for (unsigned int i=0;i<memories_.size();i++){
+      const MemorySummary& sum=memsum_[i];
+      out << "MEM " << memories_[i]->getName() << " " << memories_[i]->getSector()
+	  << " " << nevents_ << " " << sum.nentries << " " << sum.maxentries
+	  << " " << sum.ndropped << " " << sum.neventsdropped
+	  << " " << sum.noverflow << " " << sum.neventsoverflow << " :";
+      writeHist(out,occupancy_[i]);
+      out << endl;
+    }
+
+    for (unsigned int i=0;i<procs_.size();i++){
+      const ProcessSummary& sum=procsum_[i];
+      out << "PROC " << procs_[i]->getName() << " " << procs_[i]->getSector()
+	  << " " << nevents_ << " " << sum.niterations << " " << sum.maxiterations
+	  << " " << sum.ntruncated << " " << sum.neventstruncated << " :";
+      writeHist(out,iterations_[i]);
+      out << endl;
+    }
+
+  }
+
+private:
+
+  void writeHist(ofstream& out, const std::vector<unsigned int>& hist) const {
+    unsigned int last=hist.size();
+    while (last>0&&hist[last-1]==0) last--;
+    for (unsigned int j=0;j<last;j++){
+      out << " " << hist[j];
+    }
+  }
+
+  struct MemorySummary{
+    MemorySummary() {nentries=0; maxentries=0; ndropped=0; neventsdropped=0; noverflow=0; neventsoverflow=0;}
+    unsigned long nentries;
+    unsigned int maxentries;
+    unsigned long ndropped;
+    unsigned int neventsdropped;
+    unsigned long noverflow;
+    unsigned int neventsoverflow;
+  };
+
+  struct ProcessSummary{
+    ProcessSummary() {niterations=0; maxiterations=0; ntruncated=0; neventstruncated=0;}
+    unsigned long niterations;
+    unsigned int maxiterations;
+    unsigned long ntruncated;
+    unsigned int neventstruncated;
+  };
+
+  unsigned int maxbin_;
+  unsigned int nevents_;
+
+  std::vector<FPGAMemoryBase*> memories_;
+  std::vector<std::vector<unsigned int> > occupancy_;
+  std::vector<MemorySummary> memsum_;
+
+  std::vector<FPGAProcessBase*> procs_;
+  std::vector<std::vector<unsigned int> > iterations_;
+  std::vector<ProcessSummary> procsum_;
+
+};
+
+#endif
@@ -508,7 +508,7 @@ public:
  
   void setAllStubIndex(int nstub){
     if (nstub>=(1<<7)){
-      if (debug1) cout << "Warning too large stubindex!"<<endl;
+      FPGA_DEBUG("Warning too large stubindex!");
       nstub=(1<<7)-1;
     }
 
@@ -517,7 +517,7 @@ public:
 
   void setAllStubAddressTE(int nstub){
     if (nstub>=(1<<7)){
-      if (debug1) cout << "Warning too large stubindex!"<<endl;
+      FPGA_DEBUG("Warning too large stubindex!");
       nstub=(1<<7)-1;
     }
 
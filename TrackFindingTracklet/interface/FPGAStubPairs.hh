@@ -12,9 +12,9 @@ class FPGAStubPairs:public FPGAMemoryBase{
 
 public:
 
-  FPGAStubPairs(string name, unsigned int iSector, 
+  FPGAStubPairs(string name, const FPGASettings* settings, unsigned int iSector, 
 		double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
   }
@@ -26,6 +26,7 @@ public:
   }
 
   unsigned int nStubPairs() const {return stubs1_.size();}
+  unsigned int nEntries() const {return nStubPairs();}
 
   FPGAStub* getFPGAStub1(unsigned int i) const {return stubs1_[i].first;}
   L1TStub* getL1TStub1(unsigned int i) const {return stubs1_[i].second;}
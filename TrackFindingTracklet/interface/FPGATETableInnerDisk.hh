@@ -141,7 +141,7 @@ public:
     
   }
 
-  int lookup(int rbin, int zbin) {
+  int lookup(int rbin, int zbin) const {
 
     int index=rbin*zbins_+zbin;
     assert(index<(int)table_.size());
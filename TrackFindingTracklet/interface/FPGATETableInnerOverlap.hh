@@ -176,7 +176,7 @@ public:
     
   }
 
-  int lookup(int zbin, int rbin) {
+  int lookup(int zbin, int rbin) const {
 
     int index=zbin*rbins_+rbin;
     //cout << "index zbin rbin value "<<index<<" "<<zbin<<" "<<rbin<<" "<<table_[index]<<endl;
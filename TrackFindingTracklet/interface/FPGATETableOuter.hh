@@ -82,7 +82,7 @@ public:
     
   }
 
-  int lookup(int zbin, int rbin) {
+  int lookup(int zbin, int rbin) const {
 
     int index=zbin*rbins_+rbin;
     return table_[index];
@@ -76,7 +76,7 @@ public:
   }
 
 
-  int lookup(int rbin, int zbin) {
+  int lookup(int rbin, int zbin) const {
 
     int index=rbin*zbins_+zbin;
     return table_[index];
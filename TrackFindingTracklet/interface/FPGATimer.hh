@@ -1,43 +1,54 @@
 #ifndef _FPGATIMER_H_
 #define _FPGATIMER_H_
 #include <math.h>
-#include <sys/time.h>
+#include <chrono>
 
 class FPGATimer{
-    
+
  public:
-    
-    FPGATimer(){ntimes_=0; ttot_=0.0;ttotsq_=0.0;};
+
+    typedef std::chrono::steady_clock clock;
+
+    FPGATimer(){ntimes_=0; ttot_=0.0;ttotsq_=0.0;tlast_=0.0;};
     virtual ~FPGATimer(){};
 
-    void start() {gettimeofday(&tstart_,0);}
+    void start() {tstart_=clock::now();}
     void stop() {
-	timeval tstop;
-	gettimeofday(&tstop,0);
-	float tsec=tstop.tv_sec-tstart_.tv_sec;
-	float tusec=tstop.tv_usec-tstart_.tv_usec;
-	if (tusec<0){
-	    tusec+=1000000.0;
-	    tsec-=1.0;
-	}
-	double tmp=tsec+tusec/1000000.0;
+	std::chrono::duration<double> dt=clock::now()-tstart_;
+	double tmp=dt.count();
+	tlast_=tmp;
 	ttot_+=tmp;
 	ttotsq_+=tmp*tmp;
 	ntimes_++;
     }
 
     unsigned int ntimes() const {return ntimes_;}
-    double  avgtime() const {return ttot_/ntimes_;}
-    double  rms() const {return sqrt((ttot_*ttot_-ttotsq_))/ntimes_;}    
+    double  avgtime() const {return ntimes_==0?0.0:ttot_/ntimes_;}
+    double  rms() const {
+      if (ntimes_==0) return 0.0;
+      double avg=ttot_/ntimes_;
+      double var=ttotsq_/ntimes_-avg*avg;
+      return var>0.0?sqrt(var):0.0;
+    }
     double tottime() const {return ttot_;}
 
+    //Time of the last start-stop interval
+    double lasttime() const {return tlast_;}
+
+    //Time in seconds of the last start() relative to the reference time t0
+    double starttime(const clock::time_point& t0) const {
+      std::chrono::duration<double> dt=tstart_-t0;
+      return dt.count();
+    }
+
  private:
 
     unsigned int ntimes_;
     double ttot_;
     double ttotsq_;
+    double tlast_;
 
-    timeval tstart_;
+    clock::time_point tstart_;
 
 };
 
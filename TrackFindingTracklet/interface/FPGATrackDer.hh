@@ -117,7 +117,7 @@ public:
   void sett(double t) { t_=t; }
   double gett() const { return t_; }
 
-  void fill(int t, double MinvDt[4][12], int iMinvDt[4][12]){
+  void fill(int t, double MinvDt[4][12], int iMinvDt[4][12]) const {
     unsigned int nlayer=0;
     if (layermask_&1) nlayer++;
     if (layermask_&2) nlayer++;
@@ -6,6 +6,8 @@
 #include <assert.h>
 #include <math.h>
 #include <vector>
+#include <map>
+#include <string>
 #include "FPGATrackDer.hh"
 
 using namespace std;
@@ -55,10 +57,10 @@ public:
     return &derivatives_[index];
   }
 
-  FPGATrackDer* getDerivatives(unsigned int layermask, 
-			       unsigned int diskmask,
-			       unsigned int alphaindex,
-			       unsigned int rinvindex){
+  const FPGATrackDer* getDerivatives(unsigned int layermask, 
+				     unsigned int diskmask,
+				     unsigned int alphaindex,
+				     unsigned int rinvindex) const {
     int index=getIndex(layermask,diskmask);
     //if (index<0||index!=17984||alphaindex!=20) {
     if (index<0) {
@@ -69,7 +71,7 @@ public:
   }
 
 
-  int getIndex(unsigned int layermask,unsigned int diskmask) {
+  int getIndex(unsigned int layermask,unsigned int diskmask) const {
 
     assert(layermask<LayerMem_.size());
 
@@ -855,82 +857,68 @@ public:
   }
 
 
-  static void getVarianceMatrix(bool layer[6],bool disk[5], int ptbin,
-				std::vector<std::vector< double > >& V) {
+  //Reads the hit position covariance matrices used by the fit with
+  //multiple scattering (useMSFit)
+  void readVarianceFile(std::string fileName) {
 
-    
-    static bool first=true;
+    Vfull_.assign(11*11*4*1000,0.0);
+    layerdiskmap_.clear();
 
-    static std::map<string, int> layerdiskmap;
-    
-    static double Vfull[11][11][4][1000];
+    ifstream in(fileName.c_str());
 
-    double sigmaz=0.15/sqrt(12.0);
-    double sigmaz2=5.0/sqrt(12.0);
-    
-    if (first) {
+    unsigned int ptbin;
 
-      first=false;
-      
-      for(unsigned int i=0;i<11;i++) {
-	for(unsigned int j=0;j<11;j++) {
-	  for(unsigned int k=0;k<4;k++) {	  
-	    for(unsigned int l=0;l<1000;l++) {	  
-	      Vfull[i][j][k][l]=0.0;
-	    }
-	  }
-	}
-      }
-	  
-      ifstream in("variance.dat");
+    int indexcount=0;
 
-      unsigned int ptbin;
+    int index=0;//determined later, but initialize here
 
-      int indexcount=0;
+    std::string type;
 
-      int index=0;//determined later, but initialize here
-      
-      std::string type;
-      
-      in >> type;
-      
-      while (in.good()) {
+    in >> type;
 
-	assert(type=="V" || type=="E");
+    while (in.good()) {
 
-	if (type=="V") {
-	  string layer,disk;
+      assert(type=="V" || type=="E");
 
-	  in >> ptbin >> layer >> disk;
+      if (type=="V") {
+	string layer,disk;
 
-	  string layerdisk=layer+disk;
+	in >> ptbin >> layer >> disk;
 
-	  if (layerdiskmap.find(layerdisk)==layerdiskmap.end()) {
-	    layerdiskmap[layerdisk]=indexcount;
-	    indexcount++;
-	  }
-
-	  index=layerdiskmap[layerdisk];
+	string layerdisk=layer+disk;
 
+	if (layerdiskmap_.find(layerdisk)==layerdiskmap_.end()) {
+	  layerdiskmap_[layerdisk]=indexcount;
+	  indexcount++;
 	}
 
-	if (type=="E") {
-	  int i,j,entries;
-	  double vij;
-	  in >> i >> j >> vij >> entries;
-	  assert(ptbin<4);
-	  assert(i<11);
-	  assert(j<11);
-	  Vfull[i][j][ptbin][index]=vij;
-	  Vfull[j][i][ptbin][index]=vij;
-	}
+	index=layerdiskmap_[layerdisk];
 
-	in >> type;
-	  
       }
-	
+
+      if (type=="E") {
+	int i,j,entries;
+	double vij;
+	in >> i >> j >> vij >> entries;
+	assert(ptbin<4);
+	assert(i<11);
+	assert(j<11);
+	Vfull_[varianceIndex(i,j,ptbin,index)]=vij;
+	Vfull_[varianceIndex(j,i,ptbin,index)]=vij;
+      }
+
+      in >> type;
+
     }
 
+  }
+
+  void getVarianceMatrix(bool layer[6],bool disk[5], int ptbin,
+			 std::vector<std::vector< double > >& V) const {
+
+    double sigmaz=0.15/sqrt(12.0);
+    double sigmaz2=5.0/sqrt(12.0);
+
     unsigned int index[11];
     std::string layerdisk="0000000000000000";
     
@@ -951,12 +939,13 @@ public:
 
     V.clear();
 
-    if (layerdiskmap.find(layerdisk)==layerdiskmap.end()) {
+    std::map<string, int>::const_iterator imap=layerdiskmap_.find(layerdisk);
+    if (imap==layerdiskmap_.end()) {
       cout << "Could not find an entry for layerdisk : "<<layerdisk<<endl;
       assert(0);
     }
 
-    int mapindex=layerdiskmap[layerdisk];
+    int mapindex=imap->second;
     
     for(unsigned int i=0;i<2*N;i++) {
       std::vector<double> tmp;
@@ -975,7 +964,7 @@ public:
 	  int indexj=index[j/2];
 	  //if (indexi<6) indexi=5-indexi;
 	  //if (indexj<6) indexj=5-indexj;
-	  V[i][j]=Vfull[indexi][indexj][ptbin][mapindex];
+	  V[i][j]=Vfull_[varianceIndex(indexi,indexj,ptbin,mapindex)];
 	}
 	if (i%2==1 && i==j){
 	  if (index[i/2]<3) {
@@ -1254,7 +1243,7 @@ public:
   
 
   
-  static void calculateDerivativesMS(unsigned int nlayers,
+  void calculateDerivativesMS(unsigned int nlayers,
 				     double r[6],
 				     unsigned int ndisks,
 				     double z[5],
@@ -1267,7 +1256,7 @@ public:
 				     int iMinvDt[4][12],
 				     double sigma[12],
 				     double kfactor[12],
-				     int ptbin){
+				     int ptbin) const {
 
 
 
@@ -1617,6 +1606,9 @@ public:
 
 private:
 
+  static unsigned int varianceIndex(int i, int j, int ptbin, int index) {
+    return ((i*11+j)*4+ptbin)*1000+index;
+  }
 
   vector<int> LayerMem_;
   vector<int> DiskMem_;
@@ -1638,6 +1630,11 @@ private:
   int nextLayerDiskValue_;
   int lastMultiplicity_;
 
+  //Covariance matrices of the fit with multiple scattering, indexed by
+  //the two hits, the pt bin and the layer and disk combination
+  vector<double> Vfull_;
+  std::map<string, int> layerdiskmap_;
+
 };
 
 
@@ -0,0 +1,93 @@
+//Digest of the final tracks, used to check that two runs (e.g. before
+//and after an optimization) produce the same tracks without writing
+//ntuples. The digest is a 64 bit FNV-1a hash of the sector, the integer
+//track parameters and the stub IDs of the tracks that are not flagged
+//as duplicates, in output order. Event digests can be combined into a
+//run digest by adding them to another FPGATrackDigest.
+#ifndef FPGATRACKDIGEST_H
+#define FPGATRACKDIGEST_H
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+#include "FPGATrack.hh"
+
+using namespace std;
+
+class FPGATrackDigest{
+
+public:
+
+  FPGATrackDigest(){
+    reset();
+  }
+
+  void reset() {
+    hash_=14695981039346656037ULL;
+    n_=0;
+  }
+
+  //Adds one 64 bit value (little endian byte order)
+  void add(unsigned long long value) {
+    for (unsigned int i=0;i<8;i++) {
+      hash_^=(value>>(8*i))&0xff;
+      hash_*=1099511628211ULL;
+    }
+  }
+
+  void add(int value) {
+    add((unsigned long long)(long long)value);
+  }
+
+  //Adds a track, duplicates are skipped
+  void add(const FPGATrack* track) {
+    if (track->duplicate()) return;
+    add(track->sector());
+    add(track->irinv());
+    add(track->iphi0());
+    add(track->id0());
+    add(track->it());
+    add(track->iz0());
+    std::map<int,int> stubIDs=track->stubID();
+    add((int)stubIDs.size());
+    for (std::map<int,int>::const_iterator it=stubIDs.begin();it!=stubIDs.end();++it) {
+      add(it->first);
+      add(it->second);
+    }
+    n_++;
+  }
+
+  void add(const std::vector<FPGATrack*>& tracks) {
+    for (unsigned int i=0;i<tracks.size();i++) {
+      add(tracks[i]);
+    }
+  }
+
+  //Adds the digest of e.g. an event to a run digest
+  void add(const FPGATrackDigest& digest) {
+    add(digest.value());
+    n_++;
+  }
+
+  unsigned long long value() const {return hash_;}
+
+  //Number of tracks (or digests) added
+  unsigned int n() const {return n_;}
+
+  string str() const {
+    ostringstream oss;
+    oss << hex << setw(16) << setfill('0') << hash_;
+    return oss.str();
+  }
+
+private:
+
+  unsigned long long hash_;
+  unsigned int n_;
+
+};
+
+#endif
@@ -11,9 +11,9 @@ class FPGATrackFit:public FPGAMemoryBase{
 
 public:
 
-  FPGATrackFit(string name, unsigned int iSector, 
+  FPGATrackFit(string name, const FPGASettings* settings, unsigned int iSector, 
 	       double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
   }
@@ -23,6 +23,7 @@ public:
   }
 
   unsigned int nTracks() const {return tracks_.size();}
+  unsigned int nEntries() const {return nTracks();}
 
   FPGATracklet* getTrack(unsigned int i) const {
     return tracks_[i];
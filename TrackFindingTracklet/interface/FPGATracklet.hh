@@ -61,6 +61,15 @@ public:
     trackletIndex_=-1;
     TCIndex_=-1;
 
+    for (unsigned int i=0;i<6;i++) {
+      layerproj_[i]=0;
+      layerresid_[i]=0;
+      diskresid_[i]=0;
+    }
+    for (unsigned int i=0;i<5;i++) {
+      diskproj_[i]=0;
+    }
+
 
     phioffset_=phioffset;
 
@@ -230,7 +239,7 @@ public:
 
   if (!validproj[i]) continue;
 
-  layerproj_[projlayer_[i]-1].init(projlayer_[i],
+  layerProjRecord(projlayer_[i]-1).init(projlayer_[i],
            rproj_[i],
            iphiproj[i],
            izproj[i],
@@ -253,7 +262,7 @@ public:
   
   if (!validprojdisk[i]) continue;
 
-  diskproj_[i].init(i+1,
+  diskProjRecord(i).init(i+1,
         zprojdisk_[i],
         iphiprojDisk[i],
         irprojDisk[i],
@@ -279,7 +288,7 @@ public:
 
   if (!validprojdisk[i]) continue;
 
-  diskproj_[abs(projdisk_[i])-1].init(projdisk_[i],
+  diskProjRecord(abs(projdisk_[i])-1).init(projdisk_[i],
              zprojdisk_[i],
              iphiprojDisk[i],
              irprojDisk[i],
@@ -301,7 +310,7 @@ public:
 
   if (!validproj[i]) continue;
   
-  layerproj_[i].init(i+1,
+  layerProjRecord(i).init(i+1,
          rproj_[i],
          iphiproj[i],
          izproj[i],
@@ -328,7 +337,7 @@ public:
 
   if (!validproj[i]) continue;
 
-  layerproj_[i].init(i+1,
+  layerProjRecord(i).init(i+1,
          rproj_[i],
          iphiproj[i],
          izproj[i],
@@ -350,7 +359,7 @@ public:
   if (!validprojdisk[i]) continue;
   int offset=1;
   if (outerStub->layer()+1==2&&innerStub->layer()+1==3) offset=0;
-  diskproj_[i+offset].init(i+offset+1,
+  diskProjRecord(i+offset).init(i+offset+1,
          zprojdisk_[i],
          iphiprojDisk[i],
          irprojDisk[i],
@@ -379,7 +388,14 @@ public:
 
 
   ~FPGATracklet() {
-
+    for (unsigned int i=0;i<6;i++) {
+      delete layerproj_[i];
+      delete layerresid_[i];
+      delete diskresid_[i];
+    }
+    for (unsigned int i=0;i<5;i++) {
+      delete diskproj_[i];
+    }
   }
 
 
@@ -429,10 +445,10 @@ public:
     } else {
       index.set(allstubindex,7,true,__LINE__,__FILE__);
     }
-    oss << index.str()<<"|"<<layerproj_[layer-1].fpgaphiprojvm().str()
-  <<"|"<< layerproj_[layer-1].fpgazbin1projvm().str() 
-        <<"|"<< layerproj_[layer-1].fpgazbin2projvm().str();
-  //<<"|"<< layerproj_[layer-1].fpgazprojvm().str();
+    oss << index.str()<<"|"<<layerProj(layer-1).fpgaphiprojvm().str()
+  <<"|"<< layerProj(layer-1).fpgazbin1projvm().str() 
+        <<"|"<< layerProj(layer-1).fpgazbin2projvm().str();
+  //<<"|"<< layerProj(layer-1).fpgazprojvm().str();
     return oss.str();
 
   }
@@ -446,8 +462,8 @@ public:
     } else {
       index.set(allstubindex,7,true,__LINE__,__FILE__);
     } 
-    oss << index.str()<<"|"<<diskproj_[disk-1].fpgaphiprojvm().str()
-  <<"|"<< diskproj_[disk-1].fpgarprojvm().str();
+    oss << index.str()<<"|"<<diskProj(disk-1).fpgaphiprojvm().str()
+  <<"|"<< diskProj(disk-1).fpgarprojvm().str();
     return oss.str();
 
   }
@@ -464,14 +480,14 @@ public:
     tmp.set(trackletIndex_,6,true,__LINE__,__FILE__);
     FPGAWord tcid;
     tcid.set(TCIndex_,7,true,__LINE__,__FILE__);
-    oss << layerproj_[layer-1].plusNeighbor()<<"|"
-        << layerproj_[layer-1].minusNeighbor()<<"|"
+    oss << layerProj(layer-1).plusNeighbor()<<"|"
+        << layerProj(layer-1).minusNeighbor()<<"|"
         << tcid.str()<<"|"
   << tmp.str()<<"|"
-        << layerproj_[layer-1].fpgaphiproj().str()<<"|"
-  << layerproj_[layer-1].fpgazproj().str()<<"|"
-  << layerproj_[layer-1].fpgaphiprojder().str()<<"|"
-  << layerproj_[layer-1].fpgazprojder().str();
+        << layerProj(layer-1).fpgaphiproj().str()<<"|"
+  << layerProj(layer-1).fpgazproj().str()<<"|"
+  << layerProj(layer-1).fpgaphiprojder().str()<<"|"
+  << layerProj(layer-1).fpgazprojder().str();
 
     return oss.str();
 
@@ -488,14 +504,14 @@ public:
     FPGAWord tcid;
     tcid.set(TCIndex_,7,true,__LINE__,__FILE__);
 
-    oss << diskproj_[abs(disk)-1].plusNeighbor()<<"|"
-        << diskproj_[abs(disk)-1].minusNeighbor()<<"|" 
+    oss << diskProj(abs(disk)-1).plusNeighbor()<<"|"
+        << diskProj(abs(disk)-1).minusNeighbor()<<"|" 
         << tcid.str()<<"|" 
         << tmp.str()<<"|"
-  << diskproj_[abs(disk)-1].fpgaphiproj().str()<<"|"
-  << diskproj_[abs(disk)-1].fpgarproj().str()<<"|"
-  << diskproj_[abs(disk)-1].fpgaphiprojder().str()<<"|"
-  << diskproj_[abs(disk)-1].fpgarprojder().str();
+  << diskProj(abs(disk)-1).fpgaphiproj().str()<<"|"
+  << diskProj(abs(disk)-1).fpgarproj().str()<<"|"
+  << diskProj(abs(disk)-1).fpgaphiprojder().str()<<"|"
+  << diskProj(abs(disk)-1).fpgarprojder().str();
 
     return oss.str();
 
@@ -512,89 +528,89 @@ public:
 
   bool validProj(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].valid();
+    return layerProj(layer-1).valid();
   }
 
   FPGAWord fpgaphiprojder(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgaphiprojder();
+    return layerProj(layer-1).fpgaphiprojder();
   }
 
   FPGAWord fpgazproj(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgazproj();
+    return layerProj(layer-1).fpgazproj();
   }
 
   FPGAWord fpgaphiproj(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgaphiproj();
+    return layerProj(layer-1).fpgaphiproj();
   }
 
   FPGAWord fpgazprojder(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgazprojder();
+    return layerProj(layer-1).fpgazprojder();
   }
 
   int zbin1projvm(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgazbin1projvm().value();
+    return layerProj(layer-1).fpgazbin1projvm().value();
   }
 
   int zbin2projvm(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgazbin2projvm().value();
+    return layerProj(layer-1).fpgazbin2projvm().value();
   }
 
   int finezvm(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgafinezvm().value();
+    return layerProj(layer-1).fpgafinezvm().value();
   }
 
   int rbin1projvm(int disk) const {
     assert(disk>=1&&disk<=5);
-    return diskproj_[disk-1].fpgarbin1projvm().value();
+    return diskProj(disk-1).fpgarbin1projvm().value();
   }
 
   int rbin2projvm(int disk) const {
     assert(disk>=1&&disk<=5);
-    return diskproj_[disk-1].fpgarbin2projvm().value();
+    return diskProj(disk-1).fpgarbin2projvm().value();
   }
 
   int finervm(int disk) const {
     assert(disk>=1&&disk<=5);
-    return diskproj_[disk-1].fpgafinervm().value();
+    return diskProj(disk-1).fpgafinervm().value();
   }
 
   int phiprojvm(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgaphiprojvm().value();
+    return layerProj(layer-1).fpgaphiprojvm().value();
   }
 
   int zprojvm(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].fpgazprojvm().value();
+    return layerProj(layer-1).fpgazprojvm().value();
   }
 
 
   
   double phiproj(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].phiproj();
+    return layerProj(layer-1).phiproj();
   }
 
   double phiprojder(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].phiprojder();
+    return layerProj(layer-1).phiprojder();
   }
 
   double zproj(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].zproj();
+    return layerProj(layer-1).zproj();
   }
 
   double zprojder(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].zprojder();
+    return layerProj(layer-1).zprojder();
   }
 
 
@@ -602,46 +618,46 @@ public:
   
   double zprojapprox(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].zprojapprox();
+    return layerProj(layer-1).zprojapprox();
   }
 
   double zprojderapprox(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].zprojderapprox();
+    return layerProj(layer-1).zprojderapprox();
   }
 
   double phiprojapprox(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].phiprojapprox();
+    return layerProj(layer-1).phiprojapprox();
   }
 
   double phiprojderapprox(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].phiprojderapprox();
+    return layerProj(layer-1).phiprojderapprox();
   }
 
   
 
   double rproj(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].rproj();
+    return layerProj(layer-1).rproj();
   }
 
   bool minusNeighbor(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].minusNeighbor();
+    return layerProj(layer-1).minusNeighbor();
   }
 
   bool plusNeighbor(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerproj_[layer-1].plusNeighbor();
+    return layerProj(layer-1).plusNeighbor();
   }
 
 
 
   double rstub(int layer) {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].rstub();
+    return layerResid(layer-1).rstub();
   }
 
 
@@ -652,44 +668,44 @@ public:
 
   bool validProjDisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].valid();
+    return diskProj(abs(disk)-1).valid();
   }
 
 
   FPGAWord fpgaphiresiddisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].fpgaphiresid();
+    return diskResid(abs(disk)-1).fpgaphiresid();
   }
 
   FPGAWord fpgarresiddisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].fpgarresid();
+    return diskResid(abs(disk)-1).fpgarresid();
   }
 
   double phiresiddisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].phiresid();
+    return diskResid(abs(disk)-1).phiresid();
   }
 
   double rresiddisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].rresid();
+    return diskResid(abs(disk)-1).rresid();
   }
 
   double phiresidapproxdisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].phiresidapprox();
+    return diskResid(abs(disk)-1).phiresidapprox();
   }
 
   double rresidapproxdisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].rresidapprox();
+    return diskResid(abs(disk)-1).rresidapprox();
   }
 
 
   double zstubdisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].zstub();
+    return diskResid(abs(disk)-1).zstub();
   }
 
 
@@ -707,108 +723,108 @@ public:
 
   void setBendIndex(int bendIndex,int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    diskproj_[abs(disk)-1].setBendIndex(bendIndex);
+    diskProjRecord(abs(disk)-1).setBendIndex(bendIndex);
   }
 
   FPGAWord getBendIndex(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].getBendIndex();
+    return diskProj(abs(disk)-1).getBendIndex();
   }
   
 
   double alphadisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].alpha();
+    return diskResid(abs(disk)-1).alpha();
   }
 
   FPGAWord ialphadisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].ialpha();
+    return diskResid(abs(disk)-1).ialpha();
   }
 
   
 
   FPGAWord fpgaphiprojdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].fpgaphiproj();
+    return diskProj(abs(disk)-1).fpgaphiproj();
   }
 
   FPGAWord fpgaphiprojderdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].fpgaphiprojder();
+    return diskProj(abs(disk)-1).fpgaphiprojder();
   }
 
   FPGAWord fpgarprojdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].fpgarproj();
+    return diskProj(abs(disk)-1).fpgarproj();
   }
   
   FPGAWord fpgarprojderdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].fpgarprojder();
+    return diskProj(abs(disk)-1).fpgarprojder();
   }
 
   
 
   double phiprojapproxdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].phiprojapprox();
+    return diskProj(abs(disk)-1).phiprojapprox();
   }
 
   double phiprojderapproxdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].phiprojderapprox();
+    return diskProj(abs(disk)-1).phiprojderapprox();
   }
   
   double rprojapproxdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].rprojapprox();
+    return diskProj(abs(disk)-1).rprojapprox();
   }
 
   double rprojderapproxdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].rprojderapprox();
+    return diskProj(abs(disk)-1).rprojderapprox();
   }
 
 
 
   double phiprojdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].phiproj();
+    return diskProj(abs(disk)-1).phiproj();
   }
 
   double phiprojderdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].phiprojder();
+    return diskProj(abs(disk)-1).phiprojder();
   }
   
   double rprojdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].rproj();
+    return diskProj(abs(disk)-1).rproj();
   }
   
   double rprojderdisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].rprojder();
+    return diskProj(abs(disk)-1).rprojder();
   }
 
 
 
   bool minusNeighborDisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].minusNeighbor();
+    return diskProj(abs(disk)-1).minusNeighbor();
   }
 
 
   bool plusNeighborDisk(int disk) const {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskproj_[abs(disk)-1].plusNeighbor();
+    return diskProj(abs(disk)-1).plusNeighbor();
   }
 
 
   bool matchdisk(int disk) {
     assert(abs(disk)>=1&&abs(disk)<=5);
-    return diskresid_[abs(disk)-1].valid();
+    return diskResid(abs(disk)-1).valid();
   }
 
   void addMatch(int layer, int ideltaphi, int ideltaz, 
@@ -821,7 +837,7 @@ public:
 
     assert(layer>=1&&layer<=6);
 
-    layerresid_[layer-1].init(layer,ideltaphi,ideltaz,stubid,dphi,dz,dphiapprox,dzapprox,rstub,stubptrs);
+    layerResidRecord(layer-1).init(layer,ideltaphi,ideltaz,stubid,dphi,dz,dphiapprox,dzapprox,rstub,stubptrs);
     
   }
 
@@ -837,7 +853,7 @@ public:
 
     assert(abs(disk)>=1&&abs(disk)<=5);
 
-    diskresid_[abs(disk)-1].init(disk,ideltaphi,ideltar,stubid,dphi,dr,dphiapprox,drapprox,zstub,alpha,stubptrs.first->alphanew(),stubptrs);
+    diskResidRecord(abs(disk)-1).init(disk,ideltaphi,ideltar,stubid,dphi,dr,dphiapprox,drapprox,zstub,alpha,stubptrs.first->alphanew(),stubptrs);
       
 
   }
@@ -880,7 +896,7 @@ public:
     int nmatches=0;
 
     for (int i=0;i<6;i++) {
-      if (layerresid_[i].valid()) {
+      if (layerResid(i).valid()) {
   nmatches++;
       }
     }
@@ -896,7 +912,7 @@ public:
     int lastdisk=5;
     if (skipD5) lastdisk--; 
     for (int i=0;i<lastdisk;i++) {
-      if (diskresid_[i].valid()) {
+      if (diskResid(i).valid()) {
   nmatches++;
       }
     }
@@ -912,13 +928,13 @@ public:
     assert(overlap_);
 
     for (int i=1;i<5;i++) {
-      if (diskresid_[i].valid()) {
+      if (diskResid(i).valid()) {
   nmatches++;
       }
     }
 
     for (int i=0;i<2;i++) {
-      if (layerresid_[i].valid()) nmatches++;
+      if (layerResid(i).valid()) nmatches++;
     }
     return nmatches;
     
@@ -928,7 +944,7 @@ public:
 
   bool match(int layer) {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].valid();
+    return layerResid(layer-1).valid();
   }
 
 
@@ -946,9 +962,9 @@ public:
     tcid.set(TCIndex_,7,true,__LINE__,__FILE__);
     oss << tcid.str()<<"|"
         << tmp.str()<<"|"
-  << layerresid_[layer-1].fpgastubid().str()<<"|"
-  << layerresid_[layer-1].fpgaphiresid().str()<<"|"
-  << layerresid_[layer-1].fpgazresid().str();
+  << layerResid(layer-1).fpgastubid().str()<<"|"
+  << layerResid(layer-1).fpgaphiresid().str()<<"|"
+  << layerResid(layer-1).fpgazresid().str();
 
     return oss.str();
 
@@ -968,9 +984,9 @@ public:
     tcid.set(TCIndex_,7,true,__LINE__,__FILE__);
     oss << tcid.str()<<"|"
         << tmp.str()<<"|"
-  << diskresid_[disk-1].fpgastubid().str()<<"|"
-  << diskresid_[disk-1].fpgaphiresid().str()<<"|"
-  << diskresid_[disk-1].fpgarresid().str();
+  << diskResid(disk-1).fpgastubid().str()<<"|"
+  << diskResid(disk-1).fpgaphiresid().str()<<"|"
+  << diskResid(disk-1).fpgarresid().str();
 
     return oss.str();
 
@@ -979,34 +995,34 @@ public:
 
   bool validResid(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].valid();
+    return layerResid(layer-1).valid();
   }
 
   
   std::pair<FPGAStub*,L1TStub*> stubptrs(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].stubptrs();
+    return layerResid(layer-1).stubptrs();
   }
 
   
   double phiresid(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].phiresid();
+    return layerResid(layer-1).phiresid();
   }
 
   double phiresidapprox(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].phiresidapprox();
+    return layerResid(layer-1).phiresidapprox();
   }
 
   double zresid(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].zresid();
+    return layerResid(layer-1).zresid();
   }
 
   double zresidapprox(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].zresidapprox();
+    return layerResid(layer-1).zresidapprox();
   }
 
 
@@ -1015,12 +1031,12 @@ public:
 
   FPGAWord fpgaphiresid(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].fpgaphiresid();
+    return layerResid(layer-1).fpgaphiresid();
   }
 
   FPGAWord fpgazresid(int layer) const {
     assert(layer>=1&&layer<=6);
-    return layerresid_[layer-1].fpgazresid();
+    return layerResid(layer-1).fpgazresid();
   }
 
 
@@ -1032,13 +1048,13 @@ public:
     tmp.push_back(outerStub_);
 
     for (unsigned int i=0;i<6;i++) {
-      if (layerresid_[i].valid()) {
-  tmp.push_back(layerresid_[i].stubptrs().second);
+      if (layerResid(i).valid()) {
+  tmp.push_back(layerResid(i).stubptrs().second);
       }
     }
 
     for (unsigned int i=0;i<5;i++) {
-      if (diskresid_[i].valid()) tmp.push_back(diskresid_[i].stubptrs().second);
+      if (diskResid(i).valid()) tmp.push_back(diskResid(i).stubptrs().second);
     }
 
     return tmp;
@@ -1068,28 +1084,28 @@ public:
       for(int i=0; i<6; i++) {
 
         //check barrel
-  if (layerresid_[i].valid()) {
+  if (layerResid(i).valid()) {
       // two extra bits to indicate if the matched stub is local or from neighbor
       int location = 1;  // local
       if (minusNeighbor(i+1)) location = 0; // phi-
       if (plusNeighbor(i+1)) location = 2;  // phi+
-      location<<=layerresid_[i].fpgastubid().nbits();
+      location<<=layerResid(i).fpgastubid().nbits();
       
-      stubIDs[1+i] = layerresid_[i].fpgastubid().value()+location;
+      stubIDs[1+i] = layerResid(i).fpgastubid().value()+location;
         }             
       
   //check disk
-  if(diskresid_[i].valid()) {
+  if(diskResid(i).valid()) {
     // two extra bits to indicate if the matched stub is local or from neighbor
     int location = 1;  // local
     if (minusNeighborDisk(i+1)) location = 0; // phi-
     if (plusNeighborDisk(i+1)) location = 2;  // phi+
-    location<<=diskresid_[i].fpgastubid().nbits();
+    location<<=diskResid(i).fpgastubid().nbits();
 
     if(itfit().value() < 0) {
-    stubIDs[-11-i] = diskresid_[i].fpgastubid().value()+location;
+    stubIDs[-11-i] = diskResid(i).fpgastubid().value()+location;
     } else {
-      stubIDs[11+i] = diskresid_[i].fpgastubid().value()+location;
+      stubIDs[11+i] = diskResid(i).fpgastubid().value()+location;
     }  
   }                     
       }
@@ -1109,29 +1125,29 @@ public:
       for(int i=0; i<5; i++) {
   
   //check barrel
-  if(layerresid_[i].valid()) {
+  if(layerResid(i).valid()) {
       // two extra bits to indicate if the matched stub is local or from neighbor
       int location = 1;  // local
       if (minusNeighbor(i+1)) location = 0; // phi-
       if (plusNeighbor(i+1)) location = 2;  // phi+
-      location<<=layerresid_[i].fpgastubid().nbits();
+      location<<=layerResid(i).fpgastubid().nbits();
       
-      stubIDs[1+i] = layerresid_[i].fpgastubid().value()+location;
+      stubIDs[1+i] = layerResid(i).fpgastubid().value()+location;
         }
   
   //check disks
-        if(i==4 && layerresid_[1].valid()) continue; // Don't add D5 if track has L1 stub
-  if(diskresid_[i].valid()) {
+        if(i==4 && layerResid(1).valid()) continue; // Don't add D5 if track has L1 stub
+  if(diskResid(i).valid()) {
     // two extra bits to indicate if the matched stub is local or from neighbor
     int location = 1;  // local
     if (minusNeighborDisk(i+1)) location = 0; // phi-
     if (plusNeighborDisk(i+1)) location = 2;  // phi+
-    location<<=diskresid_[i].fpgastubid().nbits();
+    location<<=diskResid(i).fpgastubid().nbits();
     
     if(innerStub_->disk() < 0) {
-      stubIDs[-11-i] = diskresid_[i].fpgastubid().value()+location;
+      stubIDs[-11-i] = diskResid(i).fpgastubid().value()+location;
     } else {
-      stubIDs[11+i] = diskresid_[i].fpgastubid().value()+location;
+      stubIDs[11+i] = diskResid(i).fpgastubid().value()+location;
     }
   }         
       }
@@ -1161,31 +1177,31 @@ public:
       for(int i=0; i<5; i++) {
   
   //check barrel
-  if(layerresid_[i].valid()) {
+  if(layerResid(i).valid()) {
       // two extra bits to indicate if the matched stub is local or from neighbor
       int location = 1;  // local
       if (minusNeighbor(i+1)) location = 0; // phi-
       if (plusNeighbor(i+1)) location = 2;  // phi+
-      location<<=layerresid_[i].fpgastubid().nbits();
+      location<<=layerResid(i).fpgastubid().nbits();
       
-      stubIDs[1+i] = layerresid_[i].fpgastubid().value()+location;
+      stubIDs[1+i] = layerResid(i).fpgastubid().value()+location;
   }
 
   //check disks
-  if(diskresid_[i].valid()) {
+  if(diskResid(i).valid()) {
     // two extra bits to indicate if the matched stub is local or from neighbor
     int location = 1;  // local
     if (minusNeighborDisk(i+1)) location = 0; // phi-
     if (plusNeighborDisk(i+1)) location = 2;  // phi+
-    location<<=diskresid_[i].fpgastubid().nbits();
+    location<<=diskResid(i).fpgastubid().nbits();
     
     if(innerStub_->disk() < 0) { // if negative overlap
-            if(innerFPGAStub_->layer().value()!=2 || !layerresid_[0].valid() || i!=3 ) { // Don't add D4 if this is an L3L2 track with an L1 stub
-        stubIDs[-11-i] = diskresid_[i].fpgastubid().value()+location;
+            if(innerFPGAStub_->layer().value()!=2 || !layerResid(0).valid() || i!=3 ) { // Don't add D4 if this is an L3L2 track with an L1 stub
+        stubIDs[-11-i] = diskResid(i).fpgastubid().value()+location;
             }
     } else {
-            if(innerFPGAStub_->layer().value()!=2 || !layerresid_[0].valid() || i!=3 ) {
-        stubIDs[11+i] = diskresid_[i].fpgastubid().value()+location;
+            if(innerFPGAStub_->layer().value()!=2 || !layerResid(0).valid() || i!=3 ) {
+        stubIDs[11+i] = diskResid(i).fpgastubid().value()+location;
             }
     }
   }         
@@ -1372,101 +1388,101 @@ public:
 
     if (isBarrel()) {
       if (layer()==1) {
-  if (layerresid_[2].valid()) {
-    stubid0=layerresid_[2].fpgastubid().str();
+  if (layerResid(2).valid()) {
+    stubid0=layerResid(2).fpgastubid().str();
   }
-  if (layerresid_[3].valid()) {
-    stubid1=layerresid_[3].fpgastubid().str();
+  if (layerResid(3).valid()) {
+    stubid1=layerResid(3).fpgastubid().str();
   }
-  if (layerresid_[4].valid()) {
-    stubid2=layerresid_[4].fpgastubid().str();
+  if (layerResid(4).valid()) {
+    stubid2=layerResid(4).fpgastubid().str();
   }
-  if (layerresid_[5].valid()) {
-    stubid3=layerresid_[5].fpgastubid().str();
+  if (layerResid(5).valid()) {
+    stubid3=layerResid(5).fpgastubid().str();
   }
-  if (diskresid_[0].valid()) {
-    stubid3=diskresid_[0].fpgastubid().str();
+  if (diskResid(0).valid()) {
+    stubid3=diskResid(0).fpgastubid().str();
   }
-if (diskresid_[1].valid()) {
-    stubid2=diskresid_[1].fpgastubid().str();
+if (diskResid(1).valid()) {
+    stubid2=diskResid(1).fpgastubid().str();
   }
-  if (diskresid_[2].valid()) {
-    stubid1=diskresid_[2].fpgastubid().str();
+  if (diskResid(2).valid()) {
+    stubid1=diskResid(2).fpgastubid().str();
   }
-  if (diskresid_[3].valid()) {
-    stubid0=diskresid_[3].fpgastubid().str();
+  if (diskResid(3).valid()) {
+    stubid0=diskResid(3).fpgastubid().str();
   }
       }
 
       if (layer()==3) {
-  if (layerresid_[0].valid()) {
-    stubid0=layerresid_[0].fpgastubid().str();
+  if (layerResid(0).valid()) {
+    stubid0=layerResid(0).fpgastubid().str();
   }
-  if (layerresid_[1].valid()) {
-    stubid1=layerresid_[1].fpgastubid().str();
+  if (layerResid(1).valid()) {
+    stubid1=layerResid(1).fpgastubid().str();
   }
-  if (layerresid_[4].valid()) {
-    stubid2=layerresid_[4].fpgastubid().str();
+  if (layerResid(4).valid()) {
+    stubid2=layerResid(4).fpgastubid().str();
   }
-  if (layerresid_[5].valid()) {
-    stubid3=layerresid_[5].fpgastubid().str();
+  if (layerResid(5).valid()) {
+    stubid3=layerResid(5).fpgastubid().str();
   }
-  if (diskresid_[0].valid()) {
-    stubid3=diskresid_[0].fpgastubid().str();
+  if (diskResid(0).valid()) {
+    stubid3=diskResid(0).fpgastubid().str();
   }
-  if (diskresid_[1].valid()) {
-    stubid2=diskresid_[1].fpgastubid().str();
+  if (diskResid(1).valid()) {
+    stubid2=diskResid(1).fpgastubid().str();
   }
       }
 
       if (layer()==5) {
-  if (layerresid_[0].valid()) {
-    stubid0=layerresid_[0].fpgastubid().str();
+  if (layerResid(0).valid()) {
+    stubid0=layerResid(0).fpgastubid().str();
   }
-  if (layerresid_[1].valid()) {
-    stubid1=layerresid_[1].fpgastubid().str();
+  if (layerResid(1).valid()) {
+    stubid1=layerResid(1).fpgastubid().str();
   }
-  if (layerresid_[2].valid()) {
-    stubid2=layerresid_[2].fpgastubid().str();
+  if (layerResid(2).valid()) {
+    stubid2=layerResid(2).fpgastubid().str();
   }
-  if (layerresid_[3].valid()) {
-    stubid3=layerresid_[3].fpgastubid().str();
+  if (layerResid(3).valid()) {
+    stubid3=layerResid(3).fpgastubid().str();
   }
       }
     }
 
     if (isDisk()) {
       if (disk()==1) {
-  if (layerresid_[0].valid()) {
-    stubid0=layerresid_[0].fpgastubid().str();
+  if (layerResid(0).valid()) {
+    stubid0=layerResid(0).fpgastubid().str();
   }
-  if (diskresid_[2].valid()) {
-    stubid1=diskresid_[2].fpgastubid().str();
+  if (diskResid(2).valid()) {
+    stubid1=diskResid(2).fpgastubid().str();
   }
-  if (diskresid_[3].valid()) {
-    stubid2=diskresid_[3].fpgastubid().str();
+  if (diskResid(3).valid()) {
+    stubid2=diskResid(3).fpgastubid().str();
   }
-  if (diskresid_[4].valid()) {
-    stubid3=diskresid_[4].fpgastubid().str();
-  } else  if (layerresid_[1].valid()) {
-    stubid3=layerresid_[1].fpgastubid().str();
+  if (diskResid(4).valid()) {
+    stubid3=diskResid(4).fpgastubid().str();
+  } else  if (layerResid(1).valid()) {
+    stubid3=layerResid(1).fpgastubid().str();
   }
       }
 
       if (disk()==3) {
-  if (layerresid_[0].valid()) {
-    stubid0=layerresid_[0].fpgastubid().str();
+  if (layerResid(0).valid()) {
+    stubid0=layerResid(0).fpgastubid().str();
   }
-  if (diskresid_[0].valid()) {
-    stubid1=diskresid_[0].fpgastubid().str();
+  if (diskResid(0).valid()) {
+    stubid1=diskResid(0).fpgastubid().str();
   }
-  if (diskresid_[1].valid()) {
-    stubid2=diskresid_[1].fpgastubid().str();
+  if (diskResid(1).valid()) {
+    stubid2=diskResid(1).fpgastubid().str();
   }
-  if (diskresid_[4].valid()) {
-    stubid3=diskresid_[4].fpgastubid().str();
-  } else  if (layerresid_[1].valid()) {
-    stubid3=layerresid_[1].fpgastubid().str();
+  if (diskResid(4).valid()) {
+    stubid3=diskResid(4).fpgastubid().str();
+  } else  if (layerResid(1).valid()) {
+    stubid3=layerResid(1).fpgastubid().str();
   }
       }
       
@@ -1474,17 +1490,17 @@ if (diskresid_[1].valid()) {
       
     if (isOverlap()) {
       if (layer()==1) {
-  if (diskresid_[1].valid()) {
-    stubid0=diskresid_[1].fpgastubid().str();
+  if (diskResid(1).valid()) {
+    stubid0=diskResid(1).fpgastubid().str();
   }
-  if (diskresid_[2].valid()) {
-    stubid1=diskresid_[2].fpgastubid().str();
+  if (diskResid(2).valid()) {
+    stubid1=diskResid(2).fpgastubid().str();
   }
-  if (diskresid_[3].valid()) {
-    stubid2=diskresid_[3].fpgastubid().str();
+  if (diskResid(3).valid()) {
+    stubid2=diskResid(3).fpgastubid().str();
   }
-  if (diskresid_[4].valid()) {
-    stubid3=diskresid_[4].fpgastubid().str();
+  if (diskResid(4).valid()) {
+    stubid3=diskResid(4).fpgastubid().str();
   }
 
       }
@@ -1667,6 +1683,52 @@ if (diskresid_[1].valid()) {
   
 private:
 
+  FPGATracklet(const FPGATracklet&);
+  FPGATracklet& operator=(const FPGATracklet&);
+
+  //Read access to the projection and residual records (index from 0).
+  //Slots without a record return an invalid default record.
+  const FPGALayerProjection& layerProj(int i) const {
+    static const FPGALayerProjection invalid;
+    return layerproj_[i]!=0?*layerproj_[i]:invalid;
+  }
+
+  const FPGADiskProjection& diskProj(int i) const {
+    static const FPGADiskProjection invalid;
+    return diskproj_[i]!=0?*diskproj_[i]:invalid;
+  }
+
+  const FPGALayerResidual& layerResid(int i) const {
+    static const FPGALayerResidual invalid;
+    return layerresid_[i]!=0?*layerresid_[i]:invalid;
+  }
+
+  const FPGADiskResidual& diskResid(int i) const {
+    static const FPGADiskResidual invalid;
+    return diskresid_[i]!=0?*diskresid_[i]:invalid;
+  }
+
+  //Write access, allocates the record on first use
+  FPGALayerProjection& layerProjRecord(int i) {
+    if (layerproj_[i]==0) layerproj_[i]=new FPGALayerProjection();
+    return *layerproj_[i];
+  }
+
+  FPGADiskProjection& diskProjRecord(int i) {
+    if (diskproj_[i]==0) diskproj_[i]=new FPGADiskProjection();
+    return *diskproj_[i];
+  }
+
+  FPGALayerResidual& layerResidRecord(int i) {
+    if (layerresid_[i]==0) layerresid_[i]=new FPGALayerResidual();
+    return *layerresid_[i];
+  }
+
+  FPGADiskResidual& diskResidRecord(int i) {
+    if (diskresid_[i]==0) diskresid_[i]=new FPGADiskResidual();
+    return *diskresid_[i];
+  }
+
   //Three types of tracklets... Overly complicated
   bool barrel_;
   bool disk_;
@@ -1737,11 +1799,15 @@ private:
   FPGATrack *fpgatrack_;
 
 
-  FPGALayerProjection layerproj_[6];
-  FPGADiskProjection diskproj_[5];
+  //Projections and residuals are only allocated for the layers and disks
+  //the tracklet projects to or has a match in. The records are owned by
+  //the tracklet; a null pointer is an invalid projection (residual).
+  FPGALayerProjection* layerproj_[6];
+  FPGADiskProjection* diskproj_[5];
 
-  FPGALayerResidual layerresid_[6];
-  FPGADiskResidual diskresid_[6];
+  FPGALayerResidual* layerresid_[6];
+  //6 entries, as the barrel branch of getStubIDs() loops over 6 disk residuals.
+  FPGADiskResidual* diskresid_[6];
 
   
 };
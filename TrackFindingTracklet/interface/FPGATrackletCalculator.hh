@@ -15,8 +15,8 @@ class FPGATrackletCalculator:public FPGAProcessBase{
 
 public:
 
-  FPGATrackletCalculator(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGATrackletCalculator(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
     double dphi=two_pi/NSector;
     double dphiHG=0.0;
     if (hourglass) {
@@ -1042,9 +1042,7 @@ public:
 	L1TStub* outerStub=stubpairs_[l]->getL1TStub2(i);
 	FPGAStub* outerFPGAStub=stubpairs_[l]->getFPGAStub2(i);
 
-	if (debug1) {
-	  cout << "FPGATrackletCalculator execute "<<getName()<<"["<<iSector_<<"]"<<endl;
-	}
+	FPGA_DEBUG("FPGATrackletCalculator execute "<<getName()<<"["<<iSector_<<"]");
 	
 	if (innerFPGAStub->isBarrel()&&(getName()!="TC_D1L2A"&&getName()!="TC_D1L2B")){
 
@@ -1097,23 +1095,28 @@ public:
 	  break;
 	}
 	
-	if (countall>=MAXTC) {
-	  if (debug1) cout << "Will break on MAXTC 1"<<endl;
+	if (countall>=settings_->maxTC()) {
+	  FPGA_DEBUG("Will break on MAXTC 1");
 	  break;
 	}
-	if (debug1) {
-	  cout << "FPGATrackletCalculator execute done"<<endl;
-	}
+	FPGA_DEBUG("FPGATrackletCalculator execute done");
 
       }
-      if (countall>=MAXTC) {
-	if (debug1) cout << "Will break on MAXTC 2"<<endl;
+      if (countall>=settings_->maxTC()) {
+	FPGA_DEBUG("Will break on MAXTC 2");
 	break;
       }
     }
 
+    //stub pairs not tried because of the maxTC or tracklet number limits
+    unsigned int npairs=0;
+    for(unsigned int l=0;l<stubpairs_.size();l++){
+      npairs+=stubpairs_[l]->nStubPairs();
+    }
+    countIterations(countall,npairs-countall);
+
     if (writeTrackletCalculator) {
-      static ofstream out("trackletcalculator.txt");
+      ofstream& out=debugFile("trackletcalculator.txt");
       out << getName()<<" "<<countall<<" "<<countsel<<endl;
     }
 
@@ -1433,10 +1436,8 @@ public:
 
   bool barrelSeeding(FPGAStub* innerFPGAStub, L1TStub* innerStub, FPGAStub* outerFPGAStub, L1TStub* outerStub){
 	  
-    if (debug1) {
-      cout << "FPGATrackletCalculator "<<getName()<<" "<<layer_<<" trying stub pair in layer (inner outer): "
-	   <<innerFPGAStub->layer().value()<<" "<<outerFPGAStub->layer().value()<<endl;
-    }
+    FPGA_DEBUG("FPGATrackletCalculator "<<getName()<<" "<<layer_<<" trying stub pair in layer (inner outer): "
+	   <<innerFPGAStub->layer().value()<<" "<<outerFPGAStub->layer().value());
 	    
     assert(outerFPGAStub->isBarrel());
     
@@ -1459,19 +1460,24 @@ public:
     double phiproj[4],zproj[4],phider[4],zder[4];
     double phiprojdisk[5],rprojdisk[5],phiderdisk[5],rderdisk[5];
     
-    exacttracklet(r1,z1,phi1,r2,z2,phi2,outerStub->sigmaz(),
-		  rinv,phi0,t,z0,
-		  phiproj,zproj,phider,zder,
-		  phiprojdisk,rprojdisk,phiderdisk,rderdisk);
+    if (settings_->validateTC()) {
+      exacttracklet(r1,z1,phi1,r2,z2,phi2,outerStub->sigmaz(),
+		    rinv,phi0,t,z0,
+		    phiproj,zproj,phider,zder,
+		    phiprojdisk,rprojdisk,phiderdisk,rderdisk);
 
-    if (useapprox) {
-      phi1=innerFPGAStub->phiapprox(phimin_,phimax_);
-      z1=innerFPGAStub->zapprox();
-      r1=innerFPGAStub->rapprox();
+      if (useapprox) {
+        phi1=innerFPGAStub->phiapprox(phimin_,phimax_);
+        z1=innerFPGAStub->zapprox();
+        r1=innerFPGAStub->rapprox();
 
-      phi2=outerFPGAStub->phiapprox(phimin_,phimax_);
-      z2=outerFPGAStub->zapprox();
-      r2=outerFPGAStub->rapprox();
+        phi2=outerFPGAStub->phiapprox(phimin_,phimax_);
+        z2=outerFPGAStub->zapprox();
+        r2=outerFPGAStub->rapprox();
+      }
+    } else {
+      //only the sign of t is needed to set up the projections
+      t=(z1-z2)/(r1-r2);
     }
     
     double rinvapprox,phi0approx,tapprox,z0approx;
@@ -1479,24 +1485,54 @@ public:
     double phiprojdiskapprox[5],rprojdiskapprox[5];
     double phiderdiskapprox[5],rderdiskapprox[5];
     
-    IMATH_TrackletCalculator *ITC;
-    if(layer_==1)      ITC = &ITC_L1L2;
-    else if(layer_==2) ITC = &ITC_L2L3;
-    else if(layer_==3) ITC = &ITC_L3L4;
-    else               ITC = &ITC_L5L6;
-    
-    ITC->r1.set_fval(r1-rmean[layer_-1]);
-    ITC->r2.set_fval(r2-rmean[layer_]);
-    ITC->z1.set_fval(z1);
-    ITC->z2.set_fval(z2);
-    double sphi1 = phi1 - phioffset_;
-    if(sphi1<0) sphi1 += 8*atan(1.);
-    if(sphi1>8*atan(1.)) sphi1 -= 8*atan(1.);
-    double sphi2 = phi2 - phioffset_;
-    if(sphi2<0) sphi2 += 8*atan(1.);
-    if(sphi2>8*atan(1.)) sphi2 -= 8*atan(1.);
-    ITC->phi1.set_fval(sphi1);
-    ITC->phi2.set_fval(sphi2);
+    IMATH_TrackletCalculator *ITC=scratch_->trackletCalculator(layer_);
+    
+    int ir1=innerFPGAStub->ir();
+    int iphi1=innerFPGAStub->iphi();
+    int iz1=innerFPGAStub->iz();
+      
+    int ir2=outerFPGAStub->ir();
+    int iphi2=outerFPGAStub->iphi();
+    int iz2=outerFPGAStub->iz();
+    
+    if (layer_<4) iphi1<<=(nbitsphistubL456-nbitsphistubL123);
+    if (layer_<3) iphi2<<=(nbitsphistubL456-nbitsphistubL123);
+    if (layer_<4) {
+      ir1<<=(8-nbitsrL123);
+    } else {
+      ir1<<=(8-nbitsrL456);
+    }
+    if (layer_<3) {
+      ir2<<=(8-nbitsrL123);
+    } else {
+      ir2<<=(8-nbitsrL456);
+    }
+    if (layer_>3) iz1<<=(nbitszL123-nbitszL456);
+    if (layer_>2) iz2<<=(nbitszL123-nbitszL456);  
+
+    //In validation mode the approximate values are calculated from the
+    //floating point positions, otherwise from the integer ones.
+    if (settings_->validateTC()) {
+      ITC->r1.set_fval(r1-rmean[layer_-1]);
+      ITC->r2.set_fval(r2-rmean[layer_]);
+      ITC->z1.set_fval(z1);
+      ITC->z2.set_fval(z2);
+      double sphi1 = phi1 - phioffset_;
+      if(sphi1<0) sphi1 += 8*atan(1.);
+      if(sphi1>8*atan(1.)) sphi1 -= 8*atan(1.);
+      double sphi2 = phi2 - phioffset_;
+      if(sphi2<0) sphi2 += 8*atan(1.);
+      if(sphi2>8*atan(1.)) sphi2 -= 8*atan(1.);
+      ITC->phi1.set_fval(sphi1);
+      ITC->phi2.set_fval(sphi2);
+    } else {
+      ITC->r1.set_ival(ir1);
+      ITC->r2.set_ival(ir2);
+      ITC->z1.set_ival(iz1);
+      ITC->z2.set_ival(iz2);
+      ITC->phi1.set_ival(iphi1);
+      ITC->phi2.set_ival(iphi2);
+    }
 
     ITC->rproj0.set_fval(rproj_[0]);
     ITC->rproj1.set_fval(rproj_[1]);
@@ -1590,6 +1626,27 @@ public:
       rderdiskapprox[i]   = ITC->der_rD_final.get_fval();
     }
 
+    if (!settings_->validateTC()) {
+      //Without the exact calculation the approximate values are
+      //also used in place of the exact ones
+      rinv=rinvapprox;
+      phi0=phi0approx;
+      t=tapprox;
+      z0=z0approx;
+      for(int i=0; i<4; ++i){
+	phiproj[i]=phiprojapprox[i];
+	zproj[i]=zprojapprox[i];
+	phider[i]=phiderapprox[i];
+	zder[i]=zderapprox[i];
+      }
+      for(int i=0; i<5; ++i){
+	phiprojdisk[i]=phiprojdiskapprox[i];
+	rprojdisk[i]=rprojdiskapprox[i];
+	phiderdisk[i]=phiderdiskapprox[i];
+	rderdisk[i]=rderdiskapprox[i];
+      }
+    }
+
     //now binary
     
     int irinv,iphi0,it,iz0;
@@ -1600,67 +1657,46 @@ public:
     int iphiprojdisk[5],irprojdisk[5],iphiderdisk[5],irderdisk[5];
     bool minusNeighborDisk[5],plusNeighborDisk[5];
     
-    int ir1=innerFPGAStub->ir();
-    int iphi1=innerFPGAStub->iphi();
-    int iz1=innerFPGAStub->iz();
-      
-    int ir2=outerFPGAStub->ir();
-    int iphi2=outerFPGAStub->iphi();
-    int iz2=outerFPGAStub->iz();
-    
-    if (layer_<4) iphi1<<=(nbitsphistubL456-nbitsphistubL123);
-    if (layer_<3) iphi2<<=(nbitsphistubL456-nbitsphistubL123);
-    if (layer_<4) {
-      ir1<<=(8-nbitsrL123);
-    } else {
-      ir1<<=(8-nbitsrL456);
-    }
-    if (layer_<3) {
-      ir2<<=(8-nbitsrL123);
-    } else {
-      ir2<<=(8-nbitsrL456);
+    if (settings_->validateTC()) {
+      ITC->r1.set_ival(ir1);
+      ITC->r2.set_ival(ir2);
+      ITC->z1.set_ival(iz1);
+      ITC->z2.set_ival(iz2);
+      ITC->phi1.set_ival(iphi1);
+      ITC->phi2.set_ival(iphi2);
+    
+      ITC->rinv_final.calculate();
+      ITC->phi0_final.calculate();
+      ITC->t_final.calculate();
+      ITC->z0_final.calculate();
+
+      ITC->phiL_0_final.calculate();
+      ITC->phiL_1_final.calculate();
+      ITC->phiL_2_final.calculate();
+      ITC->phiL_3_final.calculate();
+
+      ITC->zL_0_final.calculate();
+      ITC->zL_1_final.calculate();
+      ITC->zL_2_final.calculate();
+      ITC->zL_3_final.calculate();
+
+      ITC->phiD_0_final.calculate();
+      ITC->phiD_1_final.calculate();
+      ITC->phiD_2_final.calculate();
+      ITC->phiD_3_final.calculate();
+      ITC->phiD_4_final.calculate();
+
+      ITC->rD_0_final.calculate();
+      ITC->rD_1_final.calculate();
+      ITC->rD_2_final.calculate();
+      ITC->rD_3_final.calculate();
+      ITC->rD_4_final.calculate();
+
+      ITC->der_phiL_final.calculate();
+      ITC->der_zL_final.calculate();
+      ITC->der_phiD_final.calculate();
+      ITC->der_rD_final.calculate();
     }
-    if (layer_>3) iz1<<=(nbitszL123-nbitszL456);
-    if (layer_>2) iz2<<=(nbitszL123-nbitszL456);  
-      
-    ITC->r1.set_ival(ir1);
-    ITC->r2.set_ival(ir2);
-    ITC->z1.set_ival(iz1);
-    ITC->z2.set_ival(iz2);
-    ITC->phi1.set_ival(iphi1);
-    ITC->phi2.set_ival(iphi2);
-    
-    ITC->rinv_final.calculate();
-    ITC->phi0_final.calculate();
-    ITC->t_final.calculate();
-    ITC->z0_final.calculate();
-
-    ITC->phiL_0_final.calculate();
-    ITC->phiL_1_final.calculate();
-    ITC->phiL_2_final.calculate();
-    ITC->phiL_3_final.calculate();
-
-    ITC->zL_0_final.calculate();
-    ITC->zL_1_final.calculate();
-    ITC->zL_2_final.calculate();
-    ITC->zL_3_final.calculate();
-
-    ITC->phiD_0_final.calculate();
-    ITC->phiD_1_final.calculate();
-    ITC->phiD_2_final.calculate();
-    ITC->phiD_3_final.calculate();
-    ITC->phiD_4_final.calculate();
-
-    ITC->rD_0_final.calculate();
-    ITC->rD_1_final.calculate();
-    ITC->rD_2_final.calculate();
-    ITC->rD_3_final.calculate();
-    ITC->rD_4_final.calculate();
-
-    ITC->der_phiL_final.calculate();
-    ITC->der_zL_final.calculate();
-    ITC->der_phiD_final.calculate();
-    ITC->der_rD_final.calculate();
 
     //store the binary results
     irinv = ITC->rinv_final.get_ival();
@@ -1788,13 +1824,12 @@ public:
 
     bool success = true;
     if(!ITC->rinv_final.local_passes()){
-      if (debug1) 
-	cout << "FPGATrackletCalculator::BarrelSeeding irinv too large: "
-	     <<ITC->rinv_final.get_fval()<<"("<<ITC->rinv_final.get_ival()<<")\n";
+      FPGA_DEBUG("FPGATrackletCalculator::BarrelSeeding irinv too large: "
+	     <<ITC->rinv_final.get_fval()<<"("<<ITC->rinv_final.get_ival()<<")");
       success = false;
     }
     if (!ITC->z0_final.local_passes()){
-      if (debug1) cout << "Failed tracklet z0 cut "<<ITC->z0_final.get_fval()<<" in layer "<<layer_<<endl;
+      FPGA_DEBUG("Failed tracklet z0 cut "<<ITC->z0_final.get_fval()<<" in layer "<<layer_);
       success = false;
     }
     success = success && ITC->valid_trackpar.passes();
@@ -1832,7 +1867,7 @@ public:
     
     
     if (writeTrackletPars) {
-      static ofstream out("trackletpars.txt");
+      ofstream& out=debugFile("trackletpars.txt");
       out <<"Trackpars "<<layer_
 	  <<"   "<<rinv<<" "<<rinvapprox<<" "<<ITC->rinv_final.get_fval()
 	  <<"   "<<phi0<<" "<<phi0approx<<" "<<ITC->phi0_final.get_fval()
@@ -1867,10 +1902,8 @@ public:
 					    rderdiskapprox,
 					    false);
     
-    if (debug1) {
-      cout << "FPGATrackletCalculator "<<getName()<<" Found tracklet in layer = "<<layer_<<" "
-	   <<iSector_<<" phi0 = "<<phi0<<endl;
-    }
+    FPGA_DEBUG("FPGATrackletCalculator "<<getName()<<" Found tracklet in layer = "<<layer_<<" "
+	   <<iSector_<<" phi0 = "<<phi0);
         
 
     tracklet->setTrackletIndex(trackletpars_->nTracklets());
@@ -1919,9 +1952,7 @@ public:
   bool diskSeeding(FPGAStub* innerFPGAStub,L1TStub* innerStub,FPGAStub* outerFPGAStub,L1TStub* outerStub){
 
 	    
-    if (debug1) {
-      cout <<  "FPGATrackletCalculator::execute calculate disk seeds" << endl;
-    }
+    FPGA_DEBUG("FPGATrackletCalculator::execute calculate disk seeds");
 	      
     int sign=1;
     if (innerFPGAStub->disk().value()<0) sign=-1;
@@ -1954,22 +1985,28 @@ public:
     double phiproj[3],zproj[3],phider[3],zder[3];
     double phiprojdisk[3],rprojdisk[3],phiderdisk[3],rderdisk[3];
     
-    exacttrackletdisk(r1,z1,phi1,r2,z2,phi2,outerStub->sigmaz(),
-		      rinv,phi0,t,z0,
-		      phiproj,zproj,phider,zder,
-		      phiprojdisk,rprojdisk,phiderdisk,rderdisk);
+    if (settings_->validateTC()) {
+      exacttrackletdisk(r1,z1,phi1,r2,z2,phi2,outerStub->sigmaz(),
+			rinv,phi0,t,z0,
+			phiproj,zproj,phider,zder,
+			phiprojdisk,rprojdisk,phiderdisk,rderdisk);
 
 
-    //Truncates floating point positions to integer
-    //representation precision
-    if (useapprox) {
-      phi1=innerFPGAStub->phiapprox(phimin_,phimax_);
-      z1=innerFPGAStub->zapprox();
-      r1=innerFPGAStub->rapprox();
+      //Truncates floating point positions to integer
+      //representation precision
+      if (useapprox) {
+        phi1=innerFPGAStub->phiapprox(phimin_,phimax_);
+        z1=innerFPGAStub->zapprox();
+        r1=innerFPGAStub->rapprox();
       
-      phi2=outerFPGAStub->phiapprox(phimin_,phimax_);
-      z2=outerFPGAStub->zapprox();
-      r2=outerFPGAStub->rapprox();
+        phi2=outerFPGAStub->phiapprox(phimin_,phimax_);
+        z2=outerFPGAStub->zapprox();
+        r2=outerFPGAStub->rapprox();
+      }
+    } else {
+      //only the sign of t is needed to set up the projections, and
+      //for a disk seed it is the sign of z of the disk stubs
+      t=(z1>0.0)?1.0:-1.0;
     }
     
     double rinvapprox,phi0approx,tapprox,z0approx;
@@ -1977,25 +2014,44 @@ public:
     double phiprojdiskapprox[3],rprojdiskapprox[3],
       phiderdiskapprox[3],rderdiskapprox[3];
 	    
-    IMATH_TrackletCalculatorDisk *ITC;
-    if(disk_==1)       ITC = &ITC_F1F2;
-    else if(disk_==3)  ITC = &ITC_F3F4;
-    else if(disk_==-1) ITC = &ITC_B1B2;
-    else               ITC = &ITC_B3B4;
-    
-    ITC->r1.set_fval(r1);
-    ITC->r2.set_fval(r2);
-    int signt = t>0? 1 : -1;
-    ITC->z1.set_fval(z1-signt*zmean[abs(disk_)-1]);
-    ITC->z2.set_fval(z2-signt*zmean[abs(disk_)]);
-    double sphi1 = phi1 - phioffset_;
-    if(sphi1<0) sphi1 += 8*atan(1.);
-    if(sphi1>8*atan(1.)) sphi1 -= 8*atan(1.);
-    double sphi2 = phi2 - phioffset_;
-    if(sphi2<0) sphi2 += 8*atan(1.);
-    if(sphi2>8*atan(1.)) sphi2 -= 8*atan(1.);
-    ITC->phi1.set_fval(sphi1);
-    ITC->phi2.set_fval(sphi2);
+    IMATH_TrackletCalculatorDisk *ITC=scratch_->trackletCalculatorDisk(disk_);
+    
+    int ir1=innerFPGAStub->ir();
+    int iphi1=innerFPGAStub->iphi();
+    int iz1=innerFPGAStub->iz();
+    
+    int ir2=outerFPGAStub->ir();
+    int iphi2=outerFPGAStub->iphi();
+    int iz2=outerFPGAStub->iz();
+    
+    //To get same precission as for layers.
+    iphi1<<=(nbitsphistubL456-nbitsphistubL123);
+    iphi2<<=(nbitsphistubL456-nbitsphistubL123);
+
+    //In validation mode the approximate values are calculated from the
+    //floating point positions, otherwise from the integer ones.
+    if (settings_->validateTC()) {
+      ITC->r1.set_fval(r1);
+      ITC->r2.set_fval(r2);
+      int signt = t>0? 1 : -1;
+      ITC->z1.set_fval(z1-signt*zmean[abs(disk_)-1]);
+      ITC->z2.set_fval(z2-signt*zmean[abs(disk_)]);
+      double sphi1 = phi1 - phioffset_;
+      if(sphi1<0) sphi1 += 8*atan(1.);
+      if(sphi1>8*atan(1.)) sphi1 -= 8*atan(1.);
+      double sphi2 = phi2 - phioffset_;
+      if(sphi2<0) sphi2 += 8*atan(1.);
+      if(sphi2>8*atan(1.)) sphi2 -= 8*atan(1.);
+      ITC->phi1.set_fval(sphi1);
+      ITC->phi2.set_fval(sphi2);
+    } else {
+      ITC->r1.set_ival(ir1);
+      ITC->r2.set_ival(ir2);
+      ITC->z1.set_ival(iz1);
+      ITC->z2.set_ival(iz2);
+      ITC->phi1.set_ival(iphi1);
+      ITC->phi2.set_ival(iphi2);
+    }
 	    
     ITC->rproj0.set_fval(rmean[0]);
     ITC->rproj1.set_fval(rmean[1]);
@@ -2075,6 +2131,27 @@ public:
       rderdiskapprox[i]   = ITC->der_rD_final.get_fval();
     }
 
+    if (!settings_->validateTC()) {
+      //Without the exact calculation the approximate values are
+      //also used in place of the exact ones
+      rinv=rinvapprox;
+      phi0=phi0approx;
+      t=tapprox;
+      z0=z0approx;
+      for(int i=0; i<3; ++i){
+	phiproj[i]=phiprojapprox[i];
+	zproj[i]=zprojapprox[i];
+	phider[i]=phiderapprox[i];
+	zder[i]=zderapprox[i];
+      }
+      for(int i=0; i<3; ++i){
+	phiprojdisk[i]=phiprojdiskapprox[i];
+	rprojdisk[i]=rprojdiskapprox[i];
+	phiderdisk[i]=phiderdiskapprox[i];
+	rderdisk[i]=rderdiskapprox[i];
+      }
+    }
+
     //now binary
     
     int irinv,iphi0,it,iz0;
@@ -2086,50 +2163,40 @@ public:
     int iphiprojdisk[3],irprojdisk[3],iphiderdisk[3],irderdisk[3];
     bool minusNeighborDisk[3],plusNeighborDisk[3];
 
-    int ir1=innerFPGAStub->ir();
-    int iphi1=innerFPGAStub->iphi();
-    int iz1=innerFPGAStub->iz();
-    
-    int ir2=outerFPGAStub->ir();
-    int iphi2=outerFPGAStub->iphi();
-    int iz2=outerFPGAStub->iz();
-    
-    //To get same precission as for layers.
-    iphi1<<=(nbitsphistubL456-nbitsphistubL123);
-    iphi2<<=(nbitsphistubL456-nbitsphistubL123);
-    
-    ITC->r1.set_ival(ir1);
-    ITC->r2.set_ival(ir2);
-    ITC->z1.set_ival(iz1);
-    ITC->z2.set_ival(iz2);
-    ITC->phi1.set_ival(iphi1);
-    ITC->phi2.set_ival(iphi2);
+    if (settings_->validateTC()) {
+      ITC->r1.set_ival(ir1);
+      ITC->r2.set_ival(ir2);
+      ITC->z1.set_ival(iz1);
+      ITC->z2.set_ival(iz2);
+      ITC->phi1.set_ival(iphi1);
+      ITC->phi2.set_ival(iphi2);
 
-    ITC->rinv_final.calculate();
-    ITC->phi0_final.calculate();
-    ITC->t_final.calculate();
-    ITC->z0_final.calculate();
+      ITC->rinv_final.calculate();
+      ITC->phi0_final.calculate();
+      ITC->t_final.calculate();
+      ITC->z0_final.calculate();
 
-    ITC->phiL_0_final.calculate();
-    ITC->phiL_1_final.calculate();
-    ITC->phiL_2_final.calculate();
+      ITC->phiL_0_final.calculate();
+      ITC->phiL_1_final.calculate();
+      ITC->phiL_2_final.calculate();
 
-    ITC->zL_0_final.calculate();
-    ITC->zL_1_final.calculate();
-    ITC->zL_2_final.calculate();
+      ITC->zL_0_final.calculate();
+      ITC->zL_1_final.calculate();
+      ITC->zL_2_final.calculate();
 
-    ITC->phiD_0_final.calculate();
-    ITC->phiD_1_final.calculate();
-    ITC->phiD_2_final.calculate();
+      ITC->phiD_0_final.calculate();
+      ITC->phiD_1_final.calculate();
+      ITC->phiD_2_final.calculate();
 
-    ITC->rD_0_final.calculate();
-    ITC->rD_1_final.calculate();
-    ITC->rD_2_final.calculate();
+      ITC->rD_0_final.calculate();
+      ITC->rD_1_final.calculate();
+      ITC->rD_2_final.calculate();
 
-    ITC->der_phiL_final.calculate();
-    ITC->der_zL_final.calculate();
-    ITC->der_phiD_final.calculate();
-    ITC->der_rD_final.calculate();
+      ITC->der_phiL_final.calculate();
+      ITC->der_zL_final.calculate();
+      ITC->der_phiD_final.calculate();
+      ITC->der_rD_final.calculate();
+    }
 
     //store the binary results
     irinv = ITC->rinv_final.get_ival();
@@ -2226,12 +2293,11 @@ public:
 
     bool success = true;
     if(!ITC->rinv_final.local_passes()){
-      if (debug1) 
-	cout << "FPGATrackletCalculator::DiskSeeding irinv too large: "<<ITC->rinv_final.get_fval()<<endl;
+      FPGA_DEBUG("FPGATrackletCalculator::DiskSeeding irinv too large: "<<ITC->rinv_final.get_fval());
       success = false;
     }
     if (!ITC->z0_final.local_passes()) {
-      if (debug1) cout << "Failed tracklet z0 cut "<<ITC->z0_final.get_fval()<<" in layer 1"<<endl;
+      FPGA_DEBUG("Failed tracklet z0 cut "<<ITC->z0_final.get_fval()<<" in layer 1");
       success = false;
     }
     success = success && ITC->valid_trackpar.passes();
@@ -2268,7 +2334,7 @@ public:
 	    
     
     if (writeTrackletParsDisk) {
-      static ofstream out("trackletparsdisk.txt");
+      ofstream& out=debugFile("trackletparsdisk.txt");
       out <<"Trackpars         "<<disk_
 	  <<"   "<<rinv<<" "<<rinvapprox<<" "<<ITC->rinv_final.get_fval()
 	  <<"   "<<phi0<<" "<<phi0approx<<" "<<ITC->phi0_final.get_fval()
@@ -2305,10 +2371,8 @@ public:
 					    rderdiskapprox,
 					    true);
     
-    if (debug1) {
-      cout << "Found tracklet in disk = "<<disk_<<" "<<tracklet
-	   <<" "<<iSector_<<endl;
-    }
+    FPGA_DEBUG("Found tracklet in disk = "<<disk_<<" "<<tracklet
+	   <<" "<<iSector_);
         
     tracklet->setTrackletIndex(trackletpars_->nTracklets());
     tracklet->setTCIndex(TCIndex_);
@@ -2343,9 +2407,7 @@ public:
     
     disk_=innerFPGAStub->disk().value();
     
-    if (debug1) {
-      cout << "trying to make overlap tracklet disk_ = "<<disk_<<" "<<getName()<<endl;
-    }
+    FPGA_DEBUG("trying to make overlap tracklet disk_ = "<<disk_<<" "<<getName());
     
     //int sign=1;
     //if (disk_<0) sign=-1;
@@ -2373,22 +2435,27 @@ public:
     double phiproj[3],zproj[3],phider[3],zder[3];
     double phiprojdisk[4],rprojdisk[4],phiderdisk[4],rderdisk[4];
     
-    exacttrackletOverlap(r1,z1,phi1,r2,z2,phi2,outerStub->sigmaz(),
-			 rinv,phi0,t,z0,
-			 phiproj,zproj,phider,zder,
-			 phiprojdisk,rprojdisk,phiderdisk,rderdisk);
+    if (settings_->validateTC()) {
+      exacttrackletOverlap(r1,z1,phi1,r2,z2,phi2,outerStub->sigmaz(),
+			   rinv,phi0,t,z0,
+			   phiproj,zproj,phider,zder,
+			   phiprojdisk,rprojdisk,phiderdisk,rderdisk);
     
     
-    //Truncates floating point positions to integer
-    //representation precision
-    if (useapprox) {
-      phi1=innerFPGAStub->phiapprox(phimin_,phimax_);
-      z1=innerFPGAStub->zapprox();
-      r1=innerFPGAStub->rapprox();
+      //Truncates floating point positions to integer
+      //representation precision
+      if (useapprox) {
+        phi1=innerFPGAStub->phiapprox(phimin_,phimax_);
+        z1=innerFPGAStub->zapprox();
+        r1=innerFPGAStub->rapprox();
 	      
-      phi2=outerFPGAStub->phiapprox(phimin_,phimax_);
-      z2=outerFPGAStub->zapprox();
-      r2=outerFPGAStub->rapprox();
+        phi2=outerFPGAStub->phiapprox(phimin_,phimax_);
+        z2=outerFPGAStub->zapprox();
+        r2=outerFPGAStub->rapprox();
+      }
+    } else {
+      //only the sign of t is needed to set up the projections
+      t=(z1-z2)/(r1-r2);
     }
 
     double rinvapprox,phi0approx,tapprox,z0approx;
@@ -2397,27 +2464,46 @@ public:
       phiderdiskapprox[4],rderdiskapprox[4];
     
 
-    IMATH_TrackletCalculatorOverlap *ITC;
     int ll = outerFPGAStub->layer().value()+1;
-    if     (ll==1 && disk_==1)  ITC = &ITC_L1F1;
-    else if(ll==2 && disk_==1)  ITC = &ITC_L2F1;
-    else if(ll==1 && disk_==-1) ITC = &ITC_L1B1;
-    else if(ll==2 && disk_==-1) ITC = &ITC_L2B1;
-    else assert(0);
-    
-    ITC->r1.set_fval(r2-rmean[ll-1]);
-    ITC->r2.set_fval(r1);
-    int signt = t>0? 1 : -1;
-    ITC->z1.set_fval(z2);
-    ITC->z2.set_fval(z1-signt*zmean[abs(disk_)-1]);
-    double sphi1 = phi1 - phioffset_;
-    if(sphi1<0) sphi1 += 8*atan(1.);
-    if(sphi1>8*atan(1.)) sphi1 -= 8*atan(1.);
-    double sphi2 = phi2 - phioffset_;
-    if(sphi2<0) sphi2 += 8*atan(1.);
-    if(sphi2>8*atan(1.)) sphi2 -= 8*atan(1.);
-    ITC->phi1.set_fval(sphi2);
-    ITC->phi2.set_fval(sphi1);
+    IMATH_TrackletCalculatorOverlap *ITC=scratch_->trackletCalculatorOverlap(ll,disk_);
+    
+    int ir2=innerFPGAStub->ir();
+    int iphi2=innerFPGAStub->iphi();
+    int iz2=innerFPGAStub->iz();
+      
+    int ir1=outerFPGAStub->ir();
+    int iphi1=outerFPGAStub->iphi();
+    int iz1=outerFPGAStub->iz();
+      
+    //To get global precission
+    ir1<<=(8-nbitsrL123);
+    iphi1<<=(nbitsphistubL456-nbitsphistubL123);
+    iphi2<<=(nbitsphistubL456-nbitsphistubL123);
+
+    //In validation mode the approximate values are calculated from the
+    //floating point positions, otherwise from the integer ones.
+    if (settings_->validateTC()) {
+      ITC->r1.set_fval(r2-rmean[ll-1]);
+      ITC->r2.set_fval(r1);
+      int signt = t>0? 1 : -1;
+      ITC->z1.set_fval(z2);
+      ITC->z2.set_fval(z1-signt*zmean[abs(disk_)-1]);
+      double sphi1 = phi1 - phioffset_;
+      if(sphi1<0) sphi1 += 8*atan(1.);
+      if(sphi1>8*atan(1.)) sphi1 -= 8*atan(1.);
+      double sphi2 = phi2 - phioffset_;
+      if(sphi2<0) sphi2 += 8*atan(1.);
+      if(sphi2>8*atan(1.)) sphi2 -= 8*atan(1.);
+      ITC->phi1.set_fval(sphi2);
+      ITC->phi2.set_fval(sphi1);
+    } else {
+      ITC->r1.set_ival(ir1);
+      ITC->r2.set_ival(ir2);
+      ITC->z1.set_ival(iz1);
+      ITC->z2.set_ival(iz2);
+      ITC->phi1.set_ival(iphi1);
+      ITC->phi2.set_ival(iphi2);
+    }
 
     ITC->rproj0.set_fval(rmean[0]);
     ITC->rproj1.set_fval(rmean[1]);
@@ -2490,6 +2576,27 @@ public:
       rderdiskapprox[i]   = ITC->der_rD_final.get_fval();
     }
 
+    if (!settings_->validateTC()) {
+      //Without the exact calculation the approximate values are
+      //also used in place of the exact ones
+      rinv=rinvapprox;
+      phi0=phi0approx;
+      t=tapprox;
+      z0=z0approx;
+      for(int i=0; i<3; ++i){
+	phiproj[i]=phiprojapprox[i];
+	zproj[i]=zprojapprox[i];
+	phider[i]=phiderapprox[i];
+	zder[i]=zderapprox[i];
+      }
+      for(int i=0; i<4; ++i){
+	phiprojdisk[i]=phiprojdiskapprox[i];
+	rprojdisk[i]=rprojdiskapprox[i];
+	phiderdisk[i]=phiderdiskapprox[i];
+	rderdisk[i]=rderdiskapprox[i];
+      }
+    }
+
     //now binary
 
     int irinv,iphi0,it,iz0;
@@ -2501,53 +2608,42 @@ public:
     int iphiprojdisk[4],irprojdisk[4],iphiderdisk[4],irderdisk[4];
     bool minusNeighborDisk[4],plusNeighborDisk[4];
     
-    int ir2=innerFPGAStub->ir();
-    int iphi2=innerFPGAStub->iphi();
-    int iz2=innerFPGAStub->iz();
+    if (settings_->validateTC()) {
+      ITC->r1.set_ival(ir1);
+      ITC->r2.set_ival(ir2);
+      ITC->z1.set_ival(iz1);
+      ITC->z2.set_ival(iz2);
+      ITC->phi1.set_ival(iphi1);
+      ITC->phi2.set_ival(iphi2);
       
-    int ir1=outerFPGAStub->ir();
-    int iphi1=outerFPGAStub->iphi();
-    int iz1=outerFPGAStub->iz();
-      
-    //To get global precission
-    ir1<<=(8-nbitsrL123);
-    iphi1<<=(nbitsphistubL456-nbitsphistubL123);
-    iphi2<<=(nbitsphistubL456-nbitsphistubL123);
+      ITC->rinv_final.calculate();
+      ITC->phi0_final.calculate();
+      ITC->t_final.calculate();
+      ITC->z0_final.calculate();
 
-    ITC->r1.set_ival(ir1);
-    ITC->r2.set_ival(ir2);
-    ITC->z1.set_ival(iz1);
-    ITC->z2.set_ival(iz2);
-    ITC->phi1.set_ival(iphi1);
-    ITC->phi2.set_ival(iphi2);
-      
-    ITC->rinv_final.calculate();
-    ITC->phi0_final.calculate();
-    ITC->t_final.calculate();
-    ITC->z0_final.calculate();
+      ITC->phiL_0_final.calculate();
+      ITC->phiL_1_final.calculate();
+      ITC->phiL_2_final.calculate();
 
-    ITC->phiL_0_final.calculate();
-    ITC->phiL_1_final.calculate();
-    ITC->phiL_2_final.calculate();
+      ITC->zL_0_final.calculate();
+      ITC->zL_1_final.calculate();
+      ITC->zL_2_final.calculate();
 
-    ITC->zL_0_final.calculate();
-    ITC->zL_1_final.calculate();
-    ITC->zL_2_final.calculate();
+      ITC->phiD_0_final.calculate();
+      ITC->phiD_1_final.calculate();
+      ITC->phiD_2_final.calculate();
+      ITC->phiD_3_final.calculate();
 
-    ITC->phiD_0_final.calculate();
-    ITC->phiD_1_final.calculate();
-    ITC->phiD_2_final.calculate();
-    ITC->phiD_3_final.calculate();
-
-    ITC->rD_0_final.calculate();
-    ITC->rD_1_final.calculate();
-    ITC->rD_2_final.calculate();
-    ITC->rD_3_final.calculate();
+      ITC->rD_0_final.calculate();
+      ITC->rD_1_final.calculate();
+      ITC->rD_2_final.calculate();
+      ITC->rD_3_final.calculate();
 
-    ITC->der_phiL_final.calculate();
-    ITC->der_zL_final.calculate();
-    ITC->der_phiD_final.calculate();
-    ITC->der_rD_final.calculate();
+      ITC->der_phiL_final.calculate();
+      ITC->der_zL_final.calculate();
+      ITC->der_phiD_final.calculate();
+      ITC->der_rD_final.calculate();
+    }
 
     //store the binary results
     irinv = ITC->rinv_final.get_ival();
@@ -2653,36 +2749,27 @@ public:
 
     bool success = true;
     if(!ITC->t_final.local_passes()) {
-      if (debug1) {
-	cout << "FPGATrackletCalculator::OverlapSeeding t too large: "<<ITC->t_final.get_fval()<<endl;
-      }
+      FPGA_DEBUG("FPGATrackletCalculator::OverlapSeeding t too large: "<<ITC->t_final.get_fval());
       success = false;
     }
     if(!ITC->rinv_final.local_passes()){
-      if (debug1) {
-	cout << "FPGATrackletCalculator::OverlapSeeding irinv too large: "<<ITC->rinv_final.get_fval()<<endl;
-      }
+      FPGA_DEBUG("FPGATrackletCalculator::OverlapSeeding irinv too large: "<<ITC->rinv_final.get_fval());
       success = false;
     }
     if (!ITC->z0_final.local_passes()) {
-      if (debug1) {
-	cout << "Failed tracklet z0 cut "<<ITC->z0_final.get_fval()<<" in layer 1"<<endl;
-      }
+      FPGA_DEBUG("Failed tracklet z0 cut "<<ITC->z0_final.get_fval()<<" in layer 1");
       success = false;
     }
 
     success = success && ITC->valid_trackpar.passes();
 
     if (!success) {
-      if (debug1) {
-	
-	cout << "FPGATrackletCalculator::OverlapSeeding rejected no success: "
+      FPGA_DEBUG("FPGATrackletCalculator::OverlapSeeding rejected no success: "
 	     <<ITC->valid_trackpar.passes()<<" rinv="
 	     <<ITC->rinv_final.get_ival()*ITC->rinv_final.get_K()<<" eta="
 	     <<asinh(ITC->t_final.get_ival()*ITC->t_final.get_K())<<" z0="
 	     <<ITC->z0_final.get_ival()*ITC->z0_final.get_K()<<" phi0="
-	     <<ITC->phi0_final.get_ival()*ITC->phi0_final.get_K()<<endl;
-      }
+	     <<ITC->phi0_final.get_ival()*ITC->phi0_final.get_K());
       return false;
     }
 
@@ -2690,9 +2777,7 @@ public:
       double phicrit=phi0approx-asin(0.5*rcrit*rinvapprox);
       bool keep=(phicrit>phicritminmc)&&(phicrit<phicritmaxmc);
       if (!keep) {
-	if (debug1) {
-	  cout << "FPGATrackletCalculator::OverlapSeeding fail phicrit "<<endl;
-	}
+	FPGA_DEBUG("FPGATrackletCalculator::OverlapSeeding fail phicrit ");
 	return false;
       }
     }
@@ -2722,7 +2807,7 @@ public:
     
     
     if (writeTrackletParsOverlap) {
-      static ofstream out("trackletparsoverlap.txt");
+      ofstream& out=debugFile("trackletparsoverlap.txt");
       out <<"Trackpars "<<disk_
 	  <<"   "<<rinv<<" "<<irinv<<" "<<ITC->rinv_final.get_fval()
 	  <<"   "<<phi0<<" "<<iphi0<<" "<<ITC->phi0_final.get_fval()
@@ -2761,10 +2846,8 @@ public:
 					    rderdiskapprox,
 					    false,true);
     
-    if (debug1) {
-      cout << "Found tracklet in overlap = "<<layer_<<" "<<disk_
-	   <<" "<<tracklet<<" "<<iSector_<<endl;
-    }
+    FPGA_DEBUG("Found tracklet in overlap = "<<layer_<<" "<<disk_
+	   <<" "<<tracklet<<" "<<iSector_);
     
         
     tracklet->setTrackletIndex(trackletpars_->nTracklets());
@@ -2916,37 +2999,6 @@ private:
   FPGATrackletProjections* trackletproj_D5Plus_; 
   FPGATrackletProjections* trackletproj_D5Minus_;
 
-public:
-  static IMATH_TrackletCalculator ITC_L1L2;
-  static IMATH_TrackletCalculator ITC_L2L3;
-  static IMATH_TrackletCalculator ITC_L3L4;
-  static IMATH_TrackletCalculator ITC_L5L6;
-  
-  static IMATH_TrackletCalculatorDisk ITC_F1F2;
-  static IMATH_TrackletCalculatorDisk ITC_F3F4;
-  static IMATH_TrackletCalculatorDisk ITC_B1B2;
-  static IMATH_TrackletCalculatorDisk ITC_B3B4;
-
-  static IMATH_TrackletCalculatorOverlap ITC_L1F1;
-  static IMATH_TrackletCalculatorOverlap ITC_L2F1;
-  static IMATH_TrackletCalculatorOverlap ITC_L1B1;
-  static IMATH_TrackletCalculatorOverlap ITC_L2B1;
-    
 };
 
-IMATH_TrackletCalculator FPGATrackletCalculator::ITC_L1L2{1,2};
-IMATH_TrackletCalculator FPGATrackletCalculator::ITC_L2L3{2,3};
-IMATH_TrackletCalculator FPGATrackletCalculator::ITC_L3L4{3,4};
-IMATH_TrackletCalculator FPGATrackletCalculator::ITC_L5L6{5,6};
-
-IMATH_TrackletCalculatorDisk FPGATrackletCalculator::ITC_F1F2{1,2};
-IMATH_TrackletCalculatorDisk FPGATrackletCalculator::ITC_F3F4{3,4};
-IMATH_TrackletCalculatorDisk FPGATrackletCalculator::ITC_B1B2{-1,-2};
-IMATH_TrackletCalculatorDisk FPGATrackletCalculator::ITC_B3B4{-3,-4};
-
-IMATH_TrackletCalculatorOverlap FPGATrackletCalculator::ITC_L1F1{1,1};
-IMATH_TrackletCalculatorOverlap FPGATrackletCalculator::ITC_L2F1{2,1};
-IMATH_TrackletCalculatorOverlap FPGATrackletCalculator::ITC_L1B1{1,-1};
-IMATH_TrackletCalculatorOverlap FPGATrackletCalculator::ITC_L2B1{2,-1};
-
 #endif
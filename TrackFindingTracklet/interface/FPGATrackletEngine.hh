@@ -11,8 +11,8 @@ class FPGATrackletEngine:public FPGAProcessBase{
 
 public:
 
-  FPGATrackletEngine(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGATrackletEngine(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
     double dphi=two_pi/NSector;
     phimin_=iSector*dphi;
     phimax_=phimin_+dphi;
@@ -127,6 +127,7 @@ public:
 
     unsigned int countall=0;
     unsigned int countpass=0;
+    unsigned int countdropped=0; //pairs not tried because of the maxTE limit
 
     //cout << "In "<<getName()<<endl;
     
@@ -137,7 +138,7 @@ public:
       for(unsigned int i=0;i<innervmstubs_->nStubs();i++){
 	std::pair<FPGAStub*,L1TStub*> innerstub=innervmstubs_->getStub(i);
 
-	if (debug1) cout << getName()<<" have overlap stub in layer = "<<innerstub.first->layer().value()+1<<endl;
+	FPGA_DEBUG(getName()<<" have overlap stub in layer = "<<innerstub.first->layer().value()+1);
 	
 	int lookupbits=innerstub.first->getVMBitsOverlap().value();
         int rdiffmax=(lookupbits>>7);	
@@ -153,19 +154,20 @@ public:
 	  last=start;
 	}
 	for(int ibin=start;ibin<=last;ibin++) {
-	  if (debug1) cout << getName() << " looking for matching stub in bin "<<ibin
-			   <<" with "<<outervmstubs_->nStubsBinned(ibin)<<" stubs"<<endl;
+	  FPGA_DEBUG(getName() << " looking for matching stub in bin "<<ibin
+			   <<" with "<<outervmstubs_->nStubsBinned(ibin)<<" stubs");
 	  for(unsigned int j=0;j<outervmstubs_->nStubsBinned(ibin);j++){
-	    if (countall>=MAXTE) break;
+	    if (countall>=settings_->maxTE()) {
+	      countdropped+=outervmstubs_->nStubsBinned(ibin)-j;
+	      break;
+	    }
 	    countall++;
 	    std::pair<FPGAStub*,L1TStub*> outerstub=outervmstubs_->getStubBinned(ibin,j);
 	    int rbin=(outerstub.first->getVMBitsOverlap().value()&7);
 	    if (start!=ibin) rbin+=8;
 	    if ((rbin<rbinfirst)||(rbin-rbinfirst>rdiffmax)) {
-	      if (debug1) {
-		cout << getName() << " layer-disk stub pair rejected because rbin cut : "
-		     <<rbin<<" "<<rbinfirst<<" "<<rdiffmax<<endl;
-	      }
+	      FPGA_DEBUG(getName() << " layer-disk stub pair rejected because rbin cut : "
+		     <<rbin<<" "<<rbinfirst<<" "<<rdiffmax);
 	      continue;
 	    }
 
@@ -191,9 +193,7 @@ public:
 	    
 	      
 	    if (!phitable_[index]) {
-	      if (debug1) {
-		cout << "Stub pair rejected because of tracklet pt cut"<<endl;
-	      }
+	      FPGA_DEBUG("Stub pair rejected because of tracklet pt cut");
 	      continue;
 	    }
 		
@@ -204,17 +204,14 @@ public:
 	    int ptouterindex=(index<<outerbend.nbits())+outerbend.value();
 	    
 	    if (!(pttableinner_[ptinnerindex]&&pttableouter_[ptouterindex])) {
-	      if (debug1) {
-		cout << "Stub pair rejected because of stub pt cut bends : "
+	      FPGA_DEBUG("Stub pair rejected because of stub pt cut bends : "
 		     <<FPGAStub::benddecode(innerstub.first->bend().value(),innerstub.first->isPSmodule())
 		     <<" "
-		     <<FPGAStub::benddecode(outerstub.first->bend().value(),outerstub.first->isPSmodule())
-		     <<endl;
-	      }		
+		     <<FPGAStub::benddecode(outerstub.first->bend().value(),outerstub.first->isPSmodule()));
 	      continue;
 	    }
 	    
-	    if (debug1) cout << "Adding layer-disk pair in " <<getName()<<endl;
+	    FPGA_DEBUG("Adding layer-disk pair in " <<getName());
 	    stubpairs_->addStubPair(innerstub,outerstub);
 	    countpass++;
 	  }
@@ -226,7 +223,7 @@ public:
       for(unsigned int i=0;i<outervmstubs_->nStubs();i++){
 	std::pair<FPGAStub*,L1TStub*> outerstub=outervmstubs_->getStub(i);
 
-	if (debug1) cout << "Have overlap stub in layer = "<<outerstub.first->layer().value()+1<<" disk = "<<outerstub.first->disk().value()<<endl;
+	FPGA_DEBUG("Have overlap stub in layer = "<<outerstub.first->layer().value()+1<<" disk = "<<outerstub.first->disk().value());
 	
 	int lookupbits=outerstub.first->getVMBitsOverlap().value();
         int rdiffmax=(lookupbits>>7);	
@@ -244,7 +241,10 @@ public:
 	for(int ibin=start;ibin<=last;ibin++) {
 
 	  for(unsigned int j=0;j<innervmstubs_->nStubsBinned(ibin);j++){
-	    if (countall>=MAXTE) break;
+	    if (countall>=settings_->maxTE()) {
+	      countdropped+=innervmstubs_->nStubsBinned(ibin)-j;
+	      break;
+	    }
 	    countall++;
 	    std::pair<FPGAStub*,L1TStub*> innerstub=innervmstubs_->getStubBinned(ibin,j);
 	    int rbin=(innerstub.first->getVMBits().value()&7);
@@ -263,9 +263,7 @@ public:
       
       for(unsigned int i=0;i<innervmstubs_->nStubs();i++){
 	std::pair<FPGAStub*,L1TStub*> innerstub=innervmstubs_->getStub(i);
-	if (debug1) {
-	  cout << "In "<<getName()<<" have inner stub"<<endl;
-	}
+	FPGA_DEBUG("In "<<getName()<<" have inner stub");
 	
 	if ((layer1_==1 && layer2_==2)||
 	    (layer1_==2 && layer2_==3)||
@@ -284,16 +282,15 @@ public:
 	
 	  int start=(bin>>1);
 	  int last=start+(bin&1);
-	  if (debug1) {
-	    cout << "Will look in zbins "<<start<<" to "<<last<<endl;
-	  }
+	  FPGA_DEBUG("Will look in zbins "<<start<<" to "<<last);
 	  for(int ibin=start;ibin<=last;ibin++) {
 	    for(unsigned int j=0;j<outervmstubs_->nStubsBinned(ibin);j++){
-	      if (debug1) {
-		cout << "In "<<getName()<<" have outer stub"<<endl;
-	      }
+	      FPGA_DEBUG("In "<<getName()<<" have outer stub");
 
-	      if (countall>=MAXTE) break;
+	      if (countall>=settings_->maxTE()) {
+	        countdropped+=outervmstubs_->nStubsBinned(ibin)-j;
+	        break;
+	      }
 	      countall++;
 	      std::pair<FPGAStub*,L1TStub*> outerstub=outervmstubs_->getStubBinned(ibin,j);
               
@@ -303,9 +300,7 @@ public:
 	      }
 	      if (start!=ibin) zbin+=8;
 	      if (zbin<zbinfirst||zbin-zbinfirst>zdiffmax) {
-		if (debug1) {
-		  cout << "Stubpair rejected because of wrong fine z"<<endl;
-		}
+		FPGA_DEBUG("Stubpair rejected because of wrong fine z");
 		continue;
 	      }
 
@@ -340,9 +335,7 @@ public:
 	      //cout << "Stubpair layer rinv/rinvmax : "<<layer1_<<" "<<trinv/0.0057<<" "<<phitable_[index]<<endl;
 	      
 	      if (!phitable_[index]) {
-		if (debug1) {
-		  cout << "Stub pair rejected because of tracklet pt cut"<<endl;
-		}
+		FPGA_DEBUG("Stub pair rejected because of tracklet pt cut");
 		continue;
 	      }
 		
@@ -359,17 +352,14 @@ public:
 
 	      
 	      if (!(pttableinner_[ptinnerindex]&&pttableouter_[ptouterindex])) {
-		if (debug1) {
-		  cout << "Stub pair rejected because of stub pt cut bends : "
+		FPGA_DEBUG("Stub pair rejected because of stub pt cut bends : "
 		       <<FPGAStub::benddecode(innerstub.first->bend().value(),innerstub.first->isPSmodule())
 		       <<" "
-		       <<FPGAStub::benddecode(outerstub.first->bend().value(),outerstub.first->isPSmodule())
-		       <<endl;
-		}		
+		       <<FPGAStub::benddecode(outerstub.first->bend().value(),outerstub.first->isPSmodule()));
 		continue;
 	      }
 	      		
-	      if (debug1) cout << "Adding layer-layer pair in " <<getName()<<endl;
+	      FPGA_DEBUG("Adding layer-layer pair in " <<getName());
 	      stubpairs_->addStubPair(innerstub,outerstub);
 
 	      countpass++;
@@ -379,7 +369,7 @@ public:
 	} else if ((disk1_==1 && disk2_==2)||
 		   (disk1_==3 && disk2_==4)) {
 	  
-	  if (debug1) cout << getName()<<"["<<iSector_<<"] Disk-disk pair" <<endl;
+	  FPGA_DEBUG(getName()<<"["<<iSector_<<"] Disk-disk pair");
 	  
 	  int lookupbits=innerstub.first->getVMBits().value();
 	  bool negdisk=innerstub.first->disk().value()<0;
@@ -393,10 +383,13 @@ public:
 	  if (negdisk) start+=4;
 	  int last=start+(bin&1);
 	  for(int ibin=start;ibin<=last;ibin++) {
-	    if (debug1) cout << getName() << " looking for matching stub in bin "<<ibin
-			     <<" with "<<outervmstubs_->nStubsBinned(ibin)<<" stubs"<<endl;
+	    FPGA_DEBUG(getName() << " looking for matching stub in bin "<<ibin
+			     <<" with "<<outervmstubs_->nStubsBinned(ibin)<<" stubs");
 	    for(unsigned int j=0;j<outervmstubs_->nStubsBinned(ibin);j++){
-	      if (countall>=MAXTE) break;
+	      if (countall>=settings_->maxTE()) {
+	        countdropped+=outervmstubs_->nStubsBinned(ibin)-j;
+	        break;
+	      }
 	      countall++;
 	      std::pair<FPGAStub*,L1TStub*> outerstub=outervmstubs_->getStubBinned(ibin,j);
 	      int rbin=(outerstub.first->getVMBits().value()&7);
@@ -433,9 +426,7 @@ public:
 	      
 	      assert(index<phitable_.size());		
 	      if (!phitable_[index]) {
-		if (debug1) {
-		  cout << "Stub pair rejected because of tracklet pt cut"<<endl;
-		}
+		FPGA_DEBUG("Stub pair rejected because of tracklet pt cut");
 		continue;
 	      }
 		
@@ -449,19 +440,16 @@ public:
 	      assert(ptouterindex<pttableouter_.size());
 	      
 	      if (!(pttableinner_[ptinnerindex]&&pttableouter_[ptouterindex])) {
-		if (debug1) {
-		  cout << "Stub pair rejected because of stub pt cut bends : "
+		FPGA_DEBUG("Stub pair rejected because of stub pt cut bends : "
 		       <<FPGAStub::benddecode(innerstub.first->bend().value(),innerstub.first->isPSmodule())
 		       <<" "
 		       <<FPGAStub::benddecode(outerstub.first->bend().value(),outerstub.first->isPSmodule())
 		       <<" FP bend: "<<innerstub.second->bend()<<" "<<outerstub.second->bend()
-		       <<" pass : "<<pttableinner_[ptinnerindex]<<" "<<pttableouter_[ptouterindex]
-		       <<endl;
-		}
+		       <<" pass : "<<pttableinner_[ptinnerindex]<<" "<<pttableouter_[ptouterindex]);
 		continue;
 	      }
 
-	      if (debug1) cout << "Adding disk-disk pair in " <<getName()<<endl;
+	      FPGA_DEBUG("Adding disk-disk pair in " <<getName());
 	      
 	      stubpairs_->addStubPair(innerstub,outerstub);
 	      countpass++;
@@ -498,8 +486,10 @@ public:
       
     }
       
+    countIterations(countall,countdropped);
+
     if (writeTE) {
-      static ofstream out("trackletengine.txt");
+      ofstream& out=debugFile("trackletengine.txt");
       out << getName()<<" "<<countall<<" "<<countpass<<endl;
     }
 
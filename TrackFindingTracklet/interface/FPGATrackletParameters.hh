@@ -12,9 +12,9 @@ class FPGATrackletParameters:public FPGAMemoryBase{
 
 public:
 
-  FPGATrackletParameters(string name, unsigned int iSector, 
+  FPGATrackletParameters(string name, const FPGASettings* settings, unsigned int iSector, 
 			 double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
   }
@@ -29,11 +29,11 @@ public:
   }
 
   unsigned int nTracklets() const {return tracklets_.size();}
+  unsigned int nEntries() const {return nTracklets();}
 
   FPGATracklet* getFPGATracklet(unsigned int i) const {return tracklets_[i];}
 
-  void writeMatches(int &matchesL1,int &matchesL3,int &matchesL5) {
-    static ofstream out("nmatches.txt");
+  void writeMatches(ofstream& out,int &matchesL1,int &matchesL3,int &matchesL5) {
     for(unsigned int i=0;i<tracklets_.size();i++){
       if ((tracklets_[i]->nMatches()+tracklets_[i]->nMatchesDisk())>0) {
 	if (tracklets_[i]->layer()==1) matchesL1++;
@@ -11,9 +11,9 @@ class FPGATrackletProjections:public FPGAMemoryBase{
 
 public:
 
-  FPGATrackletProjections(string name, unsigned int iSector, 
+  FPGATrackletProjections(string name, const FPGASettings* settings, unsigned int iSector, 
 			  double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
 
@@ -84,6 +84,7 @@ public:
   }
 
   unsigned int nTracklets() const {return tracklets_.size();}
+  unsigned int nEntries() const {return nTracklets();}
 
   FPGATracklet* getFPGATracklet(unsigned int i) const {return tracklets_[i];}
 
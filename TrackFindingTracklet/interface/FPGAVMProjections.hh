@@ -11,9 +11,9 @@ class FPGAVMProjections:public FPGAMemoryBase{
 
 public:
 
-  FPGAVMProjections(string name, unsigned int iSector, 
+  FPGAVMProjections(string name, const FPGASettings* settings, unsigned int iSector, 
 		    double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
     string subname=name.substr(12,2);
@@ -51,6 +51,7 @@ public:
   }
 
   unsigned int nTracklets() const {return tracklets_.size();}
+  unsigned int nEntries() const {return nTracklets();}
 
   FPGATracklet* getFPGATracklet(unsigned int i) const {return tracklets_[i].first;}
 
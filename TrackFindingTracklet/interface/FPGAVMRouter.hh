@@ -3,11 +3,7 @@
 #define FPGAVMROUTER_H
 
 #include "FPGAProcessBase.hh"
-#include "FPGATETableOuter.hh"
-#include "FPGATETableInner.hh"
-#include "FPGATETableOuterDisk.hh"
-#include "FPGATETableInnerDisk.hh"
-#include "FPGATETableInnerOverlap.hh"
+#include "FPGAContext.hh"
 
 using namespace std;
 
@@ -15,8 +11,11 @@ class FPGAVMRouter:public FPGAProcessBase{
 
 public:
 
-  FPGAVMRouter(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAVMRouter(string name, const FPGASettings* settings, unsigned int iSector,
+               const FPGAContext* context):
+    FPGAProcessBase(name,settings,iSector){
+
+    context_=context;
 
     layer_=0;
     disk_=0;
@@ -83,6 +82,8 @@ public:
 	}
       }
     }
+
+    fillRoutingTables();
   }
    
   void addOutput(FPGAMemoryBase* memory,string output){
@@ -194,392 +195,359 @@ public:
   }
 
 
+  //Routes the stubs from the input links to the AllStubs, TE and ME
+  //memories in a single pass. The truncation is the same as for the
+  //previous separate passes: the AllStubs memories take the first
+  //maxVMRouter+1 stubs, the TE memories for layers and the ME memories
+  //the first maxVMRouter stubs, and the TE memories for disks all stubs.
   void execute(){
 
     assert(allstubs_.size()!=0);
 
+    bool doTE=(disk_!=5);
+    bool doTEOverlap=(layer_==1||layer_==2||disk_==1);
+
+    if (doTE||doTEOverlap) {
+      assert(stubinputs_.size()!=0);
+    }
+
+    unsigned int maxVMRouter=settings_->maxVMRouter();
+
     unsigned int count=0;
+    unsigned int ntot=0;
     for(unsigned int j=0;j<stubinputs_.size();j++){
       for(unsigned int i=0;i<stubinputs_[j]->nStubs();i++){
-	if (count>MAXVMROUTER) continue;
 	std::pair<FPGAStub*,L1TStub*> stub=stubinputs_[j]->getStub(i);
-	
-	stub.first->setAllStubIndex(count);
-	stub.second->setAllStubIndex(count);
 
-	stub.first->setAllStubAddressTE(count);
+	if (ntot<=maxVMRouter) {
+	  stub.first->setAllStubIndex(count);
+	  stub.second->setAllStubIndex(count);
+
+	  stub.first->setAllStubAddressTE(count);
 
-	for (unsigned int l=0;l<allstubs_.size();l++){
-	  allstubs_[l]->addStub(stub);
+	  for (unsigned int l=0;l<allstubs_.size();l++){
+	    allstubs_[l]->addStub(stub);
+	  }
+
+	  count++;
 	}
-	
-	count++;
+
+	bool truncated=(ntot>=maxVMRouter);
+	ntot++;
+
+	if (doTE) routeTE(stub,false,truncated);
+	if (doTEOverlap) routeTE(stub,true,truncated);
+	if (!truncated) routeME(stub,stubinputs_[j]);
       }
-    }	
+    }
+
+    countIterations(count,ntot>count?ntot-count:0);
 
 
     if (writeAllStubs) {
-      static ofstream out("allstubs.txt");
+      ofstream& out=debugFile("allstubs.txt");
       out<<allstubs_[0]->getName()<<" "<<allstubs_[0]->nStubs()<<endl;
     }
 
-    
-    if (disk_!=5) {
-      executeTE(false);
+    if ((doTE||doTEOverlap)&&writeVMOccupancyTE) {
+      for (unsigned int n=0;n<(doTE&&doTEOverlap?2:1);n++) {
+	writeVMOccupancyTEFile();
+      }
     }
-    if (layer_==1||layer_==2||disk_==1) {
-      executeTE(true);
+
+    if (stubinputs_.size()!=0&&writeVMOccupancyME) {
+      ofstream& out=debugFile("vmoccupancyme.txt");
+
+      for (int i=0;i<24;i++) {
+	if (vmstubsMEPHI_[i].size()!=0) {
+	  out<<vmstubsMEPHI_[i][0]->getName()<<" "<<vmstubsMEPHI_[i][0]->nStubs();
+	  for (unsigned int ibin=0;ibin<MEBinsDisks*2;ibin++){
+	    out <<" "<<vmstubsMEPHI_[i][0]->nStubsBin(ibin);
+	  }
+	  out<<endl;
+	}
+      }
+
     }
-    executeME();
   }
 
 
-  
-  
-  void executeTE(bool overlap){
+private:
 
-    
-    //cout << "In FPGAVMRouterTE"<<endl;
-    
-    assert(stubinputs_.size()!=0);
+  void writeVMOccupancyTEFile(){
+    ofstream& out=debugFile("vmoccupancyte.txt");
 
-    unsigned int count=0;
+    for (int i=0;i<24;i++) {
+      if (vmstubsTEPHI_[i].size()!=0) {
+	out<<vmstubsTEPHI_[i][0]->getName()<<" "<<vmstubsTEPHI_[i][0]->nStubs()<<endl;
+      }
+    }
+  }
 
- 
-    if (layer_!=0){  //First handle layer stubs
+  //Fills the tables that map the raw VM phi bin of a stub to the index
+  //of the TE (normal, extra and overlap) and ME memories
+  void fillRoutingTables(){
 
-      for(unsigned int j=0;j<stubinputs_.size();j++){
-	for(unsigned int i=0;i<stubinputs_[j]->nStubs();i++){
-	  count++;
-	  if (count>MAXVMROUTER) continue;
-	  std::pair<FPGAStub*,L1TStub*> stub=stubinputs_[j]->getStub(i);
+    int nvmte=0;
+    int nvmteextra=0;
+    int nvmteoverlap=0;
+    int nvmme=0;
+
+    if (layer_!=0) {
+      nvmte=nallstubslayers[layer_-1]*nvmtelayers[layer_-1];
+      if (layer_==2||layer_==3) {
+	nvmteextra=nallstubslayers[layer_-1]*nvmteextralayers[layer_-1];
+      }
+      if (layer_==1||layer_==2) {
+	nvmteoverlap=nallstubsoverlaplayers[layer_-1]*nvmteoverlaplayers[layer_-1];
+      }
+      nvmme=nallstubslayers[layer_-1]*nvmmelayers[layer_-1];
+    }
+    if (disk_!=0) {
+      nvmte=nallstubsdisks[disk_-1]*nvmtedisks[disk_-1];
+      if (disk_==1) {
+	nvmteoverlap=nallstubsoverlapdisks[0]*nvmteoverlapdisks[0];
+      }
+      nvmme=nallstubsdisks[disk_-1]*nvmmedisks[disk_-1];
+    }
+    assert(nvmte>0&&nvmte<=32);
+    assert(nvmme>0&&nvmme<=32);
+
+    for (int iphiRaw=0;iphiRaw<32;iphiRaw++) {
+      teBin_[iphiRaw]=iphiRaw/(32/nvmte);
+      teExtraBin_[iphiRaw]=nvmteextra>0?iphiRaw/(32/nvmteextra):-1;
+      teOverlapBin_[iphiRaw]=nvmteoverlap>0?iphiRaw/(32/nvmteoverlap):-1;
+      int bin=0;
+      if (hourglass) {
+	bin=iphiRaw/(32/nvmme);
+	if (bin>=nvmme) bin=nvmme-1;
+      } else {
+	bin=(iphiRaw-4)>>1;
+	if (bin<0) bin=0;
+	if (bin>11) bin=11;
+      }
+      meBin_[iphiRaw]=bin;
+    }
 
+  }
 
-	  int iphiRaw=stub.first->iphivmRaw();
+  void routeTE(std::pair<FPGAStub*,L1TStub*> stub, bool overlap, bool truncated){
 
-	  bool insert=false;
+    if (layer_!=0){  //First handle layer stubs
 
+      if (truncated) return;
+
+      int iphiRaw=stub.first->iphivmRaw();
+
+      bool insert=false;
+
+
+      int binlookup=-1;
+      int binlookupextra=-1;
+      if (overlap) {
+	assert(layer_==1||layer_==2);
+	binlookup=lookupInnerOverlapLayer(stub.first);
+      } else {
+	switch (layer_) {
+	case 2 : binlookup=lookupOuterLayer(stub.first);
+	  binlookupextra=lookupInnerLayer(stub.first);
+	  break;
+	case 4 : binlookup=lookupOuterLayer(stub.first);
+	  break;
+	case 6 : binlookup=lookupOuterLayer(stub.first);
+	  break;
+	case 1 : binlookup=lookupInnerLayer(stub.first);
+	  break;
+	case 3 : binlookup=lookupInnerLayer(stub.first);
+	  binlookupextra=lookupOuterLayer(stub.first);
+	  break;
+	case 5 : binlookup=lookupInnerLayer(stub.first);
+	  break;
+	default : assert(0);
+	}
+      }
+      if ((layer_==2 or layer_==3) && binlookupextra!=-1) {
+	stub.first->setVMBitsExtra(binlookupextra);
+      }
 
-	  int binlookup=-1;
-	  int binlookupextra=-1;
-	  if (overlap) {
-	    assert(layer_==1||layer_==2);
-	    binlookup=lookupInnerOverlapLayer(stub.first);
-	  } else {
-	    switch (layer_) {
-	    case 2 : binlookup=lookupOuterLayer(stub.first);
-	      binlookupextra=lookupInnerLayer(stub.first);
-	      break;
-	    case 4 : binlookup=lookupOuterLayer(stub.first);
-	      break;
-	    case 6 : binlookup=lookupOuterLayer(stub.first);
-	      break;
-	    case 1 : binlookup=lookupInnerLayer(stub.first);
-	      break;
-	    case 3 : binlookup=lookupInnerLayer(stub.first);
-	      binlookupextra=lookupOuterLayer(stub.first);
-	      break;
-	    case 5 : binlookup=lookupInnerLayer(stub.first);
-	      break;
-	    default : assert(0);
-	    }
-	  }
-	  if ((layer_==2 or layer_==3) && binlookupextra!=-1) {
-	    stub.first->setVMBitsExtra(binlookupextra);
-	  }
+      if (binlookup!=-1) {
+	if (overlap) {
+	  stub.first->setVMBitsOverlap(binlookup);
+	} else {
+	  stub.first->setVMBits(binlookup);
+	}
+      }
 
-	  if (binlookup!=-1) {
-	    if (overlap) {
-	      stub.first->setVMBitsOverlap(binlookup);
-	    } else {
-	      stub.first->setVMBits(binlookup);
-	    }
-	  }
-	  
-	  unsigned int layer=stub.first->layer().value();
-	  if ((layer==1 || layer== 2) && binlookupextra!=-1 ) {
-	    int iphiRawTmp=iphiRaw/(32/(nallstubslayers[layer]*nvmteextralayers[layer]));
-	    for (unsigned int l=0;l<vmstubsTEExtraPHI_[iphiRawTmp].size();l++){
-	      if (debug1) {
-		cout << getName()<<" try adding extra stub to "<<vmstubsTEExtraPHI_[iphiRawTmp][l]->getName()<<endl;
-	      }
-	      vmstubsTEExtraPHI_[iphiRawTmp][l]->addStub(stub);
-	      insert=true;
-	    }
-	  }
-	  
-	  if (binlookup!=-1) {
-	    if (overlap) {
-	      int iphiRawTmp=iphiRaw/(32/(nallstubsoverlaplayers[layer]*nvmteoverlaplayers[layer]));
-	      for (unsigned int l=0;l<vmstubsTEOverlapPHI_[iphiRawTmp].size();l++){
-		if (debug1) {
-		  cout << getName()<<" try adding overlap stub to "<<vmstubsTEOverlapPHI_[iphiRawTmp][l]->getName()<<endl;
-		}
-		vmstubsTEOverlapPHI_[iphiRawTmp][l]->addStub(stub);
-		insert=true;
-	      }
-	    } else {
-	      int iphiRawTmp=iphiRaw/(32/(nallstubslayers[layer]*nvmtelayers[layer]));
-	      for (unsigned int l=0;l<vmstubsTEPHI_[iphiRawTmp].size();l++){
-		if (debug1) {
-		  cout << getName()<<" try adding stub to "<<vmstubsTEPHI_[iphiRawTmp][l]->getName()<<endl;
-		}
-		vmstubsTEPHI_[iphiRawTmp][l]->addStub(stub);
-		insert=true;
-	      }
-	    }
+      if ((layer_==2 || layer_==3) && binlookupextra!=-1 ) {
+	int iphiRawTmp=teExtraBin_[iphiRaw];
+	for (unsigned int l=0;l<vmstubsTEExtraPHI_[iphiRawTmp].size();l++){
+	  FPGA_DEBUG(getName()<<" try adding extra stub to "<<vmstubsTEExtraPHI_[iphiRawTmp][l]->getName());
+	  vmstubsTEExtraPHI_[iphiRawTmp][l]->addStub(stub);
+	  insert=true;
+	}
+      }
+
+      if (binlookup!=-1) {
+	if (overlap) {
+	  int iphiRawTmp=teOverlapBin_[iphiRaw];
+	  for (unsigned int l=0;l<vmstubsTEOverlapPHI_[iphiRawTmp].size();l++){
+	    FPGA_DEBUG(getName()<<" try adding overlap stub to "<<vmstubsTEOverlapPHI_[iphiRawTmp][l]->getName());
+	    vmstubsTEOverlapPHI_[iphiRawTmp][l]->addStub(stub);
+	    insert=true;
 	  }
-	  
-	  if (false) {
-	    if (!insert) {
-	      cout << getName()<<" did not insert stub"<<endl;
-	    }
-	    assert(insert);
+	} else {
+	  int iphiRawTmp=teBin_[iphiRaw];
+	  for (unsigned int l=0;l<vmstubsTEPHI_[iphiRawTmp].size();l++){
+	    FPGA_DEBUG(getName()<<" try adding stub to "<<vmstubsTEPHI_[iphiRawTmp][l]->getName());
+	    vmstubsTEPHI_[iphiRawTmp][l]->addStub(stub);
+	    insert=true;
 	  }
 	}
       }
 
+      if (false) {
+	if (!insert) {
+	  cout << getName()<<" did not insert stub"<<endl;
+	}
+	assert(insert);
+      }
+
     }
 
     if (disk_!=0) {
-      for(unsigned int j=0;j<stubinputs_.size();j++){
-	for(unsigned int i=0;i<stubinputs_[j]->nStubs();i++){
-	  std::pair<FPGAStub*,L1TStub*> stub=stubinputs_[j]->getStub(i);
 
-	  if (!stub.second->isPSmodule()) {
-	    if (debug1) {
-	      cout << getName() <<" stub at r = "<<stub.second->r()<<" is 2S module"<<endl;
-	    }
-	    continue;
-	  }
-	  
-	  int iphiRaw=stub.first->iphivmRaw();
+      if (!stub.second->isPSmodule()) {
+	FPGA_DEBUG(getName() <<" stub at r = "<<stub.second->r()<<" is 2S module");
+	return;
+      }
 
-	  bool insert=false;
+      int iphiRaw=stub.first->iphivmRaw();
 
+      bool insert=false;
 
-	  if (overlap) {
-	    
-	    int binlookup=lookupOuterOverlapD1(stub.first);
-	    assert(binlookup>=0);
-	    stub.first->setVMBitsOverlap(binlookup);
 
-	    iphiRaw=iphiRaw/(32/(nallstubsoverlapdisks[0]*nvmteoverlapdisks[0]));
+      if (overlap) {
 
-	    for (unsigned int l=0;l<vmstubsTEOverlapPHI_[iphiRaw].size();l++){
-	      if (debug1) {
-		cout << getName()<<" added stub to : "<<vmstubsTEOverlapPHI_[iphiRaw][l]->getName()<<endl;
-	      }
-	      vmstubsTEOverlapPHI_[iphiRaw][l]->addStub(stub);
-	      insert=true;
-	    }
-	      
-	  } else {
+	int binlookup=lookupOuterOverlapD1(stub.first);
+	assert(binlookup>=0);
+	stub.first->setVMBitsOverlap(binlookup);
 
-	    int binlookup=-1;
-
-	    if (!overlap) {
-	      switch (disk_) {
-	      case 2 : binlookup=lookupOuterDisk(stub.first);
-		break;
-	      case 4 : binlookup=lookupOuterDisk(stub.first);
-		break;
-	      case 1 : binlookup=lookupInnerDisk(stub.first);
-		break;
-	      case 3 : binlookup=lookupInnerDisk(stub.first);
-		break;
-	      default : assert(0);  
-	      }
-	    } else {
-	      assert(disk_==1);
-	      binlookup=lookupOuterOverlapD1(stub.first);
-	    }
-            
-	    if (binlookup==-1) continue;
-	    stub.first->setVMBits(binlookup);
-
-              
-	    unsigned int disk=abs(stub.first->disk().value());
-	    iphiRaw=iphiRaw/(32/(nallstubsdisks[disk-1]*nvmtedisks[disk-1]));
-
-	    for (unsigned int l=0;l<vmstubsTEPHI_[iphiRaw].size();l++){
-	      if (debug1) {
-		cout << getName()<<" added stub to : "<<vmstubsTEPHI_[iphiRaw][l]->getName()<<endl;
-	      }
-	      vmstubsTEPHI_[iphiRaw][l]->addStub(stub);
-	      insert=true;
-	    }
-	    
-	  }
+	iphiRaw=teOverlapBin_[iphiRaw];
 
-	  if (!insert) {
-	    cout << getName() << " did not insert stub"<<endl;
-	  }
-	  assert(insert);
+	for (unsigned int l=0;l<vmstubsTEOverlapPHI_[iphiRaw].size();l++){
+	  FPGA_DEBUG(getName()<<" added stub to : "<<vmstubsTEOverlapPHI_[iphiRaw][l]->getName());
+	  vmstubsTEOverlapPHI_[iphiRaw][l]->addStub(stub);
+	  insert=true;
+	}
+
+      } else {
 
+	int binlookup=-1;
+
+	switch (disk_) {
+	case 2 : binlookup=lookupOuterDisk(stub.first);
+	  break;
+	case 4 : binlookup=lookupOuterDisk(stub.first);
+	  break;
+	case 1 : binlookup=lookupInnerDisk(stub.first);
+	  break;
+	case 3 : binlookup=lookupInnerDisk(stub.first);
+	  break;
+	default : assert(0);
 	}
-      }
-    }
 
+	if (binlookup==-1) return;
+	stub.first->setVMBits(binlookup);
 
-    if (writeVMOccupancyTE) {
-      static ofstream out("vmoccupancyte.txt");
-      
-      for (int i=0;i<24;i++) {
-	if (vmstubsTEPHI_[i].size()!=0) {
-	  out<<vmstubsTEPHI_[i][0]->getName()<<" "<<vmstubsTEPHI_[i][0]->nStubs()<<endl;
+	iphiRaw=teBin_[iphiRaw];
+
+	for (unsigned int l=0;l<vmstubsTEPHI_[iphiRaw].size();l++){
+	  FPGA_DEBUG(getName()<<" added stub to : "<<vmstubsTEPHI_[iphiRaw][l]->getName());
+	  vmstubsTEPHI_[iphiRaw][l]->addStub(stub);
+	  insert=true;
 	}
+
       }
-    }
-    
-    //cout << "Done in FPGAVMRouterTE"<<endl;
-    
-  }
 
+      if (!insert) {
+	cout << getName() << " did not insert stub"<<endl;
+      }
+      assert(insert);
 
-  void executeME(){
+    }
 
-    //cout << "In FPGAVMRouterME "<<getName()<<" "<<stubinputs_.size()<<endl;
+  }
 
-    
-    unsigned int count=0;
 
-    if (stubinputs_.size()!=0){
-      for(unsigned int j=0;j<stubinputs_.size();j++){
-	for(unsigned int i=0;i<stubinputs_[j]->nStubs();i++){
-	  count++;
-	  if (count>MAXVMROUTER) continue;
-	  std::pair<FPGAStub*,L1TStub*> stub=stubinputs_[j]->getStub(i);
+  void routeME(std::pair<FPGAStub*,L1TStub*> stub, FPGAInputLink* input){
 
-	  int iphiRaw=stub.first->iphivmRaw();
-	  int iphiRawPlus=stub.first->iphivmRawPlus();
-	  int iphiRawMinus=stub.first->iphivmRawMinus();
+    int iphistub=stub.first->iphivmRaw();
 
-	  int iphistub=iphiRaw;
+    if (!hourglass) {
+      assert(iphistub>=4 and iphistub<=27);
+    }
 
-	  if (hourglass) {
+    int iphiRaw=meBin_[iphistub];
+    int iphiRawPlus=meBin_[stub.first->iphivmRawPlus()];
+    int iphiRawMinus=meBin_[stub.first->iphivmRawMinus()];
 
-	    int layer=stub.first->layer().value();
-	    int disk=abs(stub.first->disk().value());
 
-	    //cout << getName()<<" layer,disk : "<<layer<<" "<<disk<<endl;
-	    
-	    int nvm=-1;
-	    if (layer!=-1) {
-	      nvm=nallstubslayers[layer]*nvmmelayers[layer];
-	    }
-	    if (disk!=0){
-	      nvm=nallstubsdisks[disk-1]*nvmmedisks[disk-1];
-	    }
-	    assert(nvm>0&&nvm<=32);
-	    iphiRaw=iphiRaw/(32/nvm);
-	    iphiRawPlus=iphiRawPlus/(32/nvm);
-	    iphiRawMinus=iphiRawMinus/(32/nvm);
-	    if (iphiRawPlus<0) iphiRawPlus=0;
-	    if (iphiRawPlus>=nvm) iphiRawPlus=nvm-1;
-	    if (iphiRawMinus<0) iphiRawMinus=0;
-	    if (iphiRawMinus>=nvm) iphiRawMinus=nvm-1;
-	    
-	  } else {
+    if (disk_!=0) {
 
-	    assert(iphiRaw>=4 and iphiRaw<=27);
-	  
-	  
-	    iphiRaw-=4;
-	    iphiRaw=iphiRaw>>1;
-	    assert(iphiRaw>=0);
-	    assert(iphiRaw<=11);
-	    
-	    iphiRawPlus-=4;
-	    iphiRawPlus=iphiRawPlus>>1;
-	    if (iphiRawPlus<0) iphiRawPlus=0;
-	    if (iphiRawPlus>11) iphiRawPlus=11;
-	    
-	    iphiRawMinus-=4;
-	    iphiRawMinus=iphiRawMinus>>1;
-	    if (iphiRawMinus<0) iphiRawMinus=0;
-	    if (iphiRawMinus>11) iphiRawMinus=11;
+      int index=stub.first->r().value();
+      if (stub.first->isPSmodule()){
+	index=stub.first->r().value()>>(stub.first->r().nbits()-nbitsfinebintable_);
+      }
 
-	  }
+      int rfine=finebintable_[index];
 
+      assert(rfine>=0);
 
-	  if (disk_!=0) {
+      stub.first->setfiner(rfine);
 
-	    int index=stub.first->r().value();
-	    if (stub.first->isPSmodule()){
-	      index=stub.first->r().value()>>(stub.first->r().nbits()-nbitsfinebintable_);
-	    }
+    }
 
-	    int rfine=finebintable_[index];
+    if (layer_!=0) {
 
-	    assert(rfine>=0);
-	    
-	    stub.first->setfiner(rfine);
+      int index=(stub.first->z().value()>>(stub.first->z().nbits()-nbitsfinebintable_))&((1<<nbitsfinebintable_)-1);
 
-	  }
+      int zfine=finebintable_[index];
 
-	  if (layer_!=0) {
+      stub.first->setfinez(zfine);
 
-	    int index=(stub.first->z().value()>>(stub.first->z().nbits()-nbitsfinebintable_))&((1<<nbitsfinebintable_)-1);
-	    
-	    int zfine=finebintable_[index];
+    }
 
-	    stub.first->setfinez(zfine);
+    bool insert=false;
 
-	  }
-	  
-	  bool insert=false;
-	  
-	  
-	  for (unsigned int l=0;l<vmstubsMEPHI_[iphiRaw].size();l++){
-	    if (debug1) {
-	      cout << "FPGAVMRouterME "<<getName()<<" add stub ( r = "<<stub.second->r()<<" phi = "<<stub.second->phi()<<" ) in : "<<vmstubsMEPHI_[iphiRaw][l]->getName()<<" iphistub = " << iphistub << " iphivmRaw Minus Plus "<<stub.first->iphivmRaw()<<" "<<stub.first->iphivmRawMinus()<<" "<<stub.first->iphivmRawPlus()<<" bins "
-		   <<iphiRawMinus<<" "<<iphiRawPlus<<endl;
-	    }
-	    vmstubsMEPHI_[iphiRaw][l]->addStub(stub);
-	    insert=true;
-	  }
-
-	  if (iphiRaw!=iphiRawPlus) {
-	    for (unsigned int l=0;l<vmstubsMEPHI_[iphiRawPlus].size();l++){
-	      vmstubsMEPHI_[iphiRawPlus][l]->addStub(stub);
-	    }
-	  }
-	  if (iphiRaw!=iphiRawMinus) {
-	    for (unsigned int l=0;l<vmstubsMEPHI_[iphiRawMinus].size();l++){
-	      vmstubsMEPHI_[iphiRawMinus][l]->addStub(stub);
-	    }
-	  }
-	 
 
-	  if (!insert){
-	    cout << "In "<<getName()<<" did not insert stub from input "<<stubinputs_[j]->getName()<<endl;
-	  }
-	  assert(insert);
+    for (unsigned int l=0;l<vmstubsMEPHI_[iphiRaw].size();l++){
+      FPGA_DEBUG("FPGAVMRouterME "<<getName()<<" add stub ( r = "<<stub.second->r()<<" phi = "<<stub.second->phi()<<" ) in : "<<vmstubsMEPHI_[iphiRaw][l]->getName()<<" iphistub = " << iphistub << " iphivmRaw Minus Plus "<<stub.first->iphivmRaw()<<" "<<stub.first->iphivmRawMinus()<<" "<<stub.first->iphivmRawPlus()<<" bins "
+	     <<iphiRawMinus<<" "<<iphiRawPlus);
+      vmstubsMEPHI_[iphiRaw][l]->addStub(stub);
+      insert=true;
+    }
 
-	}
+    if (iphiRaw!=iphiRawPlus) {
+      for (unsigned int l=0;l<vmstubsMEPHI_[iphiRawPlus].size();l++){
+	vmstubsMEPHI_[iphiRawPlus][l]->addStub(stub);
       }
-      
-      if (writeVMOccupancyME) {
-	static ofstream out("vmoccupancyme.txt");
-
-	for (int i=0;i<24;i++) {
-	  if (vmstubsMEPHI_[i].size()!=0) {
-	    out<<vmstubsMEPHI_[i][0]->getName()<<" "<<vmstubsMEPHI_[i][0]->nStubs();
-	    for (unsigned int ibin=0;ibin<MEBinsDisks*2;ibin++){
-	      out <<" "<<vmstubsMEPHI_[i][0]->nStubsBin(ibin);
-	    }
-	    out<<endl;
-	  }
-	}
-
+    }
+    if (iphiRaw!=iphiRawMinus) {
+      for (unsigned int l=0;l<vmstubsMEPHI_[iphiRawMinus].size();l++){
+	vmstubsMEPHI_[iphiRawMinus][l]->addStub(stub);
       }
-
     }
 
 
+    if (!insert){
+      cout << "In "<<getName()<<" did not insert stub from input "<<input->getName()<<endl;
+    }
+    assert(insert);
+
   }
 
+public:
+
 
 
   
@@ -589,21 +557,13 @@ public:
 
     assert(disk_==1);
     
-    static FPGATETableOuterDisk outerTableOverlapD1;
-    static bool first=true;
-
-    if (first) {
-      outerTableOverlapD1.init(1,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int rbin=(r.value())>>(r.nbits()-7);
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-3);
     bool negdisk=stub->disk().value()<0;
     if (negdisk) zbin=7-zbin; //Should this be separate table?
-    return outerTableOverlapD1.lookup(rbin,zbin);
+    return context_->outerTableOverlapD1().lookup(rbin,zbin);
 
   }
 
@@ -612,16 +572,6 @@ public:
 
     assert(disk_==2||disk_==4);
     
-    static FPGATETableOuterDisk outerTableD2;
-    static FPGATETableOuterDisk outerTableD4;
-    static bool first=true;
-
-    if (first) {
-      outerTableD2.init(2,7,3);
-      outerTableD4.init(4,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int rbin=(r.value())>>(r.nbits()-7);
@@ -629,9 +579,9 @@ public:
     bool negdisk=stub->disk().value()<0;
     if (negdisk) zbin=7-zbin; //Should this be separate table?
     switch (disk_){
-    case 2: return outerTableD2.lookup(rbin,zbin);
+    case 2: return context_->outerTableDisk(2).lookup(rbin,zbin);
       break;
-    case 4: return outerTableD4.lookup(rbin,zbin);
+    case 4: return context_->outerTableDisk(4).lookup(rbin,zbin);
       break;
     }
     assert(0);
@@ -642,16 +592,6 @@ public:
 
     assert(disk_==1||disk_==3);
     
-    static FPGATETableInnerDisk innerTableD1;
-    static FPGATETableInnerDisk innerTableD3;
-    static bool first=true;
-
-    if (first) {
-      innerTableD1.init(1,2,7,3);
-      innerTableD3.init(3,4,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int rbin=(r.value())>>(r.nbits()-7);
@@ -659,9 +599,9 @@ public:
     bool negdisk=stub->disk().value()<0;
     if (negdisk) zbin=7-zbin; //Should this be separate table?
     switch (disk_){
-    case 1: return innerTableD1.lookup(rbin,zbin);
+    case 1: return context_->innerTableDisk(1).lookup(rbin,zbin);
       break;
-    case 3: return innerTableD3.lookup(rbin,zbin);
+    case 3: return context_->innerTableDisk(3).lookup(rbin,zbin);
       break;
     }
     assert(0);
@@ -671,32 +611,18 @@ public:
 
     assert(layer_==2||layer_==3||layer_==4||layer_==6);
     
-    static FPGATETableOuter outerTableL2;
-    static FPGATETableOuter outerTableL3;
-    static FPGATETableOuter outerTableL4;
-    static FPGATETableOuter outerTableL6;
-    static bool first=true;
-
-    if (first) {
-      outerTableL2.init(2,7,4);
-      outerTableL3.init(3,7,4);
-      outerTableL4.init(4,7,4);
-      outerTableL6.init(6,7,4);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-7);
     int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-4);
     switch (layer_){
-    case 2: return outerTableL2.lookup(zbin,rbin);
+    case 2: return context_->outerTableLayer(2).lookup(zbin,rbin);
       break;
-    case 3: return outerTableL3.lookup(zbin,rbin);
+    case 3: return context_->outerTableLayer(3).lookup(zbin,rbin);
       break;
-    case 4: return outerTableL4.lookup(zbin,rbin);
+    case 4: return context_->outerTableLayer(4).lookup(zbin,rbin);
       break;
-    case 6: return outerTableL6.lookup(zbin,rbin);
+    case 6: return context_->outerTableLayer(6).lookup(zbin,rbin);
       break;
     }
     assert(0);
@@ -707,32 +633,18 @@ public:
 
     assert(layer_==1||layer_==2||layer_==3||layer_==5);
     
-    static FPGATETableInner innerTableL1;
-    static FPGATETableInner innerTableL2;
-    static FPGATETableInner innerTableL3;
-    static FPGATETableInner innerTableL5;
-    static bool first=true;
-
-    if (first) {
-      innerTableL1.init(1,2,7,4);
-      innerTableL2.init(2,3,7,4);
-      innerTableL3.init(3,4,7,4);
-      innerTableL5.init(5,6,7,4);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-7);
     int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-4);
     switch (layer_){
-    case 1: return innerTableL1.lookup(zbin,rbin);
+    case 1: return context_->innerTableLayer(1).lookup(zbin,rbin);
       break;
-    case 2: return innerTableL2.lookup(zbin,rbin);
+    case 2: return context_->innerTableLayer(2).lookup(zbin,rbin);
       break;
-    case 3: return innerTableL3.lookup(zbin,rbin);
+    case 3: return context_->innerTableLayer(3).lookup(zbin,rbin);
       break;
-    case 5: return innerTableL5.lookup(zbin,rbin);
+    case 5: return context_->innerTableLayer(5).lookup(zbin,rbin);
       break;
     }
     assert(0);
@@ -743,24 +655,14 @@ public:
 
     assert(layer_==1||layer_==2);
     
-    static FPGATETableInnerOverlap innerTableOverlapL1;
-    static FPGATETableInnerOverlap innerTableOverlapL2;
-    static bool first=true;
-
-    if (first) {
-      innerTableOverlapL1.init(1,1,7,3);
-      innerTableOverlapL2.init(2,1,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-7);
     int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-3);
     switch (layer_){
-    case 1: return innerTableOverlapL1.lookup(zbin,rbin);
+    case 1: return context_->innerTableOverlapLayer(1).lookup(zbin,rbin);
       break;
-    case 2: return innerTableOverlapL2.lookup(zbin,rbin);
+    case 2: return context_->innerTableOverlapLayer(2).lookup(zbin,rbin);
       break;
     }
     assert(0);
@@ -771,6 +673,8 @@ public:
 
 private:
 
+  const FPGAContext* context_;
+
   int layer_;
   int disk_;
 
@@ -785,6 +689,12 @@ private:
   vector<FPGAVMStubsTE*> vmstubsTEOverlapPHI_[32];
   vector<FPGAVMStubsME*> vmstubsMEPHI_[32];
 
+  //Memory index for each raw VM phi bin (see fillRoutingTables)
+  int teBin_[32];
+  int teExtraBin_[32];
+  int teOverlapBin_[32];
+  int meBin_[32];
+
 
 };
 
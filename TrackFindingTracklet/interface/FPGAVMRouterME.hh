@@ -10,8 +10,8 @@ class FPGAVMRouterME:public FPGAProcessBase{
 
 public:
 
-  FPGAVMRouterME(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAVMRouterME(string name, const FPGASettings* settings, unsigned int iSector):
+    FPGAProcessBase(name,settings,iSector){
     
     layer_=0;
     disk_=0;
@@ -168,7 +168,7 @@ public:
       for(unsigned int j=0;j<stubinputs_.size();j++){
 	for(unsigned int i=0;i<stubinputs_[j]->nStubs();i++){
 	  count++;
-	  if (count>MAXVMROUTER) continue;
+	  if (count>settings_->maxVMRouter()) continue;
 	  std::pair<FPGAStub*,L1TStub*> stub=stubinputs_[j]->getStub(i);
 
 	  int iphiRaw=stub.first->iphivmRaw();
@@ -250,9 +250,7 @@ public:
 	  bool insert=false;
 	  
 	  for (unsigned int l=0;l<vmstubsPHI_[iphiRaw].size();l++){
-	    if (debug1) {
-	      cout << "FPGAVMRouterME "<<getName()<<" add stub ( r = "<<stub.second->r()<<" phi = "<<stub.second->phi()<<" ) in : "<<vmstubsPHI_[iphiRaw][l]->getName()<<" iphistub = " << iphistub << endl;
-	    }
+	    FPGA_DEBUG("FPGAVMRouterME "<<getName()<<" add stub ( r = "<<stub.second->r()<<" phi = "<<stub.second->phi()<<" ) in : "<<vmstubsPHI_[iphiRaw][l]->getName()<<" iphistub = " << iphistub);
 	    vmstubsPHI_[iphiRaw][l]->addStub(stub);
 	    insert=true;
 	  }
@@ -286,7 +284,7 @@ public:
       }
       
       if (writeVMOccupancyME) {
-	static ofstream out("vmoccupancyme.txt");
+	ofstream& out=debugFile("vmoccupancyme.txt");
 
 	for (int i=0;i<24;i++) {
 	  if (vmstubsPHI_[i].size()!=0) {
@@ -299,7 +297,7 @@ public:
     }
 
     if (writeAllStubs) {
-      static ofstream out("allstubsme.txt");
+      ofstream& out=debugFile("allstubsme.txt");
       out<<allstubs_[0]->getName()<<" "<<allstubs_[0]->nStubs()<<endl;
     }
  
@@ -58,7 +58,7 @@ public:
     
   }
 
-  int getphiCorrValue(int ibend, int irbin){
+  int getphiCorrValue(int ibend, int irbin) const {
 
     double bend=FPGAStub::benddecode(ibend,layer_<=3);
     
@@ -3,11 +3,7 @@
 #define FPGAVMROUTERTE_H
 
 #include "FPGAProcessBase.hh"
-#include "FPGATETableOuter.hh"
-#include "FPGATETableInner.hh"
-#include "FPGATETableOuterDisk.hh"
-#include "FPGATETableInnerDisk.hh"
-#include "FPGATETableInnerOverlap.hh"
+#include "FPGAContext.hh"
 
 using namespace std;
 
@@ -15,8 +11,11 @@ class FPGAVMRouterTE:public FPGAProcessBase{
 
 public:
 
-  FPGAVMRouterTE(string name, unsigned int iSector):
-    FPGAProcessBase(name,iSector){
+  FPGAVMRouterTE(string name, const FPGASettings* settings, unsigned int iSector,
+                 const FPGAContext* context):
+    FPGAProcessBase(name,settings,iSector){
+
+    context_=context;
 
     layer_=0;
     disk_=0;
@@ -168,7 +167,7 @@ public:
       for(unsigned int j=0;j<stubinputs_.size();j++){
 	for(unsigned int i=0;i<stubinputs_[j]->nStubs();i++){
 	  count++;
-	  if (count>MAXVMROUTER) continue;
+	  if (count>settings_->maxVMRouter()) continue;
 	  std::pair<FPGAStub*,L1TStub*> stub=stubinputs_[j]->getStub(i);
           
 	  int iphiRaw=stub.first->iphivmRaw();
@@ -212,9 +211,7 @@ public:
 	    if (overlap_) iphiRaw>>=2;
 
 	    for (unsigned int l=0;l<vmstubsPHI_[iphiRaw].size();l++){
-	      if (debug1) {
-		cout << "FPGAVMRouterTE added stub to : "<<vmstubsPHI_[iphiRaw][l]->getName()<<endl;
-	      }
+	      FPGA_DEBUG("FPGAVMRouterTE added stub to : "<<vmstubsPHI_[iphiRaw][l]->getName());
 	      vmstubsPHI_[iphiRaw][l]->addStub(stub);
 	      insert=true;
 	    }
@@ -255,9 +252,7 @@ public:
           }
 	      for (unsigned int l=0;l<vmstubsPHI_[iphiRaw].size();l++){
 		vmstubsPHI_[iphiRaw][l]->addStub(stub);
-		if (debug1) {
-		  cout << getName()<<" adding stub to "<<vmstubsPHI_[iphiRaw][l]->getName()<<endl;
-		}
+		FPGA_DEBUG(getName()<<" adding stub to "<<vmstubsPHI_[iphiRaw][l]->getName());
 		insert=true;
 	      }
 	    } else {  //even layers
@@ -266,9 +261,7 @@ public:
 	      assert(iphiRaw<16);
 	      for (unsigned int l=0;l<vmstubsPHI_[iphiRaw].size();l++){
 		vmstubsPHI_[iphiRaw][l]->addStub(stub);
-		if (debug1) {
-		  cout << getName()<<" adding stub to "<<vmstubsPHI_[iphiRaw][l]->getName()<<endl;
-		}
+		FPGA_DEBUG(getName()<<" adding stub to "<<vmstubsPHI_[iphiRaw][l]->getName());
 		insert=true;
 	      }
 	    }
@@ -345,9 +338,7 @@ public:
         assert(iphiRaw<16);
         iphiRaw>>=1; //only 8 VMS in even disks
         for (unsigned int l=0;l<vmstubsPHI_[iphiRaw].size();l++){
-          if (debug1) { 
-            cout << "FPGAVMRouterTE added stub to : "<<vmstubsPHI_[iphiRaw][l]->getName()<<endl;
-          }
+          FPGA_DEBUG("FPGAVMRouterTE added stub to : "<<vmstubsPHI_[iphiRaw][l]->getName());
           vmstubsPHI_[iphiRaw][l]->addStub(stub);
           insert=true;
         }
@@ -483,7 +474,7 @@ public:
 
 
     if (writeAllStubs) {
-      static ofstream out("allstubste.txt");
+      ofstream& out=debugFile("allstubste.txt");
       out<<allstubs_[0]->getName()<<" "<<allstubs_[0]->nStubs()<<endl;
       //if (allstubs_[0]->getName()=="AS_D1PHIQn1") {
       //	cout << "Number of stubs in : "<<allstubs_[0]->getName()<<" "<<allstubs_[0]->nStubs()<<endl;
@@ -492,7 +483,7 @@ public:
 
 
     if (writeVMOccupancyTE) {
-      static ofstream out("vmoccupancyte.txt");
+      ofstream& out=debugFile("vmoccupancyte.txt");
       
       for (int i=0;i<24;i++) {
 	if (vmstubsPHI_[i].size()!=0) {
@@ -507,21 +498,13 @@ public:
 
     assert(disk_==1);
     
-    static FPGATETableOuterDisk outerTableOverlapD1;
-    static bool first=true;
-
-    if (first) {
-      outerTableOverlapD1.init(1,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int rbin=(r.value())>>(r.nbits()-7);
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-3);
     bool negdisk=stub->disk().value()<0;
     if (negdisk) zbin=7-zbin; //Should this be separate table?
-    return outerTableOverlapD1.lookup(rbin,zbin);
+    return context_->outerTableOverlapD1().lookup(rbin,zbin);
 
   }
 
@@ -530,16 +513,6 @@ public:
 
     assert(disk_==2||disk_==4);
     
-    static FPGATETableOuterDisk outerTableD2;
-    static FPGATETableOuterDisk outerTableD4;
-    static bool first=true;
-
-    if (first) {
-      outerTableD2.init(2,7,3);
-      outerTableD4.init(4,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int rbin=(r.value())>>(r.nbits()-7);
@@ -547,9 +520,9 @@ public:
     bool negdisk=stub->disk().value()<0;
     if (negdisk) zbin=7-zbin; //Should this be separate table?
     switch (disk_){
-    case 2: return outerTableD2.lookup(rbin,zbin);
+    case 2: return context_->outerTableDisk(2).lookup(rbin,zbin);
       break;
-    case 4: return outerTableD4.lookup(rbin,zbin);
+    case 4: return context_->outerTableDisk(4).lookup(rbin,zbin);
       break;
     }
     assert(0);
@@ -560,16 +533,6 @@ public:
 
     assert(disk_==1||disk_==3);
     
-    static FPGATETableInnerDisk innerTableD1;
-    static FPGATETableInnerDisk innerTableD3;
-    static bool first=true;
-
-    if (first) {
-      innerTableD1.init(1,2,7,3);
-      innerTableD3.init(3,4,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int rbin=(r.value())>>(r.nbits()-7);
@@ -577,9 +540,9 @@ public:
     bool negdisk=stub->disk().value()<0;
     if (negdisk) zbin=7-zbin; //Should this be separate table?
     switch (disk_){
-    case 1: return innerTableD1.lookup(rbin,zbin);
+    case 1: return context_->innerTableDisk(1).lookup(rbin,zbin);
       break;
-    case 3: return innerTableD3.lookup(rbin,zbin);
+    case 3: return context_->innerTableDisk(3).lookup(rbin,zbin);
       break;
     }
     assert(0);
@@ -589,28 +552,16 @@ public:
 
     assert(layer_==2||layer_==4||layer_==6);
     
-    static FPGATETableOuter outerTableL2;
-    static FPGATETableOuter outerTableL4;
-    static FPGATETableOuter outerTableL6;
-    static bool first=true;
-
-    if (first) {
-      outerTableL2.init(2,7,4);
-      outerTableL4.init(4,7,4);
-      outerTableL6.init(6,7,4);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-7);
     int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-4);
     switch (layer_){
-    case 2: return outerTableL2.lookup(zbin,rbin);
+    case 2: return context_->outerTableLayer(2).lookup(zbin,rbin);
       break;
-    case 4: return outerTableL4.lookup(zbin,rbin);
+    case 4: return context_->outerTableLayer(4).lookup(zbin,rbin);
       break;
-    case 6: return outerTableL6.lookup(zbin,rbin);
+    case 6: return context_->outerTableLayer(6).lookup(zbin,rbin);
       break;
     }
     assert(0);
@@ -621,28 +572,16 @@ public:
 
     assert(layer_==1||layer_==3||layer_==5);
     
-    static FPGATETableInner innerTableL1;
-    static FPGATETableInner innerTableL3;
-    static FPGATETableInner innerTableL5;
-    static bool first=true;
-
-    if (first) {
-      innerTableL1.init(1,2,7,4);
-      innerTableL3.init(3,4,7,4);
-      innerTableL5.init(5,6,7,4);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-7);
     int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-4);
     switch (layer_){
-    case 1: return innerTableL1.lookup(zbin,rbin);
+    case 1: return context_->innerTableLayer(1).lookup(zbin,rbin);
       break;
-    case 3: return innerTableL3.lookup(zbin,rbin);
+    case 3: return context_->innerTableLayer(3).lookup(zbin,rbin);
       break;
-    case 5: return innerTableL5.lookup(zbin,rbin);
+    case 5: return context_->innerTableLayer(5).lookup(zbin,rbin);
       break;
     }
     assert(0);
@@ -653,24 +592,14 @@ public:
 
     assert(layer_==1||layer_==2);
     
-    static FPGATETableInnerOverlap innerTableOverlapL1;
-    static FPGATETableInnerOverlap innerTableOverlapL2;
-    static bool first=true;
-
-    if (first) {
-      innerTableOverlapL1.init(1,1,7,3);
-      innerTableOverlapL2.init(2,1,7,3);
-      first=false;
-    }
-    
     FPGAWord r=stub->r();
     FPGAWord z=stub->z();
     int zbin=(z.value()+(1<<(z.nbits()-1)))>>(z.nbits()-7);
     int rbin=(r.value()+(1<<(r.nbits()-1)))>>(r.nbits()-3);
     switch (layer_){
-    case 1: return innerTableOverlapL1.lookup(zbin,rbin);
+    case 1: return context_->innerTableOverlapLayer(1).lookup(zbin,rbin);
       break;
-    case 2: return innerTableOverlapL2.lookup(zbin,rbin);
+    case 2: return context_->innerTableOverlapLayer(2).lookup(zbin,rbin);
       break;
     }
     assert(0);
@@ -681,6 +610,8 @@ public:
 
 private:
 
+  const FPGAContext* context_;
+
   int layer_;
   int disk_;
 
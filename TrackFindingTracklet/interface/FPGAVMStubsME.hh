@@ -5,6 +5,7 @@
 #include "L1TStub.hh"
 #include "FPGAStub.hh"
 #include "FPGAMemoryBase.hh"
+#include "FPGAMemoryBuffer.hh"
 
 using namespace std;
 
@@ -12,24 +13,29 @@ class FPGAVMStubsME:public FPGAMemoryBase{
 
 public:
 
-  FPGAVMStubsME(string name, unsigned int iSector, 
+  FPGAVMStubsME(string name, const FPGASettings* settings, unsigned int iSector, 
 	      double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
+    stubs_.init(settings_->vmStubsDepth(),settings_->truncateMemories());
+    for (unsigned int i=0;i<MEBinsDisks*2;i++){
+      binnedstubs_[i].init(settings_->vmStubsBinDepth(),settings_->truncateMemories());
+    }
   }
 
   void addStub(std::pair<FPGAStub*,L1TStub*> stub) {
-    stubs_.push_back(stub);
+    if (!stubs_.push_back(stub)) {
+      ndropped_++;
+      return;
+    }
     if (stub.first->isBarrel()) { // barrel
       int bin=(1<<(MEBinsBits-1))+(stub.first->z().value()>>(stub.first->z().nbits()-MEBinsBits));
       //cout << "FPGAVMStubsME::addStub "<<bin<<" "<<stub.first->z().value()<<" "<<stub.first->z().nbits()<<endl;
       assert(bin>=0);
       assert(bin<MEBins);
-      if (debug1) {
-	cout << getName() << " adding stub to bin "<<bin<<endl;
-      }
-      binnedstubs_[bin].push_back(stub);
+      FPGA_DEBUG(getName() << " adding stub to bin "<<bin);
+      if (!binnedstubs_[bin].push_back(stub)) ndropped_++;
     }
     else { // disk 
       int ir = stub.first->r().value();
@@ -48,15 +54,21 @@ public:
       assert(bin>=0);
       assert(bin<MEBinsDisks);
       if (stub.first->disk().value()<0) bin+=MEBinsDisks;
-      if (debug1) {
-	cout << getName() << " adding stub to bin "<<bin<<endl;
-      }
-      binnedstubs_[bin].push_back(stub);
+      FPGA_DEBUG(getName() << " adding stub to bin "<<bin);
+      if (!binnedstubs_[bin].push_back(stub)) ndropped_++;
       
     }
   }
 
   unsigned int nStubs() const {return stubs_.size();}
+  unsigned int nEntries() const {return nStubs();}
+  unsigned int nOverflow() const {
+    unsigned int n=stubs_.nOverflow();
+    for (unsigned int i=0;i<MEBinsDisks*2;i++){
+      n+=binnedstubs_[i].nOverflow();
+    }
+    return n;
+  }
 
   FPGAStub* getFPGAStub(unsigned int i) const {return stubs_[i].first;}
   L1TStub* getL1TStub(unsigned int i) const {return stubs_[i].second;}
@@ -82,9 +94,9 @@ public:
   }
   
   void clean() {
-    stubs_.clear();
+    stubs_.reset();
     for (unsigned int i=0; i<MEBinsDisks*2; i++){
-      binnedstubs_[i].clear();
+      binnedstubs_[i].reset();
     }
   }
 
@@ -139,9 +151,9 @@ private:
 
   double phimin_;
   double phimax_;
-  std::vector<std::pair<FPGAStub*,L1TStub*> > stubs_;
+  FPGAMemoryBuffer<std::pair<FPGAStub*,L1TStub*> > stubs_;
 
-  std::vector<std::pair<FPGAStub*,L1TStub*> > binnedstubs_[MEBinsDisks*2];
+  FPGAMemoryBuffer<std::pair<FPGAStub*,L1TStub*> > binnedstubs_[MEBinsDisks*2];
 
   
   
@@ -5,6 +5,7 @@
 #include "L1TStub.hh"
 #include "FPGAStub.hh"
 #include "FPGAMemoryBase.hh"
+#include "FPGAMemoryBuffer.hh"
 
 using namespace std;
 
@@ -12,9 +13,9 @@ class FPGAVMStubsTE:public FPGAMemoryBase{
 
 public:
 
-  FPGAVMStubsTE(string name, unsigned int iSector, 
+  FPGAVMStubsTE(string name, const FPGASettings* settings, unsigned int iSector, 
 	      double phimin, double phimax):
-    FPGAMemoryBase(name,iSector){
+    FPGAMemoryBase(name,settings,iSector){
     phimin_=phimin;
     phimax_=phimax;
     string subname=name.substr(6,2);
@@ -75,6 +76,11 @@ public:
 
     if (extra_ and layer_==2) isinner_ = true;
     if (extra_ and layer_==3) isinner_ = false;
+
+    stubs_.init(settings_->vmStubsDepth(),settings_->truncateMemories());
+    for (unsigned int i=0;i<NLONGVMBINS;i++){
+      stubsbinned_[i].init(settings_->vmStubsBinDepth(),settings_->truncateMemories());
+    }
     
   }
   
@@ -96,7 +102,12 @@ public:
     bool pass=passbend(stub.first->bend().value());
 
     if (!pass) {
-      if (debug1) cout << getName() << " Stub failed bend cut. bend = "<<FPGAStub::benddecode(stub.first->bend().value(),stub.first->isPSmodule())<<endl;
+      FPGA_DEBUG(getName() << " Stub failed bend cut. bend = "<<FPGAStub::benddecode(stub.first->bend().value(),stub.first->isPSmodule()));
+      return false;
+    }
+
+    if (!stubs_.push_back(stub)) {
+      ndropped_++;
       return false;
     }
     
@@ -105,14 +116,14 @@ public:
           bool negdisk=stub.first->disk().value()<0.0;
 	  assert(bin<4);
 	  if (negdisk) bin+=4;
-	  stubsbinned_[bin].push_back(stub);
-	  if (debug1) cout << getName()<<" Stub with lookup = "<<binlookup
-			   <<" in disk = "<<disk_<<"  in bin = "<<bin<<endl;
+	  addStubBinned(bin,stub);
+	  FPGA_DEBUG(getName()<<" Stub with lookup = "<<binlookup
+			   <<" in disk = "<<disk_<<"  in bin = "<<bin);
 	}
     } else {
       if (stub.first->isBarrel()){
 	if (!isinner_) {
-	  stubsbinned_[bin].push_back(stub);
+	  addStubBinned(bin,stub);
 	}
 	
       } else {
@@ -122,17 +133,29 @@ public:
 	if (disk_%2==0) {
 	  assert(bin<4);
 	  if (negdisk) bin+=4;
-	  stubsbinned_[bin].push_back(stub);
+	  addStubBinned(bin,stub);
 	}
         	
       }
     }
-    if (debug1) cout << "Adding stubs to "<<getName()<<endl;
-    stubs_.push_back(stub);
+    FPGA_DEBUG("Adding stubs to "<<getName());
     return true;
   }
 
+  void addStubBinned(unsigned int bin, std::pair<FPGAStub*,L1TStub*> stub) {
+    assert(bin<NLONGVMBINS);
+    if (!stubsbinned_[bin].push_back(stub)) ndropped_++;
+  }
+
   unsigned int nStubs() const {return stubs_.size();}
+  unsigned int nEntries() const {return nStubs();}
+  unsigned int nOverflow() const {
+    unsigned int n=stubs_.nOverflow();
+    for (unsigned int i=0;i<NLONGVMBINS;i++){
+      n+=stubsbinned_[i].nOverflow();
+    }
+    return n;
+  }
   unsigned int nStubsBinned(unsigned int bin) const {return stubsbinned_[bin].size();}
 
   FPGAStub* getFPGAStub(unsigned int i) const {return stubs_[i].first;}
@@ -146,9 +169,9 @@ public:
 
   
   void clean() {
-    stubs_.clear();
+    stubs_.reset();
     for (unsigned int i=0;i<NLONGVMBINS;i++){
-      stubsbinned_[i].clear();
+      stubsbinned_[i].reset();
     }
   }
 
@@ -426,8 +449,8 @@ private:
   double phimin_;
   double phimax_;
   std::vector<bool> vmbendtable_;
-  std::vector<std::pair<FPGAStub*,L1TStub*> > stubs_;
-  std::vector<std::pair<FPGAStub*,L1TStub*> > stubsbinned_[NLONGVMBINS];
+  FPGAMemoryBuffer<std::pair<FPGAStub*,L1TStub*> > stubs_;
+  FPGAMemoryBuffer<std::pair<FPGAStub*,L1TStub*> > stubsbinned_[NLONGVMBINS];
 
 };
 
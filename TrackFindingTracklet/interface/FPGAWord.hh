@@ -8,6 +8,8 @@
 #include <assert.h>
 #include <math.h>
 
+#include "FPGALog.hh"
+
 
 using namespace std;
 
@@ -25,37 +27,37 @@ public:
     nbits_=nbits;
     positive_=positive;
     if (positive) {
-      if (value<0) cout << "FPGAWord got negative value:"
-			<<value<<" ("<<file<<":"<<line<<")"<<endl;
+      if (value<0) FPGA_ERROR("FPGAWord got negative value:"
+			      <<value<<" ("<<file<<":"<<line<<")");
       assert(value>=0);
     }
     if (nbits>=22) {
-      cout << "FPGAWord got too many bits:"
-	   <<nbits<<" ("<<file<<":"<<line<<")"<<endl;
+      FPGA_ERROR("FPGAWord got too many bits:"
+		 <<nbits<<" ("<<file<<":"<<line<<")");
     }
     assert(nbits<22);
     if (nbits<=0) {
-      cout << "FPGAWord got too few bits:"
-	   <<nbits<<" ("<<file<<":"<<line<<")"<<endl;      
+      FPGA_ERROR("FPGAWord got too few bits:"
+		 <<nbits<<" ("<<file<<":"<<line<<")");
     }
     assert(nbits>0);
     if (positive) {
       if (value>=(1<<nbits)) {
 	if (file!=0) {
-	  cout << "value too large:"
-	       <<value<<" "<<(1<<nbits)<<" ("<<file<<":"<<line<<")"<<endl;
+	  FPGA_ERROR("value too large:"
+		     <<value<<" "<<(1<<nbits)<<" ("<<file<<":"<<line<<")");
 	}
       }
       assert(value<(1<<nbits));
     } else {
       if (value>(1<<(nbits-1))) {
-	cout << "value too large:"
-	     <<value<<" "<<(1<<(nbits-1))<<" ("<<file<<":"<<line<<")"<<endl;
+	FPGA_ERROR("value too large:"
+		   <<value<<" "<<(1<<(nbits-1))<<" ("<<file<<":"<<line<<")");
       }
       assert(value<=(1<<(nbits-1)));
       if (value<-(1<<(nbits-1))) {
-	cout << "value too negative:"
-	     <<value<<" "<<-(1<<(nbits-1))<<" ("<<file<<":"<<line<<")"<<endl;
+	FPGA_ERROR("value too negative:"
+		   <<value<<" "<<-(1<<(nbits-1))<<" ("<<file<<":"<<line<<")");
       }
       assert(value>=-(1<<(nbits-1)));
     }
@@ -6,7 +6,6 @@
 #include <cstdlib>
 #include <vector>
 #include <map>
-#include <ext/hash_set>
 #include <math.h>
 #include <assert.h>
 #include "L1TStub.hh"
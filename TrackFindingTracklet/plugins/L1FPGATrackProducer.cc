@@ -88,9 +88,14 @@
 ///////////////
 // FPGA emulation
 #include "L1Trigger/TrackFindingTracklet/interface/FPGAConstants.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGASettings.hh"
 #include "L1Trigger/TrackFindingTracklet/interface/FPGASector.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGASetup.hh"
 #include "L1Trigger/TrackFindingTracklet/interface/FPGAWord.hh"
 #include "L1Trigger/TrackFindingTracklet/interface/FPGATimer.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGAProfiler.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGAStatistics.hh"
+#include "L1Trigger/TrackFindingTracklet/interface/FPGATrackDigest.hh"
 #include "L1Trigger/TrackFindingTracklet/interface/FPGATrackletCalculator.hh"
 #include "L1Trigger/TrackFindingTracklet/interface/IMATH_TrackletCalculator.hh"
 #include "L1Trigger/TrackFindingTracklet/interface/FPGACabling.hh"
@@ -189,9 +194,44 @@ private:
 
   string geometryType_;
 
+  FPGASettings settings;
+  FPGAContext* context;
+  FPGAScratch* scratch;
   FPGASector** sectors;
   FPGACabling cabling;
 
+  // per module profiling, enabled if profileFileName is non-empty
+  string profileFileName_;
+  string profileTraceFileName_;
+  unsigned int profileTraceEvents_;
+  FPGAProfiler* profiler_;
+
+  // memory occupancy and truncation statistics, enabled if memoryStatsFileName is non-empty
+  string memoryStatsFileName_;
+  FPGAStatistics* statistics_;
+
+  // digest of the final tracks of the job (printed at end of job), the
+  // event digests are written to digestFileName if it is non-empty
+  FPGATrackDigest runDigest_;
+  string digestFileName_;
+  std::ofstream digestOut_;
+
+  // stage level timers, accumulated over the job
+  FPGATimer readTimer;
+  FPGATimer cleanTimer;
+  FPGATimer addStubTimer;
+  FPGATimer VMRouterTimer;  
+  FPGATimer TETimer;
+  FPGATimer TCTimer;
+  FPGATimer PTTimer;
+  FPGATimer PRTimer;
+  FPGATimer METimer;
+  FPGATimer MCTimer;
+  FPGATimer MPTimer;
+  FPGATimer MTTimer;
+  FPGATimer FTTimer;
+  FPGATimer PDTimer;
+
   edm::ESHandle<TrackerTopology> tTopoHandle;
   edm::ESHandle<TrackerGeometry> tGeomHandle;
 
@@ -218,6 +258,7 @@ private:
   /// MANDATORY METHODS ///
   virtual void beginRun( const edm::Run& run, const edm::EventSetup& iSetup );
   virtual void endRun( const edm::Run& run, const edm::EventSetup& iSetup );
+  virtual void endJob();
   virtual void produce( edm::Event& iEvent, const edm::EventSetup& iSetup );
 };
 
@@ -255,6 +296,33 @@ L1FPGATrackProducer::L1FPGATrackProducer(edm::ParameterSet const& iConfig) :
 
   geometryType_ = iConfig.getUntrackedParameter<string>("trackerGeometryType","");
 
+  profileFileName_ = iConfig.getUntrackedParameter<string>("profileFileName","");
+  profileTraceFileName_ = iConfig.getUntrackedParameter<string>("profileTraceFileName","");
+  profileTraceEvents_ = iConfig.getUntrackedParameter<unsigned int>("profileTraceEvents",10);
+
+  memoryStatsFileName_ = iConfig.getUntrackedParameter<string>("memoryStatsFileName","");
+
+  digestFileName_ = iConfig.getUntrackedParameter<string>("digestFileName","");
+
+  // --------------------------------------------------------------------------------
+  // run time settings of the emulation (defaults as in FPGASettings)
+  // --------------------------------------------------------------------------------
+
+  settings.setHybrid(iConfig.getUntrackedParameter<bool>("hybrid",settings.hybrid()));
+  settings.setDoKF(iConfig.getUntrackedParameter<bool>("doKF",settings.doKF()));
+  settings.setNHelixPar(iConfig.getUntrackedParameter<unsigned int>("nHelixPar",settings.nHelixPar()));
+  settings.setPrintDebugKF(iConfig.getUntrackedParameter<bool>("printDebugKF",settings.printDebugKF()));
+  settings.setTMUX(iConfig.getUntrackedParameter<int>("TMUX",settings.TMUX()));
+  settings.setValidateTC(iConfig.getUntrackedParameter<bool>("validateTC",settings.validateTC()));
+  settings.setMaxOffset(iConfig.getUntrackedParameter<unsigned int>("truncationOffset",settings.maxOffset()));
+  settings.setTruncation(iConfig.getUntrackedParameter<unsigned int>("truncation",hourglass?108:54));
+  settings.setAdjacentRemoval(iConfig.getUntrackedParameter<bool>("adjacentRemoval",settings.adjacentRemoval()));
+  settings.setRemovalType(iConfig.getUntrackedParameter<string>("removalType",settings.removalType()));
+  settings.setMinIndStubs(iConfig.getUntrackedParameter<int>("minIndStubs",settings.minIndStubs()));
+  settings.setVMStubsDepth(iConfig.getUntrackedParameter<unsigned int>("vmStubsDepth",settings.vmStubsDepth()));
+  settings.setVMStubsBinDepth(iConfig.getUntrackedParameter<unsigned int>("vmStubsBinDepth",settings.vmStubsBinDepth()));
+  settings.check();
+
   fitPatternFile = iConfig.getParameter<edm::FileInPath> ("fitPatternFile");
   processingModulesFile = iConfig.getParameter<edm::FileInPath> ("processingModulesFile");
   memoryModulesFile = iConfig.getParameter<edm::FileInPath> ("memoryModulesFile");
@@ -268,25 +336,7 @@ L1FPGATrackProducer::L1FPGATrackProducer(edm::ParameterSet const& iConfig) :
   // get all constants 
   // --------------------------------------------------------------------------------
   
-  krinvpars = FPGATrackletCalculator::ITC_L1L2.rinv_final.get_K();
-  kphi0pars = FPGATrackletCalculator::ITC_L1L2.phi0_final.get_K();
-  ktpars    = FPGATrackletCalculator::ITC_L1L2.t_final.get_K();
-  kz0pars   = FPGATrackletCalculator::ITC_L1L2.z0_final.get_K();
-  kd0pars   = kd0;
-
-  krdisk = kr;
-  kzpars = kz;  
-  krprojshiftdisk = FPGATrackletCalculator::ITC_L1L2.rD_0_final.get_K();
-
-  //those can be made more transparent...
-  kphiproj123=kphi0pars*4;
-  kphiproj456=kphi0pars/2;
-  kzproj=kz;
-  kphider=krinvpars*(1<<phiderbitshift);
-  kzder=ktpars*(1<<zderbitshift);
-  kphiprojdisk=kphi0pars*4.0;
-  krprojderdiskshift=krprojderdisk*(1<<rderdiskbitshift);
-  krprojderdisk=(1.0/ktpars)/(1<<t2bits);
+  FPGAInitConstants();
 
 
   eventnum=0;
@@ -294,17 +344,11 @@ L1FPGATrackProducer::L1FPGATrackProducer(edm::ParameterSet const& iConfig) :
     asciiEventOut_.open(asciiEventOutName_.c_str());
   }
 
-  sectors=new FPGASector*[NSector];
-
   cout << "cabling DTC links :     "<<DTCLinkFile.fullPath()<<endl;
   cout << "module cabling :     "<<moduleCablingFile.fullPath()<<endl;
 
   cabling.init(DTCLinkFile.fullPath().c_str(),moduleCablingFile.fullPath().c_str());
 
-  for (unsigned int i=0;i<NSector;i++) {
-    sectors[i]=new FPGASector(i);
-  }  
-
   cout << "fit pattern :     "<<fitPatternFile.fullPath()<<endl;
   cout << "process modules : "<<processingModulesFile.fullPath()<<endl;
   cout << "memory modules :  "<<memoryModulesFile.fullPath()<<endl;
@@ -313,74 +357,46 @@ L1FPGATrackProducer::L1FPGATrackProducer(edm::ParameterSet const& iConfig) :
   fitpatternfile=fitPatternFile.fullPath();
 
 
-  cout << "Will read memory modules file"<<endl;
-
-  ifstream inmem(memoryModulesFile.fullPath().c_str());
-  assert(inmem.good());
-
-  while (inmem.good()){
-    string memType, memName, size;
-    inmem >>memType>>memName>>size;
-    if (!inmem.good()) continue;
-    if (writetrace) {
-      cout << "Read memory: "<<memType<<" "<<memName<<endl;
-    }
+  context=new FPGAContext(&settings);
+  scratch=new FPGAScratch();
+
+  sectors=FPGACreateSectors(&settings,context,scratch,memoryModulesFile.fullPath(),
+                            processingModulesFile.fullPath(),wiresFile.fullPath());
+
+  profiler_=0;
+  if (profileFileName_!="") {
+    profiler_=new FPGAProfiler();
+    if (profileTraceFileName_!="") profiler_->enableTrace(profileTraceEvents_);
+    profiler_->addStage("clean",&cleanTimer);
+    profiler_->addStage("addStub",&addStubTimer);
+    profiler_->addStage("VMRouter",&VMRouterTimer);
+    profiler_->addStage("TrackletEngine",&TETimer);
+    profiler_->addStage("TrackletCalculator",&TCTimer);
+    profiler_->addStage("ProjectionTransceiver",&PTTimer);
+    profiler_->addStage("ProjectionRouter",&PRTimer);
+    profiler_->addStage("MatchEngine",&METimer);
+    profiler_->addStage("MatchCalculator",&MCTimer);
+    profiler_->addStage("MatchProcessor",&MPTimer);
+    profiler_->addStage("MatchTransceiver",&MTTimer);
+    profiler_->addStage("FitTrack",&FTTimer);
+    profiler_->addStage("PurgeDuplicate",&PDTimer);
     for (unsigned int i=0;i<NSector;i++) {
-      sectors[i]->addMem(memType,memName);
+      sectors[i]->setProfiler(profiler_);
     }
-    
   }
 
-
-  cout << "Will read processing modules file"<<endl;
-
-  ifstream inproc(processingModulesFile.fullPath().c_str());
-  assert(inproc.good());
-
-  while (inproc.good()){
-    string procType, procName;
-    inproc >>procType>>procName;
-    if (!inproc.good()) continue;
-    if (writetrace) {
-      cout << "Read process: "<<procType<<" "<<procName<<endl;
-    }
+  statistics_=0;
+  if (memoryStatsFileName_!="") {
+    statistics_=new FPGAStatistics();
     for (unsigned int i=0;i<NSector;i++) {
-      sectors[i]->addProc(procType,procName);
+      sectors[i]->setStatistics(statistics_);
     }
-    
   }
 
-
-  cout << "Will read wiring information"<<endl;
-
-  ifstream inwire(wiresFile.fullPath().c_str());
-  assert(inwire.good());
-
-  while (inwire.good()){
-    string line;
-    getline(inwire,line);
-    if (!inwire.good()) continue;
-    if (writetrace) {
-      cout << "Line : "<<line<<endl;
-    }
-    stringstream ss(line);
-    string mem,tmp1,procin,tmp2,procout;
-    ss>>mem>>tmp1>>procin;
-    if (procin=="output=>") {
-      procin="";
-      ss>>procout;
-    }
-    else{
-      ss>>tmp2>>procout;
-    }
-
-    for (unsigned int i=0;i<NSector;i++) {
-      sectors[i]->addWire(mem,procin,procout);
-    }
-  
+  if (digestFileName_!="") {
+    digestOut_.open(digestFileName_.c_str());
   }
 
-
 }
 
 /////////////
@@ -390,8 +406,34 @@ L1FPGATrackProducer::~L1FPGATrackProducer()
   if (asciiEventOutName_!="") {
     asciiEventOut_.close();
   }
+  delete profiler_;
+  delete statistics_;
+  delete context;
+  delete scratch;
 }  
 
+//////////
+// END JOB
+void L1FPGATrackProducer::endJob()
+{
+  if (profiler_!=0) {
+    cout << "Writing profiling report for "<<profiler_->nEvents()<<" events to "<<profileFileName_<<endl;
+    profiler_->writeReport(profileFileName_);
+    if (profileTraceFileName_!="") {
+      profiler_->writeTrace(profileTraceFileName_);
+    }
+  }
+  if (statistics_!=0) {
+    cout << "Writing memory statistics for "<<statistics_->nEvents()<<" events to "<<memoryStatsFileName_<<endl;
+    statistics_->writeReport(memoryStatsFileName_);
+  }
+  cout << "Track digest : "<<runDigest_.str()<<" ("<<runDigest_.n()<<" events)"<<endl;
+  if (digestFileName_!="") {
+    digestOut_ << "run "<<runDigest_.n()<<" "<<runDigest_.str()<<endl;
+    digestOut_.close();
+  }
+}
+
 //////////
 // END JOB
 void L1FPGATrackProducer::endRun(const edm::Run& run, const edm::EventSetup& iSetup)
@@ -802,20 +844,7 @@ void L1FPGATrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSe
     ev.write(asciiEventOut_);
   }
 
-  FPGATimer readTimer;
-  FPGATimer cleanTimer;
-  FPGATimer addStubTimer;
-  FPGATimer VMRouterTimer;  
-  FPGATimer TETimer;
-  FPGATimer TCTimer;
-  FPGATimer PTTimer;
-  FPGATimer PRTimer;
-  FPGATimer METimer;
-  FPGATimer MCTimer;
-  FPGATimer MPTimer;
-  FPGATimer MTTimer;
-  FPGATimer FTTimer;
-  FPGATimer PDTimer;
+  if (profiler_) profiler_->beginEvent();
 
   bool first=true;
 
@@ -834,6 +863,14 @@ void L1FPGATrackProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSe
 
 #include "FPGA.icc"  
 
+  if (statistics_) statistics_->fillEvent();
+
+  FPGATrackDigest eventDigest;
+  eventDigest.add(tracks);
+  runDigest_.add(eventDigest);
+  if (digestFileName_!="") {
+    digestOut_ << "event "<<eventDigest.n()<<" "<<eventDigest.str()<<endl;
+  }
 
   int ntracks=0;
 
@@ -28,6 +28,25 @@ TTTracksFromTrackletEmulation = cms.EDProducer("L1FPGATrackProducer",
                                                asciiFileName = cms.untracked.string(""),
                                                failscenario = cms.untracked.int32(0),
                                                trackerGeometryType  = cms.untracked.string(""),  #tilted barrel is assumed, use "flat" if running on flat
+                                               # run time settings (see FPGASettings.hh for the defaults)
+                                               hybrid = cms.untracked.bool(True),  # False for the tracklet algorithm
+                                               doKF = cms.untracked.bool(True),    # KF fit, requires hybrid
+                                               nHelixPar = cms.untracked.uint32(4),
+                                               TMUX = cms.untracked.int32(6),
+                                               validateTC = cms.untracked.bool(True),  # False: bit-accurate TrackletCalculator only
+                                               # depth of the VM stub memories and of their bins, entries beyond
+                                               # the depth are counted as overflows (dropped if truncationOffset=0)
+                                               vmStubsDepth = cms.untracked.uint32(108),
+                                               vmStubsBinDepth = cms.untracked.uint32(16),
+                                               # per module timing report (JSON) and Chrome trace, disabled if empty
+                                               profileFileName = cms.untracked.string(""),
+                                               profileTraceFileName = cms.untracked.string(""),
+                                               profileTraceEvents = cms.untracked.uint32(10),
+                                               # memory occupancy and truncation statistics, disabled if empty
+                                               memoryStatsFileName = cms.untracked.string(""),
+                                               # digests of the output tracks per event (the run digest is always
+                                               # printed at the end of the job), disabled if empty
+                                               digestFileName = cms.untracked.string(""),
                                                # specific emulation inputs 
                                                # (if running on CRAB use "../../fitpattern.txt" etc instead)
                                                fitPatternFile  = cms.FileInPath('L1Trigger/TrackFindingTracklet/test/fitpattern.txt'),
@@ -0,0 +1,36 @@
+################################################################################################
+# Captures the stub inputs of the tracklet emulation for the benchmark suite, by running the
+# L1FPGATrackProducer with asciiFileName set. The resulting file can be replayed with
+# L1FPGABenchmark without the framework. To run execute do
+# cmsRun capture_cfg.py inputMC=<file list> Events=100 asciiFile=events.txt
+#################################################################################################
+
+import FWCore.ParameterSet.Config as cms
+import FWCore.Utilities.FileUtils as FileUtils
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+process = cms.Process("L1TrackletCapture")
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.Geometry.GeometryExtended2023D17Reco_cff') ## this needs to match the geometry you are running on
+process.load('Configuration.Geometry.GeometryExtended2023D17_cff')     ## this needs to match the geometry you are running on
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:upgradePLS3', '')
+
+options = VarParsing.VarParsing ('analysis')
+options.register('inputMC', '', VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.string, "File with the list of input files")
+options.register('Events', 100, VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.int, "Number of events to capture")
+options.register('asciiFile', 'events.txt', VarParsing.VarParsing.multiplicity.singleton, VarParsing.VarParsing.varType.string, "Output file with the stubs")
+options.parseArguments()
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(options.Events))
+process.source = cms.Source("PoolSource",
+                            fileNames = cms.untracked.vstring(*FileUtils.loadListFromFile(options.inputMC)),
+                            duplicateCheckMode = cms.untracked.string('noDuplicateCheck'))
+
+process.load("L1Trigger.TrackFindingTracklet.L1TrackletEmulationTracks_cff")
+process.TTTracksFromTrackletEmulation.asciiFileName = cms.untracked.string(options.asciiFile)
+process.TTTracks = cms.Path(process.L1TrackletEmulationTracks)
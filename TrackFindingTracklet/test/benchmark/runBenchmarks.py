@@ -0,0 +1,214 @@
+#!/usr/bin/env python
+################################################################################################
+# Benchmark and regression suite for the tracklet and TMTT chains.
+#
+# For each sample in samples.txt the stub inputs are captured once (capture_cfg.py) and then
+# replayed with L1FPGABenchmark through the tracklet chain (hybrid=0) and the hybrid chain with
+# the TMTT KF (hybrid=1, doKF=1). The TMTT HT+KF chain is run with cmsRun on the same input
+# files, as the TMTT stubs need the tracker geometry. For every run the events/s, the peak RSS
+# and the time per stage are recorded in the summary file, and the track digests are compared
+# to the references in reference/<sample>_<chain>.txt. The script exits with a non-zero status
+# if any run fails, any digest differs or any reference is missing. The references are created
+# (or replaced) by running with --update-references.
+#
+# python runBenchmarks.py [--samples single_muon,ttbar_pu200] [--chains tracklet,hybrid,tmtt]
+#                         [--data <dir>] [--repeat N] [--update-references]
+#
+# Must be run inside a CMSSW area with L1Trigger/TrackFindingTracklet and
+# L1Trigger/TrackFindingTMTT built.
+################################################################################################
+
+import os
+import re
+import sys
+import json
+import argparse
+import subprocess
+
+benchDir = os.path.dirname(os.path.abspath(__file__))
+trackletTestDir = os.path.dirname(benchDir)
+tmttTestDir = os.path.join(os.path.dirname(os.path.dirname(trackletTestDir)), 'TrackFindingTMTT', 'test')
+
+chainOptions = {
+    'tracklet' : ['-hybrid', '0', '-doKF', '0'],
+    'hybrid'   : ['-hybrid', '1', '-doKF', '1'],
+}
+
+
+def readSamples(fileName):
+    samples = []
+    for line in open(fileName):
+        line = line.strip()
+        if line == '' or line.startswith('#'):
+            continue
+        name, nevents, inputMC = line.split()
+        samples.append((name, int(nevents), inputMC))
+    return samples
+
+
+def run(cmd, cwd, logName, timed=False):
+    # Runs a command, writes its output to logName and returns (status, output, peak RSS in MB).
+    # With timed=True the command is run with /usr/bin/time -v to get the peak RSS.
+    if timed:
+        cmd = ['/usr/bin/time', '-v'] + cmd
+    print('Running ' + ' '.join(cmd))
+    proc = subprocess.Popen(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = proc.communicate()[0].decode('utf-8', 'replace')
+    with open(logName, 'w') as log:
+        log.write(output)
+    rss = None
+    m = re.search(r'Maximum resident set size \(kbytes\): (\d+)', output)
+    if m:
+        rss = int(m.group(1)) / 1024.
+    return proc.returncode, output, rss
+
+
+def parseValue(output, label):
+    m = re.search(r'^' + re.escape(label) + r'\s*:\s*(\S+)', output, re.MULTILINE)
+    if m:
+        return m.group(1)
+    return None
+
+
+def parseStages(output, pattern):
+    stages = {}
+    for m in re.finditer(pattern, output, re.MULTILINE):
+        stages[m.group(1)] = float(m.group(2))
+    return stages
+
+
+def capture(sample, dataDir):
+    name, nevents, inputMC = sample
+    eventsFile = os.path.join(dataDir, name + '_events.txt')
+    if os.path.exists(eventsFile):
+        return eventsFile
+    status, output, rss = run(['cmsRun', os.path.join(benchDir, 'capture_cfg.py'),
+                               'inputMC=' + os.path.join(tmttTestDir, inputMC),
+                               'Events=' + str(nevents), 'asciiFile=' + eventsFile],
+                              dataDir, os.path.join(dataDir, name + '_capture.log'))
+    if status != 0:
+        print('ERROR: capturing the stub inputs of ' + name + ' failed')
+        return None
+    return eventsFile
+
+
+def runTracklet(sample, chain, eventsFile, dataDir, args):
+    name, nevents, inputMC = sample
+    reference = os.path.join(benchDir, 'reference', name + '_' + chain + '.txt')
+    digestFile = os.path.join(dataDir, name + '_' + chain + '_digest.txt')
+    cmd = ['L1FPGABenchmark', '-events', eventsFile, '-nevents', str(nevents),
+           '-repeat', str(args.repeat), '-digest', digestFile] + chainOptions[chain]
+    if not args.update_references and os.path.exists(reference):
+        cmd += ['-reference', reference]
+    status, output, rss = run(cmd, trackletTestDir, os.path.join(dataDir, name + '_' + chain + '.log'))
+
+    result = {'sample' : name, 'chain' : chain, 'status' : status}
+    result['events_per_s'] = parseValue(output, 'Events/s')
+    result['peak_rss_mb'] = parseValue(output, 'Peak RSS [MB]')
+    result['digest'] = parseValue(output, 'Track digest')
+    result['stages_s'] = parseStages(output, r'^\s*(\w+)\s+\d+\s+\S+\s+\S+\s+(\S+)\s+\S+\s*$')
+
+    if status == 0 and args.update_references:
+        if not os.path.isdir(os.path.dirname(reference)):
+            os.makedirs(os.path.dirname(reference))
+        with open(digestFile) as fin:
+            with open(reference, 'w') as fout:
+                fout.write(fin.read())
+        result['reference'] = 'updated'
+    elif not os.path.exists(reference):
+        print('ERROR: no reference digests ' + reference + ', create them with --update-references')
+        result['reference'] = 'missing'
+    else:
+        result['reference'] = 'ok' if status == 0 else ('differs' if status == 2 else 'error')
+    return result
+
+
+def runTMTT(sample, dataDir, args):
+    name, nevents, inputMC = sample
+    reference = os.path.join(benchDir, 'reference', name + '_tmtt.txt')
+    status, output, rss = run(['cmsRun', 'tmtt_tf_analysis_cfg.py', 'Events=' + str(nevents),
+                               'inputMC=' + inputMC, 'histFile=', 'stageTiming=1'],
+                              tmttTestDir, os.path.join(dataDir, name + '_tmtt.log'), timed=True)
+
+    result = {'sample' : name, 'chain' : 'tmtt', 'status' : status}
+    result['events_per_s'] = parseValue(output, 'Events/s')
+    result['peak_rss_mb'] = rss
+    result['stages_s'] = parseStages(output, r'^Stage (\w+) : total = (\S+) s')
+    digests = re.findall(r'^Track digest (\w+)\s*:\s*(\S+)', output, re.MULTILINE)
+    result['digest'] = ' '.join(fitter + '=' + digest for fitter, digest in digests)
+
+    if status == 0 and args.update_references:
+        if not os.path.isdir(os.path.dirname(reference)):
+            os.makedirs(os.path.dirname(reference))
+        with open(reference, 'w') as fout:
+            fout.write(result['digest'] + '\n')
+        result['reference'] = 'updated'
+    elif not os.path.exists(reference):
+        print('ERROR: no reference digests ' + reference + ', create them with --update-references')
+        result['reference'] = 'missing'
+    else:
+        expected = open(reference).read().strip()
+        if result['digest'] == expected:
+            result['reference'] = 'ok'
+        else:
+            print('ERROR: TMTT track digests of ' + name + ' (' + result['digest'] +
+                  ') differ from the reference (' + expected + ')')
+            result['reference'] = 'differs'
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark and regression suite for the tracklet and TMTT chains')
+    parser.add_argument('--samples', default='', help='comma separated list of samples (default all)')
+    parser.add_argument('--chains', default='tracklet,hybrid,tmtt', help='comma separated list of chains')
+    parser.add_argument('--data', default=os.path.join(benchDir, 'data'), help='directory for the captured events and logs')
+    parser.add_argument('--repeat', type=int, default=3, help='number of timed passes of L1FPGABenchmark')
+    parser.add_argument('--summary', default='benchmark_summary.json', help='output file with the results')
+    parser.add_argument('--update-references', action='store_true', help='store the digests as new references')
+    args = parser.parse_args()
+
+    samples = readSamples(os.path.join(benchDir, 'samples.txt'))
+    if args.samples != '':
+        selected = args.samples.split(',')
+        samples = [s for s in samples if s[0] in selected]
+    chains = args.chains.split(',')
+
+    dataDir = os.path.abspath(args.data)
+    if not os.path.isdir(dataDir):
+        os.makedirs(dataDir)
+
+    results = []
+    for sample in samples:
+        if 'tracklet' in chains or 'hybrid' in chains:
+            eventsFile = capture(sample, dataDir)
+            for chain in ['tracklet', 'hybrid']:
+                if chain not in chains:
+                    continue
+                if eventsFile is None:
+                    results.append({'sample' : sample[0], 'chain' : chain, 'status' : -1, 'reference' : 'missing'})
+                    continue
+                results.append(runTracklet(sample, chain, eventsFile, dataDir, args))
+        if 'tmtt' in chains:
+            results.append(runTMTT(sample, dataDir, args))
+
+    with open(args.summary, 'w') as out:
+        json.dump(results, out, indent=2, sort_keys=True)
+
+    print('')
+    print('%-14s %-9s %12s %14s %10s' % ('sample', 'chain', 'events/s', 'peak RSS [MB]', 'digest'))
+    failed = False
+    for r in results:
+        print('%-14s %-9s %12s %14s %10s' % (r['sample'], r['chain'], r.get('events_per_s'),
+                                             r.get('peak_rss_mb'), r['reference']))
+        if r['status'] != 0 or r['reference'] not in ['ok', 'updated']:
+            failed = True
+    print('')
+    print('Results written to ' + args.summary)
+
+    if failed:
+        print('ERROR: benchmark suite FAILED, see the logs in ' + dataDir)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()